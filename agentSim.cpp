@@ -0,0 +1,100 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "agentSimulation.h"
+#include "orderBook.h"
+#include "eventDispatcher.h"
+
+// Usage:
+//   agent_sim [--seconds S] [--makers N] [--noise N] [--momentum N]
+//             [--latency-us U] [--feed-latency-us U] [--seed S]
+//
+// Runs a population of coroutine agents (market makers, noise traders and
+// momentum traders) against the matching engine in simulated time and
+// reports the kernel's throughput, the traded volume and each kind's
+// aggregate position and mark-to-market P&L.
+namespace {
+    constexpr SimTime MICROSECOND = 1'000;
+
+    const char* kindName(AgentKind kind) {
+        switch (kind) {
+            case AgentKind::MARKET_MAKER: return "market makers";
+            case AgentKind::NOISE: return "noise traders";
+            case AgentKind::MOMENTUM: return "momentum traders";
+            default: return "custom";
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    double seconds = 10.0;
+    std::size_t makers = 20;
+    std::size_t noise = 5000;
+    std::size_t momentum = 500;
+    SimTime latency = 20 * MICROSECOND;
+    SimTime feedLatency = 10 * MICROSECOND;
+    std::uint64_t seed = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        str arg = argv[i];
+        auto value = [&]() -> str {
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << std::endl;
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+        if (arg == "--seconds") seconds = std::stod(value());
+        else if (arg == "--makers") makers = std::stoul(value());
+        else if (arg == "--noise") noise = std::stoul(value());
+        else if (arg == "--momentum") momentum = std::stoul(value());
+        else if (arg == "--latency-us") latency = std::stoll(value()) * MICROSECOND;
+        else if (arg == "--feed-latency-us") feedLatency = std::stoll(value()) * MICROSECOND;
+        else if (arg == "--seed") seed = std::stoull(value());
+        else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    OrderBook book;
+    EventDispatcher dispatcher;
+    MatchingEngine engine(book, dispatcher);
+    SimulationKernel kernel(engine, dispatcher, seed);
+
+    AgentPopulationConfig config;
+    // Half the one-way latency again as jitter on each leg
+    config.latency = TraderLatency{{latency, latency / 2}, {latency, latency / 2}, {0, 0}};
+    config.feedLatency = feedLatency;
+    config.seed = seed;
+    AgentPopulation population(kernel, dispatcher, book, config);
+    population.addMarketMakers(makers);
+    population.addNoiseTraders(noise);
+    population.addMomentumTraders(momentum);
+
+    auto start = std::chrono::steady_clock::now();
+    std::size_t processed = kernel.runUntil(static_cast<SimTime>(seconds * 1e9));
+    population.stop();
+    processed += kernel.run();
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << population.size() << " agents, simulated " << seconds << " s in " << wall << " s: " << processed << " events ("
+              << processed / wall << " events/s)\n";
+    std::cout << "  " << population.trades() << " trades, " << population.volume() << " shares, last price "
+              << population.market().lastPrice << "\n";
+
+    for (AgentKind kind : {AgentKind::MARKET_MAKER, AgentKind::NOISE, AgentKind::MOMENTUM}) {
+        std::int64_t position = 0, pnl = 0;
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < population.size(); ++i) {
+            if (population.kind(i) != kind) continue;
+            count++;
+            position += population.position(i);
+            pnl += population.markToMarket(i);
+        }
+        if (count == 0) continue;
+        std::cout << "  " << count << " " << kindName(kind) << ": net position " << position << ", P&L " << pnl / 100.0 << "\n";
+    }
+    return 0;
+}
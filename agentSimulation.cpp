@@ -0,0 +1,285 @@
+#include "agentSimulation.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include "limitOrder.h"
+#include "marketOrder.h"
+
+void AgentTask::resume() {
+    if (done()) return;
+    handle.resume();
+    if (handle.done() && handle.promise().error) std::rethrow_exception(std::exchange(handle.promise().error, nullptr));
+}
+
+Price MarketView::mid() const {
+    if (bidPrice && askPrice) return static_cast<Price>((static_cast<std::uint64_t>(bidPrice) + askPrice) / 2);
+    if (bidPrice) return bidPrice;
+    if (askPrice) return askPrice;
+    return lastPrice;
+}
+
+void AgentContext::Wait::await_suspend(std::coroutine_handle<>) const {
+    population->suspend(agent, until, untilFill);
+}
+
+AgentContext::Wait AgentContext::sleep(SimTime delay) const {
+    return Wait{population, agent, population->kernel.currentTime() + std::max<SimTime>(delay, 0), false};
+}
+
+AgentContext::Wait AgentContext::sleepUntilFill(SimTime timeout) const {
+    return Wait{population, agent, population->kernel.currentTime() + std::max<SimTime>(timeout, 0), true};
+}
+
+SimTime AgentContext::now() const { return population->kernel.currentTime(); }
+const MarketView& AgentContext::market() const { return population->market(); }
+std::mt19937_64& AgentContext::random() const { return population->rng; }
+TraderID AgentContext::traderID() const { return population->traderID(agent); }
+std::int64_t AgentContext::position() const { return population->agents.position[agent]; }
+
+Price AgentContext::mid() const {
+    const Price price = population->market().mid();
+    return price ? price : population->config.referencePrice;
+}
+
+Price AgentContext::referencePrice() const { return population->config.referencePrice; }
+
+Price AgentContext::restingPrice(Side side) const {
+    const auto& columns = population->agents;
+    if (side == Side::BUY) return columns.bidOrder[agent] ? columns.bidPrice[agent] : 0;
+    return columns.askOrder[agent] ? columns.askPrice[agent] : 0;
+}
+
+void AgentContext::placeLimit(Side side, Price price, Quantity quantity) const {
+    cancel(side);
+    auto& columns = population->agents;
+    const OrderID orderID = population->kernel.submitOrder(
+        std::make_unique<LimitOrder>(population->config.symbol, 0, OrderType::LIMIT, side, price, quantity, traderID()));
+    (side == Side::BUY ? columns.bidOrder : columns.askOrder)[agent] = orderID;
+    (side == Side::BUY ? columns.bidPrice : columns.askPrice)[agent] = price;
+}
+
+void AgentContext::quote(Price bidPrice, Quantity bidQuantity, Price askPrice, Quantity askQuantity) const {
+    if (bidQuantity == 0) cancel(Side::BUY);
+    else if (restingPrice(Side::BUY) != bidPrice) placeLimit(Side::BUY, bidPrice, bidQuantity);
+    if (askQuantity == 0) cancel(Side::SELL);
+    else if (restingPrice(Side::SELL) != askPrice) placeLimit(Side::SELL, askPrice, askQuantity);
+}
+
+void AgentContext::cancel(Side side) const {
+    OrderID& orderID = (side == Side::BUY ? population->agents.bidOrder : population->agents.askOrder)[agent];
+    if (orderID == 0) return;
+    population->kernel.cancelOrder(traderID(), orderID);
+    orderID = 0;
+}
+
+void AgentContext::cancelAll() const {
+    cancel(Side::BUY);
+    cancel(Side::SELL);
+}
+
+void AgentContext::placeMarket(Side side, Quantity quantity) const {
+    population->kernel.submitOrder(std::make_unique<MarketOrder>(population->config.symbol, 0, OrderType::MARKET, side, quantity, traderID()));
+}
+
+AgentTask marketMakerAgent(AgentContext context, MarketMakerParams params) {
+    // Spread the first quotes over one interval
+    co_await context.sleep(std::uniform_int_distribution<SimTime>(0, params.interval)(context.random()));
+    while (true) {
+        const std::int64_t position = context.position();
+        const std::int64_t lean = params.inventoryPerTick > 0 ? position / params.inventoryPerTick : 0;
+        const std::int64_t mid = static_cast<std::int64_t>(context.mid()) - lean;
+        const std::int64_t bid = std::max<std::int64_t>(1, mid - params.halfSpread);
+        const std::int64_t ask = std::max<std::int64_t>(bid + 1, mid + params.halfSpread);
+        context.quote(static_cast<Price>(bid), position < params.maxPosition ? params.size : 0,
+                      static_cast<Price>(ask), position > -params.maxPosition ? params.size : 0);
+        co_await context.sleepUntilFill(params.interval);
+    }
+}
+
+AgentTask noiseTraderAgent(AgentContext context, NoiseTraderParams params) {
+    std::exponential_distribution<double> arrival(1.0 / static_cast<double>(std::max<SimTime>(params.meanInterval, 1)));
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_int_distribution<Quantity> size(1, std::max<Quantity>(params.maxSize, 1));
+    std::uniform_int_distribution<Price> offset(0, params.maxOffset);
+    std::mt19937_64& rng = context.random();
+    while (true) {
+        co_await context.sleep(static_cast<SimTime>(arrival(rng)) + 1);
+        const Side side = unit(rng) < 0.5 ? Side::BUY : Side::SELL;
+        if (unit(rng) < params.marketProbability) {
+            context.placeMarket(side, size(rng));
+            continue;
+        }
+        const double mid = context.mid();
+        const auto anchor = std::llround(mid + params.valueWeight * (static_cast<double>(context.referencePrice()) - mid));
+        const std::int64_t away = offset(rng);
+        const std::int64_t price = side == Side::BUY ? std::max<std::int64_t>(anchor - away, 1) : anchor + away;
+        context.placeLimit(side, static_cast<Price>(price), size(rng));
+    }
+}
+
+AgentTask momentumTraderAgent(AgentContext context, MomentumTraderParams params) {
+    const double alpha = 2.0 / (static_cast<double>(params.lookback) + 1.0);
+    co_await context.sleep(std::uniform_int_distribution<SimTime>(0, params.interval)(context.random()));
+    double average = context.mid();
+    while (true) {
+        co_await context.sleep(params.interval);
+        const Price mid = context.mid();
+        const double trend = mid - average;
+        average += alpha * (mid - average);
+        const std::int64_t position = context.position();
+        // Position only counts confirmed fills, so orders in flight can overshoot the limit by one
+        Side side;
+        Quantity quantity = params.size;
+        if (trend >= params.threshold && position < params.maxPosition) side = Side::BUY;
+        else if (trend <= -static_cast<double>(params.threshold) && position > -params.maxPosition) side = Side::SELL;
+        else if (std::abs(trend) < params.threshold / 2.0 && position != 0) {
+            // The trend has faded: unwind
+            side = position > 0 ? Side::SELL : Side::BUY;
+            quantity = static_cast<Quantity>(std::min<std::int64_t>(std::abs(position), params.size));
+        }
+        else continue;
+        const std::int64_t limit = side == Side::BUY ? static_cast<std::int64_t>(mid) + params.maxSlippage
+                                                     : std::max<std::int64_t>(static_cast<std::int64_t>(mid) - params.maxSlippage, 1);
+        context.placeLimit(side, static_cast<Price>(limit), quantity);
+    }
+}
+
+AgentPopulation::AgentPopulation(SimulationKernel& kernel, EventDispatcher& dispatcher, OrderBook& book, const AgentPopulationConfig& config)
+    : kernel(kernel), book(book), config(config), rng(config.seed) {
+    // Fired synchronously by the engine inside the kernel's step, once the
+    // book reflects the whole command
+    subscriptions.add<TradeExecutedEvent>(dispatcher, [this](const TradeExecutedEvent& e) {
+        lastPrice = e.price;
+        tradeCount++;
+        tradedVolume += e.quantity;
+        snapshot(true);
+    });
+    subscriptions.add<OrderAcceptedEvent>(dispatcher, [this](const OrderAcceptedEvent&) { snapshot(false); });
+    subscriptions.add<OrderCancelledEvent>(dispatcher, [this](const OrderCancelledEvent&) { snapshot(false); });
+    subscriptions.add<MassCancelEvent>(dispatcher, [this](const MassCancelEvent&) { snapshot(false); });
+    subscriptions.add<AuctionUncrossEvent>(dispatcher, [this](const AuctionUncrossEvent&) { snapshot(false); });
+}
+
+std::size_t AgentPopulation::add(AgentKind kind, const std::function<AgentTask(AgentContext)>& program) {
+    const std::size_t agent = tasks.size();
+    kernel.addAgent(traderID(agent), *this, config.latency, false);
+
+    agents.kind.push_back(kind);
+    agents.position.push_back(0);
+    agents.cash.push_back(0);
+    agents.bidOrder.push_back(0);
+    agents.askOrder.push_back(0);
+    agents.bidPrice.push_back(0);
+    agents.askPrice.push_back(0);
+    agents.fills.push_back(0);
+    agents.generation.push_back(0);
+    agents.wakeOnFill.push_back(0);
+    tasks.push_back(program(AgentContext(*this, agent)));
+    return agent;
+}
+
+void AgentPopulation::addMarketMakers(std::size_t count, const MarketMakerParams& params) {
+    for (std::size_t i = 0; i < count; ++i) {
+        add(AgentKind::MARKET_MAKER, [&params](AgentContext context) { return marketMakerAgent(context, params); });
+    }
+}
+
+void AgentPopulation::addNoiseTraders(std::size_t count, const NoiseTraderParams& params) {
+    for (std::size_t i = 0; i < count; ++i) {
+        add(AgentKind::NOISE, [&params](AgentContext context) { return noiseTraderAgent(context, params); });
+    }
+}
+
+void AgentPopulation::addMomentumTraders(std::size_t count, const MomentumTraderParams& params) {
+    for (std::size_t i = 0; i < count; ++i) {
+        add(AgentKind::MOMENTUM, [&params](AgentContext context) { return momentumTraderAgent(context, params); });
+    }
+}
+
+std::size_t AgentPopulation::agentOf(TraderID traderID) const {
+    const std::size_t agent = traderID - config.firstTraderID;
+    if (traderID < config.firstTraderID || agent >= tasks.size()) throw std::logic_error("Trader " + std::to_string(traderID) + " is not in the population");
+    return agent;
+}
+
+void AgentPopulation::snapshot(bool traded) {
+    const BookAnalytics analytics = book.getAnalytics();
+    if (!traded && analytics.version == lastVersion) return;
+    lastVersion = analytics.version;
+    const MarketView next{analytics.bidPrice, analytics.bidQuantity, analytics.askPrice, analytics.askQuantity, lastPrice};
+    if (config.feedLatency <= 0) {
+        view = next;
+        return;
+    }
+    feed.push_back(FeedUpdate{kernel.currentTime() + config.feedLatency, next});
+}
+
+const MarketView& AgentPopulation::market() {
+    const SimTime now = kernel.currentTime();
+    while (!feed.empty() && feed.front().visibleAt <= now) {
+        view = feed.front().view;
+        feed.pop_front();
+    }
+    return view;
+}
+
+void AgentPopulation::suspend(std::size_t agent, SimTime until, bool untilFill) {
+    agents.wakeOnFill[agent] = untilFill;
+    kernel.setTimer(traderID(agent), until, agents.generation[agent]);
+}
+
+void AgentPopulation::resume(std::size_t agent) {
+    if (stopped) return;
+    agents.generation[agent]++;
+    agents.wakeOnFill[agent] = 0;
+    tasks[agent].resume();
+}
+
+void AgentPopulation::applyFill(std::size_t agent, Side side, OrderID orderID, Price price, Quantity quantity, Quantity remaining) {
+    const std::int64_t signedQuantity = side == Side::BUY ? quantity : -static_cast<std::int64_t>(quantity);
+    agents.position[agent] += signedQuantity;
+    agents.cash[agent] -= signedQuantity * price;
+    agents.fills[agent]++;
+    if (remaining == 0) clearOrder(agent, orderID);
+}
+
+void AgentPopulation::clearOrder(std::size_t agent, OrderID orderID) {
+    if (agents.bidOrder[agent] == orderID) agents.bidOrder[agent] = 0;
+    if (agents.askOrder[agent] == orderID) agents.askOrder[agent] = 0;
+}
+
+void AgentPopulation::onStart(SimulationKernel& kernel) {
+    resume(agentOf(kernel.recipient()));
+}
+
+void AgentPopulation::onExecutionReport(SimulationKernel& kernel, const EngineEvent& event) {
+    const TraderID trader = kernel.recipient();
+    const std::size_t agent = agentOf(trader);
+    if (auto* trade = std::get_if<TradeExecutedEvent>(&event)) {
+        // The kernel reports a self-trade once, so both sides may be this agent's
+        if (trade->aggressingTraderID == trader) {
+            applyFill(agent, trade->aggressingSide, trade->aggressingOrderID, trade->price, trade->quantity, trade->aggressingRemainingQuantity);
+        }
+        if (trade->restingTraderID == trader) {
+            const Side side = trade->aggressingSide == Side::BUY ? Side::SELL : Side::BUY;
+            applyFill(agent, side, trade->restingOrderID, trade->price, trade->quantity, trade->restingRemainingQuantity);
+        }
+        if (agents.wakeOnFill[agent]) resume(agent);
+    }
+    else if (auto* cancelled = std::get_if<OrderCancelledEvent>(&event)) {
+        if (cancelled->remaining == 0) clearOrder(agent, cancelled->orderID);
+    }
+    else if (auto* rejected = std::get_if<OrderRejectedEvent>(&event)) {
+        clearOrder(agent, rejected->orderID);
+    }
+}
+
+void AgentPopulation::onTimer(SimulationKernel& kernel, std::uint64_t timerID) {
+    const std::size_t agent = agentOf(kernel.recipient());
+    if (timerID == agents.generation[agent]) resume(agent);
+}
+
+std::int64_t AgentPopulation::markToMarket(std::size_t agent) const {
+    return agents.cash[agent] + agents.position[agent] * static_cast<std::int64_t>(lastPrice);
+}
@@ -0,0 +1,254 @@
+#pragma once
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <random>
+#include <utility>
+#include <vector>
+#include "simulationKernel.h"
+#include "orderBook.h"
+#include "eventDispatcher.h"
+#include "events.h"
+
+class AgentPopulation;
+
+// The coroutine an agent runs. It starts suspended; the population resumes it
+// when the simulation starts and whenever something it awaits comes due. An
+// exception thrown by the agent propagates out of the kernel step that
+// resumed it.
+class AgentTask {
+    public:
+        struct promise_type {
+            std::exception_ptr error;
+
+            AgentTask get_return_object() { return AgentTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { error = std::current_exception(); }
+        };
+
+        AgentTask() = default;
+        explicit AgentTask(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+        AgentTask(AgentTask&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+        AgentTask& operator=(AgentTask&& other) noexcept {
+            if (this != &other) {
+                if (handle) handle.destroy();
+                handle = std::exchange(other.handle, {});
+            }
+            return *this;
+        }
+        ~AgentTask() {
+            if (handle) handle.destroy();
+        }
+
+        // Runs the agent to its next suspension point.
+        void resume();
+        bool done() const { return !handle || handle.done(); }
+
+    private:
+        std::coroutine_handle<promise_type> handle;
+};
+
+enum class AgentKind : std::uint8_t {
+    MARKET_MAKER,
+    NOISE,
+    MOMENTUM,
+    CUSTOM
+};
+
+// Top of book as the agents see it, `feedLatency` behind the engine.
+struct MarketView {
+    Price bidPrice = 0;         // 0 when the side is empty
+    Quantity bidQuantity = 0;
+    Price askPrice = 0;
+    Quantity askQuantity = 0;
+    Price lastPrice = 0;        // last trade, 0 before the first
+
+    // Mid of a two-sided book, else the side that is there, else the last trade.
+    Price mid() const;
+};
+
+// What an agent's coroutine is handed: its own slot in the population and
+// the actions it can take. Orders go through the kernel, so they reach the
+// engine after the agent's order-entry latency. Each agent keeps at most one
+// resting bid and one resting ask; placing another cancels the one it replaces.
+class AgentContext {
+    private:
+        AgentPopulation* population;
+        std::size_t agent;
+
+    public:
+        struct Wait {
+            AgentPopulation* population;
+            std::size_t agent;
+            SimTime until;
+            bool untilFill;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<>) const;
+            void await_resume() const noexcept {}
+        };
+
+        AgentContext(AgentPopulation& population, std::size_t agent) : population(&population), agent(agent) {}
+
+        // Suspends the agent for `delay` simulated nanoseconds.
+        Wait sleep(SimTime delay) const;
+        // As sleep(), but resumes as soon as one of the agent's orders fills.
+        Wait sleepUntilFill(SimTime timeout) const;
+
+        SimTime now() const;
+        const MarketView& market() const;
+        // market().mid(), or the population's reference price on an empty market.
+        Price mid() const;
+        Price referencePrice() const;
+        std::mt19937_64& random() const;
+
+        TraderID traderID() const;
+        std::int64_t position() const;
+        Price restingPrice(Side side) const;     // 0 when nothing rests on that side
+
+        void placeLimit(Side side, Price price, Quantity quantity) const;
+        // Moves both resting orders to these prices. A side already resting at
+        // its price keeps its queue position; a zero quantity cancels that side.
+        void quote(Price bidPrice, Quantity bidQuantity, Price askPrice, Quantity askQuantity) const;
+        void cancel(Side side) const;
+        void cancelAll() const;
+        void placeMarket(Side side, Quantity quantity) const;
+};
+
+struct MarketMakerParams {
+    Price halfSpread = 2;                   // ticks either side of the mid
+    Quantity size = 100;
+    SimTime interval = 1'000'000;           // re-quote at least this often
+    std::int64_t inventoryPerTick = 200;    // quotes lean one tick per this much inventory
+    std::int64_t maxPosition = 5'000;       // stops quoting the side that would add to it
+};
+
+struct NoiseTraderParams {
+    SimTime meanInterval = 100'000'000;     // exponential arrivals
+    double marketProbability = 0.3;
+    Price maxOffset = 5;                    // limit orders rest up to this far behind their anchor
+    // Limit orders are anchored this fraction of the way from the mid to the
+    // reference price, which keeps the price from wandering off indefinitely
+    double valueWeight = 0.05;
+    Quantity maxSize = 100;
+};
+
+struct MomentumTraderParams {
+    SimTime interval = 10'000'000;
+    std::size_t lookback = 20;              // samples in the moving average
+    Price threshold = 2;                    // ticks from the average that count as a trend
+    Price maxSlippage = 3;                  // orders are limits this far through the mid
+    Quantity size = 10;
+    std::int64_t maxPosition = 100;         // unwinds in steps of `size` once the trend fades
+};
+
+// The built-in behaviours, usable as programs for AgentPopulation::add().
+AgentTask marketMakerAgent(AgentContext context, MarketMakerParams params);
+AgentTask noiseTraderAgent(AgentContext context, NoiseTraderParams params);
+AgentTask momentumTraderAgent(AgentContext context, MomentumTraderParams params);
+
+struct AgentPopulationConfig {
+    str symbol = "SIM";
+    TraderID firstTraderID = 1000;      // agents take consecutive ids from here
+    Price referencePrice = 10000;       // mid while the book is empty
+    TraderLatency latency{};            // order entry and acks, for every agent
+    SimTime feedLatency = 0;            // how far behind the engine MarketView runs
+    std::uint64_t seed = 1;
+};
+
+// Thousands of cooperatively scheduled traders on one SimulationKernel. Each
+// agent is a C++20 coroutine that only runs when an await comes due, so an
+// idle agent costs its coroutine frame and one row of the columns below.
+// Agents are added to the kernel without market data: instead of one
+// delivery per agent per event, the population snapshots the book's
+// analytics after each event and agents read the latest snapshot at least
+// `feedLatency` old when they wake. Executions reach the owning agent after
+// its ack latency and update its row.
+//
+// Agents run until they return or stop() is called, so bound a run with
+// runUntil(). Add agents before the kernel's first step. Single-threaded.
+class AgentPopulation : public SimulationAgent {
+    private:
+        friend class AgentContext;
+
+        struct FeedUpdate {
+            SimTime visibleAt;
+            MarketView view;
+        };
+
+        // Per-agent state, one column per field
+        struct AgentColumns {
+            std::vector<AgentKind> kind;
+            std::vector<std::int64_t> position;
+            std::vector<std::int64_t> cash;     // ticks
+            std::vector<OrderID> bidOrder;      // 0 when nothing rests
+            std::vector<OrderID> askOrder;
+            std::vector<Price> bidPrice;
+            std::vector<Price> askPrice;
+            std::vector<std::uint32_t> fills;
+            // Bumped whenever the agent resumes, so timers from earlier waits are ignored
+            std::vector<std::uint32_t> generation;
+            std::vector<std::uint8_t> wakeOnFill;
+        };
+
+        SimulationKernel& kernel;
+        OrderBook& book;
+        AgentPopulationConfig config;
+        std::mt19937_64 rng;
+        AgentColumns agents;
+        std::vector<AgentTask> tasks;
+
+        std::deque<FeedUpdate> feed;
+        MarketView view;
+        Price lastPrice = 0;
+        std::uint64_t lastVersion = 0;
+        std::uint64_t tradeCount = 0;
+        std::uint64_t tradedVolume = 0;
+        bool stopped = false;
+        Subscriptions subscriptions;
+
+        std::size_t agentOf(TraderID traderID) const;
+        void snapshot(bool traded);
+        void suspend(std::size_t agent, SimTime until, bool untilFill);
+        void resume(std::size_t agent);
+        void applyFill(std::size_t agent, Side side, OrderID orderID, Price price, Quantity quantity, Quantity remaining);
+        void clearOrder(std::size_t agent, OrderID orderID);
+
+    public:
+        AgentPopulation(SimulationKernel& kernel, EventDispatcher& dispatcher, OrderBook& book, const AgentPopulationConfig& config = {});
+        AgentPopulation(const AgentPopulation&) = delete;
+        AgentPopulation& operator=(const AgentPopulation&) = delete;
+
+        // Adds an agent running `program`, called once with its context; returns its index.
+        std::size_t add(AgentKind kind, const std::function<AgentTask(AgentContext)>& program);
+        void addMarketMakers(std::size_t count, const MarketMakerParams& params = {});
+        void addNoiseTraders(std::size_t count, const NoiseTraderParams& params = {});
+        void addMomentumTraders(std::size_t count, const MomentumTraderParams& params = {});
+
+        // No agent is resumed after this, so the kernel's run() drains what is
+        // still in flight and returns; orders left resting stay on the book.
+        void stop() { stopped = true; }
+
+        void onStart(SimulationKernel& kernel) override;
+        void onExecutionReport(SimulationKernel& kernel, const EngineEvent& event) override;
+        void onTimer(SimulationKernel& kernel, std::uint64_t timerID) override;
+
+        std::size_t size() const { return tasks.size(); }
+        TraderID traderID(std::size_t agent) const { return config.firstTraderID + static_cast<TraderID>(agent); }
+        AgentKind kind(std::size_t agent) const { return agents.kind[agent]; }
+        std::int64_t position(std::size_t agent) const { return agents.position[agent]; }
+        std::int64_t cash(std::size_t agent) const { return agents.cash[agent]; }
+        std::uint32_t fills(std::size_t agent) const { return agents.fills[agent]; }
+        bool finished(std::size_t agent) const { return tasks[agent].done(); }
+        // Cash plus position at the last trade price, in ticks.
+        std::int64_t markToMarket(std::size_t agent) const;
+
+        // Brought up to the kernel's current time.
+        const MarketView& market();
+        std::uint64_t trades() const { return tradeCount; }
+        std::uint64_t volume() const { return tradedVolume; }
+};
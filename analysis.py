@@ -1,13 +1,53 @@
+import argparse
+import numpy as np
 import pandas as pd
-import quantstats as qs
 import plotly.graph_objects as go
 from plotly.subplots import make_subplots
+import trading_core
 from data_handler import data_file_path # Path to your price data
 
+DAY_MS = 86_400_000
+
+def performance_summary(history_csv="csv/backtest_history.csv", trades_csv="csv/backtest_trades.csv"):
+    """
+    Computes returns, risk and trade statistics natively in one pass over the saved
+    backtest, on the same daily sampling as the QuantStats report.
+    """
+    history = pd.read_csv(history_csv, parse_dates=['timestamp'])
+    trades = pd.read_csv(trades_csv)
+    config = trading_core.PerformanceConfig()
+    config.bucket_ms = DAY_MS
+    config.price_scale = 1.0    # the trades CSV is already in dollars
+
+    timestamps = history['timestamp'].values.astype('datetime64[ms]').astype(np.int64)
+    fills = None
+    if not trades.empty:
+        fills = {
+            'price': trades['price'].to_numpy(),
+            'quantity': trades['quantity'].to_numpy(),
+            'side': np.where(trades['side'] == 'BUY', 1, -1).astype(np.int8),
+            'symbol': pd.Categorical(trades['symbol']).codes.astype(np.uint32),
+        }
+    summary, _ = trading_core.analyze_performance(timestamps, history['value'].to_numpy(), fills, config)
+    return summary
+
+def print_performance_summary(history_csv="csv/backtest_history.csv", trades_csv="csv/backtest_trades.csv"):
+    s = performance_summary(history_csv, trades_csv)
+    print(f"Total return:      {s.total_return:.2%}")
+    print(f"CAGR:              {s.annual_return:.2%}")
+    print(f"Volatility (ann.): {s.annual_volatility:.2%}")
+    print(f"Sharpe:            {s.sharpe:.2f}")
+    print(f"Sortino:           {s.sortino:.2f}")
+    print(f"Max drawdown:      {s.max_drawdown:.2%} ({s.max_drawdown_periods} days)")
+    print(f"Closed trades:     {s.closed_trades} ({s.win_rate:.1%} winners)")
+    print(f"Profit factor:     {s.profit_factor:.2f}")
+    print(f"Realized P&L:      ${s.realized_pnl:,.2f}")
+
 def generate_quantstats_report(history_csv="csv/backtest_history.csv", report_filename="strategy_report.html"):
     """
     Generates a comprehensive quantitative analysis report using quantstats.
     """
+    import quantstats as qs
     print("Generating QuantStats report...")
     
     # --- 1. Load and Prepare the History Data ---
@@ -42,16 +82,15 @@ def generate_interactive_plot(trades_csv="csv/backtest_trades.csv", plot_filenam
 
     # --- Load Data ---
     trades = pd.read_csv(trades_csv, parse_dates=['timestamp'])
-    price_data = pd.read_csv(data_file_path, parse_dates=True, index_col=0)
-    price_data.rename(columns=str.lower, inplace=True)
+    price_data = trading_core.load_bars_csv(str(data_file_path))
 
     # --- Create Candlestick Chart ---
     fig = make_subplots(rows=1, cols=1)
-    fig.add_trace(go.Candlestick(x=price_data.index,
-                                open=price_data['open'],
-                                high=price_data['high'],
-                                low=price_data['low'],
-                                close=price_data['close'],
+    fig.add_trace(go.Candlestick(x=pd.to_datetime(price_data['timestamp'], unit='ms'),
+                                open=price_data['open'] / 100,
+                                high=price_data['high'] / 100,
+                                low=price_data['low'] / 100,
+                                close=price_data['close'] / 100,
                                 name='AAPL Price'))
 
     # --- Add Trade Markers ---
@@ -83,5 +122,10 @@ def generate_interactive_plot(trades_csv="csv/backtest_trades.csv", plot_filenam
 
 if __name__ == "__main__":
     # This allows you to run the analysis independently after a backtest
-    generate_quantstats_report()
+    parser = argparse.ArgumentParser(description="Summarize the last backtest")
+    parser.add_argument("--quantstats", action="store_true", help="also write the full QuantStats HTML report")
+    args = parser.parse_args()
+    print_performance_summary()
+    if args.quantstats:
+        generate_quantstats_report()
     generate_interactive_plot()
\ No newline at end of file
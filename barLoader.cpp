@@ -0,0 +1,352 @@
+#include "barLoader.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+    constexpr std::int64_t DAY_MS = 86'400'000;
+    // Bytes scanned per pass; the separator offsets of a pass stay in cache
+    // while its rows are parsed. Doubled for a line that does not fit.
+    constexpr std::size_t CHUNK_BYTES = 1 << 20;
+
+    bool digits(const char*& p, const char* end, int count, int& value) {
+        if (end - p < count) return false;
+        value = 0;
+        for (int i = 0; i < count; ++i) {
+            const unsigned digit = static_cast<unsigned>(p[i] - '0');
+            if (digit > 9) return false;
+            value = value * 10 + static_cast<int>(digit);
+        }
+        p += count;
+        return true;
+    }
+
+    bool expect(const char*& p, const char* end, char c) {
+        if (p == end || *p != c) return false;
+        ++p;
+        return true;
+    }
+
+    bool isLeapYear(int year) {
+        return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    }
+
+    int daysInMonth(int year, int month) {
+        static constexpr int DAYS[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        return month == 2 && isLeapYear(year) ? 29 : DAYS[month - 1];
+    }
+
+    // Days since 1970-01-01 of a proleptic Gregorian date
+    std::int64_t daysFromCivil(int year, int month, int day) {
+        year -= month <= 2;
+        const int era = (year >= 0 ? year : year - 399) / 400;
+        const int yearOfEra = year - era * 400;
+        const int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        const int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        return static_cast<std::int64_t>(era) * 146097 + dayOfEra - 719468;
+    }
+
+    std::string_view trim(std::string_view text) {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) text.remove_suffix(1);
+        return text;
+    }
+
+    class MappedFile {
+        public:
+            const char* data = nullptr;
+            std::size_t size = 0;
+
+            explicit MappedFile(const str& path) {
+                int fd = ::open(path.c_str(), O_RDONLY);
+                if (fd < 0) throw std::runtime_error("Cannot open bar file " + path);
+                struct stat info;
+                if (fstat(fd, &info) != 0) {
+                    ::close(fd);
+                    throw std::runtime_error("Cannot stat bar file " + path);
+                }
+                size = static_cast<std::size_t>(info.st_size);
+                if (size == 0) {
+                    ::close(fd);
+                    return;
+                }
+                void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                ::close(fd);
+                if (mapped == MAP_FAILED) throw std::runtime_error("Cannot map bar file " + path);
+                madvise(mapped, size, MADV_SEQUENTIAL);
+                data = static_cast<const char*>(mapped);
+            }
+            ~MappedFile() {
+                if (data) munmap(const_cast<char*>(data), size);
+            }
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+    };
+
+    class BarParser {
+        private:
+            static constexpr std::size_t MISSING = std::numeric_limits<std::size_t>::max();
+
+            const str& path;
+            const double ticksPerUnit;
+            int decimals = -1;      // log10(ticksPerUnit) when that is a whole number up to 9
+            BarColumns& bars;
+            bool haveHeader = false;
+            std::size_t openColumn = MISSING, highColumn = MISSING, lowColumn = MISSING, closeColumn = MISSING, volumeColumn = MISSING;
+            std::size_t fieldCount = 0;
+
+            [[noreturn]] void fail(const str& what, std::string_view field, std::size_t line) const {
+                throw std::runtime_error(what + " '" + str(field) + "' on line " + std::to_string(line) + " of " + path);
+            }
+
+            void readHeader(const std::vector<std::string_view>& fields) {
+                for (std::size_t i = 1; i < fields.size(); ++i) {
+                    str name(trim(fields[i]));
+                    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+                    if (name == "open") openColumn = i;
+                    else if (name == "high") highColumn = i;
+                    else if (name == "low") lowColumn = i;
+                    else if (name == "close") closeColumn = i;
+                    else if (name == "volume") volumeColumn = i;
+                }
+                if (openColumn == MISSING || highColumn == MISSING || lowColumn == MISSING || closeColumn == MISSING) {
+                    throw std::runtime_error("Bar file needs open, high, low and close columns: " + path);
+                }
+                fieldCount = std::max({openColumn, highColumn, lowColumn, closeColumn, volumeColumn == MISSING ? 0 : volumeColumn}) + 1;
+                haveHeader = true;
+            }
+
+            // Plain decimals are converted digit by digit when a tick is a power
+            // of ten, which is exact; anything else goes through a double.
+            bool decimalPrice(std::string_view field, Price& ticks) const {
+                if (decimals < 0) return false;
+                const char* p = field.data();
+                const char* end = p + field.size();
+                std::uint64_t value = 0;
+                const char* integer = p;
+                for (; p != end && static_cast<unsigned>(*p - '0') <= 9; ++p) value = value * 10 + static_cast<unsigned>(*p - '0');
+                if (p == integer || p - integer > 10) return false;
+                int scale = decimals;
+                if (p != end && *p == '.') {
+                    for (++p; p != end && scale > 0 && static_cast<unsigned>(*p - '0') <= 9; ++p, --scale) value = value * 10 + static_cast<unsigned>(*p - '0');
+                    const bool roundUp = p != end && *p >= '5' && *p <= '9';
+                    while (p != end && static_cast<unsigned>(*p - '0') <= 9) ++p;
+                    if (p != end) return false;
+                    for (; scale > 0; --scale) value *= 10;
+                    value += roundUp;
+                } else if (p != end) {
+                    return false;
+                } else {
+                    for (; scale > 0; --scale) value *= 10;
+                }
+                if (value > std::numeric_limits<Price>::max()) return false;
+                ticks = static_cast<Price>(value);
+                return true;
+            }
+
+            Price price(std::string_view field, std::size_t line) const {
+                Price ticks = 0;
+                if (decimalPrice(field, ticks)) return ticks;
+                double value = 0;
+                const auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), value);
+                if (error != std::errc{} || end != field.data() + field.size()) fail("Bad price", field, line);
+                const double rounded = std::nearbyint(value * ticksPerUnit);
+                if (!(rounded >= 0 && rounded <= std::numeric_limits<Price>::max())) fail("Price out of range", field, line);
+                return static_cast<Price>(rounded);
+            }
+
+            std::uint64_t volume(std::string_view field, std::size_t line) const {
+                if (field.empty()) return 0;
+                const char* last = field.data() + field.size();
+                std::uint64_t shares = 0;
+                const auto integer = std::from_chars(field.data(), last, shares);
+                if (integer.ec == std::errc{} && integer.ptr == last) return shares;
+                // Some exports write volume as a float, e.g. 1.5e6
+                double value = 0;
+                const auto real = std::from_chars(field.data(), last, value);
+                if (real.ec != std::errc{} || real.ptr != last || !(value >= 0 && value < 1.8e19)) fail("Bad volume", field, line);
+                return static_cast<std::uint64_t>(std::nearbyint(value));
+            }
+
+        public:
+            BarParser(const str& path, double ticksPerUnit, BarColumns& bars) : path(path), ticksPerUnit(ticksPerUnit), bars(bars) {
+                double power = 1;
+                for (int i = 0; i <= 9 && decimals < 0; ++i, power *= 10) {
+                    if (ticksPerUnit == power) decimals = i;
+                }
+            }
+
+            bool sawHeader() const { return haveHeader; }
+
+            void row(const std::vector<std::string_view>& fields, std::size_t line) {
+                if (fields.size() == 1 && trim(fields[0]).empty()) return;
+                if (!haveHeader) {
+                    readHeader(fields);
+                    return;
+                }
+                std::int64_t timestamp = 0;
+                if (!parseTimestamp(trim(fields[0]), timestamp)) return;
+                if (fields.size() < fieldCount) {
+                    throw std::runtime_error("Line " + std::to_string(line) + " of " + path + " has " + std::to_string(fields.size()) +
+                                             " fields, expected " + std::to_string(fieldCount));
+                }
+                const std::string_view open = trim(fields[openColumn]), high = trim(fields[highColumn]);
+                const std::string_view low = trim(fields[lowColumn]), close = trim(fields[closeColumn]);
+                if (open.empty() || high.empty() || low.empty() || close.empty()) return;
+                if (!bars.timestamp.empty() && timestamp < bars.timestamp.back()) fail("Bars go back in time at", fields[0], line);
+
+                bars.timestamp.push_back(timestamp);
+                bars.open.push_back(price(open, line));
+                bars.high.push_back(price(high, line));
+                bars.low.push_back(price(low, line));
+                bars.close.push_back(price(close, line));
+                bars.volume.push_back(volumeColumn == MISSING ? 0 : volume(trim(fields[volumeColumn]), line));
+            }
+    };
+}
+
+void scanSeparators(const char* data, std::size_t size, std::vector<std::uint32_t>& offsets) {
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    for (; i + 32 <= size; i += 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, comma), _mm256_cmpeq_epi8(block, newline))));
+        while (mask) {
+            offsets.push_back(static_cast<std::uint32_t>(i + __builtin_ctz(mask)));
+            mask &= mask - 1;
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; i + 16 <= size; i += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        std::uint32_t mask = static_cast<std::uint32_t>(_mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(block, comma), _mm_cmpeq_epi8(block, newline))));
+        while (mask) {
+            offsets.push_back(static_cast<std::uint32_t>(i + __builtin_ctz(mask)));
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i < size; ++i) {
+        if (data[i] == ',' || data[i] == '\n') offsets.push_back(static_cast<std::uint32_t>(i));
+    }
+}
+
+bool parseTimestamp(std::string_view text, std::int64_t& msSinceEpoch) {
+    const char* p = text.data();
+    const char* end = p + text.size();
+    int year = 0, month = 0, day = 0;
+    if (!digits(p, end, 4, year) || !expect(p, end, '-') || !digits(p, end, 2, month) || !expect(p, end, '-') || !digits(p, end, 2, day)) {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month)) return false;
+    std::int64_t ms = daysFromCivil(year, month, day) * DAY_MS;
+
+    if (p != end) {
+        if (*p != ' ' && *p != 'T') return false;
+        ++p;
+        int hour = 0, minute = 0, second = 0, millis = 0;
+        if (!digits(p, end, 2, hour) || !expect(p, end, ':') || !digits(p, end, 2, minute)) return false;
+        if (p != end && *p == ':') {
+            ++p;
+            if (!digits(p, end, 2, second)) return false;
+            if (p != end && *p == '.') {
+                ++p;
+                const char* fraction = p;
+                for (int scale = 100; p != end && static_cast<unsigned>(*p - '0') <= 9; ++p) {
+                    millis += (*p - '0') * scale;
+                    scale /= 10;
+                }
+                if (p == fraction) return false;
+            }
+        }
+        if (hour > 23 || minute > 59 || second > 59) return false;
+        ms += ((hour * 60 + minute) * 60 + second) * 1000 + millis;
+
+        if (p != end) {
+            if (*p == 'Z') {
+                ++p;
+            } else if (*p == '+' || *p == '-') {
+                const int sign = *p++ == '+' ? 1 : -1;
+                int offsetHours = 0, offsetMinutes = 0;
+                if (!digits(p, end, 2, offsetHours)) return false;
+                if (p != end && *p == ':') ++p;
+                if (!digits(p, end, 2, offsetMinutes) || offsetHours > 23 || offsetMinutes > 59) return false;
+                ms -= sign * static_cast<std::int64_t>(offsetHours * 60 + offsetMinutes) * 60'000;
+            }
+            if (p != end) return false;
+        }
+    }
+    msSinceEpoch = ms;
+    return true;
+}
+
+BarColumns loadBarCsv(const str& path, double ticksPerUnit) {
+    if (!(ticksPerUnit > 0)) throw std::invalid_argument("Ticks per unit must be positive.");
+    MappedFile file(path);
+    const char* data = file.data;
+    const std::size_t size = file.size;
+
+    BarColumns bars;
+    BarParser parser(path, ticksPerUnit, bars);
+    std::vector<std::uint32_t> separators;
+    std::vector<std::string_view> fields;
+    std::size_t rowStart = 0, line = 0, chunk = CHUNK_BYTES;
+
+    // Pass one finds the separators of a chunk, pass two walks them row by
+    // row. A row cut off by the end of the chunk is rescanned with the next.
+    while (rowStart < size) {
+        const std::size_t base = rowStart;
+        const std::size_t chunkEnd = std::min(size, base + chunk);
+        separators.clear();
+        scanSeparators(data + base, chunkEnd - base, separators);
+        if (bars.timestamp.capacity() == 0 && chunkEnd < size) {
+            // Reserve from the row density of the first chunk
+            const std::size_t rows = std::count_if(separators.begin(), separators.end(), [&](std::uint32_t at) { return data[base + at] == '\n'; });
+            const std::size_t estimate = rows * (size / (chunkEnd - base) + 1);
+            for (auto* column : {&bars.open, &bars.high, &bars.low, &bars.close}) column->reserve(estimate);
+            bars.timestamp.reserve(estimate);
+            bars.volume.reserve(estimate);
+        }
+
+        std::size_t fieldStart = base;
+        fields.clear();
+        for (std::uint32_t offset : separators) {
+            const std::size_t at = base + offset;
+            fields.emplace_back(data + fieldStart, at - fieldStart);
+            fieldStart = at + 1;
+            if (data[at] == '\n') {
+                parser.row(fields, ++line);
+                fields.clear();
+                rowStart = fieldStart;
+            }
+        }
+        if (chunkEnd == size) {
+            if (rowStart < size) {
+                fields.emplace_back(data + fieldStart, size - fieldStart);
+                parser.row(fields, ++line);
+                rowStart = size;
+            }
+        } else if (rowStart == base) {
+            if (chunk > std::numeric_limits<std::uint32_t>::max() / 2) throw std::runtime_error("Line too long in " + path);
+            chunk *= 2;
+        }
+    }
+    if (!parser.sawHeader()) throw std::runtime_error("Bar file has no header: " + path);
+    return bars;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "order.h"
+#include "types.h"
+
+// One OHLCV bar per index, prices in integer ticks.
+struct BarColumns {
+    std::vector<std::int64_t> timestamp;    // ms since the epoch, UTC
+    std::vector<Price> open;
+    std::vector<Price> high;
+    std::vector<Price> low;
+    std::vector<Price> close;
+    std::vector<std::uint64_t> volume;
+
+    std::size_t size() const { return timestamp.size(); }
+};
+
+// Loads a bar CSV: timestamp first, then named columns of which open, high,
+// low and close are required, volume is optional and the rest (adj close,
+// ...) are ignored. Header names are case-insensitive, and rows whose first
+// field is not a date, such as the ticker and date rows yfinance writes under
+// the header, are skipped, as are rows with an empty price. Prices are
+// rounded to ticks of 1 / `ticksPerUnit`. Timestamps are ISO 8601 dates or
+// date-times, UTC unless they carry an offset, and must not go backwards.
+// Quoted fields are not supported. The file is memory-mapped and split on a
+// SIMD scan for separators. Throws std::runtime_error on unreadable files,
+// missing columns and malformed numbers.
+BarColumns loadBarCsv(const str& path, double ticksPerUnit = 100.0);
+
+// Appends the offset of every ',' and '\n' in [data, data + size).
+void scanSeparators(const char* data, std::size_t size, std::vector<std::uint32_t>& offsets);
+
+// YYYY-MM-DD, optionally followed by ' ' or 'T', HH:MM[:SS[.fraction]] and
+// 'Z' or a ±HH[:]MM offset. Returns false if `text` is not such a timestamp.
+bool parseTimestamp(std::string_view text, std::int64_t& msSinceEpoch);
@@ -1,6 +1,8 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/functional.h>
 #include <pybind11/chrono.h>
+#include <pybind11/stl.h>
+#include <pybind11/numpy.h>
 
 #include "eventDispatcher.h"
 #include "events.h"
@@ -9,9 +11,136 @@
 #include "limitOrder.h"
 #include "marketOrder.h"
 #include "matchingEngine.h"
+#include "engineConfig.h"
+#include "fillRecorder.h"
+#include "ledger.h"
+#include "indicators.h"
+#include "shmServer.h"
+#include "shmClient.h"
+#include "strategyHost.h"
+#include "l2Replay.h"
+#include "tradeTape.h"
+#include "performanceAnalytics.h"
+#include "itchReplay.h"
+#include "barLoader.h"
 
 namespace py = pybind11;
 
+// Wraps a column as a NumPy array that shares its buffer; `owner` keeps the
+// storage alive for as long as any array built on it exists.
+template<typename T>
+py::array_t<T> columnView(std::vector<T>& column, const py::capsule& owner) {
+    return py::array_t<T>({column.size()}, {sizeof(T)}, column.data(), owner);
+}
+
+// Tape query results as one NumPy array per field.
+py::dict tapeColumns(const std::vector<TapeTrade>& trades) {
+    auto column = [&trades](auto field) {
+        using T = std::decay_t<decltype(field(trades.front()))>;
+        py::array_t<T> array(trades.size());
+        T* out = array.mutable_data();
+        for (const TapeTrade& trade : trades) *out++ = field(trade);
+        return array;
+    };
+    py::dict result;
+    if (trades.empty()) {
+        for (const char* name : {"sequence", "timestamp", "symbol", "price", "quantity", "aggressing_order_id", "aggressing_trader_id",
+                                 "aggressing_side", "aggressing_remaining", "resting_order_id", "resting_trader_id", "resting_remaining"}) {
+            result[name] = py::array_t<std::int64_t>(0);
+        }
+        return result;
+    }
+    result["sequence"] = column([](const TapeTrade& t) { return t.sequence; });
+    result["timestamp"] = column([](const TapeTrade& t) { return t.timestamp; });
+    result["symbol"] = column([](const TapeTrade& t) { return t.symbol; });
+    result["price"] = column([](const TapeTrade& t) { return t.price; });
+    result["quantity"] = column([](const TapeTrade& t) { return t.quantity; });
+    result["aggressing_order_id"] = column([](const TapeTrade& t) { return t.aggressingOrderID; });
+    result["aggressing_trader_id"] = column([](const TapeTrade& t) { return t.aggressingTraderID; });
+    result["aggressing_side"] = column([](const TapeTrade& t) { return static_cast<std::int8_t>(t.aggressingSide == Side::BUY ? 1 : -1); });
+    result["aggressing_remaining"] = column([](const TapeTrade& t) { return t.aggressingRemainingQuantity; });
+    result["resting_order_id"] = column([](const TapeTrade& t) { return t.restingOrderID; });
+    result["resting_trader_id"] = column([](const TapeTrade& t) { return t.restingTraderID; });
+    result["resting_remaining"] = column([](const TapeTrade& t) { return t.restingRemainingQuantity; });
+    return result;
+}
+
+using DoubleArray = py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+// Runs a batch indicator kernel over a 1-d array into a freshly allocated result.
+template<typename Kernel>
+py::array_t<double> batchIndicator(const DoubleArray& input, std::size_t period, Kernel kernel) {
+    if (input.ndim() != 1) throw std::invalid_argument("Expected a one-dimensional array.");
+    py::array_t<double> output(input.size());
+    const double* in = input.data();
+    double* out = output.mutable_data();
+    const std::size_t n = static_cast<std::size_t>(input.size());
+    {
+        py::gil_scoped_release release;
+        kernel(in, n, period, out);
+    }
+    return output;
+}
+
+// Every matching policy is exposed under its own class with the same interface.
+template<typename Engine>
+void bindMatchingEngine(py::module_& m, const char* name) {
+    py::class_<Engine>(m, name)
+        .def(py::init<OrderBook&, EventDispatcher&>())
+        .def(py::init<OrderBook&, EventDispatcher&, const EngineConfig&>(), py::arg("order_book"), py::arg("dispatcher"), py::arg("config"))
+        .def("submit_order", &Engine::submitOrder, py::arg("order"))
+        .def("cancel_order", &Engine::cancelOrder, py::arg("order_id"))
+        .def("mass_cancel", py::overload_cast<TraderID>(&Engine::massCancel), py::arg("trader_id"))
+        .def("mass_cancel", py::overload_cast<TraderID, Side>(&Engine::massCancel), py::arg("trader_id"), py::arg("side"))
+        .def("mass_cancel_symbol", &Engine::massCancelSymbol, py::arg("symbol"))
+        .def("mass_cancel_all", &Engine::massCancelAll)
+        .def("begin_auction", &Engine::beginAuction)
+        .def("uncross", &Engine::uncross)
+        .def("set_time", &Engine::setTime, py::arg("now"))
+        .def("run_pending", &Engine::runPending)
+        .def("set_risk_limits", &Engine::setRiskLimits, py::arg("trader_id"), py::arg("limits"))
+        .def("start", &Engine::start, py::call_guard<py::gil_scoped_release>())
+        .def("stop", &Engine::stop);
+}
+
+// One backtest's columns, converted once and kept alive while the analytics
+// run without the GIL. `fills` is a dict like FillRecorder.take_fills() returns.
+struct PerformanceArrays {
+    py::array_t<std::int64_t, py::array::c_style | py::array::forcecast> timestamp;
+    DoubleArray equity;
+    DoubleArray price;
+    DoubleArray quantity;
+    py::array_t<std::int8_t, py::array::c_style | py::array::forcecast> side;
+    py::array_t<std::uint32_t, py::array::c_style | py::array::forcecast> symbol;
+    PerformanceInput input;
+
+    PerformanceArrays(const py::handle& timestamps, const py::handle& values, const py::object& fills)
+        : timestamp(py::cast<decltype(timestamp)>(timestamps)), equity(py::cast<DoubleArray>(values)) {
+        if (timestamp.ndim() != 1 || equity.ndim() != 1 || timestamp.size() != equity.size())
+            throw std::invalid_argument("Timestamps and equity must be one-dimensional and the same length.");
+        input.timestamp = timestamp.data();
+        input.equity = equity.data();
+        input.points = static_cast<std::size_t>(equity.size());
+        if (fills.is_none()) return;
+
+        py::dict columns = fills.cast<py::dict>();
+        price = py::cast<DoubleArray>(columns["price"]);
+        quantity = py::cast<DoubleArray>(columns["quantity"]);
+        side = py::cast<decltype(side)>(columns["side"]);
+        if (price.size() != quantity.size() || price.size() != side.size())
+            throw std::invalid_argument("Fill columns must be the same length.");
+        input.fillPrice = price.data();
+        input.fillQuantity = quantity.data();
+        input.fillSide = side.data();
+        input.fills = static_cast<std::size_t>(price.size());
+        if (columns.contains("symbol")) {
+            symbol = py::cast<decltype(symbol)>(columns["symbol"]);
+            if (symbol.size() != price.size()) throw std::invalid_argument("Fill columns must be the same length.");
+            input.fillSymbol = symbol.data();
+        }
+    }
+};
+
 PYBIND11_MODULE(trading_core, m) {
     m.doc() = "Python bindings for the C++ trading core";
 
@@ -25,7 +154,14 @@ PYBIND11_MODULE(trading_core, m) {
         .value("MARKET", OrderType::MARKET)
         .export_values();
     
-    py::class_<Order, py::smart_holder>(m, "Order");
+    py::enum_<TimeInForce>(m, "TimeInForce")
+        .value("GTC", TimeInForce::GTC)
+        .value("DAY", TimeInForce::DAY)
+        .value("GTD", TimeInForce::GTD);
+
+    py::class_<Order, py::smart_holder>(m, "Order")
+        .def_property("time_in_force", &Order::getTimeInForce, &Order::setTimeInForce)
+        .def_property("expire_time", &Order::getExpireTime, &Order::setExpireTime);
 
     py::class_<LimitOrder, Order, py::smart_holder>(m, "LimitOrder")
         .def(py::init<const std::string&, OrderID, OrderType, Side, std::string, Quantity, TraderID>())
@@ -37,12 +173,40 @@ PYBIND11_MODULE(trading_core, m) {
         .def(py::init<const std::string&, OrderID, OrderType, Side, Quantity, TraderID>())
         .def("get_quantity", &MarketOrder::getQuantity);
     
-    py::class_<MatchingEngine>(m, "MatchingEngine")
-        .def(py::init<OrderBook&, EventDispatcher&>())
-        .def("submit_order", &MatchingEngine::submitOrder, py::arg("order"))
-        .def("cancel_order", &MatchingEngine::cancelOrder, py::arg("order_id"))
-        .def("start", &MatchingEngine::start, py::call_guard<py::gil_scoped_release>())
-        .def("stop", &MatchingEngine::stop);
+    py::enum_<WaitStrategy>(m, "WaitStrategy")
+        .value("BLOCKING", WaitStrategy::BLOCKING)
+        .value("BUSY_POLL", WaitStrategy::BUSY_POLL);
+
+    py::enum_<SelfTradePrevention>(m, "SelfTradePrevention")
+        .value("NONE", SelfTradePrevention::NONE)
+        .value("CANCEL_RESTING", SelfTradePrevention::CANCEL_RESTING)
+        .value("CANCEL_AGGRESSOR", SelfTradePrevention::CANCEL_AGGRESSOR)
+        .value("DECREMENT_BOTH", SelfTradePrevention::DECREMENT_BOTH);
+
+    py::class_<RiskLimits>(m, "RiskLimits")
+        .def(py::init<>())
+        .def_readwrite("max_order_quantity", &RiskLimits::maxOrderQuantity)
+        .def_readwrite("max_position", &RiskLimits::maxPosition)
+        .def_readwrite("max_open_orders", &RiskLimits::maxOpenOrders)
+        .def_readwrite("price_band_ticks", &RiskLimits::priceBandTicks);
+
+    py::class_<EngineConfig>(m, "EngineConfig")
+        .def(py::init<>())
+        .def_readwrite("matching_core", &EngineConfig::matchingCore)
+        .def_readwrite("realtime_priority", &EngineConfig::realtimePriority)
+        .def_readwrite("wait_strategy", &EngineConfig::waitStrategy)
+        .def_readwrite("expected_orders", &EngineConfig::expectedOrders)
+        .def_readwrite("bind_memory", &EngineConfig::bindMemory)
+        .def_readwrite("prefault_bytes", &EngineConfig::prefaultBytes)
+        .def_readwrite("lock_memory", &EngineConfig::lockMemory)
+        .def_readwrite("self_trade_prevention", &EngineConfig::selfTradePrevention)
+        .def_readwrite("default_risk_limits", &EngineConfig::defaultRiskLimits)
+        .def_readwrite("max_traders", &EngineConfig::maxTraders)
+        .def_readwrite("session_close", &EngineConfig::sessionClose);
+
+    bindMatchingEngine<MatchingEngine>(m, "MatchingEngine");
+    bindMatchingEngine<ProRataMatchingEngine>(m, "ProRataMatchingEngine");
+    bindMatchingEngine<TopOrderMatchingEngine>(m, "TopOrderMatchingEngine");
 
     py::class_<TradeExecutedEvent>(m, "TradeExecutedEvent")
         .def(py::init<>())
@@ -71,6 +235,8 @@ PYBIND11_MODULE(trading_core, m) {
         .def_readwrite("order_id", &OrderAcceptedEvent::orderID)
         .def_readwrite("price", &OrderAcceptedEvent::price)
         .def_readwrite("quantity", &OrderAcceptedEvent::quantity)
+        .def_readwrite("symbol", &OrderAcceptedEvent::symbol)
+        .def_readwrite("side", &OrderAcceptedEvent::side)
         .def("__repr__",
             [](const OrderAcceptedEvent &e) {
                 return "<OrderAcceptedEvent: orderID=" + std::to_string(e.orderID) +
@@ -83,12 +249,46 @@ PYBIND11_MODULE(trading_core, m) {
         .def(py::init<>())
         .def_readwrite("order_id", &OrderCancelledEvent::orderID)
         .def_readwrite("quantity", &OrderCancelledEvent::quantity)
+        .def_readwrite("remaining", &OrderCancelledEvent::remaining)
         .def("__repr__",
             [](const OrderCancelledEvent &e) {
                 return "<OrderCancelledEvent: orderID=" + std::to_string(e.orderID) +
-                       ", quantity=" + std::to_string(e.quantity) + ">";
+                       ", quantity=" + std::to_string(e.quantity) + ", remaining=" + std::to_string(e.remaining) + ">";
+            }
+        );
+    py::class_<MassCancelEvent>(m, "MassCancelEvent")
+        .def(py::init<>())
+        .def_readwrite("cancelled", &MassCancelEvent::cancelled)
+        .def("__repr__",
+            [](const MassCancelEvent &e) {
+                return "<MassCancelEvent: cancelled=" + std::to_string(e.cancelled.size()) + " orders>";
+            }
+        );
+
+    py::enum_<RejectReason>(m, "RejectReason")
+        .value("ORDER_SIZE", RejectReason::ORDER_SIZE)
+        .value("POSITION_LIMIT", RejectReason::POSITION_LIMIT)
+        .value("OPEN_ORDER_LIMIT", RejectReason::OPEN_ORDER_LIMIT)
+        .value("PRICE_BAND", RejectReason::PRICE_BAND)
+        .value("UNKNOWN_TRADER", RejectReason::UNKNOWN_TRADER);
+
+    py::class_<OrderRejectedEvent>(m, "OrderRejectedEvent")
+        .def(py::init<>())
+        .def_readwrite("order_id", &OrderRejectedEvent::orderID)
+        .def_readwrite("trader_id", &OrderRejectedEvent::traderID)
+        .def_readwrite("reason", &OrderRejectedEvent::reason)
+        .def("__repr__",
+            [](const OrderRejectedEvent &e) {
+                return "<OrderRejectedEvent: orderID=" + std::to_string(e.orderID) +
+                       ", traderID=" + std::to_string(e.traderID) + ">";
             }
         );
+    py::class_<AuctionUncrossEvent>(m, "AuctionUncrossEvent")
+        .def(py::init<>())
+        .def_readwrite("price", &AuctionUncrossEvent::price)
+        .def_readwrite("volume", &AuctionUncrossEvent::volume)
+        .def_readwrite("imbalance", &AuctionUncrossEvent::imbalance);
+
     py::class_<MarketDataEvent>(m, "MarketDataEvent")
         .def(py::init<>())
         .def_readwrite("symbol", &MarketDataEvent::symbol)
@@ -103,9 +303,435 @@ PYBIND11_MODULE(trading_core, m) {
         .def("publish_order_accepted", &EventDispatcher::publish<OrderAcceptedEvent>)
         .def("subscribe_order_cancelled", &EventDispatcher::subscribe<OrderCancelledEvent>)
         .def("publish_order_cancelled", &EventDispatcher::publish<OrderCancelledEvent>)      
+        .def("subscribe_mass_cancel", &EventDispatcher::subscribe<MassCancelEvent>)
+        .def("publish_mass_cancel", &EventDispatcher::publish<MassCancelEvent>)
+        .def("subscribe_order_rejected", &EventDispatcher::subscribe<OrderRejectedEvent>)
+        .def("publish_order_rejected", &EventDispatcher::publish<OrderRejectedEvent>)
+        .def("subscribe_auction_uncross", &EventDispatcher::subscribe<AuctionUncrossEvent>)
+        .def("publish_auction_uncross", &EventDispatcher::publish<AuctionUncrossEvent>)
         .def("subscribe_market_data", &EventDispatcher::subscribe<MarketDataEvent>)
-        .def("publish_market_data", &EventDispatcher::publish<MarketDataEvent>);
+        .def("publish_market_data", &EventDispatcher::publish<MarketDataEvent>)
+        // Waits for callbacks running on the matching thread, which need the GIL
+        .def("unsubscribe", &EventDispatcher::unsubscribe, py::call_guard<py::gil_scoped_release>());
         
+    py::class_<FillRecorder, py::smart_holder>(m, "FillRecorder")
+        .def(py::init<std::optional<TraderID>, std::size_t>(), py::arg("trader_id") = py::none(), py::arg("capacity") = 1 << 16)
+        .def("attach", [](std::shared_ptr<FillRecorder> self, EventDispatcher& dispatcher) {
+            // The subscription shares ownership so the recorder outlives Python references to it
+            dispatcher.subscribe<TradeExecutedEvent>([self](const TradeExecutedEvent& e) { self->onTrade(e); });
+        }, py::arg("dispatcher"))
+        .def("set_clock", &FillRecorder::setClock, py::arg("timestamp_ms"))
+        .def("record_equity", &FillRecorder::recordEquity, py::arg("timestamp_ms"), py::arg("value"))
+        .def("fill_count", &FillRecorder::fillCount)
+        .def_property_readonly("symbols", &FillRecorder::getSymbols)
+        .def("take_fills", [](FillRecorder& self) {
+            std::unique_ptr<FillColumns> batch;
+            {
+                py::gil_scoped_release release;
+                batch = self.takeFills();
+            }
+            FillColumns* columns = batch.release();
+            py::capsule owner(columns, [](void* p) { delete static_cast<FillColumns*>(p); });
+            py::dict result;
+            result["timestamp"] = columnView(columns->timestamp, owner);
+            result["symbol"] = columnView(columns->symbol, owner);
+            result["side"] = columnView(columns->side, owner);
+            result["price"] = columnView(columns->price, owner);
+            result["quantity"] = columnView(columns->quantity, owner);
+            result["order_id"] = columnView(columns->orderID, owner);
+            result["trader_id"] = columnView(columns->traderID, owner);
+            return result;
+        })
+        .def("take_equity", [](FillRecorder& self) {
+            std::unique_ptr<EquityColumns> batch;
+            {
+                py::gil_scoped_release release;
+                batch = self.takeEquity();
+            }
+            EquityColumns* columns = batch.release();
+            py::capsule owner(columns, [](void* p) { delete static_cast<EquityColumns*>(p); });
+            py::dict result;
+            result["timestamp"] = columnView(columns->timestamp, owner);
+            result["value"] = columnView(columns->value, owner);
+            return result;
+        });
+
+    py::class_<TradeTapeWriter, py::smart_holder>(m, "TradeTapeWriter")
+        .def(py::init<const str&, std::size_t>(), py::arg("path"), py::arg("block_trades") = 4096)
+        .def("attach", [](std::shared_ptr<TradeTapeWriter> self, EventDispatcher& dispatcher) {
+            dispatcher.subscribe<TradeExecutedEvent>([self](const TradeExecutedEvent& e) { self->onTrade(e); });
+        }, py::arg("dispatcher"))
+        .def("set_clock", &TradeTapeWriter::setClock, py::arg("timestamp_ms"))
+        .def("flush", &TradeTapeWriter::flush)
+        .def("close", &TradeTapeWriter::close)
+        .def("trade_count", &TradeTapeWriter::tradeCount);
+
+    py::class_<TradeTapeReader>(m, "TradeTapeReader")
+        .def(py::init<const str&>(), py::arg("path"))
+        .def("query", [](TradeTapeReader& self, std::optional<std::int64_t> from, std::optional<std::int64_t> to,
+                         std::optional<TraderID> traderID, std::optional<str> symbol) {
+            TapeQuery query;
+            if (from) query.from = *from;
+            if (to) query.to = *to;
+            query.traderID = traderID;
+            query.symbol = std::move(symbol);
+            std::vector<TapeTrade> trades;
+            {
+                py::gil_scoped_release release;
+                trades = self.query(query);
+            }
+            return tapeColumns(trades);
+        }, py::arg("from_ms") = py::none(), py::arg("to_ms") = py::none(), py::arg("trader_id") = py::none(), py::arg("symbol") = py::none())
+        .def("sequence_range", [](TradeTapeReader& self, std::uint64_t first, std::uint64_t last) {
+            std::vector<TapeTrade> trades;
+            {
+                py::gil_scoped_release release;
+                trades = self.sequenceRange(first, last);
+            }
+            return tapeColumns(trades);
+        }, py::arg("first"), py::arg("last"))
+        .def_property_readonly("symbols", &TradeTapeReader::symbols)
+        .def("trade_count", &TradeTapeReader::tradeCount)
+        .def("blocks_decoded", &TradeTapeReader::blocksDecoded);
+
+    py::class_<PositionSnapshot>(m, "PositionSnapshot")
+        .def_readonly("symbol", &PositionSnapshot::symbol)
+        .def_readonly("quantity", &PositionSnapshot::quantity)
+        .def_readonly("cost_basis", &PositionSnapshot::costBasis)
+        .def_readonly("market_value", &PositionSnapshot::marketValue)
+        .def_readonly("realized_pnl", &PositionSnapshot::realizedPnl)
+        .def_readonly("unrealized_pnl", &PositionSnapshot::unrealizedPnl);
+
+    py::class_<AccountSnapshot>(m, "AccountSnapshot")
+        .def_readonly("trader_id", &AccountSnapshot::traderID)
+        .def_readonly("cash", &AccountSnapshot::cash)
+        .def_readonly("market_value", &AccountSnapshot::marketValue)
+        .def_readonly("realized_pnl", &AccountSnapshot::realizedPnl)
+        .def_readonly("unrealized_pnl", &AccountSnapshot::unrealizedPnl)
+        .def_readonly("equity", &AccountSnapshot::equity)
+        .def_readonly("fill_count", &AccountSnapshot::fillCount);
+
+    py::class_<Ledger, py::smart_holder>(m, "Ledger")
+        .def(py::init<>())
+        .def("attach", [](std::shared_ptr<Ledger> self, EventDispatcher& dispatcher) {
+            dispatcher.subscribe<TradeExecutedEvent>([self](const TradeExecutedEvent& e) { self->onTrade(e); });
+            dispatcher.subscribe<MarketDataEvent>([self](const MarketDataEvent& e) { self->onMarketData(e); });
+        }, py::arg("dispatcher"))
+        .def("open_account", &Ledger::openAccount, py::arg("trader_id"), py::arg("cash"))
+        .def("account", &Ledger::getAccount, py::arg("trader_id"))
+        .def("position", &Ledger::getPosition, py::arg("trader_id"), py::arg("symbol"))
+        .def("positions", &Ledger::getPositions, py::arg("trader_id"))
+        .def("mark", &Ledger::getMark, py::arg("symbol"));
+
+    py::class_<SimpleMovingAverage>(m, "SimpleMovingAverage")
+        .def(py::init<std::size_t>(), py::arg("period"))
+        .def("update", &SimpleMovingAverage::update, py::arg("value"))
+        .def_property_readonly("value", &SimpleMovingAverage::value)
+        .def_property_readonly("ready", &SimpleMovingAverage::ready);
+
+    py::class_<ExponentialMovingAverage>(m, "ExponentialMovingAverage")
+        .def(py::init<std::size_t>(), py::arg("period"))
+        .def("update", &ExponentialMovingAverage::update, py::arg("value"))
+        .def_property_readonly("value", &ExponentialMovingAverage::value)
+        .def_property_readonly("ready", &ExponentialMovingAverage::ready);
+
+    py::class_<RollingStdDev>(m, "RollingStdDev")
+        .def(py::init<std::size_t>(), py::arg("period"))
+        .def("update", &RollingStdDev::update, py::arg("value"))
+        .def_property_readonly("value", &RollingStdDev::value)
+        .def_property_readonly("mean", &RollingStdDev::average)
+        .def_property_readonly("ready", &RollingStdDev::ready);
+
+    py::class_<RollingMin>(m, "RollingMin")
+        .def(py::init<std::size_t>(), py::arg("period"))
+        .def("update", &RollingMin::update, py::arg("value"))
+        .def_property_readonly("value", &RollingMin::value)
+        .def_property_readonly("ready", &RollingMin::ready);
+
+    py::class_<RollingMax>(m, "RollingMax")
+        .def(py::init<std::size_t>(), py::arg("period"))
+        .def("update", &RollingMax::update, py::arg("value"))
+        .def_property_readonly("value", &RollingMax::value)
+        .def_property_readonly("ready", &RollingMax::ready);
+
+    py::class_<RollingVWAP>(m, "RollingVWAP")
+        .def(py::init<std::size_t>(), py::arg("period"))
+        .def("update", &RollingVWAP::update, py::arg("price"), py::arg("quantity"))
+        .def_property_readonly("value", &RollingVWAP::value)
+        .def_property_readonly("ready", &RollingVWAP::ready);
+
+    m.def("sma", [](const DoubleArray& values, std::size_t period) {
+        return batchIndicator(values, period, indicators::sma);
+    }, py::arg("values"), py::arg("period"));
+    m.def("ema", [](const DoubleArray& values, std::size_t period) {
+        return batchIndicator(values, period, indicators::ema);
+    }, py::arg("values"), py::arg("period"));
+    m.def("rolling_std", [](const DoubleArray& values, std::size_t period) {
+        return batchIndicator(values, period, indicators::rollingStdDev);
+    }, py::arg("values"), py::arg("period"));
+    m.def("rolling_min", [](const DoubleArray& values, std::size_t period) {
+        return batchIndicator(values, period, indicators::rollingMin);
+    }, py::arg("values"), py::arg("period"));
+    m.def("rolling_max", [](const DoubleArray& values, std::size_t period) {
+        return batchIndicator(values, period, indicators::rollingMax);
+    }, py::arg("values"), py::arg("period"));
+    m.def("vwap", [](const DoubleArray& prices, const DoubleArray& volumes, std::size_t period) {
+        if (prices.size() != volumes.size()) throw std::invalid_argument("Prices and volumes must be the same length.");
+        const double* v = volumes.data();
+        return batchIndicator(prices, period, [v](const double* p, std::size_t n, std::size_t w, double* out) {
+            indicators::vwap(p, v, n, w, out);
+        });
+    }, py::arg("prices"), py::arg("volumes"), py::arg("period"));
+
+    // Columns of integer ticks and epoch milliseconds, viewing the loaded vectors
+    m.def("load_bars_csv", [](const str& path, double ticksPerUnit) {
+        auto bars = std::make_unique<BarColumns>();
+        {
+            py::gil_scoped_release release;
+            *bars = loadBarCsv(path, ticksPerUnit);
+        }
+        BarColumns* columns = bars.release();
+        py::capsule owner(columns, [](void* p) { delete static_cast<BarColumns*>(p); });
+        py::dict result;
+        result["timestamp"] = columnView(columns->timestamp, owner);
+        result["open"] = columnView(columns->open, owner);
+        result["high"] = columnView(columns->high, owner);
+        result["low"] = columnView(columns->low, owner);
+        result["close"] = columnView(columns->close, owner);
+        result["volume"] = columnView(columns->volume, owner);
+        return result;
+    }, py::arg("path"), py::arg("ticks_per_unit") = 100.0);
+
+    py::class_<PerformanceConfig>(m, "PerformanceConfig")
+        .def(py::init<>())
+        .def_readwrite("periods_per_year", &PerformanceConfig::periodsPerYear)
+        .def_readwrite("risk_free_rate", &PerformanceConfig::riskFreeRate)
+        .def_readwrite("bucket_ms", &PerformanceConfig::bucketMs)
+        .def_readwrite("rolling_window", &PerformanceConfig::rollingWindow)
+        .def_readwrite("price_scale", &PerformanceConfig::priceScale);
+
+    py::class_<PerformanceSummary>(m, "PerformanceSummary")
+        .def_readonly("periods", &PerformanceSummary::periods)
+        .def_readonly("start_value", &PerformanceSummary::startValue)
+        .def_readonly("end_value", &PerformanceSummary::endValue)
+        .def_readonly("total_return", &PerformanceSummary::totalReturn)
+        .def_readonly("annual_return", &PerformanceSummary::annualReturn)
+        .def_readonly("annual_volatility", &PerformanceSummary::annualVolatility)
+        .def_readonly("sharpe", &PerformanceSummary::sharpe)
+        .def_readonly("sortino", &PerformanceSummary::sortino)
+        .def_readonly("max_drawdown", &PerformanceSummary::maxDrawdown)
+        .def_readonly("max_drawdown_periods", &PerformanceSummary::maxDrawdownPeriods)
+        .def_readonly("calmar", &PerformanceSummary::calmar)
+        .def_readonly("fills", &PerformanceSummary::fills)
+        .def_readonly("closed_trades", &PerformanceSummary::closedTrades)
+        .def_readonly("winning_trades", &PerformanceSummary::winningTrades)
+        .def_readonly("win_rate", &PerformanceSummary::winRate)
+        .def_readonly("gross_profit", &PerformanceSummary::grossProfit)
+        .def_readonly("gross_loss", &PerformanceSummary::grossLoss)
+        .def_readonly("profit_factor", &PerformanceSummary::profitFactor)
+        .def_readonly("average_win", &PerformanceSummary::averageWin)
+        .def_readonly("average_loss", &PerformanceSummary::averageLoss)
+        .def_readonly("realized_pnl", &PerformanceSummary::realizedPnl)
+        .def_readonly("turnover", &PerformanceSummary::turnover);
+
+    m.def("analyze_performance", [](const py::handle& timestamp, const py::handle& equity, const py::object& fills, const PerformanceConfig& config) {
+        PerformanceArrays arrays(timestamp, equity, fills);
+        auto report = std::make_unique<PerformanceReport>();
+        {
+            py::gil_scoped_release release;
+            *report = analyzePerformance(arrays.input, config);
+        }
+        PerformanceReport* owned = report.release();
+        py::capsule owner(owned, [](void* p) { delete static_cast<PerformanceReport*>(p); });
+        PerformanceSeries& series = owned->series;
+        py::dict columns;
+        columns["timestamp"] = columnView(series.timestamp, owner);
+        columns["equity"] = columnView(series.equity, owner);
+        columns["returns"] = columnView(series.returns, owner);
+        columns["drawdown"] = columnView(series.drawdown, owner);
+        if (config.rollingWindow > 0) {
+            columns["rolling_sharpe"] = columnView(series.rollingSharpe, owner);
+            columns["rolling_volatility"] = columnView(series.rollingVolatility, owner);
+        }
+        return py::make_tuple(owned->summary, columns);
+    }, py::arg("timestamp"), py::arg("equity"), py::arg("fills") = py::none(), py::arg("config") = PerformanceConfig{});
+
+    // `results` is a list of (timestamp, equity) or (timestamp, equity, fills) tuples
+    m.def("analyze_performance_batch", [](const py::list& results, const PerformanceConfig& config, std::size_t threads) {
+        std::vector<PerformanceArrays> arrays;
+        arrays.reserve(results.size());
+        for (const py::handle& result : results) {
+            py::tuple columns = result.cast<py::tuple>();
+            arrays.emplace_back(columns[0], columns[1], columns.size() > 2 ? py::object(columns[2]) : py::object(py::none()));
+        }
+        std::vector<PerformanceInput> inputs;
+        for (const PerformanceArrays& a : arrays) inputs.push_back(a.input);
+
+        std::vector<PerformanceReport> reports;
+        {
+            py::gil_scoped_release release;
+            reports = analyzePerformanceBatch(inputs, config, threads);
+        }
+        std::vector<PerformanceSummary> summaries;
+        summaries.reserve(reports.size());
+        for (const PerformanceReport& report : reports) summaries.push_back(report.summary);
+        return summaries;
+    }, py::arg("results"), py::arg("config") = PerformanceConfig{}, py::arg("threads") = 0);
+
+    py::class_<BookAnalytics>(m, "BookAnalytics")
+        .def_readonly("bid_price", &BookAnalytics::bidPrice)
+        .def_readonly("bid_quantity", &BookAnalytics::bidQuantity)
+        .def_readonly("bid_orders", &BookAnalytics::bidOrders)
+        .def_readonly("ask_price", &BookAnalytics::askPrice)
+        .def_readonly("ask_quantity", &BookAnalytics::askQuantity)
+        .def_readonly("ask_orders", &BookAnalytics::askOrders)
+        .def_readonly("depth_ticks", &BookAnalytics::depthTicks)
+        .def_readonly("bid_depth", &BookAnalytics::bidDepth)
+        .def_readonly("ask_depth", &BookAnalytics::askDepth)
+        .def_readonly("version", &BookAnalytics::version)
+        .def("imbalance", &BookAnalytics::imbalance)
+        .def("depth_imbalance", &BookAnalytics::depthImbalance)
+        .def("microprice", &BookAnalytics::microprice);
+
     py::class_<OrderBook>(m, "OrderBook")
-        .def(py::init<>());
+        .def(py::init<>())
+        .def("get_analytics", &OrderBook::getAnalytics)
+        .def("set_analytics_depth", &OrderBook::setAnalyticsDepth, py::arg("ticks"));
+
+    py::class_<ItchStats>(m, "ItchStats")
+        .def_readonly("messages", &ItchStats::messages)
+        .def_readonly("applied", &ItchStats::applied)
+        .def_readonly("filtered", &ItchStats::filtered)
+        .def_readonly("unknown_orders", &ItchStats::unknownOrders);
+
+    py::class_<ItchReplay>(m, "ItchReplay")
+        .def(py::init<const str&>(), py::arg("path"))
+        .def("add_locate", &ItchReplay::addLocate, py::arg("locate"))
+        .def("add_symbol", &ItchReplay::addSymbol, py::arg("symbol"))
+        .def("publish_trades", &ItchReplay::publishTrades, py::arg("dispatcher"), py::arg("session_date_ms"), py::keep_alive<1, 2>())
+        .def("step", &ItchReplay::step, py::arg("max_messages") = std::numeric_limits<std::size_t>::max(),
+             py::call_guard<py::gil_scoped_release>())
+        .def("run_until", &ItchReplay::runUntil, py::arg("nanos_since_midnight"), py::call_guard<py::gil_scoped_release>())
+        .def("done", &ItchReplay::done)
+        .def("current_time", &ItchReplay::currentTime)
+        .def("stats", &ItchReplay::stats, py::return_value_policy::copy)
+        .def("book_count", &ItchReplay::bookCount)
+        .def("get_book", py::overload_cast<std::uint16_t>(&ItchReplay::getBook), py::arg("locate"), py::return_value_policy::reference_internal)
+        .def("get_book", py::overload_cast<const str&>(&ItchReplay::getBook), py::arg("symbol"), py::return_value_policy::reference_internal)
+        .def("get_symbol", &ItchReplay::getSymbol, py::arg("locate"));
+
+    py::enum_<RejectCode>(m, "RejectCode")
+        .value("ORDER_SIZE", RejectCode::ORDER_SIZE)
+        .value("POSITION_LIMIT", RejectCode::POSITION_LIMIT)
+        .value("OPEN_ORDER_LIMIT", RejectCode::OPEN_ORDER_LIMIT)
+        .value("PRICE_BAND", RejectCode::PRICE_BAND)
+        .value("UNKNOWN_TRADER", RejectCode::UNKNOWN_TRADER)
+        .value("THROTTLED", RejectCode::THROTTLED)
+        .value("NOT_LOGGED_IN", RejectCode::NOT_LOGGED_IN)
+        .value("UNKNOWN_TOKEN", RejectCode::UNKNOWN_TOKEN)
+        .value("DUPLICATE_TOKEN", RejectCode::DUPLICATE_TOKEN)
+        .value("INVALID_ORDER", RejectCode::INVALID_ORDER)
+        .value("TOO_LATE_TO_REPLACE", RejectCode::TOO_LATE_TO_REPLACE)
+        .value("REPLACE_PENDING", RejectCode::REPLACE_PENDING);
+
+    py::enum_<ShmReportType>(m, "ShmReportType")
+        .value("ACCEPTED", ShmReportType::ACCEPTED)
+        .value("EXECUTED", ShmReportType::EXECUTED)
+        .value("CANCELLED", ShmReportType::CANCELLED)
+        .value("REJECTED", ShmReportType::REJECTED);
+
+    py::class_<ShmReport>(m, "ShmReport")
+        .def_readonly("token", &ShmReport::token)
+        .def_readonly("order_id", &ShmReport::orderID)
+        .def_readonly("price", &ShmReport::price)
+        .def_readonly("quantity", &ShmReport::quantity)
+        .def_readonly("remaining", &ShmReport::remaining)
+        .def_readonly("type", &ShmReport::type)
+        .def_readonly("reason", &ShmReport::reason);
+
+    py::class_<TopOfBook>(m, "TopOfBook")
+        .def_readonly("bid_price", &TopOfBook::bidPrice)
+        .def_readonly("bid_quantity", &TopOfBook::bidQuantity)
+        .def_readonly("ask_price", &TopOfBook::askPrice)
+        .def_readonly("ask_quantity", &TopOfBook::askQuantity)
+        .def_readonly("last_price", &TopOfBook::lastPrice)
+        .def_readonly("version", &TopOfBook::version);
+
+    py::class_<ShmServerConfig>(m, "ShmServerConfig")
+        .def(py::init<>())
+        .def_readwrite("name", &ShmServerConfig::name)
+        .def_readwrite("busy_poll", &ShmServerConfig::busyPoll)
+        .def_readwrite("poll_core", &ShmServerConfig::pollCore);
+
+    py::class_<ShmServer>(m, "ShmServer")
+        .def(py::init<MatchingEngine&, EventDispatcher&, OrderBook&, const ShmServerConfig&>(),
+             py::arg("engine"), py::arg("dispatcher"), py::arg("book"), py::arg("config") = ShmServerConfig{},
+             py::keep_alive<1, 2>(), py::keep_alive<1, 3>(), py::keep_alive<1, 4>())
+        .def("start", &ShmServer::start)
+        .def("stop", &ShmServer::stop, py::call_guard<py::gil_scoped_release>());
+
+    py::class_<ShmClient>(m, "ShmClient")
+        .def(py::init<const str&, TraderID>(), py::arg("name"), py::arg("trader_id"))
+        .def("close", &ShmClient::close)
+        .def("is_connected", &ShmClient::isConnected)
+        .def("submit", &ShmClient::submit, py::arg("token"), py::arg("symbol"), py::arg("side"),
+             py::arg("order_type"), py::arg("price"), py::arg("quantity"))
+        .def("cancel", &ShmClient::cancel, py::arg("token"))
+        .def("poll", [](ShmClient& self) -> std::optional<ShmReport> {
+            ShmReport report;
+            if (self.poll(report)) return report;
+            return std::nullopt;
+        })
+        .def("top_of_book", &ShmClient::topOfBook);
+
+    py::class_<Bar>(m, "Bar")
+        .def(py::init([](const str& symbol, Timestamp timestamp, double open, double high, double low, double close, double volume) {
+            return Bar{symbol, timestamp, open, high, low, close, volume};
+        }), py::arg("symbol"), py::arg("timestamp"), py::arg("open"), py::arg("high"), py::arg("low"), py::arg("close"), py::arg("volume") = 0.0)
+        .def_readwrite("symbol", &Bar::symbol)
+        .def_readwrite("timestamp", &Bar::timestamp)
+        .def_readwrite("open", &Bar::open)
+        .def_readwrite("high", &Bar::high)
+        .def_readwrite("low", &Bar::low)
+        .def_readwrite("close", &Bar::close)
+        .def_readwrite("volume", &Bar::volume);
+
+    py::class_<StrategyHost>(m, "StrategyHost")
+        .def(py::init<MatchingEngine&, EventDispatcher&, OrderBook&, std::vector<str>>(),
+             py::arg("engine"), py::arg("dispatcher"), py::arg("book"), py::arg("search_paths") = std::vector<str>{},
+             py::keep_alive<1, 2>(), py::keep_alive<1, 3>(), py::keep_alive<1, 4>())
+        .def("load", &StrategyHost::load, py::arg("name"), py::arg("trader_id"), py::arg("params") = "")
+        .def("publish_bar", &StrategyHost::publishBar, py::arg("bar"), py::call_guard<py::gil_scoped_release>())
+        .def("stop", &StrategyHost::stop, py::call_guard<py::gil_scoped_release>())
+        .def("resolve", &StrategyHost::resolve, py::arg("name"))
+        .def("__len__", &StrategyHost::size);
+
+    py::class_<L2Level>(m, "L2Level")
+        .def_readonly("price", &L2Level::price)
+        .def_readonly("quantity", &L2Level::quantity);
+
+    py::class_<SimOrder>(m, "SimOrder")
+        .def_readonly("order_id", &SimOrder::orderID)
+        .def_readonly("side", &SimOrder::side)
+        .def_readonly("price", &SimOrder::price)
+        .def_readonly("quantity", &SimOrder::quantity)
+        .def_readonly("remaining", &SimOrder::remaining)
+        .def_readonly("queue_ahead", &SimOrder::queueAhead);
+
+    py::class_<L2Replay>(m, "L2Replay")
+        .def(py::init([](EventDispatcher& dispatcher, const str& symbol, TraderID traderID, const str& path) {
+            return std::make_unique<L2Replay>(dispatcher, symbol, traderID, loadL2Csv(path));
+        }), py::arg("dispatcher"), py::arg("symbol"), py::arg("trader_id"), py::arg("path"), py::keep_alive<1, 2>())
+        .def("step", &L2Replay::step)
+        .def("run_until", &L2Replay::runUntil, py::arg("timestamp"))
+        .def("run", &L2Replay::run)
+        .def("submit_limit", &L2Replay::submitLimit, py::arg("side"), py::arg("price"), py::arg("quantity"))
+        .def("submit_market", &L2Replay::submitMarket, py::arg("side"), py::arg("quantity"))
+        .def("cancel", &L2Replay::cancel, py::arg("order_id"))
+        .def("get_order", &L2Replay::getOrder, py::arg("order_id"))
+        .def("best_bid", [](const L2Replay& self) { return self.getBook().best(Side::BUY); })
+        .def("best_ask", [](const L2Replay& self) { return self.getBook().best(Side::SELL); })
+        .def_property_readonly("current_time", &L2Replay::currentTime)
+        .def_property_readonly("done", &L2Replay::done)
+        .def("__len__", &L2Replay::size);
     }
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include "types.h"
+
+// Signals derived from the book, kept current by OrderBook as orders are
+// added, filled and cancelled. Empty sides read as price and quantity 0.
+struct BookAnalytics {
+    Price bidPrice = 0;
+    Quantity bidQuantity = 0;
+    std::uint32_t bidOrders = 0;    // queue length at the best bid
+    Price askPrice = 0;
+    Quantity askQuantity = 0;
+    std::uint32_t askOrders = 0;
+    Price depthTicks = 0;
+    std::uint64_t bidDepth = 0;     // resting within depthTicks of the best bid, best level included
+    std::uint64_t askDepth = 0;
+    std::uint64_t version = 0;      // bumps on every change
+
+    // Top-of-book imbalance in [-1, 1]; positive when bids outweigh offers.
+    double imbalance() const {
+        const double total = static_cast<double>(bidQuantity) + askQuantity;
+        return total == 0 ? 0.0 : (static_cast<double>(bidQuantity) - askQuantity) / total;
+    }
+
+    double depthImbalance() const {
+        const double total = static_cast<double>(bidDepth) + askDepth;
+        return total == 0 ? 0.0 : (static_cast<double>(bidDepth) - askDepth) / total;
+    }
+
+    // Mid weighted by the opposite side's size, so it leans towards the thinner
+    // side. One-sided books return that side's price, empty books 0.
+    double microprice() const {
+        if (bidQuantity == 0 || askQuantity == 0) return bidQuantity ? bidPrice : askQuantity ? askPrice : 0.0;
+        return (static_cast<double>(bidPrice) * askQuantity + static_cast<double>(askPrice) * bidQuantity) /
+               (static_cast<double>(bidQuantity) + askQuantity);
+    }
+};
+
+// Single-writer seqlock: the thread mutating the book publishes, any number
+// of readers take consistent copies without locking. Fields are relaxed
+// atomics so concurrent reads are defined.
+class SharedBookAnalytics {
+    private:
+        std::atomic<std::uint64_t> sequence{0};
+        std::atomic<Price> bidPrice{0};
+        std::atomic<Quantity> bidQuantity{0};
+        std::atomic<std::uint32_t> bidOrders{0};
+        std::atomic<Price> askPrice{0};
+        std::atomic<Quantity> askQuantity{0};
+        std::atomic<std::uint32_t> askOrders{0};
+        std::atomic<Price> depthTicks{0};
+        std::atomic<std::uint64_t> bidDepth{0};
+        std::atomic<std::uint64_t> askDepth{0};
+
+    public:
+        void store(const BookAnalytics& analytics) {
+            const std::uint64_t start = sequence.load(std::memory_order_relaxed) + 1;
+            sequence.store(start, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            bidPrice.store(analytics.bidPrice, std::memory_order_relaxed);
+            bidQuantity.store(analytics.bidQuantity, std::memory_order_relaxed);
+            bidOrders.store(analytics.bidOrders, std::memory_order_relaxed);
+            askPrice.store(analytics.askPrice, std::memory_order_relaxed);
+            askQuantity.store(analytics.askQuantity, std::memory_order_relaxed);
+            askOrders.store(analytics.askOrders, std::memory_order_relaxed);
+            depthTicks.store(analytics.depthTicks, std::memory_order_relaxed);
+            bidDepth.store(analytics.bidDepth, std::memory_order_relaxed);
+            askDepth.store(analytics.askDepth, std::memory_order_relaxed);
+            sequence.store(start + 1, std::memory_order_release);
+        }
+
+        BookAnalytics load() const {
+            BookAnalytics analytics;
+            while (true) {
+                const std::uint64_t before = sequence.load(std::memory_order_acquire);
+                if (before & 1) continue;
+                analytics.bidPrice = bidPrice.load(std::memory_order_relaxed);
+                analytics.bidQuantity = bidQuantity.load(std::memory_order_relaxed);
+                analytics.bidOrders = bidOrders.load(std::memory_order_relaxed);
+                analytics.askPrice = askPrice.load(std::memory_order_relaxed);
+                analytics.askQuantity = askQuantity.load(std::memory_order_relaxed);
+                analytics.askOrders = askOrders.load(std::memory_order_relaxed);
+                analytics.depthTicks = depthTicks.load(std::memory_order_relaxed);
+                analytics.bidDepth = bidDepth.load(std::memory_order_relaxed);
+                analytics.askDepth = askDepth.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) == before) {
+                    analytics.version = before / 2;
+                    return analytics;
+                }
+            }
+        }
+};
@@ -0,0 +1,119 @@
+import csv
+import heapq
+from datetime import datetime
+from pathlib import Path
+
+
+class SymbolFeed:
+    """Streams one symbol's bars from a CSV file in timestamp order.
+
+    Rows are read `chunk_size` at a time and the file is reopened for each
+    chunk, so thousands of feeds hold neither thousands of descriptors nor
+    more than a chunk of rows each. The first column is the timestamp; rows
+    where it does not parse (e.g. the extra header rows yfinance writes) are
+    skipped. Other columns become float fields keyed by lower-cased name.
+    """
+
+    def __init__(self, symbol: str, path, chunk_size: int = 1024):
+        if chunk_size < 1:
+            raise ValueError("chunk_size must be positive")
+        self.symbol = symbol
+        self.path = Path(path)
+        self.chunk_size = chunk_size
+        self._columns = None
+        self._offset = 0
+        self._buffer = []
+        self._next = 0
+        self._exhausted = False
+        self._last_timestamp = None
+
+    def __iter__(self):
+        return self
+
+    def __next__(self):
+        while self._next == len(self._buffer):
+            if self._exhausted:
+                raise StopIteration
+            self._refill()
+        row = self._buffer[self._next]
+        self._next += 1
+        return row
+
+    def _refill(self):
+        with open(self.path, newline="") as f:
+            f.seek(self._offset)
+            if self._columns is None:
+                header = next(csv.reader([f.readline()]), [])
+                self._columns = [column.strip().lower() for column in header[1:]]
+            lines = []
+            while len(lines) < self.chunk_size:
+                line = f.readline()
+                if not line:
+                    self._exhausted = True
+                    break
+                lines.append(line)
+            self._offset = f.tell()
+
+        self._buffer = []
+        self._next = 0
+        for fields in csv.reader(lines):
+            if not fields:
+                continue
+            try:
+                timestamp = datetime.fromisoformat(fields[0].strip())
+            except ValueError:
+                continue
+            if self._last_timestamp is not None and timestamp < self._last_timestamp:
+                raise ValueError(f"{self.path}: bars are not in timestamp order at {fields[0]}")
+            self._last_timestamp = timestamp
+            bar = {column: float(value) for column, value in zip(self._columns, fields[1:]) if value}
+            self._buffer.append((timestamp, bar))
+
+
+class MergedDataHandler:
+    """Merges per-symbol feeds into one stream in global timestamp order.
+
+    A heap holds the next bar of every feed, so each bar costs O(log k) for k
+    feeds and only one chunk per feed is in memory. Bars with equal
+    timestamps come out in feed order.
+    """
+
+    def __init__(self, feeds):
+        self.feeds = list(feeds)
+
+    @classmethod
+    def from_directory(cls, directory, chunk_size: int = 1024):
+        """One feed per `<SYMBOL>.csv` file in `directory`."""
+        paths = sorted(Path(directory).glob("*.csv"))
+        return cls(SymbolFeed(path.stem, path, chunk_size) for path in paths)
+
+    def stream_bars(self):
+        """Yields (timestamp, symbol, bar) across all feeds."""
+        heap = []
+        for index, feed in enumerate(self.feeds):
+            first = next(feed, None)
+            if first is not None:
+                heap.append((first[0], index, first[1]))
+        heapq.heapify(heap)
+
+        while heap:
+            timestamp, index, bar = heap[0]
+            feed = self.feeds[index]
+            yield timestamp, feed.symbol, bar
+            following = next(feed, None)
+            if following is None:
+                heapq.heappop(heap)
+            else:
+                heapq.heapreplace(heap, (following[0], index, following[1]))
+
+    def stream_slices(self):
+        """Yields (timestamp, {symbol: bar}) with every bar sharing a timestamp."""
+        current, bars = None, {}
+        for timestamp, symbol, bar in self.stream_bars():
+            if bars and timestamp != current:
+                yield current, bars
+                bars = {}
+            current = timestamp
+            bars[symbol] = bar
+        if bars:
+            yield current, bars
@@ -1,4 +1,5 @@
 import pandas as pd
+import trading_core
 import yfinance as yf
 import os
 from pathlib import Path
@@ -19,20 +20,29 @@ if not data_file_path.is_file():
         print(f"An error occurred during download: {e}")
 
 class CSVDataHandler:
-    def __init__(self, csv_path, symbol) -> None:
+    """Loads one symbol's bars natively into NumPy columns.
+
+    `trading_core.load_bars_csv` parses the file straight into integer-tick
+    columns (the yfinance Ticker/Date rows are skipped), so `columns` can be
+    handed to the batch indicators or the engine without another copy.
+    """
+
+    PRICE_COLUMNS = ("open", "high", "low", "close")
+
+    def __init__(self, csv_path, symbol, ticks_per_unit=100) -> None:
         self.symbol = symbol
-        self._raw_data = pd.read_csv(
-            csv_path, 
-            header=0,
-            skiprows=[1, 2],
-            index_col=0,
-            parse_dates=True
-        )
-        self._raw_data.rename(columns=str.lower, inplace=True)
-        self._data_stream = self._raw_data.iterrows()
-        print(f"Data handler initialized for {self.symbol} with {len(self._raw_data)} bars.")
-    
-    def stream_bars(self):
-        """Generator function to yield each bar from the data."""
-        return self._data_stream
+        self.ticks_per_unit = ticks_per_unit
+        self.columns = trading_core.load_bars_csv(str(csv_path), ticks_per_unit)
+        print(f"Data handler initialized for {self.symbol} with {len(self)} bars.")
+
+    def __len__(self):
+        return len(self.columns["timestamp"])
 
+    def stream_bars(self):
+        """Yields (timestamp, bar) with bar prices back in dollars."""
+        prices = [(name, self.columns[name].tolist()) for name in self.PRICE_COLUMNS]
+        volumes = self.columns["volume"].tolist()
+        for i, timestamp in enumerate(self.columns["timestamp"].tolist()):
+            bar = {name: column[i] / self.ticks_per_unit for name, column in prices}
+            bar["volume"] = volumes[i]
+            yield pd.Timestamp(timestamp, unit="ms"), bar
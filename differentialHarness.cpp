@@ -0,0 +1,368 @@
+#include "differentialHarness.h"
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <sstream>
+
+namespace {
+    constexpr const char* FUZZ_SYMBOL = "FUZZ";
+    constexpr Price FUZZ_BASE_PRICE = 1000;
+
+    // Weighted so that most of a stream builds and trades through the book
+    constexpr FuzzOp OPS[32] = {
+        FuzzOp::LIMIT, FuzzOp::LIMIT, FuzzOp::LIMIT, FuzzOp::LIMIT, FuzzOp::LIMIT, FuzzOp::LIMIT, FuzzOp::LIMIT, FuzzOp::LIMIT,
+        FuzzOp::LIMIT, FuzzOp::LIMIT, FuzzOp::LIMIT, FuzzOp::LIMIT, FuzzOp::LIMIT, FuzzOp::LIMIT, FuzzOp::LIMIT, FuzzOp::LIMIT,
+        FuzzOp::MARKET, FuzzOp::MARKET, FuzzOp::MARKET, FuzzOp::MARKET,
+        FuzzOp::CANCEL, FuzzOp::CANCEL, FuzzOp::CANCEL, FuzzOp::CANCEL, FuzzOp::CANCEL,
+        FuzzOp::MASS_CANCEL_TRADER, FuzzOp::MASS_CANCEL_TRADER_SIDE, FuzzOp::MASS_CANCEL_ALL,
+        FuzzOp::BEGIN_AUCTION, FuzzOp::BEGIN_AUCTION, FuzzOp::UNCROSS, FuzzOp::UNCROSS
+    };
+
+    const char* sideName(Side side) { return side == Side::BUY ? "BUY" : "SELL"; }
+
+    // Every field but the timestamp; mass cancels sorted, as venues may walk
+    // their books in any order
+    str describe(const EngineEvent& event) {
+        std::ostringstream out;
+        std::visit([&out](const auto& e) {
+            using T = std::decay_t<decltype(e)>;
+            if constexpr (std::is_same_v<T, TradeExecutedEvent>) {
+                out << "Trade " << e.symbol << ' ' << e.quantity << '@' << e.price << " aggressor #" << e.aggressingOrderID
+                    << " (trader " << e.aggressingTraderID << ' ' << sideName(e.aggressingSide) << ", " << e.aggressingRemainingQuantity
+                    << " left) resting #" << e.restingOrderID << " (trader " << e.restingTraderID << ", " << e.restingRemainingQuantity << " left)";
+            }
+            else if constexpr (std::is_same_v<T, OrderAcceptedEvent>) {
+                out << "Accepted #" << e.orderID << ' ' << e.symbol << ' ' << sideName(e.side) << ' ' << e.quantity << '@' << e.price;
+            }
+            else if constexpr (std::is_same_v<T, OrderCancelledEvent>) {
+                out << "Cancelled #" << e.orderID << ' ' << e.quantity << " (" << e.remaining << " left)";
+            }
+            else if constexpr (std::is_same_v<T, OrderRejectedEvent>) {
+                out << "Rejected #" << e.orderID << " trader " << e.traderID << " reason " << static_cast<int>(e.reason);
+            }
+            else if constexpr (std::is_same_v<T, MassCancelEvent>) {
+                std::vector<OrderCancelledEvent> cancelled = e.cancelled;
+                std::sort(cancelled.begin(), cancelled.end(), [](const auto& a, const auto& b) { return a.orderID < b.orderID; });
+                out << "MassCancel [";
+                for (std::size_t i = 0; i < cancelled.size(); ++i) out << (i ? " " : "") << '#' << cancelled[i].orderID << ':' << cancelled[i].quantity;
+                out << ']';
+            }
+            else {
+                out << "Uncross " << e.volume << '@' << e.price << " imbalance " << e.imbalance;
+            }
+        }, event);
+        return out.str();
+    }
+
+    std::vector<str> describe(const std::vector<EngineEvent>& events) {
+        std::vector<str> lines;
+        lines.reserve(events.size());
+        for (const EngineEvent& event : events) lines.push_back(describe(event));
+        return lines;
+    }
+
+    str join(const std::vector<str>& lines) {
+        str joined;
+        for (const str& line : lines) joined += "\n    " + line;
+        return joined.empty() ? "\n    (nothing)" : joined;
+    }
+
+    str describe(const BookState& state) {
+        std::ostringstream out;
+        auto side = [&out](const char* name, const std::vector<LevelState>& levels) {
+            for (const LevelState& level : levels) {
+                out << "\n    " << name << ' ' << level.price << " x" << level.quantity << ':';
+                for (const RestingOrderState& order : level.orders) out << " #" << order.orderID << "(t" << order.traderID << ")=" << order.quantity;
+            }
+        };
+        side("bid", state.bids);
+        side("ask", state.asks);
+        str text = out.str();
+        return text.empty() ? "\n    (empty)" : text;
+    }
+
+    str describe(const FuzzCommand& command) {
+        std::ostringstream out;
+        switch (command.op) {
+            case FuzzOp::LIMIT:
+                out << "LIMIT " << sideName(command.side) << ' ' << command.quantity << '@' << command.price << " trader " << command.traderID;
+                break;
+            case FuzzOp::MARKET:
+                out << "MARKET " << sideName(command.side) << ' ' << command.quantity << " trader " << command.traderID;
+                break;
+            case FuzzOp::CANCEL:
+                out << "CANCEL submission " << command.target;
+                break;
+            case FuzzOp::MASS_CANCEL_TRADER:
+                out << "MASS_CANCEL trader " << command.traderID;
+                break;
+            case FuzzOp::MASS_CANCEL_TRADER_SIDE:
+                out << "MASS_CANCEL trader " << command.traderID << ' ' << sideName(command.side);
+                break;
+            case FuzzOp::MASS_CANCEL_ALL:
+                out << "MASS_CANCEL_ALL";
+                break;
+            case FuzzOp::BEGIN_AUCTION:
+                out << "BEGIN_AUCTION";
+                break;
+            case FuzzOp::UNCROSS:
+                out << "UNCROSS";
+                break;
+        }
+        return out.str();
+    }
+}
+
+std::vector<FuzzCommand> decodeFuzzCommands(const std::uint8_t* data, std::size_t size) {
+    std::vector<FuzzCommand> commands;
+    commands.reserve(size / FUZZ_RECORD_SIZE);
+    for (std::size_t offset = 0; offset + FUZZ_RECORD_SIZE <= size; offset += FUZZ_RECORD_SIZE) {
+        const std::uint8_t* record = data + offset;
+        FuzzCommand command;
+        command.op = OPS[record[0] % 32];
+        command.side = (record[1] & 1) ? Side::SELL : Side::BUY;
+        command.traderID = 1 + (record[1] >> 1) % 4;
+        command.price = FUZZ_BASE_PRICE + record[2] % 16;
+        command.quantity = 1 + record[3] % 64;
+        command.target = static_cast<std::uint16_t>(record[4] | (record[5] << 8));
+        commands.push_back(command);
+    }
+    return commands;
+}
+
+std::vector<FuzzCommand> randomFuzzCommands(std::uint64_t seed, std::size_t count) {
+    std::mt19937_64 rng(seed);
+    std::vector<std::uint8_t> bytes(count * FUZZ_RECORD_SIZE);
+    for (std::uint8_t& byte : bytes) byte = static_cast<std::uint8_t>(rng());
+    return decodeFuzzCommands(bytes.data(), bytes.size());
+}
+
+std::optional<std::size_t> NaiveVenue::best(Side side) const {
+    std::optional<std::size_t> found;
+    for (std::size_t i = 0; i < orders.size(); ++i) {
+        if (orders[i].side != side) continue;
+        // Strictly better only, so the earliest order wins a price tie
+        if (!found || (side == Side::BUY ? orders[i].price > orders[*found].price : orders[i].price < orders[*found].price)) found = i;
+    }
+    return found;
+}
+
+void NaiveVenue::submit(const FuzzCommand& command, OrderID orderID, std::vector<EngineEvent>& events) {
+    const bool isLimit = command.op != FuzzOp::MARKET;
+    Quantity remaining = command.quantity;
+    while (!auction && remaining > 0) {
+        std::optional<std::size_t> index = best(command.side == Side::BUY ? Side::SELL : Side::BUY);
+        if (!index) break;
+        Resting& resting = orders[*index];
+        if (isLimit && (command.side == Side::BUY ? command.price < resting.price : command.price > resting.price)) break;
+
+        const Quantity quantity = std::min(remaining, resting.quantity);
+        remaining -= quantity;
+        resting.quantity -= quantity;
+        events.emplace_back(TradeExecutedEvent{FUZZ_SYMBOL, resting.price, quantity, orderID, command.traderID, command.side, remaining,
+                                               resting.orderID, resting.traderID, resting.quantity});
+        if (resting.quantity == 0) orders.erase(orders.begin() + *index);
+    }
+
+    if (remaining == 0) return;
+    if (isLimit) {
+        events.emplace_back(OrderAcceptedEvent{orderID, command.price, remaining, FUZZ_SYMBOL, command.side});
+        orders.push_back({orderID, command.traderID, command.side, command.price, remaining});
+    }
+    else {
+        events.emplace_back(OrderCancelledEvent{orderID, remaining});
+    }
+}
+
+void NaiveVenue::cancel(OrderID orderID, std::vector<EngineEvent>& events) {
+    auto it = std::find_if(orders.begin(), orders.end(), [orderID](const Resting& order) { return order.orderID == orderID; });
+    if (it == orders.end()) return;
+    events.emplace_back(OrderCancelledEvent{orderID, it->quantity});
+    orders.erase(it);
+}
+
+void NaiveVenue::massCancel(const FuzzCommand& command, std::vector<EngineEvent>& events) {
+    auto matches = [&command](const Resting& order) {
+        if (command.op == FuzzOp::MASS_CANCEL_ALL) return true;
+        if (order.traderID != command.traderID) return false;
+        return command.op != FuzzOp::MASS_CANCEL_TRADER_SIDE || order.side == command.side;
+    };
+    MassCancelEvent event;
+    for (const Resting& order : orders) {
+        if (matches(order)) event.cancelled.push_back({order.orderID, order.quantity});
+    }
+    orders.erase(std::remove_if(orders.begin(), orders.end(), matches), orders.end());
+    events.emplace_back(std::move(event));
+}
+
+void NaiveVenue::beginAuction(std::vector<EngineEvent>&) {
+    auction = true;
+}
+
+void NaiveVenue::uncross(std::vector<EngineEvent>& events) {
+    auction = false;
+    AuctionUncrossEvent summary{0, 0, 0};
+    std::optional<std::size_t> bid = best(Side::BUY);
+    std::optional<std::size_t> ask = best(Side::SELL);
+
+    if (bid && ask && orders[*bid].price >= orders[*ask].price) {
+        const Price low = orders[*ask].price;
+        const Price high = orders[*bid].price;
+        std::vector<Price> prices;
+        for (const Resting& order : orders) {
+            if (order.price >= low && order.price <= high) prices.push_back(order.price);
+        }
+        std::sort(prices.begin(), prices.end());
+        prices.erase(std::unique(prices.begin(), prices.end()), prices.end());
+
+        // Try every price: most volume, then least imbalance, first such price
+        // kept and the last one tying it remembered
+        Price tieHigh = 0;
+        for (Price price : prices) {
+            std::uint64_t demand = 0;
+            std::uint64_t supply = 0;
+            for (const Resting& order : orders) {
+                if (order.side == Side::BUY && order.price >= price) demand += order.quantity;
+                if (order.side == Side::SELL && order.price <= price) supply += order.quantity;
+            }
+            const std::uint64_t volume = std::min(demand, supply);
+            const std::int64_t imbalance = static_cast<std::int64_t>(demand) - static_cast<std::int64_t>(supply);
+            if (volume > summary.volume || (volume == summary.volume && std::llabs(imbalance) < std::llabs(summary.imbalance))) {
+                summary = {price, volume, imbalance};
+                tieHigh = price;
+            }
+            else if (volume == summary.volume && std::llabs(imbalance) == std::llabs(summary.imbalance)) {
+                tieHigh = price;
+            }
+        }
+        if (summary.imbalance > 0) summary.price = tieHigh;
+        else if (summary.imbalance == 0) summary.price += (tieHigh - summary.price) / 2;
+
+        std::uint64_t remaining = summary.volume;
+        while (remaining > 0) {
+            const std::size_t buyIndex = *best(Side::BUY);
+            const std::size_t sellIndex = *best(Side::SELL);
+            Resting& buy = orders[buyIndex];
+            Resting& sell = orders[sellIndex];
+            const Quantity quantity = static_cast<Quantity>(std::min<std::uint64_t>(remaining, std::min(buy.quantity, sell.quantity)));
+            buy.quantity -= quantity;
+            sell.quantity -= quantity;
+            remaining -= quantity;
+            events.emplace_back(TradeExecutedEvent{FUZZ_SYMBOL, summary.price, quantity, buy.orderID, buy.traderID, Side::BUY, buy.quantity,
+                                                   sell.orderID, sell.traderID, sell.quantity});
+            orders.erase(std::remove_if(orders.begin(), orders.end(), [](const Resting& order) { return order.quantity == 0; }), orders.end());
+        }
+    }
+    events.emplace_back(summary);
+}
+
+BookState NaiveVenue::state() {
+    BookState state;
+    auto collect = [this](Side side, std::vector<LevelState>& levels) {
+        std::vector<Resting> sided;
+        std::copy_if(orders.begin(), orders.end(), std::back_inserter(sided), [side](const Resting& order) { return order.side == side; });
+        // Stable, so orders within a price keep their arrival order
+        std::stable_sort(sided.begin(), sided.end(), [side](const Resting& a, const Resting& b) {
+            return side == Side::BUY ? a.price > b.price : a.price < b.price;
+        });
+        for (const Resting& order : sided) {
+            if (levels.empty() || levels.back().price != order.price) levels.push_back({order.price, 0, {}});
+            levels.back().quantity += order.quantity;
+            levels.back().orders.push_back({order.orderID, order.traderID, order.quantity});
+        }
+    };
+    collect(Side::BUY, state.bids);
+    collect(Side::SELL, state.asks);
+    return state;
+}
+
+std::optional<Divergence> runDifferential(const std::vector<FuzzCommand>& commands, const VenueFactory& reference, const VenueFactory& candidate) {
+    std::unique_ptr<Venue> expected = reference();
+    std::unique_ptr<Venue> actual = candidate();
+    std::vector<OrderID> submitted;
+    std::vector<EngineEvent> expectedEvents;
+    std::vector<EngineEvent> actualEvents;
+
+    for (std::size_t i = 0; i < commands.size(); ++i) {
+        const FuzzCommand& command = commands[i];
+        expectedEvents.clear();
+        actualEvents.clear();
+        switch (command.op) {
+            case FuzzOp::LIMIT:
+            case FuzzOp::MARKET: {
+                const OrderID orderID = submitted.size() + 1;
+                submitted.push_back(orderID);
+                expected->submit(command, orderID, expectedEvents);
+                actual->submit(command, orderID, actualEvents);
+                break;
+            }
+            case FuzzOp::CANCEL:
+                if (submitted.empty()) continue;
+                expected->cancel(submitted[command.target % submitted.size()], expectedEvents);
+                actual->cancel(submitted[command.target % submitted.size()], actualEvents);
+                break;
+            case FuzzOp::MASS_CANCEL_TRADER:
+            case FuzzOp::MASS_CANCEL_TRADER_SIDE:
+            case FuzzOp::MASS_CANCEL_ALL:
+                expected->massCancel(command, expectedEvents);
+                actual->massCancel(command, actualEvents);
+                break;
+            case FuzzOp::BEGIN_AUCTION:
+                expected->beginAuction(expectedEvents);
+                actual->beginAuction(actualEvents);
+                break;
+            case FuzzOp::UNCROSS:
+                expected->uncross(expectedEvents);
+                actual->uncross(actualEvents);
+                break;
+        }
+
+        std::vector<str> want = describe(expectedEvents);
+        std::vector<str> got = describe(actualEvents);
+        if (want != got) {
+            return Divergence{i, "command " + std::to_string(i) + " (" + describe(command) + ")\n  reference:" + join(want) + "\n  candidate:" + join(got)};
+        }
+    }
+
+    BookState want = expected->state();
+    BookState got = actual->state();
+    if (want != got) {
+        return Divergence{commands.empty() ? 0 : commands.size() - 1,
+                          "final book\n  reference:" + describe(want) + "\n  candidate:" + describe(got)};
+    }
+    return std::nullopt;
+}
+
+std::vector<FuzzCommand> minimizeCommands(std::vector<FuzzCommand> commands, const VenueFactory& reference, const VenueFactory& candidate) {
+    std::optional<Divergence> divergence = runDifferential(commands, reference, candidate);
+    if (!divergence) return commands;
+    // Nothing after the first disagreement matters
+    commands.resize(divergence->commandIndex + 1);
+
+    std::size_t chunks = 2;
+    while (commands.size() >= 2) {
+        const std::size_t chunk = (commands.size() + chunks - 1) / chunks;
+        bool reduced = false;
+        for (std::size_t start = 0; start < commands.size(); start += chunk) {
+            std::vector<FuzzCommand> complement(commands.begin(), commands.begin() + start);
+            complement.insert(complement.end(), commands.begin() + std::min(start + chunk, commands.size()), commands.end());
+            if (runDifferential(complement, reference, candidate)) {
+                commands = std::move(complement);
+                chunks = std::max<std::size_t>(chunks - 1, 2);
+                reduced = true;
+                break;
+            }
+        }
+        if (!reduced) {
+            if (chunks >= commands.size()) break;
+            chunks = std::min(chunks * 2, commands.size());
+        }
+    }
+    return commands;
+}
+
+str formatCommands(const std::vector<FuzzCommand>& commands) {
+    str text;
+    for (std::size_t i = 0; i < commands.size(); ++i) text += std::to_string(i) + ": " + describe(commands[i]) + "\n";
+    return text;
+}
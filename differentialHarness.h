@@ -0,0 +1,206 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "matchingEngine.h"
+#include "orderBook.h"
+#include "eventDispatcher.h"
+#include "events.h"
+#include "limitOrder.h"
+#include "marketOrder.h"
+#include "types.h"
+
+enum class FuzzOp : std::uint8_t {
+    LIMIT,
+    MARKET,
+    CANCEL,
+    MASS_CANCEL_TRADER,
+    MASS_CANCEL_TRADER_SIDE,
+    MASS_CANCEL_ALL,
+    BEGIN_AUCTION,
+    UNCROSS
+};
+
+// One step of a randomized command stream. Cancels name an earlier
+// submission by position (`target` modulo the submissions so far), so a
+// stream stays meaningful when the minimizer drops commands from it.
+struct FuzzCommand {
+    FuzzOp op = FuzzOp::LIMIT;
+    Side side = Side::BUY;
+    TraderID traderID = 1;
+    Price price = 0;
+    Quantity quantity = 0;
+    std::uint16_t target = 0;
+};
+
+// Six bytes per command; a trailing partial record is ignored. Prices fall in
+// a narrow band and traders in a small pool so books cross and orders collide.
+constexpr std::size_t FUZZ_RECORD_SIZE = 6;
+std::vector<FuzzCommand> decodeFuzzCommands(const std::uint8_t* data, std::size_t size);
+std::vector<FuzzCommand> randomFuzzCommands(std::uint64_t seed, std::size_t count);
+
+struct RestingOrderState {
+    OrderID orderID;
+    TraderID traderID;
+    Quantity quantity;
+
+    bool operator==(const RestingOrderState&) const = default;
+};
+
+struct LevelState {
+    Price price;
+    Quantity quantity;                      // as the book aggregates it
+    std::vector<RestingOrderState> orders;  // time priority
+
+    bool operator==(const LevelState&) const = default;
+};
+
+struct BookState {
+    std::vector<LevelState> bids;   // best first
+    std::vector<LevelState> asks;
+
+    bool operator==(const BookState&) const = default;
+};
+
+// A book or engine under test. Submissions arrive with the order id the
+// harness assigned, so every venue sees identical ids.
+class Venue {
+    public:
+        virtual ~Venue() = default;
+
+        virtual void submit(const FuzzCommand& command, OrderID orderID, std::vector<EngineEvent>& events) = 0;
+        virtual void cancel(OrderID orderID, std::vector<EngineEvent>& events) = 0;
+        virtual void massCancel(const FuzzCommand& command, std::vector<EngineEvent>& events) = 0;
+        virtual void beginAuction(std::vector<EngineEvent>& events) = 0;
+        virtual void uncross(std::vector<EngineEvent>& events) = 0;
+        virtual BookState state() = 0;
+};
+
+using VenueFactory = std::function<std::unique_ptr<Venue>()>;
+
+// Any BasicMatchingEngine over its own OrderBook, driven synchronously.
+template<typename Engine>
+class EngineVenue : public Venue {
+    private:
+        OrderBook book;
+        EventDispatcher dispatcher;
+        Engine engine;
+        std::vector<EngineEvent>* sink = nullptr;
+
+        template<typename Event>
+        void capture() {
+            dispatcher.subscribe<Event>([this](const Event& e) { if (sink) sink->emplace_back(e); });
+        }
+
+        void drain(std::vector<EngineEvent>& events) {
+            sink = &events;
+            engine.runPending();
+            sink = nullptr;
+        }
+
+    public:
+        explicit EngineVenue(const EngineConfig& config = EngineConfig{}) : engine(book, dispatcher, config) {
+            capture<TradeExecutedEvent>();
+            capture<OrderAcceptedEvent>();
+            capture<OrderCancelledEvent>();
+            capture<OrderRejectedEvent>();
+            capture<MassCancelEvent>();
+            capture<AuctionUncrossEvent>();
+        }
+
+        void submit(const FuzzCommand& command, OrderID orderID, std::vector<EngineEvent>& events) override {
+            std::unique_ptr<Order> order;
+            if (command.op == FuzzOp::MARKET) {
+                order = std::make_unique<MarketOrder>("FUZZ", orderID, OrderType::MARKET, command.side, command.quantity, command.traderID);
+            }
+            else {
+                order = std::make_unique<LimitOrder>("FUZZ", orderID, OrderType::LIMIT, command.side, command.price, command.quantity, command.traderID);
+            }
+            engine.submitReserved(std::move(order));
+            drain(events);
+        }
+
+        void cancel(OrderID orderID, std::vector<EngineEvent>& events) override {
+            engine.cancelOrder(orderID);
+            drain(events);
+        }
+
+        void massCancel(const FuzzCommand& command, std::vector<EngineEvent>& events) override {
+            if (command.op == FuzzOp::MASS_CANCEL_ALL) engine.massCancelAll();
+            else if (command.op == FuzzOp::MASS_CANCEL_TRADER_SIDE) engine.massCancel(command.traderID, command.side);
+            else engine.massCancel(command.traderID);
+            drain(events);
+        }
+
+        void beginAuction(std::vector<EngineEvent>& events) override {
+            engine.beginAuction();
+            drain(events);
+        }
+
+        void uncross(std::vector<EngineEvent>& events) override {
+            engine.uncross();
+            drain(events);
+        }
+
+        BookState state() override {
+            BookState state;
+            auto read = [this](Side side, std::vector<LevelState>& levels) {
+                for (const LevelSnapshot& snapshot : book.depth(side)) {
+                    LevelState level{snapshot.price, snapshot.quantity, {}};
+                    for (OrderID id : snapshot.orders) {
+                        Order* order = book.getOrder(id);
+                        level.orders.push_back({id, order ? order->getTraderID() : 0, order ? order->getQuantity() : 0});
+                    }
+                    levels.push_back(std::move(level));
+                }
+            };
+            read(Side::BUY, state.bids);
+            read(Side::SELL, state.asks);
+            return state;
+        }
+};
+
+// Straight-line model of FIFO price-time matching over a flat vector. Slow
+// and obviously correct, it is the second opinion the engine is checked
+// against when no alternative book is plugged in.
+class NaiveVenue : public Venue {
+    private:
+        struct Resting {
+            OrderID orderID;
+            TraderID traderID;
+            Side side;
+            Price price;
+            Quantity quantity;
+        };
+
+        std::vector<Resting> orders;    // arrival order
+        bool auction = false;
+
+        std::optional<std::size_t> best(Side side) const;
+
+    public:
+        void submit(const FuzzCommand& command, OrderID orderID, std::vector<EngineEvent>& events) override;
+        void cancel(OrderID orderID, std::vector<EngineEvent>& events) override;
+        void massCancel(const FuzzCommand& command, std::vector<EngineEvent>& events) override;
+        void beginAuction(std::vector<EngineEvent>& events) override;
+        void uncross(std::vector<EngineEvent>& events) override;
+        BookState state() override;
+};
+
+struct Divergence {
+    std::size_t commandIndex;   // command after which the venues disagreed
+    str description;
+};
+
+// Runs the stream through both venues, comparing the events of every command
+// (timestamps aside, mass cancels as sets) and then the resting books.
+std::optional<Divergence> runDifferential(const std::vector<FuzzCommand>& commands, const VenueFactory& reference, const VenueFactory& candidate);
+
+// Delta-debugging reduction: a shortest-found subsequence of `commands` that
+// still diverges. Returns the input unchanged if it does not diverge.
+std::vector<FuzzCommand> minimizeCommands(std::vector<FuzzCommand> commands, const VenueFactory& reference, const VenueFactory& candidate);
+
+str formatCommands(const std::vector<FuzzCommand>& commands);
@@ -0,0 +1,69 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "types.h"
+
+enum class WaitStrategy {
+    BLOCKING,   // sleep on the ingress queue's condition variable
+    BUSY_POLL   // spin on the ingress queue; lowest latency, burns a core
+};
+
+enum class SelfTradePrevention {
+    NONE,              // allow a trader to trade with themself
+    CANCEL_RESTING,    // cancel the trader's resting order and keep matching
+    CANCEL_AGGRESSOR,  // cancel what is left of the incoming order
+    DECREMENT_BOTH     // reduce both orders by the smaller quantity without trading
+};
+
+// Pre-trade limits. A zero disables the individual check.
+struct RiskLimits {
+    Quantity maxOrderQuantity = 0;
+    std::int64_t maxPosition = 0;       // absolute net position including open orders
+    std::uint32_t maxOpenOrders = 0;
+    Price priceBandTicks = 0;           // max distance of a limit price from the last trade
+
+    bool any() const {
+        return maxOrderQuantity != 0 || maxPosition != 0 || maxOpenOrders != 0 || priceBandTicks != 0;
+    }
+};
+
+struct EngineConfig {
+    // Core to pin the matching thread to, or -1 to leave it to the scheduler.
+    // Event subscribers run on this thread, so they inherit the pinning.
+    int matchingCore = -1;
+
+    // SCHED_FIFO priority for the matching thread, or 0 to keep the default policy.
+    int realtimePriority = 0;
+
+    WaitStrategy waitStrategy = WaitStrategy::BLOCKING;
+
+    // Number of resting orders to size the book's tables for. The tables are
+    // allocated from the matching thread after it is pinned, so with Linux's
+    // first-touch policy they land on that core's NUMA node.
+    std::size_t expectedOrders = 0;
+
+    // Bind the matching thread's allocations to the NUMA node of matchingCore
+    // instead of relying on first touch. Needs matchingCore.
+    bool bindMemory = false;
+
+    // Bytes of heap the matching thread faults in before the book is sized,
+    // so the tables and the first orders land on resident pages. Switches
+    // off malloc trimming and mmap for the whole process; 0 skips it.
+    std::size_t prefaultBytes = 0;
+
+    // mlockall() the process once the book is sized so nothing is paged out.
+    bool lockMemory = false;
+
+    SelfTradePrevention selfTradePrevention = SelfTradePrevention::NONE;
+
+    // Limits applied to every trader without an explicit override.
+    RiskLimits defaultRiskLimits;
+
+    // Risk state is kept in flat arrays indexed by trader id; ids at or above
+    // this bound are rejected while risk checks are active.
+    TraderID maxTraders = 1 << 16;
+
+    // Time of day, UTC, at which DAY orders expire.
+    std::chrono::milliseconds sessionClose = std::chrono::hours(21);
+};
@@ -1,22 +1,40 @@
 #pragma once
 
+#include <algorithm>
 #include <functional>
 #include <unordered_map>
 #include <vector>
 #include <any>
 #include <typeindex>
 #include <iostream>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <utility>
+#include <cstdint>
 
+using SubscriptionID = std::uint64_t;
 
 class EventDispatcher {
 private:
+    struct Subscriber {
+        SubscriptionID id;
+        std::function<void(const std::any&)> callback;
+    };
+    // Replaced rather than modified, so a publish can run its callbacks from
+    // the list it picked up without holding the lock.
+    using SubscriberList = std::shared_ptr<const std::vector<Subscriber>>;
+
     std::mutex mtx;
-    std::unordered_map<std::type_index, std::vector<std::function<void(const std::any&)>>> subscribers;
+    std::unordered_map<std::type_index, SubscriberList> subscribers;
+    SubscriptionID nextID = 1;
+
+    // Publishes in progress on this thread, across dispatchers
+    static inline thread_local int publishing = 0;
 
 public:
     template<typename TEvent>
-    void subscribe(std::function<void(const TEvent&)> callback) {
+    SubscriptionID subscribe(std::function<void(const TEvent&)> callback) {
         std::lock_guard<std::mutex> lock(mtx);
         auto typeIndex = std::type_index(typeid(TEvent));
 
@@ -24,24 +42,77 @@ public:
             callback(std::any_cast<const TEvent&>(event));
         };
 
-        subscribers[typeIndex].push_back(wrapper);
+        SubscriberList& list = subscribers[typeIndex];
+        auto updated = list ? std::make_shared<std::vector<Subscriber>>(*list) : std::make_shared<std::vector<Subscriber>>();
+        updated->push_back(Subscriber{nextID, wrapper});
+        list = std::move(updated);
+        return nextID++;
+    }
+
+    // Once this returns the callback is not called again. It waits for
+    // publishes already running it on other threads, so it is safe to call
+    // from the destructor of whatever the callback captured. Called from
+    // inside a callback, it cannot wait for the publish that is running.
+    void unsubscribe(SubscriptionID id) {
+        SubscriberList previous;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            for (auto& [type, list] : subscribers) {
+                if (!list) continue;
+                auto it = std::find_if(list->begin(), list->end(), [id](const Subscriber& s) { return s.id == id; });
+                if (it == list->end()) continue;
+                auto updated = std::make_shared<std::vector<Subscriber>>(*list);
+                updated->erase(updated->begin() + (it - list->begin()));
+                previous = std::exchange(list, std::move(updated));
+                break;
+            }
+        }
+        if (!previous || publishing > 0) return;
+        while (previous.use_count() > 1) std::this_thread::yield();
     }
 
    template<typename TEvent>
     void publish(const TEvent& event) {
         auto typeIndex = std::type_index(typeid(TEvent));
-        std::vector<std::function<void(const std::any&)>> callbacks;
+        SubscriberList callbacks;
 
         {
             std::lock_guard<std::mutex> lock(mtx);
-            if (subscribers.count(typeIndex)) {
-                callbacks = subscribers.at(typeIndex);
-            }
+            auto it = subscribers.find(typeIndex);
+            if (it != subscribers.end()) callbacks = it->second;
         }
-        for (const auto& callback : callbacks) {
-           try {callback(event);}
+        if (!callbacks) return;
+        struct Publishing {
+            Publishing() { publishing++; }
+            ~Publishing() { publishing--; }
+        } inProgress;
+        for (const auto& subscriber : *callbacks) {
+           try {subscriber.callback(event);}
            catch (const std::exception& e) {std::cerr << "Exception in event subscriber: " << e.what() << std::endl;}
         }
     }
 };
 
+// Unsubscribes everything added through it when cleared or destroyed. Owners
+// declare it after the state their callbacks touch, so it is released first;
+// the dispatchers must outlive it.
+class Subscriptions {
+private:
+    std::vector<std::pair<EventDispatcher*, SubscriptionID>> entries;
+
+public:
+    Subscriptions() = default;
+    Subscriptions(const Subscriptions&) = delete;
+    Subscriptions& operator=(const Subscriptions&) = delete;
+    ~Subscriptions() { clear(); }
+
+    template<typename TEvent>
+    void add(EventDispatcher& dispatcher, std::function<void(const TEvent&)> callback) {
+        entries.emplace_back(&dispatcher, dispatcher.subscribe<TEvent>(std::move(callback)));
+    }
+
+    void clear() {
+        for (auto [dispatcher, id] : entries) dispatcher->unsubscribe(id);
+        entries.clear();
+    }
+};
@@ -2,6 +2,8 @@
 #include "types.h"
 #include "order.h"
 #include <chrono>
+#include <cstdint>
+#include <vector>
 
 struct TradeExecutedEvent {
     str symbol;
@@ -21,15 +23,47 @@ struct TradeExecutedEvent {
     Timestamp timestamp = std::chrono::time_point_cast<std::chrono::milliseconds>(std::chrono::system_clock::now());
 };
 
+// Published when a limit order comes to rest on the book.
 struct OrderAcceptedEvent {
     OrderID orderID;
     Price price;
     Quantity quantity;
+    str symbol;
+    Side side = Side::BUY;
 };
 
+// `quantity` is what was taken off. Self-trade prevention may only reduce an
+// order, leaving `remaining` live; the order is gone once `remaining` is 0.
 struct OrderCancelledEvent {
     OrderID orderID;
     Quantity quantity;
+    Quantity remaining = 0;
+};
+
+// One event for a whole mass cancel, however many orders it removed.
+struct MassCancelEvent {
+    std::vector<OrderCancelledEvent> cancelled;
+};
+
+enum class RejectReason {
+    ORDER_SIZE,
+    POSITION_LIMIT,
+    OPEN_ORDER_LIMIT,
+    PRICE_BAND,
+    UNKNOWN_TRADER
+};
+
+struct OrderRejectedEvent {
+    OrderID orderID;
+    TraderID traderID;
+    RejectReason reason;
+};
+
+// Closes an auction; published after the uncross's trades, volume 0 if nothing crossed.
+struct AuctionUncrossEvent {
+    Price price;
+    std::uint64_t volume;
+    std::int64_t imbalance;
 };
 
 struct MarketDataEvent {
@@ -0,0 +1,290 @@
+#include "feedClient.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+    FeedPacketHeader readPacketHeader(const char* data) {
+        FeedPacketHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        return header;
+    }
+
+    // Calls `handle(message, index)` for each well-formed message; stops at the first malformed one.
+    template<typename Handler>
+    void forEachMessage(const char* data, std::size_t size, std::uint16_t count, Handler&& handle) {
+        std::size_t offset = sizeof(FeedPacketHeader);
+        for (std::uint16_t i = 0; i < count; ++i) {
+            if (offset + sizeof(FeedMessageHeader) > size) return;
+            FeedMessageHeader header;
+            std::memcpy(&header, data + offset, sizeof(header));
+            if (header.length == 0 || header.length != feedMessageSize(header.type) || offset + header.length > size) return;
+            handle(data + offset, header.type, i);
+            offset += header.length;
+        }
+    }
+
+    template<typename Message>
+    Message readMessage(const char* data) {
+        Message message;
+        std::memcpy(&message, data, sizeof(message));
+        return message;
+    }
+}
+
+void FeedBook::adjustLevel(Side side, Price price, std::int64_t delta) {
+    auto adjust = [&](auto& levels) {
+        auto it = levels.try_emplace(price, 0).first;
+        it->second += delta;
+        if (it->second == 0) levels.erase(it);
+    };
+    if (side == Side::BUY) adjust(bids);
+    else adjust(asks);
+}
+
+void FeedBook::add(OrderID orderID, const FeedOrder& order) {
+    if (!orders.emplace(orderID, order).second) return;
+    adjustLevel(order.side, order.price, order.quantity);
+}
+
+void FeedBook::reduce(OrderID orderID, Quantity quantity) {
+    auto it = orders.find(orderID);
+    if (it == orders.end()) return;
+    Quantity reduced = std::min(quantity, it->second.quantity);
+    adjustLevel(it->second.side, it->second.price, -static_cast<std::int64_t>(reduced));
+    it->second.quantity -= reduced;
+    if (it->second.quantity == 0) orders.erase(it);
+}
+
+void FeedBook::remove(OrderID orderID) {
+    auto it = orders.find(orderID);
+    if (it == orders.end()) return;
+    adjustLevel(it->second.side, it->second.price, -static_cast<std::int64_t>(it->second.quantity));
+    orders.erase(it);
+}
+
+void FeedBook::clear() {
+    orders.clear();
+    bids.clear();
+    asks.clear();
+}
+
+std::optional<FeedLevel> FeedBook::getBestBid() const {
+    if (bids.empty()) return std::nullopt;
+    return FeedLevel{bids.begin()->first, bids.begin()->second};
+}
+
+std::optional<FeedLevel> FeedBook::getBestAsk() const {
+    if (asks.empty()) return std::nullopt;
+    return FeedLevel{asks.begin()->first, asks.begin()->second};
+}
+
+std::uint64_t FeedBook::getQuantityAt(Side side, Price price) const {
+    if (side == Side::BUY) {
+        auto it = bids.find(price);
+        return it == bids.end() ? 0 : it->second;
+    }
+    auto it = asks.find(price);
+    return it == asks.end() ? 0 : it->second;
+}
+
+const FeedOrder* FeedBook::getOrder(OrderID orderID) const {
+    auto it = orders.find(orderID);
+    return it == orders.end() ? nullptr : &it->second;
+}
+
+void FeedBookBuilder::onIncrementalPacket(const char* data, std::size_t size) {
+    if (size < sizeof(FeedPacketHeader)) return;
+    const FeedPacketHeader header = readPacketHeader(data);
+    if (header.count == 0) return;
+
+    if (!synchronized) {
+        if (pending.size() == MAX_PENDING_PACKETS) pending.pop_front();
+        pending.emplace_back(data, data + size);
+        return;
+    }
+    if (header.sequence + header.count - 1 <= lastSequence) return;    // duplicate
+    if (header.sequence > lastSequence + 1) {
+        synchronized = false;
+        gapCount++;
+        pending.clear();
+        pending.emplace_back(data, data + size);
+        return;
+    }
+    applyPacket(data, size, header.sequence, header.count);
+}
+
+void FeedBookBuilder::applyPacket(const char* data, std::size_t size, std::uint64_t firstSequence, std::uint16_t count) {
+    forEachMessage(data, size, count, [&](const char* message, FeedMessageType, std::uint16_t index) {
+        const std::uint64_t sequence = firstSequence + index;
+        if (sequence <= lastSequence) return;
+        applyMessage(book, message);
+        lastSequence = sequence;
+    });
+}
+
+void FeedBookBuilder::applyMessage(FeedBook& target, const char* data) {
+    FeedMessageHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    switch (header.type) {
+        case FeedMessageType::ADD_ORDER: {
+            auto message = readMessage<AddOrderMessage>(data);
+            FeedOrder order{static_cast<Side>(header.side), message.price, message.quantity, {}};
+            std::memcpy(order.symbol, message.symbol, sizeof(order.symbol));
+            target.add(message.orderID, order);
+            break;
+        }
+        case FeedMessageType::ORDER_EXECUTED: {
+            auto message = readMessage<OrderExecutedMessage>(data);
+            target.reduce(message.orderID, message.quantity);
+            break;
+        }
+        case FeedMessageType::ORDER_CANCEL: {
+            auto message = readMessage<OrderCancelMessage>(data);
+            target.reduce(message.orderID, message.quantity);
+            break;
+        }
+        case FeedMessageType::ORDER_DELETE:
+            target.remove(readMessage<OrderDeleteMessage>(data).orderID);
+            break;
+        case FeedMessageType::CROSS_TRADE: {
+            auto message = readMessage<CrossTradeMessage>(data);
+            lastCross = FeedLevel{message.price, message.volume};
+            break;
+        }
+        case FeedMessageType::SNAPSHOT_START:
+        case FeedMessageType::SNAPSHOT_END:
+            break;
+    }
+}
+
+void FeedBookBuilder::onSnapshotPacket(const char* data, std::size_t size) {
+    if (synchronized || size < sizeof(FeedPacketHeader)) return;
+    const FeedPacketHeader header = readPacketHeader(data);
+
+    forEachMessage(data, size, header.count, [&](const char* message, FeedMessageType type, std::uint16_t) {
+        switch (type) {
+            case FeedMessageType::SNAPSHOT_START: {
+                auto start = readMessage<SnapshotStartMessage>(message);
+                staging.clear();
+                snapshotActive = true;
+                snapshotSequence = start.sequence;
+                snapshotExpected = start.orderCount;
+                snapshotReceived = 0;
+                break;
+            }
+            case FeedMessageType::ADD_ORDER:
+                if (!snapshotActive) break;
+                applyMessage(staging, message);
+                snapshotReceived++;
+                break;
+            case FeedMessageType::SNAPSHOT_END: {
+                auto end = readMessage<SnapshotEndMessage>(message);
+                // A lost snapshot packet shows up as a short count; wait for the next cycle
+                if (snapshotActive && end.sequence == snapshotSequence && snapshotReceived == snapshotExpected) completeSnapshot();
+                snapshotActive = false;
+                break;
+            }
+            default:
+                break;
+        }
+    });
+}
+
+void FeedBookBuilder::completeSnapshot() {
+    auto firstOf = [](const std::vector<char>& packet) { return readPacketHeader(packet.data()).sequence; };
+    auto lastOf = [](const std::vector<char>& packet) {
+        FeedPacketHeader header = readPacketHeader(packet.data());
+        return header.sequence + header.count - 1;
+    };
+
+    while (!pending.empty() && lastOf(pending.front()) <= snapshotSequence) pending.pop_front();
+    // Packets between the snapshot and the held ones were lost too
+    if (!pending.empty() && firstOf(pending.front()) > snapshotSequence + 1) return;
+
+    std::swap(book, staging);
+    staging.clear();
+    lastSequence = snapshotSequence;
+    synchronized = true;
+
+    std::deque<std::vector<char>> replay = std::move(pending);
+    pending.clear();
+    for (const std::vector<char>& packet : replay) onIncrementalPacket(packet.data(), packet.size());
+}
+
+FeedClient::FeedClient(const FeedConfig& config) : buffer(64 * 1024) {
+    incrementalFd = openSocket(config, config.port, port);
+    snapshotFd = openSocket(config, config.snapshotPort, snapshotPort);
+}
+
+FeedClient::~FeedClient() {
+    if (incrementalFd >= 0) close(incrementalFd);
+    if (snapshotFd >= 0) close(snapshotFd);
+}
+
+int FeedClient::openSocket(const FeedConfig& config, std::uint16_t requestedPort, std::uint16_t& boundPort) {
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) throw std::system_error(errno, std::generic_category(), "socket");
+
+    // Several consumers on one host can share a multicast port
+    int enable = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    int receiveBuffer = 4 * 1024 * 1024;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(requestedPort);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        int error = errno;
+        close(fd);
+        throw std::system_error(error, std::generic_category(), "bind");
+    }
+    socklen_t length = sizeof(address);
+    getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length);
+    boundPort = ntohs(address.sin_port);
+
+    in_addr group{};
+    if (inet_pton(AF_INET, config.address.c_str(), &group) != 1) {
+        close(fd);
+        throw std::invalid_argument("Invalid feed address: " + config.address);
+    }
+    if (IN_MULTICAST(ntohl(group.s_addr))) {
+        ip_mreq membership{};
+        membership.imr_multiaddr = group;
+        membership.imr_interface.s_addr = htonl(INADDR_ANY);
+        if (!config.interfaceAddress.empty()) inet_pton(AF_INET, config.interfaceAddress.c_str(), &membership.imr_interface);
+        if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) < 0) {
+            int error = errno;
+            close(fd);
+            throw std::system_error(error, std::generic_category(), "IP_ADD_MEMBERSHIP");
+        }
+    }
+    return fd;
+}
+
+std::size_t FeedClient::poll(std::chrono::milliseconds timeout) {
+    pollfd descriptors[2] = {{incrementalFd, POLLIN, 0}, {snapshotFd, POLLIN, 0}};
+    if (::poll(descriptors, 2, static_cast<int>(timeout.count())) <= 0) return 0;
+
+    std::size_t packets = 0;
+    for (const pollfd& descriptor : descriptors) {
+        if (!(descriptor.revents & POLLIN)) continue;
+        while (true) {
+            ssize_t received = recv(descriptor.fd, buffer.data(), buffer.size(), 0);
+            if (received <= 0) break;
+            if (descriptor.fd == incrementalFd) builder.onIncrementalPacket(buffer.data(), static_cast<std::size_t>(received));
+            else builder.onSnapshotPacket(buffer.data(), static_cast<std::size_t>(received));
+            packets++;
+        }
+    }
+    return packets;
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include "marketDataProtocol.h"
+#include "marketDataFeed.h"
+#include "order.h"
+
+struct FeedOrder {
+    Side side;
+    Price price;
+    Quantity quantity;
+    char symbol[8];
+};
+
+struct FeedLevel {
+    Price price;
+    std::uint64_t quantity;
+};
+
+// Order-by-order book as rebuilt from the feed, with aggregated levels.
+class FeedBook {
+    private:
+        std::unordered_map<OrderID, FeedOrder> orders;
+        std::map<Price, std::uint64_t, std::greater<Price>> bids;
+        std::map<Price, std::uint64_t> asks;
+
+        void adjustLevel(Side side, Price price, std::int64_t delta);
+
+    public:
+        void add(OrderID orderID, const FeedOrder& order);
+        void reduce(OrderID orderID, Quantity quantity);
+        void remove(OrderID orderID);
+        void clear();
+
+        std::optional<FeedLevel> getBestBid() const;
+        std::optional<FeedLevel> getBestAsk() const;
+        std::uint64_t getQuantityAt(Side side, Price price) const;
+        const FeedOrder* getOrder(OrderID orderID) const;
+        std::size_t orderCount() const { return orders.size(); }
+};
+
+// Applies feed packets to a FeedBook, detecting gaps from the sequence
+// numbers. A consumer starts synchronized at sequence 0, so one that sees the
+// session from the first packet never needs a snapshot. After a gap (or on a
+// late join) incremental packets are held back until a complete snapshot at
+// or past the start of the held packets arrives; the book is then rebuilt
+// from the snapshot and the held packets are replayed on top.
+class FeedBookBuilder {
+    private:
+        static constexpr std::size_t MAX_PENDING_PACKETS = 4096;
+
+        FeedBook book;
+        std::uint64_t lastSequence = 0;
+        bool synchronized = true;
+        std::uint64_t gapCount = 0;
+        std::deque<std::vector<char>> pending;
+
+        FeedBook staging;
+        bool snapshotActive = false;
+        std::uint64_t snapshotSequence = 0;
+        std::uint32_t snapshotExpected = 0;
+        std::uint32_t snapshotReceived = 0;
+
+        std::optional<FeedLevel> lastCross;
+
+        void applyPacket(const char* data, std::size_t size, std::uint64_t firstSequence, std::uint16_t count);
+        void applyMessage(FeedBook& target, const char* message);
+        void completeSnapshot();
+
+    public:
+        void onIncrementalPacket(const char* data, std::size_t size);
+        void onSnapshotPacket(const char* data, std::size_t size);
+
+        const FeedBook& getBook() const { return book; }
+        bool isSynchronized() const { return synchronized; }
+        std::uint64_t getSequence() const { return lastSequence; }
+        std::uint64_t getGapCount() const { return gapCount; }
+        std::optional<FeedLevel> getLastCross() const { return lastCross; }
+};
+
+// Reference consumer: listens on the incremental and snapshot channels
+// (joining the group when the address is multicast) and feeds a builder.
+// Ports of 0 bind ephemeral ports, see getPort()/getSnapshotPort().
+class FeedClient {
+    private:
+        int incrementalFd = -1;
+        int snapshotFd = -1;
+        std::uint16_t port = 0;
+        std::uint16_t snapshotPort = 0;
+        std::vector<char> buffer;
+        FeedBookBuilder builder;
+
+        int openSocket(const FeedConfig& config, std::uint16_t requestedPort, std::uint16_t& boundPort);
+
+    public:
+        explicit FeedClient(const FeedConfig& config);
+        ~FeedClient();
+        FeedClient(const FeedClient&) = delete;
+        FeedClient& operator=(const FeedClient&) = delete;
+
+        // Waits up to `timeout` for datagrams and applies all that are ready.
+        // Returns the number of packets processed.
+        std::size_t poll(std::chrono::milliseconds timeout);
+
+        const FeedBookBuilder& getBuilder() const { return builder; }
+        const FeedBook& getBook() const { return builder.getBook(); }
+        std::uint16_t getPort() const { return port; }
+        std::uint16_t getSnapshotPort() const { return snapshotPort; }
+};
@@ -0,0 +1,53 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "feedClient.h"
+
+// Usage:
+//   feed_listener [--address ADDR] --port PORT --snapshot-port PORT [--interface ADDR]
+//
+// Reference consumer: rebuilds the book from the feed and prints the top of
+// book and feed state once a second.
+int main(int argc, char** argv) {
+    FeedConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        str arg = argv[i];
+        auto value = [&]() -> str {
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << std::endl;
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+        if (arg == "--address") config.address = value();
+        else if (arg == "--port") config.port = static_cast<std::uint16_t>(std::stoul(value()));
+        else if (arg == "--snapshot-port") config.snapshotPort = static_cast<std::uint16_t>(std::stoul(value()));
+        else if (arg == "--interface") config.interfaceAddress = value();
+        else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (config.port == 0 || config.snapshotPort == 0) {
+        std::cerr << "--port and --snapshot-port are required" << std::endl;
+        return 1;
+    }
+
+    FeedClient client(config);
+    auto nextReport = std::chrono::steady_clock::now();
+    while (true) {
+        client.poll(std::chrono::milliseconds(100));
+        if (std::chrono::steady_clock::now() < nextReport) continue;
+        nextReport += std::chrono::seconds(1);
+
+        const FeedBookBuilder& builder = client.getBuilder();
+        const FeedBook& book = client.getBook();
+        std::cout << "seq " << builder.getSequence() << (builder.isSynchronized() ? "" : " (recovering)")
+                  << " gaps " << builder.getGapCount() << " orders " << book.orderCount();
+        if (auto bid = book.getBestBid()) std::cout << " bid " << bid->quantity << "@" << bid->price;
+        if (auto ask = book.getBestAsk()) std::cout << " ask " << ask->quantity << "@" << ask->price;
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,94 @@
+#include "fillRecorder.h"
+
+void FillColumns::reserve(std::size_t capacity) {
+    timestamp.reserve(capacity);
+    symbol.reserve(capacity);
+    side.reserve(capacity);
+    price.reserve(capacity);
+    quantity.reserve(capacity);
+    orderID.reserve(capacity);
+    traderID.reserve(capacity);
+}
+
+void EquityColumns::reserve(std::size_t capacity) {
+    timestamp.reserve(capacity);
+    value.reserve(capacity);
+}
+
+FillRecorder::FillRecorder(std::optional<TraderID> trader, std::size_t capacity)
+    : trader(trader), capacity(capacity) {
+    fills.reserve(capacity);
+    equity.reserve(capacity);
+}
+
+void FillRecorder::subscribe(EventDispatcher& dispatcher) {
+    subscriptions.add<TradeExecutedEvent>(dispatcher, [this](const TradeExecutedEvent& event) { onTrade(event); });
+}
+
+std::uint32_t FillRecorder::internSymbol(const str& symbol) {
+    auto it = symbolIndex.find(symbol);
+    if (it != symbolIndex.end()) return it->second;
+    std::uint32_t index = static_cast<std::uint32_t>(symbols.size());
+    symbols.push_back(symbol);
+    symbolIndex.emplace(symbol, index);
+    return index;
+}
+
+void FillRecorder::onTrade(const TradeExecutedEvent& event) {
+    Side side = event.aggressingSide;
+    OrderID orderID = event.aggressingOrderID;
+    TraderID traderID = event.aggressingTraderID;
+
+    if (trader && event.aggressingTraderID != *trader) {
+        if (event.restingTraderID != *trader) return;
+        side = getOppositeSide(event.aggressingSide);
+        orderID = event.restingOrderID;
+        traderID = event.restingTraderID;
+    }
+
+    std::lock_guard<std::mutex> lock(mtx);
+    fills.timestamp.push_back(clock != 0 ? clock : event.timestamp.time_since_epoch().count());
+    fills.symbol.push_back(internSymbol(event.symbol));
+    fills.side.push_back(side == Side::BUY ? 1 : -1);
+    fills.price.push_back(event.price);
+    fills.quantity.push_back(event.quantity);
+    fills.orderID.push_back(orderID);
+    fills.traderID.push_back(traderID);
+}
+
+void FillRecorder::setClock(std::int64_t timestampMs) {
+    std::lock_guard<std::mutex> lock(mtx);
+    clock = timestampMs;
+}
+
+void FillRecorder::recordEquity(std::int64_t timestampMs, double value) {
+    std::lock_guard<std::mutex> lock(mtx);
+    equity.timestamp.push_back(timestampMs);
+    equity.value.push_back(value);
+}
+
+std::unique_ptr<FillColumns> FillRecorder::takeFills() {
+    auto batch = std::make_unique<FillColumns>();
+    batch->reserve(capacity);
+    std::lock_guard<std::mutex> lock(mtx);
+    std::swap(*batch, fills);
+    return batch;
+}
+
+std::unique_ptr<EquityColumns> FillRecorder::takeEquity() {
+    auto batch = std::make_unique<EquityColumns>();
+    batch->reserve(capacity);
+    std::lock_guard<std::mutex> lock(mtx);
+    std::swap(*batch, equity);
+    return batch;
+}
+
+std::size_t FillRecorder::fillCount() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return fills.size();
+}
+
+std::vector<str> FillRecorder::getSymbols() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return symbols;
+}
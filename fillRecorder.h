@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include "types.h"
+#include "events.h"
+#include "eventDispatcher.h"
+
+// Fills in struct-of-arrays form. Handed out whole by FillRecorder so the
+// buffers can back NumPy arrays without a copy.
+struct FillColumns {
+    std::vector<std::int64_t> timestamp;   // ms since epoch
+    std::vector<std::uint32_t> symbol;     // index into FillRecorder::getSymbols()
+    std::vector<std::int8_t> side;         // +1 buy, -1 sell
+    std::vector<Price> price;
+    std::vector<Quantity> quantity;
+    std::vector<OrderID> orderID;
+    std::vector<TraderID> traderID;
+
+    void reserve(std::size_t capacity);
+    std::size_t size() const { return timestamp.size(); }
+};
+
+struct EquityColumns {
+    std::vector<std::int64_t> timestamp;
+    std::vector<double> value;
+
+    void reserve(std::size_t capacity);
+    std::size_t size() const { return timestamp.size(); }
+};
+
+// Accumulates TradeExecutedEvents into preallocated columns on the matching
+// thread, replacing a per-fill callback into Python. With a trader filter only
+// that trader's fills are kept, seen from their side of the trade; otherwise
+// every trade is kept from the aggressor's side.
+class FillRecorder {
+    private:
+        std::mutex mtx;
+        std::optional<TraderID> trader;
+        std::size_t capacity;
+        std::int64_t clock = 0;
+
+        FillColumns fills;
+        EquityColumns equity;
+        std::vector<str> symbols;
+        std::unordered_map<str, std::uint32_t> symbolIndex;
+        Subscriptions subscriptions;
+
+        std::uint32_t internSymbol(const str& symbol);
+
+    public:
+        explicit FillRecorder(std::optional<TraderID> trader = std::nullopt, std::size_t capacity = 1 << 16);
+
+        void subscribe(EventDispatcher& dispatcher);
+        void onTrade(const TradeExecutedEvent& event);
+
+        // Stamp subsequent fills with this time instead of the event's wall clock,
+        // e.g. the timestamp of the bar being replayed.
+        void setClock(std::int64_t timestampMs);
+        void recordEquity(std::int64_t timestampMs, double value);
+
+        // Hand over everything recorded so far and start a fresh, preallocated batch.
+        std::unique_ptr<FillColumns> takeFills();
+        std::unique_ptr<EquityColumns> takeEquity();
+
+        std::size_t fillCount();
+        std::vector<str> getSymbols();
+};
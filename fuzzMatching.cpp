@@ -0,0 +1,83 @@
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include "differentialHarness.h"
+
+// libFuzzer target: every input is a command stream run through the matching
+// engine and the naive reference venue. On the first disagreement the stream
+// is minimized, printed with the divergence, and the process aborts so the
+// fuzzer keeps the crashing input.
+//
+// Built with -fsanitize=fuzzer when TRADING_FUZZ is on (clang). Otherwise a
+// standalone driver is compiled in:
+//   fuzz_matching [--runs N] [--commands N] [--seed S] [input files...]
+// replays the given files, or generates N random streams when there are none.
+namespace {
+    bool check(const std::vector<FuzzCommand>& commands) {
+        VenueFactory reference = [] { return std::make_unique<NaiveVenue>(); };
+        VenueFactory candidate = [] { return std::make_unique<EngineVenue<MatchingEngine>>(); };
+        std::optional<Divergence> divergence = runDifferential(commands, reference, candidate);
+        if (!divergence) return true;
+
+        std::vector<FuzzCommand> minimal = minimizeCommands(commands, reference, candidate);
+        std::cerr << "Divergence at " << runDifferential(minimal, reference, candidate)->description << "\n"
+                  << "Minimized from " << commands.size() << " to " << minimal.size() << " commands:\n"
+                  << formatCommands(minimal);
+        return false;
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size) {
+    if (!check(decodeFuzzCommands(data, size))) std::abort();
+    return 0;
+}
+
+#ifdef TRADING_FUZZ_STANDALONE
+int main(int argc, char** argv) {
+    std::size_t runs = 10000;
+    std::size_t count = 200;
+    std::uint64_t seed = 1;
+    std::vector<str> inputs;
+
+    for (int i = 1; i < argc; ++i) {
+        str arg = argv[i];
+        auto value = [&]() -> str {
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << std::endl;
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+        if (arg == "--runs") runs = std::stoul(value());
+        else if (arg == "--commands") count = std::stoul(value());
+        else if (arg == "--seed") seed = std::stoull(value());
+        else inputs.push_back(arg);
+    }
+
+    for (const str& path : inputs) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            std::cerr << "Cannot open " << path << std::endl;
+            return 1;
+        }
+        std::vector<std::uint8_t> bytes{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+        LLVMFuzzerTestOneInput(bytes.data(), bytes.size());
+    }
+    if (!inputs.empty()) {
+        std::cout << "Replayed " << inputs.size() << " inputs without divergence\n";
+        return 0;
+    }
+
+    for (std::size_t run = 0; run < runs; ++run) {
+        if (!check(randomFuzzCommands(seed + run, count))) {
+            std::cerr << "Seed " << seed + run << std::endl;
+            return 1;
+        }
+    }
+    std::cout << runs << " streams of " << count << " commands agreed\n";
+    return 0;
+}
+#endif
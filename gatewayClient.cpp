@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "orderEntryClient.h"
+#include "orderGateway.h"
+#include "orderFlowGenerator.h"
+#include "matchingEngine.h"
+#include "orderBook.h"
+#include "eventDispatcher.h"
+
+// Usage:
+//   gateway_client [--host HOST] [--port PORT] [--messages N] [--window N]
+//                  [--trader ID] [--seed S]
+//
+// Replays a synthetic order flow over one order-entry session and reports the
+// wire-to-ack latency of every enter and replace (send until ACCEPTED or
+// REJECTED). Without --port an engine and gateway are started in-process and
+// the session runs over loopback. At most --window requests are in flight.
+int main(int argc, char** argv) {
+    str host = "127.0.0.1";
+    std::uint16_t port = 0;
+    std::size_t messageCount = 100'000;
+    std::size_t window = 64;
+    TraderID traderID = 1;
+    OrderFlowConfig flowConfig;
+
+    for (int i = 1; i < argc; ++i) {
+        str arg = argv[i];
+        auto value = [&]() -> str {
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << std::endl;
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+        if (arg == "--host") host = value();
+        else if (arg == "--port") port = static_cast<std::uint16_t>(std::stoul(value()));
+        else if (arg == "--messages") messageCount = std::stoull(value());
+        else if (arg == "--window") window = std::max<std::size_t>(1, std::stoull(value()));
+        else if (arg == "--trader") traderID = static_cast<TraderID>(std::stoul(value()));
+        else if (arg == "--seed") flowConfig.seed = std::stoull(value());
+        else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    OrderBook book;
+    EventDispatcher dispatcher;
+    MatchingEngine engine(book, dispatcher);
+    std::unique_ptr<OrderGateway> gateway;
+    if (port == 0) {
+        gateway = std::make_unique<OrderGateway>(engine, dispatcher);
+        engine.start();
+        gateway->start();
+        port = gateway->getPort();
+        std::cout << "Started in-process gateway on port " << port << std::endl;
+    }
+
+    OrderFlowGenerator generator(flowConfig);
+    std::vector<FlowMessage> messages = generator.generate(messageCount);
+
+    OrderEntryClient client;
+    client.connect(host, port);
+    client.login(traderID);
+    GatewayResponse response;
+    if (!client.receive(response, std::chrono::seconds(5)) || response.type != GatewayMessageType::LOGIN_ACCEPTED) {
+        std::cerr << "Login failed" << std::endl;
+        return 1;
+    }
+
+    // Generator order ids double as tokens; replaces re-enter under the new id.
+    std::vector<std::chrono::steady_clock::time_point> sentAt(messages.size() + 2);
+    std::vector<double> latenciesUs;
+    latenciesUs.reserve(messages.size());
+    std::size_t inFlight = 0;
+    std::uint64_t executions = 0, cancels = 0, rejects = 0;
+
+    auto handle = [&](const GatewayResponse& r) {
+        switch (r.type) {
+            case GatewayMessageType::ACCEPTED:
+            case GatewayMessageType::REJECTED:
+                // Cancels of already-filled orders are rejected too but were never timed
+                if (r.token < sentAt.size() && sentAt[r.token] != std::chrono::steady_clock::time_point{}) {
+                    latenciesUs.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - sentAt[r.token]).count());
+                    sentAt[r.token] = {};
+                    --inFlight;
+                }
+                if (r.type == GatewayMessageType::REJECTED) ++rejects;
+                break;
+            case GatewayMessageType::EXECUTED: ++executions; break;
+            case GatewayMessageType::CANCELLED: ++cancels; break;
+            default: break;
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    for (const FlowMessage& message : messages) {
+        while (inFlight >= window) {
+            if (!client.receive(response, std::chrono::seconds(5))) {
+                std::cerr << "Timed out waiting for acks" << std::endl;
+                return 1;
+            }
+            handle(response);
+        }
+
+        switch (message.type) {
+            case FlowMessageType::ADD:
+            case FlowMessageType::MARKETABLE:
+                sentAt[message.orderID] = std::chrono::steady_clock::now();
+                client.enterOrder(message.orderID, "SYNTH", message.side, OrderType::LIMIT, message.price, message.quantity);
+                ++inFlight;
+                break;
+            case FlowMessageType::CANCEL:
+                client.cancelOrder(message.targetID);
+                break;
+            case FlowMessageType::MODIFY:
+                sentAt[message.orderID] = std::chrono::steady_clock::now();
+                client.replaceOrder(message.targetID, message.orderID, message.price, message.quantity);
+                ++inFlight;
+                break;
+        }
+    }
+    while (inFlight > 0 && client.receive(response, std::chrono::seconds(5))) handle(response);
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    client.close();
+    if (gateway) {
+        engine.stop();
+        gateway->stop();
+    }
+
+    std::sort(latenciesUs.begin(), latenciesUs.end());
+    auto percentile = [&](double p) {
+        if (latenciesUs.empty()) return 0.0;
+        return latenciesUs[std::min(latenciesUs.size() - 1, static_cast<std::size_t>(p * latenciesUs.size()))];
+    };
+
+    std::cout << "Sent " << messages.size() << " messages in " << elapsed << " s ("
+              << static_cast<std::uint64_t>(messages.size() / elapsed) << " msg/s)" << std::endl;
+    std::cout << "Acks: " << latenciesUs.size() << ", executions: " << executions
+              << ", cancels: " << cancels << ", rejects: " << rejects << std::endl;
+    std::cout << "Wire-to-ack latency (us): p50 " << percentile(0.50) << ", p99 " << percentile(0.99)
+              << ", p99.9 " << percentile(0.999) << ", max " << (latenciesUs.empty() ? 0.0 : latenciesUs.back()) << std::endl;
+    return 0;
+}
@@ -0,0 +1,247 @@
+#include "indicators.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+    constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+
+    // Running window sums are re-summed exactly this often to stop rounding drift
+    constexpr std::size_t RESYNC_INTERVAL = 4096;
+
+    void checkPeriod(std::size_t period) {
+        if (period == 0) throw std::invalid_argument("Indicator period must be positive.");
+    }
+
+    // out[i] = a[i] - b[i]
+    void subtract(const double* a, const double* b, std::size_t n, double* out) {
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 4 <= n; i += 4) {
+            _mm256_storeu_pd(out + i, _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+        }
+#endif
+        for (; i < n; i++) out[i] = a[i] - b[i];
+    }
+
+    // out[i] = a[i] * b[i]
+    void multiply(const double* a, const double* b, std::size_t n, double* out) {
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 4 <= n; i += 4) {
+            _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+        }
+#endif
+        for (; i < n; i++) out[i] = a[i] * b[i];
+    }
+
+    // out[i] = a[i] / b[i]
+    void divide(const double* a, const double* b, std::size_t n, double* out) {
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 4 <= n; i += 4) {
+            _mm256_storeu_pd(out + i, _mm256_div_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+        }
+#endif
+        for (; i < n; i++) out[i] = a[i] / b[i];
+    }
+
+    // out[i] = sum of input[i - period + 1 .. i], NaN before the first full window.
+    // The lagged differences are computed in bulk; only the running add is serial.
+    void windowSums(const double* input, std::size_t n, std::size_t period, double* out) {
+        std::fill(out, out + std::min(n, period - 1), NaN);
+        if (n < period) return;
+
+        subtract(input + period, input, n - period, out + period);
+        double sum = 0.0;
+        for (std::size_t i = 0; i < period; i++) sum += input[i];
+        out[period - 1] = sum;
+        for (std::size_t i = period; i < n; i++) {
+            if (i % RESYNC_INTERVAL == 0) {
+                sum = 0.0;
+                for (std::size_t j = i + 1 - period; j <= i; j++) sum += input[j];
+            } else {
+                sum += out[i];
+            }
+            out[i] = sum;
+        }
+    }
+
+    // van Herk / Gil-Werman: per-block prefix and suffix extremes, then one
+    // elementwise combine per output, independent of the period.
+    template<typename Compare>
+    void rollingExtreme(const double* input, std::size_t n, std::size_t period, double* out) {
+        checkPeriod(period);
+        std::fill(out, out + std::min(n, period - 1), NaN);
+        if (n < period) return;
+
+        Compare better;
+        auto pick = [&](double a, double b) { return better(b, a) ? b : a; };
+        std::vector<double> prefix(n), suffix(n);
+        for (std::size_t start = 0; start < n; start += period) {
+            std::size_t end = std::min(start + period, n);
+            prefix[start] = input[start];
+            for (std::size_t i = start + 1; i < end; i++) prefix[i] = pick(prefix[i - 1], input[i]);
+            suffix[end - 1] = input[end - 1];
+            for (std::size_t i = end - 1; i > start; i--) suffix[i - 1] = pick(suffix[i], input[i - 1]);
+        }
+
+        const double* left = suffix.data();
+        const double* right = prefix.data() + period - 1;
+        double* result = out + period - 1;
+        const std::size_t count = n - period + 1;
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 4 <= count; i += 4) {
+            __m256d a = _mm256_loadu_pd(left + i);
+            __m256d b = _mm256_loadu_pd(right + i);
+            if constexpr (std::is_same_v<Compare, std::less<double>>) {
+                _mm256_storeu_pd(result + i, _mm256_min_pd(a, b));
+            } else {
+                _mm256_storeu_pd(result + i, _mm256_max_pd(a, b));
+            }
+        }
+#endif
+        for (; i < count; i++) result[i] = pick(left[i], right[i]);
+    }
+}
+
+SimpleMovingAverage::SimpleMovingAverage(std::size_t period) : window(period) {
+    checkPeriod(period);
+}
+
+double SimpleMovingAverage::update(double value) {
+    if (count == window.size()) sum -= window[next];
+    else count++;
+    window[next] = value;
+    sum += value;
+    next = (next + 1) % window.size();
+    if (next == 0) {
+        // Once per lap, re-sum exactly so rounding error cannot accumulate
+        sum = 0.0;
+        for (std::size_t i = 0; i < count; i++) sum += window[i];
+    }
+    return sum / count;
+}
+
+ExponentialMovingAverage::ExponentialMovingAverage(std::size_t period)
+    : alpha(2.0 / (static_cast<double>(period) + 1.0)), length(period) {
+    checkPeriod(period);
+}
+
+double ExponentialMovingAverage::update(double value) {
+    current = count == 0 ? value : current + alpha * (value - current);
+    count++;
+    return current;
+}
+
+RollingStdDev::RollingStdDev(std::size_t period) : window(period) {
+    checkPeriod(period);
+}
+
+double RollingStdDev::update(double value) {
+    if (count == window.size()) {
+        double old = window[next];
+        double oldMean = mean;
+        mean += (value - old) / count;
+        m2 += (value - old) * (value - mean + old - oldMean);
+    } else {
+        count++;
+        double delta = value - mean;
+        mean += delta / count;
+        m2 += delta * (value - mean);
+    }
+    window[next] = value;
+    next = (next + 1) % window.size();
+    return this->value();
+}
+
+double RollingStdDev::value() const {
+    if (count < 2) return 0.0;
+    return std::sqrt(std::max(m2, 0.0) / (count - 1));
+}
+
+RollingVWAP::RollingVWAP(std::size_t period) : prices(period), volumes(period) {
+    checkPeriod(period);
+}
+
+double RollingVWAP::update(double price, double quantity) {
+    if (count == prices.size()) {
+        notional -= prices[next] * volumes[next];
+        volume -= volumes[next];
+    } else {
+        count++;
+    }
+    prices[next] = price;
+    volumes[next] = quantity;
+    notional += price * quantity;
+    volume += quantity;
+    next = (next + 1) % prices.size();
+    return value();
+}
+
+namespace indicators {
+    void sma(const double* input, std::size_t n, std::size_t period, double* output) {
+        checkPeriod(period);
+        windowSums(input, n, period, output);
+        const double scale = 1.0 / period;
+        for (std::size_t i = period - 1; i < n; i++) output[i] *= scale;
+    }
+
+    void ema(const double* input, std::size_t n, std::size_t period, double* output) {
+        // The recurrence is inherently serial, so there is no vector path here
+        checkPeriod(period);
+        const double alpha = 2.0 / (static_cast<double>(period) + 1.0);
+        double current = n > 0 ? input[0] : 0.0;
+        for (std::size_t i = 0; i < n; i++) {
+            if (i > 0) current += alpha * (input[i] - current);
+            output[i] = i + 1 >= period ? current : NaN;
+        }
+    }
+
+    void rollingStdDev(const double* input, std::size_t n, std::size_t period, double* output) {
+        checkPeriod(period);
+        if (period < 2) {
+            std::fill(output, output + n, period == 1 ? 0.0 : NaN);
+            return;
+        }
+        if (n < period) {
+            std::fill(output, output + n, NaN);
+            return;
+        }
+
+        // Shift by the first sample so sum-of-squares does not cancel catastrophically
+        std::vector<double> shifted(n, input[0]), squares(n), sums(n);
+        subtract(input, shifted.data(), n, shifted.data());
+        multiply(shifted.data(), shifted.data(), n, squares.data());
+        windowSums(shifted.data(), n, period, sums.data());
+        windowSums(squares.data(), n, period, output);
+
+        std::fill(output, output + period - 1, NaN);
+        for (std::size_t i = period - 1; i < n; i++) {
+            double variance = (output[i] - sums[i] * sums[i] / period) / (period - 1);
+            output[i] = std::sqrt(std::max(variance, 0.0));
+        }
+    }
+
+    void rollingMin(const double* input, std::size_t n, std::size_t period, double* output) {
+        rollingExtreme<std::less<double>>(input, n, period, output);
+    }
+
+    void rollingMax(const double* input, std::size_t n, std::size_t period, double* output) {
+        rollingExtreme<std::greater<double>>(input, n, period, output);
+    }
+
+    void vwap(const double* prices, const double* volumes, std::size_t n, std::size_t period, double* output) {
+        checkPeriod(period);
+        std::vector<double> notional(n), notionalSums(n);
+        multiply(prices, volumes, n, notional.data());
+        windowSums(notional.data(), n, period, notionalSums.data());
+        windowSums(volumes, n, period, output);
+        if (n >= period) divide(notionalSums.data() + period - 1, output + period - 1, n - period + 1, output + period - 1);
+    }
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+// Rolling indicators with O(1) updates per sample, plus batch kernels that
+// compute the same series over a whole array. Batch outputs are NaN until the
+// window has filled; standard deviations are sample (n - 1) deviations.
+
+class SimpleMovingAverage {
+    private:
+        std::vector<double> window;
+        std::size_t next = 0;
+        std::size_t count = 0;
+        double sum = 0.0;
+
+    public:
+        explicit SimpleMovingAverage(std::size_t period);
+
+        double update(double value);
+        double value() const { return count == 0 ? 0.0 : sum / count; }
+        bool ready() const { return count == window.size(); }
+        std::size_t period() const { return window.size(); }
+};
+
+// Seeded with the first sample, alpha = 2 / (period + 1).
+class ExponentialMovingAverage {
+    private:
+        double alpha;
+        double current = 0.0;
+        std::size_t count = 0;
+        std::size_t length;
+
+    public:
+        explicit ExponentialMovingAverage(std::size_t period);
+
+        double update(double value);
+        double value() const { return current; }
+        bool ready() const { return count >= length; }
+};
+
+// Sliding-window Welford: the oldest sample is removed as the newest is added.
+class RollingStdDev {
+    private:
+        std::vector<double> window;
+        std::size_t next = 0;
+        std::size_t count = 0;
+        double mean = 0.0;
+        double m2 = 0.0;
+
+    public:
+        explicit RollingStdDev(std::size_t period);
+
+        double update(double value);
+        double value() const;
+        double average() const { return mean; }
+        bool ready() const { return count == window.size(); }
+};
+
+// Monotonic queue over a fixed ring: each sample is pushed and popped at most once.
+template<typename Compare>
+class RollingExtreme {
+    private:
+        struct Entry {
+            std::uint64_t index;
+            double value;
+        };
+
+        std::vector<Entry> ring;
+        std::size_t head = 0;
+        std::size_t size = 0;
+        std::uint64_t seen = 0;
+        std::size_t length;
+        Compare keep;
+
+    public:
+        explicit RollingExtreme(std::size_t period) : ring(period), length(period) {
+            if (period == 0) throw std::invalid_argument("Indicator period must be positive.");
+        }
+
+        double update(double value) {
+            // Expire the entry that leaves the window, then drop those the new sample dominates
+            if (size > 0 && ring[head].index + length <= seen) {
+                head = (head + 1) % length;
+                size--;
+            }
+            while (size > 0 && !keep(ring[(head + size - 1) % length].value, value)) size--;
+            ring[(head + size) % length] = {seen, value};
+            size++;
+            seen++;
+            return ring[head].value;
+        }
+
+        double value() const { return size == 0 ? 0.0 : ring[head].value; }
+        bool ready() const { return seen >= length; }
+};
+
+using RollingMin = RollingExtreme<std::less<double>>;
+using RollingMax = RollingExtreme<std::greater<double>>;
+
+class RollingVWAP {
+    private:
+        std::vector<double> prices;
+        std::vector<double> volumes;
+        std::size_t next = 0;
+        std::size_t count = 0;
+        double notional = 0.0;
+        double volume = 0.0;
+
+    public:
+        explicit RollingVWAP(std::size_t period);
+
+        double update(double price, double quantity);
+        double value() const { return volume == 0.0 ? 0.0 : notional / volume; }
+        bool ready() const { return count == prices.size(); }
+};
+
+namespace indicators {
+    void sma(const double* input, std::size_t n, std::size_t period, double* output);
+    void ema(const double* input, std::size_t n, std::size_t period, double* output);
+    void rollingStdDev(const double* input, std::size_t n, std::size_t period, double* output);
+    void rollingMin(const double* input, std::size_t n, std::size_t period, double* output);
+    void rollingMax(const double* input, std::size_t n, std::size_t period, double* output);
+    void vwap(const double* prices, const double* volumes, std::size_t n, std::size_t period, double* output);
+}
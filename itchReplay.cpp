@@ -0,0 +1,455 @@
+#include "itchReplay.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <random>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "limitOrder.h"
+
+namespace {
+    constexpr std::size_t LOCATES = 1 << 16;
+
+    std::uint16_t be16(const std::uint8_t* p) {
+        return static_cast<std::uint16_t>(p[0] << 8 | p[1]);
+    }
+
+    std::uint32_t be32(const std::uint8_t* p) {
+        std::uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return __builtin_bswap32(value);
+    }
+
+    std::uint64_t be48(const std::uint8_t* p) {
+        return static_cast<std::uint64_t>(be16(p)) << 32 | be32(p + 2);
+    }
+
+    std::uint64_t be64(const std::uint8_t* p) {
+        std::uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return __builtin_bswap64(value);
+    }
+
+    // 8-byte space-padded stock field
+    str stockName(const std::uint8_t* p) {
+        std::size_t length = 8;
+        while (length > 0 && p[length - 1] == ' ') length--;
+        return str(reinterpret_cast<const char*>(p), length);
+    }
+
+    // ITCH prices have four decimals, the book's two
+    Price toCents(std::uint32_t price) {
+        return std::max<Price>(1, price / 100);
+    }
+
+    std::size_t expectedLength(char type) {
+        switch (type) {
+            case 'R': return itch::STOCK_DIRECTORY_LENGTH;
+            case 'A': return itch::ADD_ORDER_LENGTH;
+            case 'F': return itch::ADD_ORDER_MPID_LENGTH;
+            case 'E': return itch::ORDER_EXECUTED_LENGTH;
+            case 'C': return itch::ORDER_EXECUTED_PRICE_LENGTH;
+            case 'X': return itch::ORDER_CANCEL_LENGTH;
+            case 'D': return itch::ORDER_DELETE_LENGTH;
+            case 'U': return itch::ORDER_REPLACE_LENGTH;
+            default: return itch::HEADER_LENGTH;
+        }
+    }
+}
+
+ItchReplay::ItchReplay(const str& path) : symbols(LOCATES), books(LOCATES) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open ITCH file " + path);
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot stat ITCH file " + path);
+    }
+    size = static_cast<std::size_t>(info.st_size);
+    if (size == 0) {
+        ::close(fd);
+        return;
+    }
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) throw std::runtime_error("Cannot map ITCH file " + path);
+    madvise(mapped, size, MADV_SEQUENTIAL);
+    data = static_cast<const std::uint8_t*>(mapped);
+
+    if (size >= 2 && data[0] == 0x1f && data[1] == 0x8b) {
+        munmap(mapped, size);
+        throw std::runtime_error("ITCH file is gzip-compressed, decompress it first: " + path);
+    }
+}
+
+ItchReplay::~ItchReplay() {
+    if (data) munmap(const_cast<std::uint8_t*>(data), size);
+}
+
+void ItchReplay::addLocate(std::uint16_t locate) {
+    if (wanted.empty()) wanted.resize(LOCATES);
+    wanted[locate] = 1;
+    filtering = true;
+}
+
+void ItchReplay::addSymbol(const str& symbol) {
+    if (wanted.empty()) wanted.resize(LOCATES);
+    wantedSymbols.push_back(symbol);
+    // The directory may already have gone past
+    if (auto it = locates.find(symbol); it != locates.end()) wanted[it->second] = 1;
+    filtering = true;
+}
+
+void ItchReplay::publishTrades(EventDispatcher& eventDispatcher, std::int64_t sessionDate) {
+    dispatcher = &eventDispatcher;
+    sessionDateMs = sessionDate;
+}
+
+std::size_t ItchReplay::step(std::size_t maxMessages) {
+    std::size_t read = 0;
+    while (read < maxMessages && cursor < size) {
+        if (cursor + 2 > size) throw std::runtime_error("Truncated ITCH file");
+        const std::size_t length = be16(data + cursor);
+        if (cursor + 2 + length > size) throw std::runtime_error("Truncated ITCH file");
+        apply(data + cursor + 2, length);
+        cursor += 2 + length;
+        read++;
+    }
+    return read;
+}
+
+std::size_t ItchReplay::runUntil(std::uint64_t nanosSinceMidnight) {
+    std::size_t read = 0;
+    while (cursor < size) {
+        // Peek at the timestamp; anything malformed is left for step() to report
+        if (cursor + 2 + itch::HEADER_LENGTH <= size && be16(data + cursor) >= itch::HEADER_LENGTH &&
+            be48(data + cursor + 2 + 5) > nanosSinceMidnight) break;
+        read += step(1);
+    }
+    return read;
+}
+
+void ItchReplay::apply(const std::uint8_t* message, std::size_t length) {
+    if (length == 0) throw std::runtime_error("Empty ITCH message");
+    const char type = static_cast<char>(message[0]);
+    if (length < expectedLength(type)) throw std::runtime_error(str("Short ITCH message of type ") + type);
+    counters.messages++;
+    clock = be48(message + 5);
+    const std::uint16_t locate = be16(message + 1);
+
+    if (type == 'R') {
+        symbols[locate] = stockName(message + 11);
+        locates[symbols[locate]] = locate;
+        if (std::find(wantedSymbols.begin(), wantedSymbols.end(), symbols[locate]) != wantedSymbols.end()) wanted[locate] = 1;
+        return;
+    }
+    if (type != 'A' && type != 'F' && type != 'E' && type != 'C' && type != 'X' && type != 'D' && type != 'U') return;
+    if (filtering && !wanted[locate]) {
+        counters.filtered++;
+        return;
+    }
+
+    const OrderID orderID = be64(message + 11);
+    if (type == 'A' || type == 'F') {
+        if (symbols[locate].empty()) {
+            symbols[locate] = stockName(message + 24);
+            locates[symbols[locate]] = locate;
+        }
+        addOrder(*bookFor(locate), locate, orderID, message[19] == 'B' ? Side::BUY : Side::SELL, be32(message + 20), be32(message + 32));
+        counters.applied++;
+        return;
+    }
+
+    // The rest refer to a resting order, so a locate without a book has nothing to apply
+    OrderBook* book = books[locate].get();
+    Order* order = book ? book->getOrder(orderID) : nullptr;
+    if (!order) {
+        counters.unknownOrders++;
+        return;
+    }
+    switch (type) {
+        case 'E':
+            execute(*book, locate, *order, be32(message + 19), std::nullopt, true);
+            break;
+        case 'C':
+            execute(*book, locate, *order, be32(message + 19), be32(message + 32), message[31] == 'Y');
+            break;
+        case 'X':
+            book->reduceOrderQuantity(orderID, std::min<Quantity>(be32(message + 19), order->getQuantity()));
+            break;
+        case 'D':
+            book->removeOrder(orderID);
+            break;
+        case 'U': {
+            // The replacement loses priority, so it is a delete and a fresh add
+            const Side side = order->getSide();
+            book->removeOrder(orderID);
+            addOrder(*book, locate, be64(message + 19), side, be32(message + 27), be32(message + 31));
+            break;
+        }
+    }
+    counters.applied++;
+}
+
+OrderBook* ItchReplay::bookFor(std::uint16_t locate) {
+    if (!books[locate]) books[locate] = std::make_unique<OrderBook>();
+    return books[locate].get();
+}
+
+void ItchReplay::addOrder(OrderBook& book, std::uint16_t locate, OrderID orderID, Side side, Quantity shares, std::uint32_t price) {
+    if (shares == 0) return;
+    book.addOrder(std::make_unique<LimitOrder>(symbols[locate], orderID, OrderType::LIMIT, side, toCents(price), shares, 0));
+}
+
+void ItchReplay::execute(OrderBook& book, std::uint16_t locate, Order& order, Quantity shares, std::optional<std::uint32_t> price,
+                         bool printable) {
+    const OrderID orderID = order.getOrderID();
+    const Side side = order.getSide();
+    const Price restingPrice = static_cast<LimitOrder&>(order).getPrice();
+    const Quantity executed = std::min(shares, order.getQuantity());
+    const Quantity remaining = order.getQuantity() - executed;
+    book.reduceOrderQuantity(orderID, executed);
+
+    if (dispatcher && printable) {
+        TradeExecutedEvent event{symbols[locate], price ? toCents(*price) : restingPrice, executed,
+                                 0, 0, getOppositeSide(side), 0, orderID, 0, remaining};
+        event.timestamp = Timestamp(std::chrono::milliseconds(sessionDateMs + static_cast<std::int64_t>(clock / 1'000'000)));
+        dispatcher->publish(event);
+    }
+}
+
+std::size_t ItchReplay::bookCount() const {
+    return static_cast<std::size_t>(std::count_if(books.begin(), books.end(), [](const auto& book) { return book != nullptr; }));
+}
+
+OrderBook* ItchReplay::getBook(std::uint16_t locate) {
+    return books[locate].get();
+}
+
+OrderBook* ItchReplay::getBook(const str& symbol) {
+    auto it = locates.find(symbol);
+    return it != locates.end() ? books[it->second].get() : nullptr;
+}
+
+const str& ItchReplay::getSymbol(std::uint16_t locate) const {
+    return symbols[locate];
+}
+
+namespace {
+    void putBE(str& buffer, std::uint64_t value, int bytes) {
+        for (int i = bytes - 1; i >= 0; --i) buffer.push_back(static_cast<char>(value >> (8 * i)));
+    }
+
+    void putStock(str& buffer, const str& symbol) {
+        str padded = symbol.substr(0, 8);
+        padded.resize(8, ' ');
+        buffer += padded;
+    }
+}
+
+ItchWriter::ItchWriter(const str& path) : file(path, std::ios::binary | std::ios::trunc) {
+    if (!file) throw std::runtime_error("Cannot create ITCH file " + path);
+}
+
+void ItchWriter::header(char type, std::uint16_t locate, std::uint64_t timestamp) {
+    buffer.clear();
+    buffer.push_back(type);
+    putBE(buffer, locate, 2);
+    putBE(buffer, 0, 2);
+    putBE(buffer, timestamp, 6);
+}
+
+void ItchWriter::flushMessage() {
+    char length[2] = {static_cast<char>(buffer.size() >> 8), static_cast<char>(buffer.size())};
+    file.write(length, 2);
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
+void ItchWriter::systemEvent(std::uint64_t timestamp, char code) {
+    header('S', 0, timestamp);
+    buffer.push_back(code);
+    flushMessage();
+}
+
+void ItchWriter::stockDirectory(std::uint16_t locate, std::uint64_t timestamp, const str& symbol) {
+    header('R', locate, timestamp);
+    putStock(buffer, symbol);
+    buffer.push_back('Q');              // market category
+    buffer.push_back('N');              // financial status
+    putBE(buffer, 100, 4);              // round lot size
+    buffer.push_back('N');              // round lots only
+    buffer.push_back('C');              // issue classification
+    buffer += "Z ";                     // issue sub-type
+    buffer.push_back('P');              // authenticity
+    buffer.push_back('N');              // short sale threshold
+    buffer.push_back(' ');              // IPO flag
+    buffer.push_back('1');              // LULD reference price tier
+    buffer.push_back('N');              // ETP flag
+    putBE(buffer, 0, 4);                // ETP leverage factor
+    buffer.push_back('N');              // inverse indicator
+    flushMessage();
+}
+
+void ItchWriter::addOrder(std::uint16_t locate, std::uint64_t timestamp, OrderID orderID, Side side, Quantity shares, const str& symbol,
+                          Price price, bool attributed) {
+    header(attributed ? 'F' : 'A', locate, timestamp);
+    putBE(buffer, orderID, 8);
+    buffer.push_back(side == Side::BUY ? 'B' : 'S');
+    putBE(buffer, shares, 4);
+    putStock(buffer, symbol);
+    putBE(buffer, static_cast<std::uint64_t>(price) * 100, 4);
+    if (attributed) buffer += "SYNT";
+    flushMessage();
+}
+
+void ItchWriter::orderExecuted(std::uint16_t locate, std::uint64_t timestamp, OrderID orderID, Quantity shares, std::uint64_t matchNumber) {
+    header('E', locate, timestamp);
+    putBE(buffer, orderID, 8);
+    putBE(buffer, shares, 4);
+    putBE(buffer, matchNumber, 8);
+    flushMessage();
+}
+
+void ItchWriter::orderExecutedWithPrice(std::uint16_t locate, std::uint64_t timestamp, OrderID orderID, Quantity shares,
+                                        std::uint64_t matchNumber, Price price, bool printable) {
+    header('C', locate, timestamp);
+    putBE(buffer, orderID, 8);
+    putBE(buffer, shares, 4);
+    putBE(buffer, matchNumber, 8);
+    buffer.push_back(printable ? 'Y' : 'N');
+    putBE(buffer, static_cast<std::uint64_t>(price) * 100, 4);
+    flushMessage();
+}
+
+void ItchWriter::orderCancel(std::uint16_t locate, std::uint64_t timestamp, OrderID orderID, Quantity shares) {
+    header('X', locate, timestamp);
+    putBE(buffer, orderID, 8);
+    putBE(buffer, shares, 4);
+    flushMessage();
+}
+
+void ItchWriter::orderDelete(std::uint16_t locate, std::uint64_t timestamp, OrderID orderID) {
+    header('D', locate, timestamp);
+    putBE(buffer, orderID, 8);
+    flushMessage();
+}
+
+void ItchWriter::orderReplace(std::uint16_t locate, std::uint64_t timestamp, OrderID orderID, OrderID newOrderID, Quantity shares, Price price) {
+    header('U', locate, timestamp);
+    putBE(buffer, orderID, 8);
+    putBE(buffer, newOrderID, 8);
+    putBE(buffer, shares, 4);
+    putBE(buffer, static_cast<std::uint64_t>(price) * 100, 4);
+    flushMessage();
+}
+
+void ItchWriter::trade(std::uint16_t locate, std::uint64_t timestamp, Side side, Quantity shares, const str& symbol, Price price,
+                       std::uint64_t matchNumber) {
+    header('P', locate, timestamp);
+    putBE(buffer, 0, 8);
+    buffer.push_back(side == Side::BUY ? 'B' : 'S');
+    putBE(buffer, shares, 4);
+    putStock(buffer, symbol);
+    putBE(buffer, static_cast<std::uint64_t>(price) * 100, 4);
+    putBE(buffer, matchNumber, 8);
+    flushMessage();
+}
+
+void ItchWriter::close() {
+    file.close();
+}
+
+std::size_t synthesizeItch(const str& path, std::size_t messages, std::uint16_t stocks, std::uint64_t seed) {
+    if (stocks == 0) throw std::invalid_argument("Need at least one stock.");
+    struct Live {
+        OrderID orderID;
+        std::uint16_t locate;
+        Side side;
+        Quantity shares;
+    };
+
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::geometric_distribution<int> depth(0.3);
+    ItchWriter writer(path);
+
+    constexpr std::uint64_t open = 34'200'000'000'000;      // 9:30
+    constexpr std::uint64_t session = 23'400'000'000'000;   // 6.5 hours
+    const std::uint64_t spacing = std::max<std::uint64_t>(1, session / std::max<std::size_t>(messages, 1));
+    std::uint64_t now = open;
+
+    std::vector<str> names;
+    std::vector<Price> mids;
+    writer.systemEvent(now, 'O');
+    for (std::uint16_t i = 0; i < stocks; ++i) {
+        str name = std::to_string(i + 1);
+        names.push_back("STK" + str(4 - std::min<std::size_t>(4, name.size()), '0') + name);
+        mids.push_back(static_cast<Price>(1000 + rng() % 50000));
+        writer.stockDirectory(static_cast<std::uint16_t>(i + 1), now, names.back());
+    }
+    std::size_t written = 1 + stocks;
+
+    std::vector<Live> live;
+    OrderID nextOrderID = 1;
+    std::uint64_t match = 1;
+    for (; written < messages; ++written) {
+        now += spacing;
+        const double r = uniform(rng);
+        // Adds outnumber removals until each stock rests about 200 orders, as in a real book
+        if (live.empty() || r < (live.size() < 200u * stocks ? 0.55 : 0.45)) {
+            const std::uint16_t index = static_cast<std::uint16_t>(rng() % stocks);
+            Price& mid = mids[index];
+            if (uniform(rng) < 0.05) mid = std::max<Price>(10, mid + static_cast<Price>(rng() % 3) - 1);
+            const Side side = uniform(rng) < 0.5 ? Side::BUY : Side::SELL;
+            const Price offset = 1 + static_cast<Price>(depth(rng));
+            const Price price = side == Side::BUY ? std::max<Price>(1, mid - offset) : mid + offset;
+            const Quantity shares = 100 * (1 + static_cast<Quantity>(rng() % 10));
+            writer.addOrder(static_cast<std::uint16_t>(index + 1), now, nextOrderID, side, shares, names[index], price, uniform(rng) < 0.1);
+            live.push_back({nextOrderID++, static_cast<std::uint16_t>(index + 1), side, shares});
+            continue;
+        }
+
+        // Most activity is on recently added orders, like quotes being refreshed
+        const std::size_t recent = std::min<std::size_t>(live.size(), 1024);
+        const std::size_t pick = uniform(rng) < 0.8 ? live.size() - 1 - rng() % recent : rng() % live.size();
+        Live& order = live[pick];
+        bool gone = false;
+        if (r < 0.55) {
+            const Quantity shares = std::min<Quantity>(order.shares, 100 * (1 + static_cast<Quantity>(rng() % 3)));
+            if (uniform(rng) < 0.2) writer.orderExecutedWithPrice(order.locate, now, order.orderID, shares, match++, mids[order.locate - 1]);
+            else writer.orderExecuted(order.locate, now, order.orderID, shares, match++);
+            order.shares -= shares;
+            gone = order.shares == 0;
+        }
+        else if (r < 0.65) {
+            const Quantity shares = std::min<Quantity>(order.shares, 100);
+            writer.orderCancel(order.locate, now, order.orderID, shares);
+            order.shares -= shares;
+            gone = order.shares == 0;
+        }
+        else if (r < 0.90) {
+            writer.orderDelete(order.locate, now, order.orderID);
+            gone = true;
+        }
+        else if (r < 0.97) {
+            const Price mid = mids[order.locate - 1];
+            const Price offset = 1 + static_cast<Price>(depth(rng));
+            const Price price = order.side == Side::BUY ? std::max<Price>(1, mid - offset) : mid + offset;
+            const Quantity shares = 100 * (1 + static_cast<Quantity>(rng() % 10));
+            writer.orderReplace(order.locate, now, order.orderID, nextOrderID, shares, price);
+            order.orderID = nextOrderID++;
+            order.shares = shares;
+        }
+        else {
+            writer.trade(order.locate, now, Side::BUY, 100, names[order.locate - 1], mids[order.locate - 1], match++);
+        }
+        if (gone) {
+            live[pick] = live.back();
+            live.pop_back();
+        }
+    }
+    writer.close();
+    return live.size();
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include "eventDispatcher.h"
+#include "events.h"
+#include "orderBook.h"
+#include "types.h"
+
+// NASDAQ TotalView-ITCH 5.0 as distributed in the historical files: each
+// message is preceded by a 2-byte big-endian length. All fields are
+// big-endian, timestamps are 6-byte nanoseconds since midnight and prices
+// carry four implied decimals.
+namespace itch {
+    constexpr std::size_t HEADER_LENGTH = 11;   // type, stock locate, tracking number, timestamp
+
+    constexpr std::size_t SYSTEM_EVENT_LENGTH = 12;
+    constexpr std::size_t STOCK_DIRECTORY_LENGTH = 39;
+    constexpr std::size_t ADD_ORDER_LENGTH = 36;
+    constexpr std::size_t ADD_ORDER_MPID_LENGTH = 40;
+    constexpr std::size_t ORDER_EXECUTED_LENGTH = 31;
+    constexpr std::size_t ORDER_EXECUTED_PRICE_LENGTH = 36;
+    constexpr std::size_t ORDER_CANCEL_LENGTH = 23;
+    constexpr std::size_t ORDER_DELETE_LENGTH = 19;
+    constexpr std::size_t ORDER_REPLACE_LENGTH = 35;
+    constexpr std::size_t TRADE_LENGTH = 44;
+}
+
+struct ItchStats {
+    std::uint64_t messages = 0;         // every message read
+    std::uint64_t applied = 0;          // order messages applied to a book
+    std::uint64_t filtered = 0;         // order messages for stocks not being replayed
+    std::uint64_t unknownOrders = 0;    // referenced an order no book holds, e.g. after starting mid-day
+};
+
+// Replays an uncompressed ITCH 5.0 capture into one OrderBook per stock.
+// The file is memory-mapped and decoded in place, so decoding costs no
+// allocation, though every order added to a book is allocated like any
+// other; add, execute, cancel, delete and replace messages are applied to
+// the book of their stock locate and everything else is skipped by its
+// length. ITCH order reference numbers become the books' order ids. Prices
+// are truncated to cents, and sub-penny prices round up to one cent.
+// Single-threaded.
+class ItchReplay {
+    private:
+        const std::uint8_t* data = nullptr;
+        std::size_t size = 0;
+        std::size_t cursor = 0;
+
+        // Indexed by stock locate. With a filter, `wanted` marks the locates
+        // to replay; symbols are resolved as the stock directory arrives.
+        bool filtering = false;
+        std::vector<std::uint8_t> wanted;
+        std::vector<str> wantedSymbols;
+        std::vector<str> symbols;
+        std::unordered_map<str, std::uint16_t> locates;
+        std::vector<std::unique_ptr<OrderBook>> books;
+
+        EventDispatcher* dispatcher = nullptr;
+        std::int64_t sessionDateMs = 0;
+        std::uint64_t clock = 0;
+        ItchStats counters;
+
+        OrderBook* bookFor(std::uint16_t locate);
+        void apply(const std::uint8_t* message, std::size_t length);
+        void addOrder(OrderBook& book, std::uint16_t locate, OrderID orderID, Side side, Quantity shares, std::uint32_t price);
+        void execute(OrderBook& book, std::uint16_t locate, Order& order, Quantity shares, std::optional<std::uint32_t> price, bool printable);
+
+    public:
+        explicit ItchReplay(const str& path);
+        ~ItchReplay();
+        ItchReplay(const ItchReplay&) = delete;
+        ItchReplay& operator=(const ItchReplay&) = delete;
+
+        // Restrict the replay to these stocks; without either, every stock is replayed.
+        void addLocate(std::uint16_t locate);
+        void addSymbol(const str& symbol);
+
+        // Publish executions as TradeExecutedEvents, resting side from the book
+        // and aggressor ids 0. `sessionDateMs` is midnight of the capture's day.
+        void publishTrades(EventDispatcher& dispatcher, std::int64_t sessionDateMs);
+
+        // Decodes and applies up to `maxMessages`; returns how many were read.
+        // Throws std::runtime_error on a truncated or malformed message.
+        std::size_t step(std::size_t maxMessages = std::numeric_limits<std::size_t>::max());
+        // Applies every message stamped at or before `nanosSinceMidnight`.
+        std::size_t runUntil(std::uint64_t nanosSinceMidnight);
+        bool done() const { return cursor >= size; }
+
+        // Nanoseconds since midnight of the last message read.
+        std::uint64_t currentTime() const { return clock; }
+        const ItchStats& stats() const { return counters; }
+        std::size_t bookCount() const;
+
+        // nullptr until the stock's first order arrives.
+        OrderBook* getBook(std::uint16_t locate);
+        OrderBook* getBook(const str& symbol);
+        // Empty until the stock directory message for the locate has been read.
+        const str& getSymbol(std::uint16_t locate) const;
+};
+
+// Encodes ITCH 5.0 messages with their length prefixes, for synthetic
+// captures in tests and benchmarks. Prices are in cents.
+class ItchWriter {
+    private:
+        std::ofstream file;
+        str buffer;
+
+        void header(char type, std::uint16_t locate, std::uint64_t timestamp);
+        void flushMessage();
+
+    public:
+        explicit ItchWriter(const str& path);
+
+        void systemEvent(std::uint64_t timestamp, char code);
+        void stockDirectory(std::uint16_t locate, std::uint64_t timestamp, const str& symbol);
+        void addOrder(std::uint16_t locate, std::uint64_t timestamp, OrderID orderID, Side side, Quantity shares, const str& symbol, Price price,
+                      bool attributed = false);
+        void orderExecuted(std::uint16_t locate, std::uint64_t timestamp, OrderID orderID, Quantity shares, std::uint64_t matchNumber);
+        void orderExecutedWithPrice(std::uint16_t locate, std::uint64_t timestamp, OrderID orderID, Quantity shares, std::uint64_t matchNumber,
+                                    Price price, bool printable = true);
+        void orderCancel(std::uint16_t locate, std::uint64_t timestamp, OrderID orderID, Quantity shares);
+        void orderDelete(std::uint16_t locate, std::uint64_t timestamp, OrderID orderID);
+        void orderReplace(std::uint16_t locate, std::uint64_t timestamp, OrderID orderID, OrderID newOrderID, Quantity shares, Price price);
+        // Non-displayed trade; replays skip it.
+        void trade(std::uint16_t locate, std::uint64_t timestamp, Side side, Quantity shares, const str& symbol, Price price, std::uint64_t matchNumber);
+        void close();
+};
+
+// Writes a session of `messages` messages over `stocks` symbols (STK0001,
+// ...) with a consistent random mix of adds, executions, cancels, deletes and
+// replaces around a drifting mid. Returns how many orders are left resting.
+std::size_t synthesizeItch(const str& path, std::size_t messages, std::uint16_t stocks, std::uint64_t seed = 1);
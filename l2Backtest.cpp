@@ -0,0 +1,146 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include "l2Replay.h"
+#include "eventDispatcher.h"
+#include "events.h"
+
+// Usage:
+//   l2_backtest [--file L2.csv | --synthetic N] [--seed S] [--quote-size Q] [--max-position P]
+//
+// Replays a day of L2 updates for one symbol (see loadL2Csv for the format)
+// against a market maker that keeps one order joined at the best bid and one
+// at the best ask, and reports replay throughput and the fills the queue
+// model gave it. Without --file a synthetic session of N events is generated.
+namespace {
+    std::vector<L2Event> synthesize(std::size_t count, std::uint64_t seed) {
+        std::mt19937_64 rng(seed);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        std::uniform_int_distribution<Quantity> size(100, 1000);
+        std::uniform_int_distribution<Quantity> printSize(1, 200);
+        std::geometric_distribution<int> depth(0.4);
+
+        constexpr std::int64_t sessionStart = 1'700'000'000'000'000'000;
+        constexpr std::int64_t sessionLength = 23'400'000'000'000;   // 6.5 hours
+        const std::int64_t spacing = std::max<std::int64_t>(1, sessionLength / static_cast<std::int64_t>(count));
+
+        std::vector<L2Event> events;
+        events.reserve(count + 2);
+        std::int64_t now = sessionStart;
+        Price mid = 10000;
+        auto book = [&](Side side, Price price, Quantity quantity) { events.push_back({now, L2EventType::BOOK, side, price, quantity}); };
+
+        for (int level = 0; level < 10; ++level) {
+            book(Side::BUY, mid - 1 - level, size(rng));
+            book(Side::SELL, mid + 1 + level, size(rng));
+        }
+        while (events.size() < count) {
+            now += spacing;
+            const double r = uniform(rng);
+            if (r < 0.10) {
+                const Side aggressor = uniform(rng) < 0.5 ? Side::BUY : Side::SELL;
+                const Price touch = aggressor == Side::BUY ? mid + 1 : mid - 1;
+                events.push_back({now, L2EventType::TRADE, aggressor, touch, printSize(rng)});
+                book(getOppositeSide(aggressor), touch, size(rng));
+            }
+            else if (r < 0.13) {
+                // The mid ticks and the level it moves onto clears
+                if (uniform(rng) < 0.5) {
+                    book(Side::SELL, mid + 1, 0);
+                    mid++;
+                }
+                else {
+                    book(Side::BUY, mid - 1, 0);
+                    mid--;
+                }
+                book(Side::BUY, mid - 1, size(rng));
+                book(Side::SELL, mid + 1, size(rng));
+            }
+            else {
+                const Side side = uniform(rng) < 0.5 ? Side::BUY : Side::SELL;
+                const Price offset = 1 + static_cast<Price>(std::min(depth(rng), 9));
+                book(side, side == Side::BUY ? mid - offset : mid + offset, uniform(rng) < 0.1 ? 0 : size(rng));
+            }
+        }
+        return events;
+    }
+}
+
+int main(int argc, char** argv) {
+    str path;
+    std::size_t synthetic = 5'000'000;
+    std::uint64_t seed = 42;
+    Quantity quoteSize = 100;
+    std::int64_t maxPosition = 1000;
+
+    for (int i = 1; i < argc; ++i) {
+        str arg = argv[i];
+        auto value = [&]() -> str {
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << std::endl;
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+        if (arg == "--file") path = value();
+        else if (arg == "--synthetic") synthetic = std::stoull(value());
+        else if (arg == "--seed") seed = std::stoull(value());
+        else if (arg == "--quote-size") quoteSize = static_cast<Quantity>(std::stoul(value()));
+        else if (arg == "--max-position") maxPosition = std::stoll(value());
+        else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<L2Event> events = path.empty() ? synthesize(synthetic, seed) : loadL2Csv(path);
+    const std::size_t eventCount = events.size();
+
+    constexpr TraderID traderID = 1;
+    EventDispatcher dispatcher;
+    std::int64_t position = 0;
+    std::uint64_t fills = 0, volume = 0;
+    double cash = 0.0;
+    dispatcher.subscribe<TradeExecutedEvent>([&](const TradeExecutedEvent& e) {
+        const Side side = e.aggressingTraderID == traderID ? e.aggressingSide : getOppositeSide(e.aggressingSide);
+        const std::int64_t signedQuantity = side == Side::BUY ? e.quantity : -static_cast<std::int64_t>(e.quantity);
+        position += signedQuantity;
+        cash -= signedQuantity * (e.price / 100.0);
+        fills++;
+        volume += e.quantity;
+    });
+
+    L2Replay replay(dispatcher, "SYNTH", traderID, std::move(events));
+    OrderID bidID = 0, askID = 0;
+    Price bidPrice = 0, askPrice = 0;
+
+    // Re-join the touch whenever it moves or a quote has filled
+    auto requote = [&](Side side, OrderID& id, Price& quoted) {
+        std::optional<L2Level> best = replay.getBook().best(side);
+        const bool live = id != 0 && replay.getOrder(id).has_value();
+        const bool allowed = side == Side::BUY ? position < maxPosition : position > -maxPosition;
+        if (live && best && best->price == quoted && allowed) return;
+        if (live) replay.cancel(id);
+        id = 0;
+        if (best && allowed) {
+            quoted = best->price;
+            id = replay.submitLimit(side, quoted, quoteSize);
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    while (replay.step()) {
+        requote(Side::BUY, bidID, bidPrice);
+        requote(Side::SELL, askID, askPrice);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::optional<L2Level> lastBid = replay.getBook().best(Side::BUY);
+    const double mark = lastBid ? lastBid->price / 100.0 : 0.0;
+    std::cout << "Replayed " << eventCount << " L2 events in " << seconds << " s (" << eventCount / seconds << " events/s)\n"
+              << "Fills: " << fills << ", volume " << volume << ", position " << position
+              << ", marked P&L " << cash + position * mark << std::endl;
+    return 0;
+}
@@ -0,0 +1,290 @@
+#include "l2Replay.h"
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    template<typename Before>
+    std::vector<L2Level>::iterator findLevel(std::vector<L2Level>& levels, Price price, Before before) {
+        return std::lower_bound(levels.begin(), levels.end(), price, [&](const L2Level& level, Price p) { return before(level.price, p); });
+    }
+
+    template<typename Before>
+    Quantity setLevel(std::vector<L2Level>& levels, Price price, Quantity quantity, Before before) {
+        auto it = findLevel(levels, price, before);
+        if (it != levels.end() && it->price == price) {
+            const Quantity previous = it->quantity;
+            if (quantity == 0) levels.erase(it);
+            else it->quantity = quantity;
+            return previous;
+        }
+        if (quantity != 0) levels.insert(it, L2Level{price, quantity});
+        return 0;
+    }
+
+    template<typename Before>
+    Quantity levelQuantity(const std::vector<L2Level>& levels, Price price, Before before) {
+        auto it = std::lower_bound(levels.begin(), levels.end(), price, [&](const L2Level& level, Price p) { return before(level.price, p); });
+        return (it != levels.end() && it->price == price) ? it->quantity : 0;
+    }
+
+    // Splits the next comma-separated field off `line`
+    std::string_view nextField(std::string_view& line) {
+        std::size_t comma = line.find(',');
+        std::string_view field = line.substr(0, comma);
+        line = comma == std::string_view::npos ? std::string_view() : line.substr(comma + 1);
+        return field;
+    }
+
+    template<typename T>
+    bool parseInteger(std::string_view field, T& value) {
+        auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), value);
+        return error == std::errc() && end == field.data() + field.size();
+    }
+
+    bool parsePrice(std::string_view field, Price& price) {
+        std::size_t dot = field.find('.');
+        Price dollars = 0, cents = 0;
+        if (!parseInteger(field.substr(0, dot), dollars)) return false;
+        if (dot != std::string_view::npos) {
+            std::string_view fraction = field.substr(dot + 1);
+            if (fraction.empty() || fraction.size() > 2 || !parseInteger(fraction, cents)) return false;
+            if (fraction.size() == 1) cents *= 10;
+        }
+        price = dollars * 100 + cents;
+        return true;
+    }
+}
+
+std::vector<L2Event> loadL2Csv(const str& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) throw std::runtime_error("Cannot open L2 file " + path);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const str contents = buffer.str();
+
+    std::vector<L2Event> events;
+    std::string_view remaining(contents);
+    std::size_t lineNumber = 0;
+    while (!remaining.empty()) {
+        std::size_t newline = remaining.find('\n');
+        std::string_view line = remaining.substr(0, newline);
+        remaining = newline == std::string_view::npos ? std::string_view() : remaining.substr(newline + 1);
+        lineNumber++;
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.empty()) continue;
+
+        std::string_view timestamp = nextField(line), type = nextField(line), side = nextField(line);
+        std::string_view price = nextField(line), quantity = nextField(line);
+        L2Event event{};
+        const bool valid = parseInteger(timestamp, event.timestamp) && type.size() == 1 && side.size() == 1 &&
+                           (type[0] == 'B' || type[0] == 'T') && (side[0] == 'B' || side[0] == 'S') &&
+                           parsePrice(price, event.price) && parseInteger(quantity, event.quantity) && line.empty();
+        if (!valid) {
+            if (lineNumber == 1) continue;   // header
+            throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": malformed L2 event");
+        }
+        event.type = type[0] == 'B' ? L2EventType::BOOK : L2EventType::TRADE;
+        event.side = side[0] == 'B' ? Side::BUY : Side::SELL;
+        events.push_back(event);
+    }
+    return events;
+}
+
+Quantity L2Book::set(Side side, Price price, Quantity quantity) {
+    if (side == Side::BUY) return setLevel(bids, price, quantity, std::less<Price>());
+    return setLevel(asks, price, quantity, std::greater<Price>());
+}
+
+Quantity L2Book::quantityAt(Side side, Price price) const {
+    if (side == Side::BUY) return levelQuantity(bids, price, std::less<Price>());
+    return levelQuantity(asks, price, std::greater<Price>());
+}
+
+std::optional<L2Level> L2Book::best(Side side) const {
+    const std::vector<L2Level>& book = levels(side);
+    if (book.empty()) return std::nullopt;
+    return book.back();
+}
+
+void L2Book::clear() {
+    bids.clear();
+    asks.clear();
+}
+
+L2Replay::L2Replay(EventDispatcher& dispatcher, str symbol, TraderID traderID, std::vector<L2Event> events)
+    : dispatcher(dispatcher), symbol(std::move(symbol)), traderID(traderID), events(std::move(events)) {}
+
+bool L2Replay::step() {
+    if (cursor == events.size()) return false;
+    apply(events[cursor++]);
+    return true;
+}
+
+std::size_t L2Replay::runUntil(std::int64_t timestamp) {
+    std::size_t applied = 0;
+    while (cursor < events.size() && events[cursor].timestamp <= timestamp) {
+        apply(events[cursor++]);
+        applied++;
+    }
+    return applied;
+}
+
+std::size_t L2Replay::run() {
+    std::size_t applied = events.size() - cursor;
+    while (cursor < events.size()) apply(events[cursor++]);
+    return applied;
+}
+
+void L2Replay::apply(const L2Event& event) {
+    now = event.timestamp;
+    if (event.type == L2EventType::BOOK) onBookUpdate(event);
+    else onTrade(event);
+    removeFilled();
+    publishFills();
+}
+
+void L2Replay::onBookUpdate(const L2Event& event) {
+    const Quantity previous = book.set(event.side, event.price, event.quantity);
+    if (event.quantity < previous) {
+        // Cancels are assumed to come from ahead of and behind each order in proportion
+        const std::uint64_t decrease = previous - event.quantity;
+        for (SimOrder& order : orders) {
+            if (order.side != event.side || order.price != event.price) continue;
+            order.queueAhead -= static_cast<Quantity>(decrease * order.queueAhead / previous);
+            order.queueAhead = std::min(order.queueAhead, event.quantity);
+        }
+    }
+    fillCrossedOrders();
+}
+
+void L2Replay::onTrade(const L2Event& event) {
+    const Side restingSide = getOppositeSide(event.side);
+    Quantity filledAtPrice = 0;
+    for (SimOrder& order : orders) {
+        if (order.side != restingSide || order.remaining == 0) continue;
+        const bool through = restingSide == Side::BUY ? event.price < order.price : event.price > order.price;
+        if (through) {
+            fill(order, order.price, order.remaining, false);
+            continue;
+        }
+        if (order.price != event.price) continue;
+
+        const Quantity ahead = std::min(order.queueAhead, event.quantity);
+        order.queueAhead -= ahead;
+        const Quantity available = event.quantity - ahead;
+        if (available > filledAtPrice) {
+            const Quantity quantity = std::min(available - filledAtPrice, order.remaining);
+            filledAtPrice += quantity;
+            fill(order, order.price, quantity, false);
+        }
+    }
+
+    // Take the print out of the level so the book update that follows it is not read as cancels
+    const Quantity displayed = book.quantityAt(restingSide, event.price);
+    if (displayed > 0) book.set(restingSide, event.price, displayed > event.quantity ? displayed - event.quantity : 0);
+}
+
+void L2Replay::fillCrossedOrders() {
+    const std::optional<L2Level> bestBid = book.best(Side::BUY);
+    const std::optional<L2Level> bestAsk = book.best(Side::SELL);
+    for (SimOrder& order : orders) {
+        if (order.remaining == 0) continue;
+        const bool crossed = order.side == Side::BUY ? (bestAsk && bestAsk->price <= order.price)
+                                                     : (bestBid && bestBid->price >= order.price);
+        if (crossed) fill(order, order.price, order.remaining, false);
+    }
+}
+
+void L2Replay::take(SimOrder& order, std::optional<Price> limit) {
+    const Side opposite = getOppositeSide(order.side);
+    while (order.remaining > 0) {
+        std::optional<L2Level> level = book.best(opposite);
+        if (!level) break;
+        if (limit && (order.side == Side::BUY ? level->price > *limit : level->price < *limit)) break;
+        const Quantity quantity = std::min(order.remaining, level->quantity);
+        book.set(opposite, level->price, level->quantity - quantity);
+        fill(order, level->price, quantity, true);
+    }
+}
+
+void L2Replay::fill(SimOrder& order, Price price, Quantity quantity, bool aggressor) {
+    order.remaining -= quantity;
+
+    TradeExecutedEvent trade;
+    trade.symbol = symbol;
+    trade.price = price;
+    trade.quantity = quantity;
+    if (aggressor) {
+        trade.aggressingOrderID = order.orderID;
+        trade.aggressingTraderID = traderID;
+        trade.aggressingSide = order.side;
+        trade.aggressingRemainingQuantity = order.remaining;
+        trade.restingOrderID = 0;
+        trade.restingTraderID = 0;
+        trade.restingRemainingQuantity = 0;
+    }
+    else {
+        trade.aggressingOrderID = 0;
+        trade.aggressingTraderID = 0;
+        trade.aggressingSide = getOppositeSide(order.side);
+        trade.aggressingRemainingQuantity = 0;
+        trade.restingOrderID = order.orderID;
+        trade.restingTraderID = traderID;
+        trade.restingRemainingQuantity = order.remaining;
+    }
+    trade.timestamp = Timestamp(std::chrono::milliseconds(now / 1'000'000));
+    fills.push_back(trade);
+}
+
+void L2Replay::publishFills() {
+    // Fills a callback causes are appended and published by the outer call
+    if (publishing) return;
+    publishing = true;
+    for (std::size_t i = 0; i < fills.size(); i++) {
+        const TradeExecutedEvent trade = fills[i];
+        dispatcher.publish(trade);
+    }
+    fills.clear();
+    publishing = false;
+}
+
+void L2Replay::removeFilled() {
+    std::erase_if(orders, [](const SimOrder& order) { return order.remaining == 0; });
+}
+
+OrderID L2Replay::submitLimit(Side side, Price price, Quantity quantity) {
+    if (price == 0 || quantity == 0) throw std::invalid_argument("Price and quantity must be positive.");
+    SimOrder order{nextOrderID++, side, price, quantity, quantity, 0};
+    take(order, price);
+    if (order.remaining > 0) {
+        order.queueAhead = book.quantityAt(side, price);
+        orders.push_back(order);
+    }
+    publishFills();
+    return order.orderID;
+}
+
+OrderID L2Replay::submitMarket(Side side, Quantity quantity) {
+    if (quantity == 0) throw std::invalid_argument("Quantity must be positive.");
+    SimOrder order{nextOrderID++, side, 0, quantity, quantity, 0};
+    take(order, std::nullopt);
+    publishFills();
+    return order.orderID;
+}
+
+bool L2Replay::cancel(OrderID orderID) {
+    auto it = std::find_if(orders.begin(), orders.end(), [&](const SimOrder& order) { return order.orderID == orderID; });
+    if (it == orders.end()) return false;
+    orders.erase(it);
+    return true;
+}
+
+std::optional<SimOrder> L2Replay::getOrder(OrderID orderID) const {
+    auto it = std::find_if(orders.begin(), orders.end(), [&](const SimOrder& order) { return order.orderID == orderID; });
+    if (it == orders.end()) return std::nullopt;
+    return *it;
+}
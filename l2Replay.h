@@ -0,0 +1,116 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include "eventDispatcher.h"
+#include "events.h"
+#include "order.h"
+#include "types.h"
+
+enum class L2EventType : std::uint8_t { BOOK, TRADE };
+
+// One historical market-data update. BOOK sets the displayed size of a level
+// (0 removes it); TRADE reports a print, `side` being the aggressor's.
+struct L2Event {
+    std::int64_t timestamp;     // nanoseconds since the epoch
+    L2EventType type;
+    Side side;
+    Price price;
+    Quantity quantity;
+};
+
+// Reads `timestamp,type,side,price,quantity` lines, e.g.
+// `1700000000000000000,B,S,150.25,300` or `...,T,B,150.25,100`. Type is B(ook)
+// or T(rade), side B(uy) or S(ell), price in dollars with up to two decimals.
+// A header line is skipped. Throws std::runtime_error on malformed input.
+std::vector<L2Event> loadL2Csv(const str& path);
+
+struct L2Level {
+    Price price;
+    Quantity quantity;
+};
+
+// Aggregated price levels. Each side is a sorted vector with the best level
+// at the back, so the updates near the touch that make up most of a feed
+// move little or nothing.
+class L2Book {
+    private:
+        std::vector<L2Level> bids;   // ascending
+        std::vector<L2Level> asks;   // descending
+
+    public:
+        // Returns the previous size at the level.
+        Quantity set(Side side, Price price, Quantity quantity);
+        Quantity quantityAt(Side side, Price price) const;
+        std::optional<L2Level> best(Side side) const;
+        // Best level last.
+        const std::vector<L2Level>& levels(Side side) const { return side == Side::BUY ? bids : asks; }
+        void clear();
+};
+
+// A simulated order resting among the historical liquidity. `queueAhead` is
+// the displayed size estimated to be in front of it at its price.
+struct SimOrder {
+    OrderID orderID;
+    Side side;
+    Price price;
+    Quantity quantity;
+    Quantity remaining;
+    Quantity queueAhead;
+};
+
+// Replays historical L2 updates for one symbol into an L2Book and fills the
+// strategy's simulated orders against them without touching the matching
+// engine. A resting order joins the back of its level; trades at its price
+// consume the queue ahead of it before filling it, a shrinking level is
+// assumed to lose cancels ahead of and behind the order in proportion, and
+// trades or quotes through its price fill it outright. Marketable orders take
+// displayed liquidity immediately. Fills are published as TradeExecutedEvents
+// (the historical side has order and trader id 0), so Ledger, FillRecorder and
+// the Python portfolio account for them unchanged, once the step or
+// submission that caused them is done with the order list; a subscriber may
+// submit or cancel from its callback. Single-threaded.
+class L2Replay {
+    private:
+        EventDispatcher& dispatcher;
+        str symbol;
+        TraderID traderID;
+        std::vector<L2Event> events;
+        std::size_t cursor = 0;
+        std::int64_t now = 0;
+        L2Book book;
+        std::vector<SimOrder> orders;       // live, in submission order
+        OrderID nextOrderID = 1;
+        std::vector<TradeExecutedEvent> fills;   // awaiting publishFills
+        bool publishing = false;
+
+        void apply(const L2Event& event);
+        void onBookUpdate(const L2Event& event);
+        void onTrade(const L2Event& event);
+        void fillCrossedOrders();
+        void take(SimOrder& order, std::optional<Price> limit);
+        void fill(SimOrder& order, Price price, Quantity quantity, bool aggressor);
+        void publishFills();
+        void removeFilled();
+
+    public:
+        L2Replay(EventDispatcher& dispatcher, str symbol, TraderID traderID, std::vector<L2Event> events);
+
+        // Applies the next event; false once the history is exhausted.
+        bool step();
+        // Applies every event stamped at or before `timestamp`; returns how many.
+        std::size_t runUntil(std::int64_t timestamp);
+        std::size_t run();
+
+        // Order ids are local to the replay. A market order's unfilled part is dropped.
+        OrderID submitLimit(Side side, Price price, Quantity quantity);
+        OrderID submitMarket(Side side, Quantity quantity);
+        bool cancel(OrderID orderID);
+
+        std::optional<SimOrder> getOrder(OrderID orderID) const;
+        const std::vector<SimOrder>& getOrders() const { return orders; }
+        const L2Book& getBook() const { return book; }
+        std::int64_t currentTime() const { return now; }
+        bool done() const { return cursor == events.size(); }
+        std::size_t size() const { return events.size(); }
+};
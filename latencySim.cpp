@@ -0,0 +1,132 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "simulationKernel.h"
+#include "limitOrder.h"
+#include "marketOrder.h"
+#include "orderBook.h"
+#include "eventDispatcher.h"
+
+// Usage:
+//   latency_sim [--seconds S] [--takers N] [--quote-interval-us U] [--step-ns NS] [--seed S]
+//
+// A market maker re-quotes a random-walk mid on a timer; N takers race to
+// lift every new offer, taker i sitting i * step further from the engine.
+// Runs in simulated time and reports each taker's share of the fills along
+// with the kernel's throughput.
+namespace {
+    constexpr SimTime MICROSECOND = 1'000;
+
+    class MarketMaker : public SimulationAgent {
+        private:
+            TraderID traderID;
+            SimTime interval;
+            SimTime end;
+            std::mt19937_64 rng;
+            Price mid = 10000;
+
+        public:
+            MarketMaker(TraderID traderID, SimTime interval, SimTime end, std::uint64_t seed)
+                : traderID(traderID), interval(interval), end(end), rng(seed) {}
+
+            void onStart(SimulationKernel& kernel) override { kernel.setTimer(traderID, 0, 0); }
+
+            void onTimer(SimulationKernel& kernel, std::uint64_t) override {
+                kernel.massCancel(traderID);
+                mid += (rng() & 1) ? 1 : -1;
+                kernel.submitOrder(std::make_unique<LimitOrder>("SYNTH", 0, OrderType::LIMIT, Side::BUY, mid - 1, 10, traderID));
+                kernel.submitOrder(std::make_unique<LimitOrder>("SYNTH", 0, OrderType::LIMIT, Side::SELL, mid + 1, 10, traderID));
+                if (kernel.currentTime() + interval < end) kernel.setTimer(traderID, kernel.currentTime() + interval, 0);
+            }
+    };
+
+    class Taker : public SimulationAgent {
+        private:
+            TraderID traderID;
+            TraderID makerID;
+
+        public:
+            Quantity filled = 0;
+
+            Taker(TraderID traderID, TraderID makerID) : traderID(traderID), makerID(makerID) {}
+
+            void onMarketData(SimulationKernel& kernel, const EngineEvent& event) override {
+                auto* accepted = std::get_if<OrderAcceptedEvent>(&event);
+                if (accepted && accepted->side == Side::SELL) {
+                    kernel.submitOrder(std::make_unique<MarketOrder>("SYNTH", 0, OrderType::MARKET, Side::BUY, accepted->quantity, traderID));
+                }
+            }
+
+            void onExecutionReport(SimulationKernel&, const EngineEvent& event) override {
+                if (auto* trade = std::get_if<TradeExecutedEvent>(&event); trade && trade->aggressingTraderID == traderID &&
+                    trade->aggressingSide == Side::BUY && trade->restingTraderID == makerID) {
+                    filled += trade->quantity;
+                }
+            }
+    };
+}
+
+int main(int argc, char** argv) {
+    double seconds = 60.0;
+    std::size_t takerCount = 4;
+    SimTime quoteInterval = 100 * MICROSECOND;
+    SimTime step = 2 * MICROSECOND;
+    std::uint64_t seed = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        str arg = argv[i];
+        auto value = [&]() -> str {
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << std::endl;
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+        if (arg == "--seconds") seconds = std::stod(value());
+        else if (arg == "--takers") takerCount = std::max<std::size_t>(1, std::stoul(value()));
+        else if (arg == "--quote-interval-us") quoteInterval = std::stoll(value()) * MICROSECOND;
+        else if (arg == "--step-ns") step = std::stoll(value());
+        else if (arg == "--seed") seed = std::stoull(value());
+        else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    const SimTime end = static_cast<SimTime>(seconds * 1e9);
+    OrderBook book;
+    EventDispatcher dispatcher;
+    MatchingEngine engine(book, dispatcher);
+    SimulationKernel kernel(engine, dispatcher, seed);
+
+    constexpr TraderID makerID = 1;
+    MarketMaker maker(makerID, quoteInterval, end, seed);
+    kernel.addAgent(makerID, maker, TraderLatency{{5 * MICROSECOND, 0}, {5 * MICROSECOND, 0}, {5 * MICROSECOND, 0}});
+
+    std::vector<std::unique_ptr<Taker>> takers;
+    for (std::size_t i = 0; i < takerCount; ++i) {
+        const TraderID id = static_cast<TraderID>(i + 2);
+        takers.push_back(std::make_unique<Taker>(id, makerID));
+        const SimTime oneWay = 10 * MICROSECOND + static_cast<SimTime>(i) * step;
+        // Half a microsecond of jitter on every leg so near-ties do not always go the same way
+        kernel.addAgent(id, *takers.back(), TraderLatency{{oneWay, 500}, {oneWay, 500}, {oneWay, 500}});
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    const std::size_t processed = kernel.run();
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    Quantity total = 0;
+    for (const auto& taker : takers) total += taker->filled;
+    std::cout << "Simulated " << seconds << " s in " << wall << " s: " << processed << " events ("
+              << processed / wall << " events/s)\n";
+    for (std::size_t i = 0; i < takers.size(); ++i) {
+        const double share = total == 0 ? 0.0 : 100.0 * takers[i]->filled / total;
+        std::cout << "  taker " << i + 1 << " (+" << static_cast<SimTime>(i) * step << " ns): " << takers[i]->filled
+                  << " lots, " << share << "% of fills\n";
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include "ledger.h"
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+std::uint32_t Ledger::internSymbol(const str& symbol) {
+    auto it = symbolIndex.find(symbol);
+    if (it != symbolIndex.end()) return it->second;
+    std::uint32_t index = static_cast<std::uint32_t>(symbols.size());
+    symbolIndex.emplace(symbol, index);
+    symbols.push_back(symbol);
+    marks.push_back(0);
+    holders.emplace_back();
+    return index;
+}
+
+void Ledger::openAccount(TraderID traderID, Money cash) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (accounts.count(traderID)) throw std::invalid_argument("Account already exists for this trader.");
+    Account account;
+    account.traderID = traderID;
+    account.cash = cash;
+    accounts.emplace(traderID, std::move(account));
+}
+
+void Ledger::subscribe(EventDispatcher& dispatcher) {
+    subscriptions.add<TradeExecutedEvent>(dispatcher, [this](const TradeExecutedEvent& event) { onTrade(event); });
+    subscriptions.add<MarketDataEvent>(dispatcher, [this](const MarketDataEvent& event) { onMarketData(event); });
+}
+
+void Ledger::onTrade(const TradeExecutedEvent& event) {
+    std::lock_guard<std::mutex> lock(mtx);
+    const std::uint32_t symbol = internSymbol(event.symbol);
+    const std::int64_t quantity = event.quantity;
+
+    auto aggressor = accounts.find(event.aggressingTraderID);
+    if (aggressor != accounts.end()) {
+        applyFill(aggressor->second, symbol, event.aggressingSide == Side::BUY ? quantity : -quantity, event.price);
+    }
+    auto resting = accounts.find(event.restingTraderID);
+    if (resting != accounts.end()) {
+        applyFill(resting->second, symbol, event.aggressingSide == Side::BUY ? -quantity : quantity, event.price);
+    }
+
+    // A trade is also the newest price for the symbol
+    applyMark(symbol, event.price);
+}
+
+void Ledger::onMarketData(const MarketDataEvent& event) {
+    std::lock_guard<std::mutex> lock(mtx);
+    applyMark(internSymbol(event.symbol), event.last_price);
+}
+
+void Ledger::applyFill(Account& account, std::uint32_t symbol, std::int64_t fill, Price price) {
+    auto [it, inserted] = account.positions.try_emplace(symbol);
+    Position& position = it->second;
+    if (inserted) holders[symbol].push_back({&account, &position});
+
+    const Money oldMarketValue = position.quantity * static_cast<Money>(marks[symbol]);
+    const Money oldCost = position.costBasis;
+
+    std::int64_t opening = fill;
+    if (position.quantity != 0 && (position.quantity > 0) != (fill > 0)) {
+        // Close against the existing position at its average cost; any excess opens the other way
+        std::int64_t closing = std::min(std::llabs(fill), std::llabs(position.quantity));
+        if (position.quantity < 0) closing = -closing;
+        Money removedCost = position.costBasis * closing / position.quantity;
+        Money realized = closing * static_cast<Money>(price) - removedCost;
+
+        position.realizedPnl += realized;
+        account.realizedPnl += realized;
+        position.quantity -= closing;
+        position.costBasis -= removedCost;
+        opening = fill + closing;
+    }
+    position.quantity += opening;
+    position.costBasis += opening * static_cast<Money>(price);
+
+    account.cash -= fill * static_cast<Money>(price);
+    account.costBasis += position.costBasis - oldCost;
+    account.marketValue += position.quantity * static_cast<Money>(marks[symbol]) - oldMarketValue;
+    account.fillCount++;
+}
+
+void Ledger::applyMark(std::uint32_t symbol, Price price) {
+    const Money delta = static_cast<Money>(price) - static_cast<Money>(marks[symbol]);
+    marks[symbol] = price;
+    if (delta == 0) return;
+    for (const Holder& holder : holders[symbol]) {
+        holder.account->marketValue += holder.position->quantity * delta;
+    }
+}
+
+PositionSnapshot Ledger::snapshot(std::uint32_t symbol, const Position& position) const {
+    const Money marketValue = position.quantity * static_cast<Money>(marks[symbol]);
+    return {symbols[symbol], position.quantity, position.costBasis, marketValue,
+            position.realizedPnl, marketValue - position.costBasis};
+}
+
+std::optional<AccountSnapshot> Ledger::getAccount(TraderID traderID) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = accounts.find(traderID);
+    if (it == accounts.end()) return std::nullopt;
+    const Account& account = it->second;
+    return AccountSnapshot{account.traderID, account.cash, account.marketValue, account.realizedPnl,
+                           account.marketValue - account.costBasis, account.cash + account.marketValue, account.fillCount};
+}
+
+std::optional<PositionSnapshot> Ledger::getPosition(TraderID traderID, const str& symbol) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto account = accounts.find(traderID);
+    auto index = symbolIndex.find(symbol);
+    if (account == accounts.end() || index == symbolIndex.end()) return std::nullopt;
+    auto position = account->second.positions.find(index->second);
+    if (position == account->second.positions.end()) return std::nullopt;
+    return snapshot(index->second, position->second);
+}
+
+std::vector<PositionSnapshot> Ledger::getPositions(TraderID traderID) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::vector<PositionSnapshot> result;
+    auto account = accounts.find(traderID);
+    if (account == accounts.end()) return result;
+    for (const auto& [symbol, position] : account->second.positions) {
+        if (position.quantity != 0) result.push_back(snapshot(symbol, position));
+    }
+    return result;
+}
+
+std::optional<Price> Ledger::getMark(const str& symbol) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto index = symbolIndex.find(symbol);
+    if (index == symbolIndex.end()) return std::nullopt;
+    return marks[index->second];
+}
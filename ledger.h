@@ -0,0 +1,84 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include "types.h"
+#include "events.h"
+#include "eventDispatcher.h"
+
+// All money amounts are integer price ticks (cents) times shares.
+using Money = std::int64_t;
+
+struct PositionSnapshot {
+    str symbol;
+    std::int64_t quantity;
+    Money costBasis;        // signed total cost of the open position
+    Money marketValue;      // quantity * last mark
+    Money realizedPnl;
+    Money unrealizedPnl;
+};
+
+struct AccountSnapshot {
+    TraderID traderID;
+    Money cash;
+    Money marketValue;
+    Money realizedPnl;
+    Money unrealizedPnl;
+    Money equity;
+    std::uint64_t fillCount;
+};
+
+// Positions and PnL for a set of traders, kept in fixed point and updated
+// incrementally: a fill touches one position, a new mark touches only the
+// positions in that symbol. Fills arrive on the matching thread, marks on
+// whichever thread publishes market data; readers get snapshots.
+class Ledger {
+    private:
+        struct Position {
+            std::int64_t quantity = 0;
+            Money costBasis = 0;
+            Money realizedPnl = 0;
+        };
+
+        struct Account {
+            TraderID traderID;
+            Money cash = 0;
+            Money marketValue = 0;
+            Money costBasis = 0;
+            Money realizedPnl = 0;
+            std::uint64_t fillCount = 0;
+            std::unordered_map<std::uint32_t, Position> positions;
+        };
+
+        struct Holder {
+            Account* account;
+            Position* position;
+        };
+
+        mutable std::mutex mtx;
+        std::unordered_map<TraderID, Account> accounts;
+        std::unordered_map<str, std::uint32_t> symbolIndex;
+        std::vector<str> symbols;
+        std::vector<Price> marks;
+        std::vector<std::vector<Holder>> holders;    // per symbol, every position ever opened in it
+        Subscriptions subscriptions;
+
+        std::uint32_t internSymbol(const str& symbol);
+        void applyFill(Account& account, std::uint32_t symbol, std::int64_t signedQuantity, Price price);
+        void applyMark(std::uint32_t symbol, Price price);
+        PositionSnapshot snapshot(std::uint32_t symbol, const Position& position) const;
+
+    public:
+        void openAccount(TraderID traderID, Money cash);
+        void subscribe(EventDispatcher& dispatcher);
+
+        void onTrade(const TradeExecutedEvent& event);
+        void onMarketData(const MarketDataEvent& event);
+
+        std::optional<AccountSnapshot> getAccount(TraderID traderID) const;
+        std::optional<PositionSnapshot> getPosition(TraderID traderID, const str& symbol) const;
+        std::vector<PositionSnapshot> getPositions(TraderID traderID) const;
+        std::optional<Price> getMark(const str& symbol) const;
+};
@@ -1,4 +1,5 @@
 #include "limitOrder.h"
+#include <algorithm>
 
 inline bool isValidPrice(const str& priceStr) {
     if (priceStr.find('-') != std::string::npos) return false;
@@ -24,3 +25,21 @@ LimitOrder::LimitOrder(str symbol, OrderID orderID, OrderType orderType, Side si
    setSymbol(symbol); setPriceStr(priceStr); setPrice(convertPriceToInt(priceStr));
    setOrderID(orderID); setOrderType(orderType); setSide(side); setQuantity(quantity); setTraderID(traderID);
 }
+
+inline str convertPriceToStr(Price price) {
+    str text = std::to_string(price / 100);
+    text += price % 100 < 10 ? ".0" : ".";
+    text += std::to_string(price % 100);
+    return text;
+}
+
+LimitOrder::LimitOrder(str symbol, OrderID orderID, OrderType orderType, Side side, Price price, Quantity quantity, TraderID traderID) {
+   if (price == 0) {
+    throw std::invalid_argument("Price must be positive.");
+   }
+   if (quantity == 0) {
+    throw std::invalid_argument("Quantity must be positive.");
+   }
+   setSymbol(symbol); setPriceStr(convertPriceToStr(price)); setPrice(price);
+   setOrderID(orderID); setOrderType(orderType); setSide(side); setQuantity(quantity); setTraderID(traderID);
+}
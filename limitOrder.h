@@ -15,6 +15,15 @@ class LimitOrder : public Order {
             Quantity quantity,
             TraderID traderID
         );
+        LimitOrder(
+            str symbol,
+            OrderID orderID,
+            OrderType orderType,
+            Side side,
+            Price price,
+            Quantity quantity,
+            TraderID traderID
+        );
 
         str getPriceStr() {
             return priceStr;
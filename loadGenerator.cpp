@@ -0,0 +1,105 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include "orderFlowGenerator.h"
+#include "matchingEngine.h"
+#include "orderBook.h"
+#include "eventDispatcher.h"
+#include "events.h"
+#include "marketDataFeed.h"
+
+// Usage:
+//   load_generator [--messages N] [--rate MSG_PER_SEC] [--traders N] [--seed S]
+//                  [--paced] [--speed X] [--record FILE] [--replay FILE]
+//                  [--feed-address ADDR --feed-port PORT --snapshot-port PORT]
+//
+// Without --paced the stream is pushed into the engine as fast as possible;
+// with it, messages are released at their Poisson timestamps. With --feed-port
+// the book is also published as a UDP market-data feed (see feed_listener).
+int main(int argc, char** argv) {
+    OrderFlowConfig config;
+    std::size_t messageCount = 1'000'000;
+    bool paced = false;
+    double speed = 1.0;
+    str recordPath;
+    str replayPath;
+    FeedConfig feedConfig;
+
+    for (int i = 1; i < argc; ++i) {
+        str arg = argv[i];
+        auto value = [&]() -> str {
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << std::endl;
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+        if (arg == "--messages") messageCount = std::stoull(value());
+        else if (arg == "--rate") config.messagesPerSecond = std::stod(value());
+        else if (arg == "--traders") config.numTraders = std::stoul(value());
+        else if (arg == "--seed") config.seed = std::stoull(value());
+        else if (arg == "--paced") paced = true;
+        else if (arg == "--speed") speed = std::stod(value());
+        else if (arg == "--record") recordPath = value();
+        else if (arg == "--replay") replayPath = value();
+        else if (arg == "--feed-address") feedConfig.address = value();
+        else if (arg == "--feed-port") feedConfig.port = static_cast<std::uint16_t>(std::stoul(value()));
+        else if (arg == "--snapshot-port") feedConfig.snapshotPort = static_cast<std::uint16_t>(std::stoul(value()));
+        else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<FlowMessage> messages;
+    if (!replayPath.empty()) {
+        OrderFlowReader reader(replayPath);
+        messages = reader.readAll();
+        std::cout << "Replaying " << messages.size() << " messages from " << replayPath << std::endl;
+    }
+    else {
+        OrderFlowGenerator generator(config);
+        messages = generator.generate(messageCount);
+        std::cout << "Generated " << messages.size() << " messages" << std::endl;
+    }
+
+    if (!recordPath.empty()) {
+        OrderFlowWriter writer(recordPath);
+        writer.write(messages);
+        std::cout << "Recorded stream to " << recordPath << std::endl;
+    }
+
+    OrderBook book;
+    EventDispatcher dispatcher;
+    MatchingEngine engine(book, dispatcher);
+
+    std::atomic<std::uint64_t> trades{0};
+    std::atomic<std::uint64_t> cancellations{0};
+    dispatcher.subscribe<TradeExecutedEvent>([&](const TradeExecutedEvent&) { trades.fetch_add(1, std::memory_order_relaxed); });
+    dispatcher.subscribe<OrderCancelledEvent>([&](const OrderCancelledEvent&) { cancellations.fetch_add(1, std::memory_order_relaxed); });
+
+    std::unique_ptr<MarketDataFeed> feed;
+    if (feedConfig.port != 0) {
+        feed = std::make_unique<MarketDataFeed>(dispatcher, feedConfig);
+        feed->start();
+    }
+
+    OrderFlowDriver driver(engine, "SYNTH");
+
+    engine.start();
+    auto start = std::chrono::steady_clock::now();
+    if (paced) driver.runPaced(messages, speed);
+    else driver.runFlatOut(messages);
+    engine.stop();
+    if (feed) feed->stop();
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Processed " << messages.size() << " messages in " << elapsed << " s ("
+              << static_cast<std::uint64_t>(messages.size() / elapsed) << " msg/s)" << std::endl;
+    std::cout << "Trades: " << trades.load() << ", cancellations: " << cancellations.load() << std::endl;
+    if (feed) std::cout << "Feed messages: " << feed->getSequence() << std::endl;
+    return 0;
+}
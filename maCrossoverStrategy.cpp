@@ -0,0 +1,52 @@
+#include "strategyPlugin.h"
+#include "indicators.h"
+
+// C++ port of MovingAverageCrossoverStrategy (strategy.py), built as a
+// loadable plugin. Parameters: symbol, short, long, quantity.
+//   host.load("ma_crossover", traderID, "symbol=AAPL,short=5,long=50");
+class MovingAverageCrossover : public Strategy {
+    private:
+        str symbol = "AAPL";
+        Quantity quantity = 10;
+        SimpleMovingAverage shortSma;
+        SimpleMovingAverage longSma;
+        StrategyContext* context = nullptr;
+        bool inPosition = false;
+
+        static std::size_t param(const std::unordered_map<str, str>& params, const str& key, std::size_t fallback) {
+            auto it = params.find(key);
+            return it == params.end() ? fallback : std::stoul(it->second);
+        }
+
+    public:
+        explicit MovingAverageCrossover(const str& params) : MovingAverageCrossover(parseStrategyParams(params)) {}
+
+        explicit MovingAverageCrossover(const std::unordered_map<str, str>& params)
+            : quantity(static_cast<Quantity>(param(params, "quantity", 10))),
+              shortSma(param(params, "short", 10)),
+              longSma(param(params, "long", 30)) {
+            if (auto it = params.find("symbol"); it != params.end()) symbol = it->second;
+        }
+
+        void onStart(StrategyContext& ctx) override {
+            context = &ctx;
+        }
+
+        void onBar(const Bar& bar) override {
+            if (bar.symbol != symbol) return;
+            const double shortMa = shortSma.update(bar.close);
+            const double longMa = longSma.update(bar.close);
+            if (!longSma.ready()) return;
+
+            if (shortMa > longMa && !inPosition) {
+                inPosition = true;
+                context->submitMarket(symbol, Side::BUY, quantity);
+            }
+            else if (shortMa < longMa && inPosition) {
+                inPosition = false;
+                context->submitMarket(symbol, Side::SELL, quantity);
+            }
+        }
+};
+
+TRADING_EXPORT_STRATEGY(MovingAverageCrossover)
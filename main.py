@@ -1,7 +1,8 @@
+import argparse
 import trading_core
-import time
-from portfolio import Portfolio
-from data_handler import CSVDataHandler, data_file_path
+from portfolio import LedgerPortfolio, to_epoch_ms
+from data_handler import data_file_path
+from data_feeds import MergedDataHandler, SymbolFeed
 from strategy import MovingAverageCrossoverStrategy
 
 trader_ids = set() 
@@ -34,57 +35,85 @@ class MarketSimulator:
         self.resting_ask_id = self.engine.submit_order(ask_order)
         
     def cleanup_market(self):
-        if self.resting_bid_id is not None:
-           print(f"SIM: Cleaning up previous BID (ID: {self.resting_bid_id})") 
-           self.engine.cancel_order(self.resting_bid_id)
-           self.resting_bid_id = None
+        # Pull both simulated quotes in one engine command per trader instead of cancelling by id
+        if self.resting_bid_id is not None or self.resting_ask_id is not None:
+            print(f"SIM: Cleaning up previous quotes (BID ID: {self.resting_bid_id}, ASK ID: {self.resting_ask_id})")
+            self.engine.mass_cancel(self.bid_trader_id)
+            self.engine.mass_cancel(self.ask_trader_id)
+            self.resting_bid_id = None
+            self.resting_ask_id = None
 
-        if self.resting_ask_id is not None:
-            print(f"SIM: Cleaning up previous ASK (ID: {self.resting_ask_id})")
-            self.engine.cancel_order(self.resting_ask_id)
-            self.resting_ask_id = None 
+class Venue:
+    """Book, engine, quotes and strategy for one symbol; the book matches a single symbol.
+    The engine is never started: the backtest loop runs every venue's commands on its
+    own thread with run_pending(), so the universe size does not set the thread count."""
+    def __init__(self, dispatcher, portfolio, symbol: str):
+        self.book = trading_core.OrderBook()
+        self.engine = trading_core.MatchingEngine(self.book, dispatcher)
+        self.market_sim = MarketSimulator(engine=self.engine, symbol=symbol)
+        self.strategy = MovingAverageCrossoverStrategy(self.engine, portfolio, symbol, 5, 50)
 
 if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Run the moving-average crossover backtest")
+    parser.add_argument("--data-dir", help="directory of <SYMBOL>.csv files to merge by timestamp (default: AAPL only)")
+    parser.add_argument("--chunk-size", type=int, default=1024, help="rows read per feed at a time")
+    parser.add_argument("--tape", help="record every execution to this trade tape")
+    args = parser.parse_args()
+
     print("Starting Trading System Backtest")
 
     dispatcher = trading_core.EventDispatcher()
-    orderbook = trading_core.OrderBook()
-    engine = trading_core.MatchingEngine(orderbook, dispatcher)
-
-    portfolio = Portfolio(cash="10000.00", trader_id=1)
-    data_handler = CSVDataHandler(csv_path=data_file_path, symbol="AAPL")
-
-    market_sim = MarketSimulator(engine=engine, symbol="AAPL")
-    strategy = MovingAverageCrossoverStrategy(engine, portfolio, "AAPL", 5, 50)
 
-    dispatcher.subscribe_trade_executed(portfolio.on_fill)
-    dispatcher.subscribe_market_data(portfolio.on_market_data)
+    recorder = trading_core.FillRecorder(trader_id=1)
+    recorder.attach(dispatcher)
+    ledger = trading_core.Ledger()
+    ledger.attach(dispatcher)
+    tape = None
+    if args.tape:
+        tape = trading_core.TradeTapeWriter(args.tape)
+        tape.attach(dispatcher)
+    portfolio = LedgerPortfolio(ledger, cash="10000.00", trader_id=1, recorder=recorder)
+    if args.data_dir:
+        data_handler = MergedDataHandler.from_directory(args.data_dir, args.chunk_size)
+    else:
+        data_handler = MergedDataHandler([SymbolFeed("AAPL", data_file_path, args.chunk_size)])
+    print(f"Data handler initialized with {len(data_handler.feeds)} symbol feed(s).")
 
-    engine.start()
+    venues = {}
 
-    for bar_data in data_handler.stream_bars():
-        timestamp, bar = bar_data
+    for timestamp, bars in data_handler.stream_slices():
         portfolio.current_bar_timestamp = timestamp
+        recorder.set_clock(to_epoch_ms(timestamp))
+        if tape:
+            tape.set_clock(to_epoch_ms(timestamp))
         print(f"\nProcessing {timestamp} | Portfolio Value: ${portfolio.value:.2f}")
-        
-        market_sim.cleanup_market()
-        market_sim.create_market_for_bar(bar)
 
-        strategy.on_bar(bar)
-        
-        market_event = trading_core.MarketDataEvent()
-        market_event.symbol = "AAPL" 
-        market_event.last_price = int(bar['close'] * 100)
-        portfolio.on_market_data(market_event)
-        portfolio.log_state(timestamp)
+        for symbol, bar in bars.items():
+            venue = venues.get(symbol)
+            if venue is None:
+                venue = venues[symbol] = Venue(dispatcher, portfolio, symbol)
+            venue.engine.set_time(timestamp)
+
+            venue.market_sim.cleanup_market()
+            venue.market_sim.create_market_for_bar(bar)
 
-        time.sleep(0.002)
+            venue.strategy.on_bar(bar)
+            venue.engine.run_pending()
+
+            market_event = trading_core.MarketDataEvent()
+            market_event.symbol = symbol
+            market_event.last_price = int(bar['close'] * 100)
+            dispatcher.publish_market_data(market_event)
+        portfolio.log_state(timestamp)
 
     print("\n--- Backtest Complete ---")
-    
-    market_sim.cleanup_market()
-    time.sleep(0.002)
-    engine.stop()
+
+    for venue in venues.values():
+        venue.market_sim.cleanup_market()
+        venue.engine.run_pending()
+    if tape:
+        tape.close()
+        print(f"Wrote {tape.trade_count()} trades to {args.tape}")
 
     final_value = portfolio.value
     pnl = final_value - 10000.0
@@ -92,4 +121,4 @@ if __name__ == "__main__":
     print(f"Total Profit/Loss: ${pnl:,.2f}")
     print(f"Total Trades Executed: {portfolio.trade_count}")
     print(f"Final Holdings: {portfolio.holdings}")
-    portfolio.save_results()
\ No newline at end of file
+    portfolio.save_results()
@@ -0,0 +1,230 @@
+#include "marketDataFeed.h"
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+    sockaddr_in makeAddress(const str& address, std::uint16_t port) {
+        sockaddr_in result{};
+        result.sin_family = AF_INET;
+        result.sin_port = htons(port);
+        if (inet_pton(AF_INET, address.c_str(), &result.sin_addr) != 1) {
+            throw std::invalid_argument("Invalid feed address: " + address);
+        }
+        return result;
+    }
+
+    void copySymbol(char (&target)[8], const str& symbol) {
+        std::memset(target, 0, sizeof(target));
+        std::memcpy(target, symbol.data(), std::min(symbol.size(), sizeof(target)));
+    }
+}
+
+MarketDataFeed::MarketDataFeed(EventDispatcher& dispatcher, const FeedConfig& config)
+    : config(config), packet(config.maxPacketSize), snapshotPacket(config.maxPacketSize) {
+    if (config.maxPacketSize < sizeof(FeedPacketHeader) + sizeof(AddOrderMessage)) {
+        throw std::invalid_argument("Feed packet size too small for one message");
+    }
+    incrementalAddress = makeAddress(config.address, config.port);
+    snapshotAddress = makeAddress(config.address, config.snapshotPort);
+
+    subscriptions.add<OrderAcceptedEvent>(dispatcher, [this](const OrderAcceptedEvent& e) {
+        FeedEvent event{FeedEventKind::ADD, e.side, {}, e.price, e.quantity, e.orderID, 0};
+        copySymbol(event.symbol, e.symbol);
+        events.push(event);
+    });
+    subscriptions.add<TradeExecutedEvent>(dispatcher, [this](const TradeExecutedEvent& e) {
+        // The aggressor is only on the book during an auction uncross; the
+        // publisher drops executions for orders it has not seen added.
+        enqueue(FeedEventKind::EXECUTE, e.restingOrderID, e.quantity);
+        enqueue(FeedEventKind::EXECUTE, e.aggressingOrderID, e.quantity);
+    });
+    subscriptions.add<OrderCancelledEvent>(dispatcher, [this](const OrderCancelledEvent& e) {
+        enqueue(FeedEventKind::CANCEL, e.orderID, e.quantity);
+    });
+    subscriptions.add<MassCancelEvent>(dispatcher, [this](const MassCancelEvent& e) {
+        for (const OrderCancelledEvent& cancelled : e.cancelled) enqueue(FeedEventKind::CANCEL, cancelled.orderID, cancelled.quantity);
+    });
+    subscriptions.add<AuctionUncrossEvent>(dispatcher, [this](const AuctionUncrossEvent& e) {
+        if (e.volume > 0) events.push({FeedEventKind::CROSS, Side::BUY, {}, e.price, 0, 0, e.volume});
+    });
+}
+
+MarketDataFeed::~MarketDataFeed() {
+    subscriptions.clear();
+    stop();
+}
+
+void MarketDataFeed::enqueue(FeedEventKind kind, OrderID orderID, Quantity quantity) {
+    events.push({kind, Side::BUY, {}, 0, quantity, orderID, 0});
+}
+
+void MarketDataFeed::start() {
+    socketFd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (socketFd < 0) throw std::system_error(errno, std::generic_category(), "socket");
+
+    if (IN_MULTICAST(ntohl(incrementalAddress.sin_addr.s_addr))) {
+        unsigned char ttl = static_cast<unsigned char>(config.multicastTtl);
+        setsockopt(socketFd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+        if (!config.interfaceAddress.empty()) {
+            in_addr interface = makeAddress(config.interfaceAddress, 0).sin_addr;
+            setsockopt(socketFd, IPPROTO_IP, IP_MULTICAST_IF, &interface, sizeof(interface));
+        }
+    }
+
+    lastSnapshot = std::chrono::steady_clock::now();
+    running = true;
+    publisherThread = std::thread([this] { run(); });
+}
+
+void MarketDataFeed::stop() {
+    if (!publisherThread.joinable()) return;
+    running = false;
+    publisherThread.join();
+    close(socketFd);
+    socketFd = -1;
+}
+
+void MarketDataFeed::run() {
+    const auto idleWait = config.snapshotInterval.count() > 0
+        ? std::min(config.snapshotInterval, std::chrono::milliseconds(50))
+        : std::chrono::milliseconds(50);
+
+    FeedEvent event;
+    while (true) {
+        const bool stopping = !running;
+        if (events.tryPopFor(event, stopping ? std::chrono::milliseconds(0) : idleWait)) {
+            apply(event);
+            while (events.tryPop(event)) apply(event);
+            flush();
+        }
+        else if (stopping) {
+            break;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (snapshotRequested.exchange(false) ||
+            (config.snapshotInterval.count() > 0 && now - lastSnapshot >= config.snapshotInterval)) {
+            publishSnapshot();
+            lastSnapshot = now;
+        }
+    }
+}
+
+template<typename Message>
+Message* MarketDataFeed::nextMessage(FeedMessageType type, std::uint8_t side) {
+    Message* message = packet.empty() ? nullptr : packet.append<Message>(type, side);
+    if (!message) {
+        flush();
+        packet.begin(nextSequence);
+        message = packet.append<Message>(type, side);
+    }
+    nextSequence++;
+    return message;
+}
+
+// Every snapshot packet carries the sequence the snapshot is consistent with.
+template<typename Message>
+Message* MarketDataFeed::nextSnapshotMessage(FeedMessageType type, std::uint8_t side) {
+    Message* message = snapshotPacket.append<Message>(type, side);
+    if (!message) {
+        const std::uint64_t sequence = reinterpret_cast<const FeedPacketHeader*>(snapshotPacket.data())->sequence;
+        send(snapshotPacket, snapshotAddress);
+        snapshotPacket.begin(sequence);
+        message = snapshotPacket.append<Message>(type, side);
+    }
+    return message;
+}
+
+void MarketDataFeed::apply(const FeedEvent& event) {
+    switch (event.kind) {
+        case FeedEventKind::ADD: {
+            BookOrder order{{}, event.side, event.price, event.quantity};
+            std::memcpy(order.symbol, event.symbol, sizeof(order.symbol));
+            orders[event.orderID] = order;
+
+            auto* message = nextMessage<AddOrderMessage>(FeedMessageType::ADD_ORDER, static_cast<std::uint8_t>(event.side));
+            message->price = event.price;
+            message->orderID = event.orderID;
+            message->quantity = event.quantity;
+            std::memcpy(message->symbol, event.symbol, sizeof(message->symbol));
+            break;
+        }
+        case FeedEventKind::EXECUTE: {
+            auto it = orders.find(event.orderID);
+            if (it == orders.end()) return;
+            Quantity executed = std::min(event.quantity, it->second.quantity);
+            auto* message = nextMessage<OrderExecutedMessage>(FeedMessageType::ORDER_EXECUTED);
+            message->quantity = executed;
+            message->orderID = event.orderID;
+            it->second.quantity -= executed;
+            if (it->second.quantity == 0) orders.erase(it);
+            break;
+        }
+        case FeedEventKind::CANCEL: {
+            auto it = orders.find(event.orderID);
+            if (it == orders.end()) return;
+            if (event.quantity < it->second.quantity) {
+                auto* message = nextMessage<OrderCancelMessage>(FeedMessageType::ORDER_CANCEL);
+                message->quantity = event.quantity;
+                message->orderID = event.orderID;
+                it->second.quantity -= event.quantity;
+            }
+            else {
+                nextMessage<OrderDeleteMessage>(FeedMessageType::ORDER_DELETE)->orderID = event.orderID;
+                orders.erase(it);
+            }
+            break;
+        }
+        case FeedEventKind::CROSS: {
+            auto* message = nextMessage<CrossTradeMessage>(FeedMessageType::CROSS_TRADE);
+            message->price = event.price;
+            message->volume = event.volume;
+            break;
+        }
+    }
+}
+
+void MarketDataFeed::flush() {
+    if (packet.empty()) return;
+    send(packet, incrementalAddress);
+    packet.begin(nextSequence);
+    publishedSequence = nextSequence - 1;
+}
+
+void MarketDataFeed::publishSnapshot() {
+    flush();
+    const std::uint64_t sequence = nextSequence - 1;
+    const std::uint32_t orderCount = static_cast<std::uint32_t>(orders.size());
+
+    // Order ids are assigned in arrival order, so this also restores time priority
+    snapshotIDs.clear();
+    for (const auto& [orderID, order] : orders) snapshotIDs.push_back(orderID);
+    std::sort(snapshotIDs.begin(), snapshotIDs.end());
+
+    snapshotPacket.begin(sequence);
+    auto* start = nextSnapshotMessage<SnapshotStartMessage>(FeedMessageType::SNAPSHOT_START);
+    start->orderCount = orderCount;
+    start->sequence = sequence;
+    for (OrderID orderID : snapshotIDs) {
+        const BookOrder& order = orders.at(orderID);
+        auto* message = nextSnapshotMessage<AddOrderMessage>(FeedMessageType::ADD_ORDER, static_cast<std::uint8_t>(order.side));
+        message->price = order.price;
+        message->orderID = orderID;
+        message->quantity = order.quantity;
+        std::memcpy(message->symbol, order.symbol, sizeof(message->symbol));
+    }
+    auto* end = nextSnapshotMessage<SnapshotEndMessage>(FeedMessageType::SNAPSHOT_END);
+    end->orderCount = orderCount;
+    end->sequence = sequence;
+    send(snapshotPacket, snapshotAddress);
+}
+
+void MarketDataFeed::send(const FeedPacketWriter& writer, const sockaddr_in& address) {
+    // Best effort like any UDP feed; consumers recover from loss via snapshots
+    sendto(socketFd, writer.data(), writer.size(), 0, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+}
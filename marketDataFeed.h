@@ -0,0 +1,128 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <netinet/in.h>
+#include "marketDataProtocol.h"
+#include "eventDispatcher.h"
+#include "events.h"
+#include "threadSafeQueue.h"
+
+struct FeedConfig {
+    // Destination, or the group to join on the consumer side. A multicast
+    // address (224.0.0.0/4) is published as multicast, anything else unicast.
+    str address = "127.0.0.1";
+    std::uint16_t port = 0;
+    std::uint16_t snapshotPort = 0;
+    str interfaceAddress;                                // multicast interface, default route if empty
+    int multicastTtl = 1;
+    std::size_t maxPacketSize = 1400;                    // keeps datagrams under a 1500-byte MTU
+    std::chrono::milliseconds snapshotInterval{1000};    // 0 only publishes snapshots on request
+};
+
+// Packs messages into one datagram of at most `maxPacketSize` bytes.
+class FeedPacketWriter {
+    private:
+        std::vector<char> buffer;
+        std::size_t length = 0;
+
+        FeedPacketHeader& header() { return *reinterpret_cast<FeedPacketHeader*>(buffer.data()); }
+
+    public:
+        explicit FeedPacketWriter(std::size_t maxPacketSize) : buffer(maxPacketSize) {}
+
+        void begin(std::uint64_t sequence) {
+            length = sizeof(FeedPacketHeader);
+            header() = {sequence, 0, 0, 0};
+        }
+
+        // nullptr when the packet has no room for the message.
+        template<typename Message>
+        Message* append(FeedMessageType type, std::uint8_t side = 0) {
+            if (length + sizeof(Message) > buffer.size()) return nullptr;
+            Message* message = new (buffer.data() + length) Message{};
+            message->header = {static_cast<std::uint16_t>(sizeof(Message)), type, side};
+            length += sizeof(Message);
+            header().count++;
+            return message;
+        }
+
+        bool empty() const { return length <= sizeof(FeedPacketHeader); }
+        const char* data() const { return buffer.data(); }
+        std::size_t size() const { return length; }
+};
+
+// Publishes the engine's order-by-order book as an ITCH-style UDP feed plus
+// a periodic snapshot channel for late joiners and gap recovery. Dispatcher
+// callbacks only enqueue; a publisher thread sequences the messages, packs
+// whatever is queued into as few datagrams as fit, and keeps its own copy of
+// the book to turn cancels into cancel/delete and to build snapshots.
+class MarketDataFeed {
+    private:
+        enum class FeedEventKind : std::uint8_t { ADD, EXECUTE, CANCEL, CROSS };
+
+        struct FeedEvent {
+            FeedEventKind kind;
+            Side side;
+            char symbol[8];
+            Price price;
+            Quantity quantity;
+            OrderID orderID;
+            std::uint64_t volume;
+        };
+
+        struct BookOrder {
+            char symbol[8];
+            Side side;
+            Price price;
+            Quantity quantity;
+        };
+
+        FeedConfig config;
+        int socketFd = -1;
+        sockaddr_in incrementalAddress{};
+        sockaddr_in snapshotAddress{};
+
+        ThreadSafeQueue<FeedEvent> events;
+        std::unordered_map<OrderID, BookOrder> orders;
+        std::vector<OrderID> snapshotIDs;
+        FeedPacketWriter packet;
+        FeedPacketWriter snapshotPacket;
+        std::uint64_t nextSequence = 1;
+        std::chrono::steady_clock::time_point lastSnapshot;
+
+        std::atomic<std::uint64_t> publishedSequence{0};
+        std::atomic<bool> snapshotRequested{false};
+        std::atomic<bool> running{false};
+        std::thread publisherThread;
+        Subscriptions subscriptions;
+
+        void enqueue(FeedEventKind kind, OrderID orderID, Quantity quantity);
+        void run();
+        void apply(const FeedEvent& event);
+        void flush();
+        void publishSnapshot();
+        void send(const FeedPacketWriter& writer, const sockaddr_in& address);
+
+        template<typename Message>
+        Message* nextMessage(FeedMessageType type, std::uint8_t side = 0);
+        template<typename Message>
+        Message* nextSnapshotMessage(FeedMessageType type, std::uint8_t side = 0);
+
+    public:
+        MarketDataFeed(EventDispatcher& dispatcher, const FeedConfig& config);
+        ~MarketDataFeed();
+
+        void start();
+        void stop();
+
+        // Publishes a snapshot at the next opportunity, outside the regular interval.
+        void requestSnapshot() { snapshotRequested = true; }
+
+        // Last sequence sent on the incremental channel.
+        std::uint64_t getSequence() const { return publishedSequence.load(); }
+};
@@ -0,0 +1,109 @@
+#pragma once
+#include <cstdint>
+#include "types.h"
+
+// ITCH-style binary market data. Each UDP datagram is a FeedPacketHeader
+// followed by `count` messages; message n carries sequence `sequence + n`.
+// Sequences are contiguous across the session, starting at 1, so a consumer
+// detects loss from the packet header alone. Integers are little-endian and
+// every message size is a multiple of 8, so messages are read as plain structs.
+//
+// The book is order-by-order: ADD_ORDER introduces a resting order and the
+// other messages refer to it by id. ORDER_CANCEL removes part of an order,
+// ORDER_DELETE the rest of it.
+//
+// The snapshot channel repeats the whole book as SNAPSHOT_START, one ADD_ORDER
+// per resting order and SNAPSHOT_END. Its packet headers carry the incremental
+// sequence the snapshot is consistent with.
+
+enum class FeedMessageType : char {
+    ADD_ORDER = 'A',
+    ORDER_EXECUTED = 'E',
+    ORDER_CANCEL = 'X',
+    ORDER_DELETE = 'D',
+    CROSS_TRADE = 'Q',         // auction uncross print
+    SNAPSHOT_START = 'S',
+    SNAPSHOT_END = 'F'
+};
+
+struct FeedPacketHeader {
+    std::uint64_t sequence;     // sequence of the first message
+    std::uint16_t count;
+    std::uint16_t reserved;
+    std::uint32_t reserved2;
+};
+
+// Every message starts with its length and type.
+struct FeedMessageHeader {
+    std::uint16_t length;
+    FeedMessageType type;
+    std::uint8_t side;          // Side, for ADD_ORDER
+};
+
+struct AddOrderMessage {
+    FeedMessageHeader header;
+    Price price;
+    OrderID orderID;
+    Quantity quantity;
+    std::uint32_t reserved;
+    char symbol[8];             // NUL-padded
+};
+
+struct OrderExecutedMessage {
+    FeedMessageHeader header;
+    Quantity quantity;          // executed at the order's price
+    OrderID orderID;
+};
+
+struct OrderCancelMessage {
+    FeedMessageHeader header;
+    Quantity quantity;          // removed; the order stays on the book
+    OrderID orderID;
+};
+
+struct OrderDeleteMessage {
+    FeedMessageHeader header;
+    std::uint32_t reserved;
+    OrderID orderID;
+};
+
+struct CrossTradeMessage {
+    FeedMessageHeader header;
+    Price price;
+    std::uint64_t volume;
+};
+
+struct SnapshotStartMessage {
+    FeedMessageHeader header;
+    std::uint32_t orderCount;
+    std::uint64_t sequence;
+};
+
+struct SnapshotEndMessage {
+    FeedMessageHeader header;
+    std::uint32_t orderCount;
+    std::uint64_t sequence;
+};
+
+static_assert(sizeof(FeedPacketHeader) == 16);
+static_assert(sizeof(AddOrderMessage) == 32);
+static_assert(sizeof(OrderExecutedMessage) == 16);
+static_assert(sizeof(OrderCancelMessage) == 16);
+static_assert(sizeof(OrderDeleteMessage) == 16);
+static_assert(sizeof(CrossTradeMessage) == 16);
+static_assert(sizeof(SnapshotStartMessage) == 16);
+static_assert(sizeof(SnapshotEndMessage) == 16);
+
+// Size of the message a type code announces, or 0 for an unknown type.
+constexpr std::uint16_t feedMessageSize(FeedMessageType type) {
+    switch (type) {
+        case FeedMessageType::ADD_ORDER: return sizeof(AddOrderMessage);
+        case FeedMessageType::ORDER_EXECUTED: return sizeof(OrderExecutedMessage);
+        case FeedMessageType::ORDER_CANCEL: return sizeof(OrderCancelMessage);
+        case FeedMessageType::ORDER_DELETE: return sizeof(OrderDeleteMessage);
+        case FeedMessageType::CROSS_TRADE: return sizeof(CrossTradeMessage);
+        case FeedMessageType::SNAPSHOT_START: return sizeof(SnapshotStartMessage);
+        case FeedMessageType::SNAPSHOT_END: return sizeof(SnapshotEndMessage);
+    }
+    return 0;
+}
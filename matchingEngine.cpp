@@ -1,129 +1,480 @@
 #include "matchingEngine.h"
+#include <future>
+#include <stdexcept>
+#include "threadTuning.h"
 
-MatchingEngine::MatchingEngine(OrderBook& orderBook, EventDispatcher& eventDispatcher)
-    : book(orderBook), dispatcher(eventDispatcher), nextOrderID(1) {}
+template<typename MatchingPolicy>
+BasicMatchingEngine<MatchingPolicy>::BasicMatchingEngine(OrderBook& orderBook, EventDispatcher& eventDispatcher, const EngineConfig& engineConfig)
+    : book(orderBook), dispatcher(eventDispatcher), config(engineConfig), nextOrderID(1),
+      risk(engineConfig.defaultRiskLimits, engineConfig.maxTraders), expiryCheck(orderBook.nextExpiryCheck()) {}
 
-MatchingEngine::~MatchingEngine() {
+template<typename MatchingPolicy>
+BasicMatchingEngine<MatchingPolicy>::~BasicMatchingEngine() {
     stop();
 }
 
-OrderID MatchingEngine::submitOrder(std::unique_ptr<Order> order) {
+template<typename MatchingPolicy>
+OrderID BasicMatchingEngine<MatchingPolicy>::submitOrder(std::unique_ptr<Order> order) {
     OrderID id = nextOrderID.fetch_add(1);
     order->setOrderID(id);
-    incoming_orders.push(std::move(order));
+    incoming_commands.push(Command{CommandType::SUBMIT, id, std::move(order), {}, {}});
     return id;
 }
 
-void MatchingEngine::cancelOrder(OrderID orderID) {
-    incoming_cancellations.push(orderID);
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::submitReserved(std::unique_ptr<Order> order) {
+    OrderID id = order->getOrderID();
+    incoming_commands.push(Command{CommandType::SUBMIT, id, std::move(order), {}, {}});
 }
 
-void MatchingEngine::start() {
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::cancelOrder(OrderID orderID) {
+    incoming_commands.push(Command{CommandType::CANCEL, orderID, nullptr, {}, {}});
+}
+
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::massCancel(TraderID traderID) {
+    incoming_commands.push(Command{CommandType::MASS_CANCEL, 0, nullptr, {MassCancelScope::TRADER, traderID, Side::BUY, {}}, {}});
+}
+
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::massCancel(TraderID traderID, Side side) {
+    incoming_commands.push(Command{CommandType::MASS_CANCEL, 0, nullptr, {MassCancelScope::TRADER_SIDE, traderID, side, {}}, {}});
+}
+
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::massCancelSymbol(const str& symbol) {
+    incoming_commands.push(Command{CommandType::MASS_CANCEL, 0, nullptr, {MassCancelScope::SYMBOL, 0, Side::BUY, symbol}, {}});
+}
+
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::massCancelAll() {
+    incoming_commands.push(Command{CommandType::MASS_CANCEL, 0, nullptr, {MassCancelScope::ALL, 0, Side::BUY, {}}, {}});
+}
+
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::beginAuction() {
+    incoming_commands.push(Command{CommandType::BEGIN_AUCTION, 0, nullptr, {}, {}});
+}
+
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::uncross() {
+    incoming_commands.push(Command{CommandType::UNCROSS, 0, nullptr, {}, {}});
+}
+
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::setTime(Timestamp now) {
+    incoming_commands.push(Command{CommandType::SET_TIME, 0, nullptr, {}, now});
+}
+
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::resumeWallClock() {
+    incoming_commands.push(Command{CommandType::SET_TIME, 0, nullptr, {}, Timestamp{}});
+}
+
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::advanceOrderIDs(OrderID next) {
+    OrderID current = nextOrderID.load();
+    while (current < next && !nextOrderID.compare_exchange_weak(current, next)) {}
+}
+
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::start() {
     running = true;
-    worker_thread = std::thread(&MatchingEngine::run_loop, this);
+
+    // The worker reports back once it is pinned and its memory is in place, so
+    // a bad configuration surfaces here rather than on a detached thread.
+    std::promise<void> ready;
+    std::future<void> configured = ready.get_future();
+    worker_thread = std::thread([this, &ready] {
+        try {
+            configureWorkerThread();
+        }
+        catch (...) {
+            ready.set_exception(std::current_exception());
+            return;
+        }
+        ready.set_value();
+        run_loop();
+    });
+
+    try {
+        configured.get();
+    }
+    catch (...) {
+        worker_thread.join();
+        running = false;
+        throw;
+    }
 }
 
-void MatchingEngine::stop() {
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::stop() {
+    if (!worker_thread.joinable()) return;
+    // The stop command is queued behind everything already submitted, so the
+    // worker drains pending commands before it exits.
+    incoming_commands.push(Command{CommandType::STOP, 0, nullptr, {}, {}});
+    worker_thread.join();
     running = false;
-    incoming_orders.push(nullptr);
-    incoming_cancellations.push(0);
-    if (worker_thread.joinable()) {
-        worker_thread.join();
+}
+
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::configureWorkerThread() {
+    if (config.matchingCore >= 0) pinCurrentThread(config.matchingCore);
+    if (config.realtimePriority > 0) setCurrentThreadRealtime(config.realtimePriority);
+    if (config.bindMemory) {
+        if (config.matchingCore < 0) throw std::invalid_argument("bindMemory needs a matchingCore");
+        bindCurrentThreadMemory(numaNodeOfCore(config.matchingCore));
     }
+    if (config.prefaultBytes > 0) prefaultMemory(config.prefaultBytes);
+    if (config.expectedOrders > 0) {
+        book.reserve(config.expectedOrders);
+        cancelledOrders.reserve(config.expectedOrders);
+    }
+    if (config.lockMemory) lockProcessMemory();
 }
 
-void MatchingEngine::run_loop() {
+// False when it gave up waiting because an order is due to expire on the wall clock.
+template<typename MatchingPolicy>
+bool BasicMatchingEngine<MatchingPolicy>::nextCommand(Command& command) {
+    const bool expiring = !clock && expiryCheck;
+    const Timestamp due = expiring ? *expiryCheck : Timestamp{};
+    if (config.waitStrategy == WaitStrategy::BUSY_POLL) {
+        for (std::uint32_t spins = 1; !incoming_commands.tryPop(command); spins++) {
+            // The clock is only read every few spins
+            if (expiring && spins % 64 == 0 && std::chrono::system_clock::now() >= due) return false;
+            cpuRelax();
+        }
+        return true;
+    }
+    if (expiring) return incoming_commands.tryPopFor(command, due - std::chrono::system_clock::now());
+    command = incoming_commands.pop();
+    return true;
+}
+
+template<typename MatchingPolicy>
+bool BasicMatchingEngine<MatchingPolicy>::execute(Command& command) {
+    switch (command.type) {
+        case CommandType::SUBMIT:
+            if (command.order) processOrderSubmission(std::move(command.order));
+            break;
+        case CommandType::CANCEL:
+            if (command.orderID != 0) processOrderCancellation(command.orderID);
+            break;
+        case CommandType::MASS_CANCEL:
+            processMassCancel(command.massCancel);
+            break;
+        case CommandType::BEGIN_AUCTION:
+            phase = TradingPhase::AUCTION;
+            break;
+        case CommandType::UNCROSS:
+            processUncross();
+            break;
+        case CommandType::SET_TIME:
+            // The epoch is resumeWallClock()
+            if (command.time == Timestamp{}) {
+                clock.reset();
+                journalClock = Timestamp{};
+            }
+            else clock = command.time;
+            break;
+        case CommandType::STOP:
+            return false;
+    }
+    return true;
+}
+
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::run_loop() {
     while (running) {
-        std::unique_ptr<Order> order = incoming_orders.pop();
-        
-        if (order) processOrderSubmission(std::move(order));
-        
-        OrderID id_to_cancel = incoming_cancellations.pop();
-        if (id_to_cancel != 0) {
-            processOrderCancellation(id_to_cancel);
+        Command command;
+        const bool received = nextCommand(command);
+        if (journal) {
+            sampleWallClock();
+            if (received && command.type != CommandType::STOP) journal->append(command);
         }
+        if (received && !execute(command)) return;
+        processExpiries();
+        // Only this thread writes it
+        if (received) executed.store(executed.load(std::memory_order_relaxed) + 1, std::memory_order_release);
     }
 }
 
-void MatchingEngine::processOrderSubmission(std::unique_ptr<Order> order) {
+template<typename MatchingPolicy>
+std::size_t BasicMatchingEngine<MatchingPolicy>::runPending() {
+    std::size_t processed = 0;
+    Command command;
+    while (incoming_commands.tryPop(command)) {
+        if (journal) sampleWallClock();
+        if (command.type != CommandType::STOP) {
+            if (journal) journal->append(command);
+            execute(command);
+        }
+        processExpiries();
+        if (command.type != CommandType::STOP) executed.store(executed.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        processed++;
+    }
+    return processed;
+}
+
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::processOrderSubmission(std::unique_ptr<Order> order) {
     if (order->getQuantity() == 0) {
         return;
     }
 
-    matchOrder(order.get());    
+    if (std::optional<RejectReason> reason = risk.check(*order)) {
+        order->setOrderStatus(OrderStatus::REJECTED);
+        pendingEvents.emplace_back(OrderRejectedEvent{order->getOrderID(), order->getTraderID(), *reason});
+        publishPendingEvents();
+        return;
+    }
+
+    // An order already past its deadline can still trade on arrival but never rests
+    bool canRest = order->getOrderType() == OrderType::LIMIT;
+    if (order->getTimeInForce() != TimeInForce::GTC) {
+        const Timestamp now = currentTime();
+        if (order->getTimeInForce() == TimeInForce::DAY) order->setExpireTime(sessionCloseAfter(now));
+        canRest = canRest && order->getExpireTime() > now;
+    }
+
+    if (phase == TradingPhase::CONTINUOUS) matchOrder(order.get());
 
     if (order->getQuantity() > 0) {
-        if (order->getOrderType() == OrderType::LIMIT) {
+        if (canRest) {
            placeRestingLimitOrder(std::unique_ptr<LimitOrder>(static_cast<LimitOrder*>(order.release()))); 
         }
         else {
             order->setOrderStatus(OrderStatus::CANCELLED);
-            dispatcher.publish(OrderCancelledEvent{order->getOrderID(), order->getQuantity()});
+            pendingEvents.emplace_back(OrderCancelledEvent{order->getOrderID(), order->getQuantity()});
         }
     }
+    publishPendingEvents();
 }
 
-void MatchingEngine::processOrderCancellation(OrderID orderID) {
-    try {
-        book.cancelOrder(orderID);
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::processOrderCancellation(OrderID orderID) {
+    Order* order = book.getOrder(orderID);
+    if (!order) return;
+
+    const TraderID traderID = order->getTraderID();
+    const Side side = order->getSide();
+    const Quantity quantity = order->getQuantity();
+    book.cancelOrder(orderID);
+    risk.onRestingReduced(traderID, side, quantity, true);
+    dispatcher.publish(OrderCancelledEvent{orderID, quantity});
+}
+
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::processMassCancel(const MassCancelRequest& request) {
+    cancelledOrders.clear();
+    switch (request.scope) {
+        case MassCancelScope::TRADER:
+            book.cancelTraderOrders(request.traderID, std::nullopt, cancelledOrders);
+            break;
+        case MassCancelScope::TRADER_SIDE:
+            book.cancelTraderOrders(request.traderID, request.side, cancelledOrders);
+            break;
+        case MassCancelScope::SYMBOL:
+            book.cancelSymbolOrders(request.symbol, cancelledOrders);
+            break;
+        case MassCancelScope::ALL:
+            book.cancelAllOrders(cancelledOrders);
+            break;
     }
-    catch (const std::invalid_argument& e) {
-        // TODO: add some logic here
+
+    MassCancelEvent event;
+    event.cancelled.reserve(cancelledOrders.size());
+    for (const CancelledOrder& order : cancelledOrders) {
+        risk.onRestingReduced(order.traderID, order.side, order.quantity, true);
+        event.cancelled.push_back({order.orderID, order.quantity});
+    }
+    dispatcher.publish(event);
+}
+
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::processExpiries() {
+    if (!expiryCheck) return;
+    const Timestamp now = currentTime();
+    if (now < *expiryCheck) return;
+
+    cancelledOrders.clear();
+    book.expireOrders(now, cancelledOrders);
+    expiryCheck = book.nextExpiryCheck();
+    for (const CancelledOrder& order : cancelledOrders) {
+        risk.onRestingReduced(order.traderID, order.side, order.quantity, true);
+        dispatcher.publish(OrderCancelledEvent{order.orderID, order.quantity});
+    }
+}
+
+template<typename MatchingPolicy>
+Timestamp BasicMatchingEngine<MatchingPolicy>::currentTime() const {
+    if (clock) return *clock;
+    if (journal) return journalClock;
+    return std::chrono::time_point_cast<std::chrono::milliseconds>(std::chrono::system_clock::now());
+}
+
+// A replica applies the journaled time as a SET_TIME, which expires orders
+// before the next command runs; doing the same here keeps the two in step.
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::sampleWallClock() {
+    if (clock) return;
+    const Timestamp now = std::chrono::time_point_cast<std::chrono::milliseconds>(std::chrono::system_clock::now());
+    if (now == journalClock) return;
+    journalClock = now;
+    journal->appendWallClock(now);
+    processExpiries();
+}
+
+template<typename MatchingPolicy>
+Timestamp BasicMatchingEngine<MatchingPolicy>::sessionCloseAfter(Timestamp now) const {
+    Timestamp close = std::chrono::floor<std::chrono::days>(now) + config.sessionClose;
+    if (close <= now) close += std::chrono::days(1);
+    return close;
+}
+
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::processUncross() {
+    phase = TradingPhase::CONTINUOUS;
+    AuctionUncrossEvent summary{0, 0, 0};
+
+    if (std::optional<AuctionResult> result = book.computeUncross()) {
+        summary = {result->price, result->volume, result->imbalance};
+
+        // Everything at or through the equilibrium price is eligible, so filling
+        // best bid against best ask in time priority executes exactly `volume`.
+        // There is no aggressor in an auction; trades are reported with the buy
+        // order in the aggressing fields.
+        std::uint64_t remaining = result->volume;
+        while (remaining > 0) {
+            LimitOrder* buy = static_cast<LimitOrder*>(book.getOrder(book.getBestBid()->orders.front()));
+            LimitOrder* sell = static_cast<LimitOrder*>(book.getOrder(book.getBestAsk()->orders.front()));
+            const OrderID buyID = buy->getOrderID();
+            const OrderID sellID = sell->getOrderID();
+            const Quantity buyQuantity = buy->getQuantity();
+            Quantity tradeQuantity = std::min(buyQuantity, sell->getQuantity());
+            if (tradeQuantity > remaining) tradeQuantity = static_cast<Quantity>(remaining);
+
+            createTrade(buy, sell, result->price, tradeQuantity);
+            risk.onRestingReduced(buy->getTraderID(), Side::BUY, tradeQuantity, tradeQuantity == buyQuantity);
+            book.reduceOrderQuantity(buyID, tradeQuantity);
+            book.reduceOrderQuantity(sellID, tradeQuantity);
+            remaining -= tradeQuantity;
+        }
     }
+
+    pendingEvents.emplace_back(summary);
+    publishPendingEvents();
 }
 
-void MatchingEngine::matchOrder(Order* incomingOrder) {
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::matchOrder(Order* incomingOrder) {
+    const Side side = incomingOrder->getSide();
+    const bool isLimit = incomingOrder->getOrderType() == OrderType::LIMIT;
+    const Price limitPrice = isLimit ? static_cast<LimitOrder*>(incomingOrder)->getPrice() : 0;
+
     while (incomingOrder->getQuantity() > 0) {
-        std::optional<MarketData> bestOpposingLevel = (incomingOrder->getSide() == Side::BUY) ? book.getBestAsk() : book.getBestBid();
+        std::optional<MarketData> bestOpposingLevel = (side == Side::BUY) ? book.getBestAsk() : book.getBestBid();
         
         if (!bestOpposingLevel) break;
 
-        if (incomingOrder->getOrderType() == OrderType::LIMIT) {
-            auto limitOrder = static_cast<LimitOrder*>(incomingOrder);
-            Price limitPrice = limitOrder->getPrice();
+        if (isLimit) {
             Price bestOpposingPrice = bestOpposingLevel->price;
-
-            if (incomingOrder->getSide() == Side::BUY && limitPrice < bestOpposingPrice) break;
-            if (incomingOrder->getSide() == Side::SELL && limitPrice > bestOpposingPrice) break;
+            if (side == Side::BUY && limitPrice < bestOpposingPrice) break;
+            if (side == Side::SELL && limitPrice > bestOpposingPrice) break;
         }
-        
-        std::list<OrderID> restingOrderIDs = bestOpposingLevel->orders;
 
-        for (OrderID restingOrderID : restingOrderIDs) {
-           Order* genericRestingOrder = book.getOrder(restingOrderID); 
-           if (!genericRestingOrder) continue;
-           
-           LimitOrder* restingOrder = static_cast<LimitOrder*>(genericRestingOrder);
+        // The policy decides who at this level trades and how much; the book
+        // drops filled orders and empty levels as we go.
+        levelFills.clear();
+        MatchingPolicy::allocate(book, *bestOpposingLevel, incomingOrder->getQuantity(), levelFills);
+
+        for (const LevelFill& fill : levelFills) {
+            LimitOrder* restingOrder = fill.order;
 
-           Quantity tradeQuantity = std::min(incomingOrder->getQuantity(), restingOrder->getQuantity());
-           Price tradePrice = restingOrder->getPrice();
+            if (config.selfTradePrevention != SelfTradePrevention::NONE &&
+                restingOrder->getTraderID() == incomingOrder->getTraderID()) {
+                // The level has changed under the allocation, so work it out again
+                preventSelfTrade(incomingOrder, restingOrder);
+                break;
+            }
 
-           createTrade(incomingOrder, restingOrder, tradePrice, tradeQuantity);
+            createTrade(incomingOrder, restingOrder, restingOrder->getPrice(), fill.quantity);
+            incomingOrder->setQuantity(incomingOrder->getQuantity() - fill.quantity);
+            book.reduceOrderQuantity(restingOrder->getOrderID(), fill.quantity);
+        }
+    }
+}
 
-           incomingOrder->setQuantity(incomingOrder->getQuantity() - tradeQuantity);
-           book.reduceOrderQuantity(restingOrderID, tradeQuantity); 
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::preventSelfTrade(Order* aggressor, LimitOrder* resting) {
+    const OrderID restingOrderID = resting->getOrderID();
+    const Quantity restingQuantity = resting->getQuantity();
 
-           if (incomingOrder->getQuantity() == 0) return;
-           
+    switch (config.selfTradePrevention) {
+        case SelfTradePrevention::CANCEL_RESTING:
+            resting->setOrderStatus(OrderStatus::CANCELLED);
+            risk.onRestingReduced(resting->getTraderID(), resting->getSide(), restingQuantity, true);
+            book.cancelOrder(restingOrderID);
+            pendingEvents.emplace_back(OrderCancelledEvent{restingOrderID, restingQuantity});
+            break;
+        case SelfTradePrevention::CANCEL_AGGRESSOR:
+            aggressor->setOrderStatus(OrderStatus::CANCELLED);
+            pendingEvents.emplace_back(OrderCancelledEvent{aggressor->getOrderID(), aggressor->getQuantity()});
+            aggressor->setQuantity(0);
+            break;
+        case SelfTradePrevention::DECREMENT_BOTH: {
+            // Whichever side is left with quantity stays live, and the aggressor keeps matching
+            Quantity decrement = std::min(aggressor->getQuantity(), restingQuantity);
+            risk.onRestingReduced(resting->getTraderID(), resting->getSide(), decrement, decrement == restingQuantity);
+            book.reduceOrderQuantity(restingOrderID, decrement);
+            aggressor->setQuantity(aggressor->getQuantity() - decrement);
+            if (aggressor->getQuantity() == 0) aggressor->setOrderStatus(OrderStatus::CANCELLED);
+            pendingEvents.emplace_back(OrderCancelledEvent{restingOrderID, decrement, restingQuantity - decrement});
+            pendingEvents.emplace_back(OrderCancelledEvent{aggressor->getOrderID(), decrement, aggressor->getQuantity()});
+            break;
         }
+        case SelfTradePrevention::NONE:
+            break;
     }
 }
 
-void MatchingEngine::placeRestingLimitOrder(std::unique_ptr<LimitOrder> order) {
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::placeRestingLimitOrder(std::unique_ptr<LimitOrder> order) {
     order->setOrderStatus(OrderStatus::ACCEPTED);
+    risk.onOrderRested(order->getTraderID(), order->getSide(), order->getQuantity());
+    pendingEvents.emplace_back(OrderAcceptedEvent{order->getOrderID(), order->getPrice(), order->getQuantity(), order->getSymbol(), order->getSide()});
+    if (order->getTimeInForce() != TimeInForce::GTC && (!expiryCheck || order->getExpireTime() < *expiryCheck)) {
+        expiryCheck = order->getExpireTime();
+    }
     book.addOrder(std::move(order));
 }
 
-void MatchingEngine::createTrade(Order* aggressor, Order* resting, Price tradePrice, Quantity tradeQuantity) {
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::createTrade(Order* aggressor, Order* resting, Price tradePrice, Quantity tradeQuantity) {
     Quantity aggressorRemaining = aggressor->getQuantity() - tradeQuantity;
     Quantity restingRemaining = resting->getQuantity() - tradeQuantity;
     aggressor->setOrderStatus(aggressorRemaining > 0 ? OrderStatus::PARTIALLY_FILLED : OrderStatus::FILLED);
     resting->setOrderStatus(restingRemaining > 0 ? OrderStatus::PARTIALLY_FILLED : OrderStatus::FILLED);
-    dispatcher.publish(TradeExecutedEvent{aggressor->getSymbol(), tradePrice, tradeQuantity, 
-        aggressor->getOrderID(), aggressor->getTraderID(), aggressor->getSide(), aggressor->getQuantity(), 
-        resting->getOrderID(), resting->getTraderID(), resting->getQuantity()});
+    risk.onTrade(aggressor->getTraderID(), aggressor->getSide(), resting->getTraderID(), tradePrice, tradeQuantity, restingRemaining == 0);
+    pendingEvents.emplace_back(TradeExecutedEvent{aggressor->getSymbol(), tradePrice, tradeQuantity, 
+        aggressor->getOrderID(), aggressor->getTraderID(), aggressor->getSide(), aggressorRemaining, 
+        resting->getOrderID(), resting->getTraderID(), restingRemaining, currentTime()});
 }
 
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::publishPendingEvents() {
+    for (const EngineEvent& event : pendingEvents) {
+        std::visit([this](const auto& e) { dispatcher.publish(e); }, event);
+    }
+    pendingEvents.clear();
+}
 
+template<typename MatchingPolicy>
+void BasicMatchingEngine<MatchingPolicy>::setRiskLimits(TraderID traderID, const RiskLimits& limits) {
+    risk.setLimits(traderID, limits);
+}
 
-
+template class BasicMatchingEngine<FifoMatching>;
+template class BasicMatchingEngine<ProRataMatching>;
+template class BasicMatchingEngine<TopOrderProRataMatching>;
@@ -6,37 +6,170 @@
 #include "eventDispatcher.h"
 #include "events.h"
 #include <memory>
+#include <variant>
+#include <vector>
 #include "threadSafeQueue.h"
+#include "engineConfig.h"
+#include "riskManager.h"
+#include "matchingPolicy.h"
 
-class MatchingEngine {
+enum class CommandType {
+    SUBMIT,
+    CANCEL,
+    MASS_CANCEL,
+    BEGIN_AUCTION,
+    UNCROSS,
+    SET_TIME,
+    STOP
+};
+
+enum class MassCancelScope {
+    TRADER,
+    TRADER_SIDE,
+    SYMBOL,
+    ALL
+};
+
+// During an auction orders rest without matching until the uncross.
+enum class TradingPhase {
+    CONTINUOUS,
+    AUCTION
+};
+
+struct MassCancelRequest {
+    MassCancelScope scope = MassCancelScope::ALL;
+    TraderID traderID = 0;
+    Side side = Side::BUY;
+    str symbol;
+};
+
+struct Command {
+    CommandType type = CommandType::STOP;
+    OrderID orderID = 0;
+    std::unique_ptr<Order> order;
+    MassCancelRequest massCancel;
+    Timestamp time{};
+};
+
+// Receives every command on the matching thread, in execution order, just
+// before it runs; see ReplicationPrimary. Engines built with the same config
+// and risk overrides that apply the same journal end up in the same state.
+class CommandJournal {
+    public:
+        virtual ~CommandJournal() = default;
+        virtual void append(const Command& command) = 0;
+        // Wall-clock time the following commands run at, while no clock is set.
+        virtual void appendWallClock(Timestamp now) = 0;
+};
+
+using EngineEvent = std::variant<TradeExecutedEvent, OrderAcceptedEvent, OrderCancelledEvent, OrderRejectedEvent, MassCancelEvent, AuctionUncrossEvent>;
+
+// The allocation policy is a template parameter so the matching loop calls it
+// directly; the instantiations below are compiled in matchingEngine.cpp.
+template<typename MatchingPolicy>
+class BasicMatchingEngine {
     private:
         OrderBook& book;
         EventDispatcher& dispatcher;
+        EngineConfig config;
         std::atomic<OrderID> nextOrderID;
+        RiskManager risk;
+        TradingPhase phase = TradingPhase::CONTINUOUS;
+        // Set by setTime(); the wall clock until then
+        std::optional<Timestamp> clock;
+        // Until then no order can expire, so the loop neither checks the book
+        // nor wakes up for it; moved earlier as DAY/GTD orders rest.
+        std::optional<Timestamp> expiryCheck;
+        CommandJournal* journal = nullptr;
+        Timestamp journalClock{};
+
+        // Events raised while processing a command are published once the book
+        // reflects the whole command, so subscribers never observe it half-applied.
+        std::vector<EngineEvent> pendingEvents;
+        std::vector<CancelledOrder> cancelledOrders;
+        std::vector<LevelFill> levelFills;
 
         std::thread worker_thread;
         std::atomic<bool> running{false};
-        ThreadSafeQueue<OrderID> incoming_cancellations;
-        ThreadSafeQueue<std::unique_ptr<Order>> incoming_orders;
+        std::atomic<std::uint64_t> executed{0};
+        ThreadSafeQueue<Command> incoming_commands;
 
         void processOrderSubmission(std::unique_ptr<Order> order);
         void processOrderCancellation(OrderID orderID);
+        void processMassCancel(const MassCancelRequest& request);
+        void processUncross();
+        void processExpiries();
+        Timestamp currentTime() const;
+        void sampleWallClock();
+        Timestamp sessionCloseAfter(Timestamp now) const;
         void matchOrder(Order* incomingOrder);
         void placeRestingLimitOrder(std::unique_ptr<LimitOrder> order);
+        void preventSelfTrade(Order* aggressor, LimitOrder* resting);
         void createTrade(Order* aggressor, Order* resting, Price tradePrice, Quantity tradeQuantity);
+        void publishPendingEvents();
 
+        void configureWorkerThread();
+        bool nextCommand(Command& command);
+        bool execute(Command& command);
         void run_loop();
 
     public:
-        MatchingEngine(OrderBook& orderBook, EventDispatcher& eventDispatcher);
-        ~MatchingEngine();
+        BasicMatchingEngine(OrderBook& orderBook, EventDispatcher& eventDispatcher, const EngineConfig& engineConfig = EngineConfig{});
+        ~BasicMatchingEngine();
         
         OrderID submitOrder(std::unique_ptr<Order> order);
+        // For callers that need an order's id before it reaches the engine:
+        // reserve the id, stamp it on the order, then submitReserved().
+        OrderID reserveOrderID() { return nextOrderID.fetch_add(1); }
+        bool isRunning() const { return running.load(); }
+        void submitReserved(std::unique_ptr<Order> order);
         void cancelOrder(OrderID orderID);
+        void massCancel(TraderID traderID);
+        void massCancel(TraderID traderID, Side side);
+        void massCancelSymbol(const str& symbol);
+        void massCancelAll();
+
+        // Queue an auction: orders accumulate until uncross(), which executes
+        // everything at one equilibrium price and resumes continuous matching.
+        void beginAuction();
+        void uncross();
+
+        // DAY and GTD orders expire against the engine clock, checked between
+        // commands, and trades are stamped with it. It follows the wall clock until setTime(), after which it
+        // only moves when told to, queued in order with everything else (bar
+        // timestamps in a backtest, simulated time in a simulation).
+        void setTime(Timestamp now);
+        // Back to the wall clock, e.g. on a promoted backup.
+        void resumeWallClock();
+
+        // Set before start(). With a journal, the wall clock is read once per
+        // command and journaled, and orders due by then expire before it runs.
+        void setJournal(CommandJournal* commandJournal) { journal = commandJournal; }
+        // Ids assigned from here on are at least `next`, so a promoted backup
+        // carries on from the primary's.
+        void advanceOrderIDs(OrderID next);
         
         void start();
         void stop();
 
+        // Processes every queued command on the calling thread and returns how
+        // many ran. For deterministic simulation only; never while started.
+        std::size_t runPending();
+        // Commands run to completion so far, STOP aside; readable from any thread.
+        std::uint64_t executedCommands() const { return executed.load(std::memory_order_acquire); }
+
+        const EngineConfig& getConfig() const { return config; }
+
+        // Risk state is owned by the matching thread; set overrides before start().
+        void setRiskLimits(TraderID traderID, const RiskLimits& limits);
+        const RiskManager& getRiskManager() const { return risk; }
+
 };
 
+extern template class BasicMatchingEngine<FifoMatching>;
+extern template class BasicMatchingEngine<ProRataMatching>;
+extern template class BasicMatchingEngine<TopOrderProRataMatching>;
 
+using MatchingEngine = BasicMatchingEngine<FifoMatching>;
+using ProRataMatchingEngine = BasicMatchingEngine<ProRataMatching>;
+using TopOrderMatchingEngine = BasicMatchingEngine<TopOrderProRataMatching>;
@@ -0,0 +1,55 @@
+#include "matchingPolicy.h"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+    // Pro-rata over the orders in [begin, end), whose sizes total `levelQuantity`.
+    void allocateProRata(OrderBook& book, std::list<OrderID>::const_iterator begin, std::list<OrderID>::const_iterator end,
+                         std::uint64_t levelQuantity, Quantity incoming, std::vector<LevelFill>& fills) {
+        if (incoming == 0 || levelQuantity == 0) return;
+
+        const std::size_t first = fills.size();
+        Quantity allocated = 0;
+        for (auto it = begin; it != end; ++it) {
+            LimitOrder* order = static_cast<LimitOrder*>(book.getOrder(*it));
+            Quantity share = incoming >= levelQuantity
+                ? order->getQuantity()
+                : static_cast<Quantity>(static_cast<std::uint64_t>(incoming) * order->getQuantity() / levelQuantity);
+            fills.push_back({order, share});
+            allocated += share;
+        }
+
+        // Rounding leftovers go out in time priority
+        Quantity leftover = std::min<std::uint64_t>(incoming, levelQuantity) - allocated;
+        for (std::size_t i = first; i < fills.size() && leftover > 0; ++i) {
+            Quantity extra = std::min(leftover, fills[i].order->getQuantity() - fills[i].quantity);
+            fills[i].quantity += extra;
+            leftover -= extra;
+        }
+
+        fills.erase(std::remove_if(fills.begin() + first, fills.end(), [](const LevelFill& fill) { return fill.quantity == 0; }),
+                    fills.end());
+    }
+}
+
+void FifoMatching::allocate(OrderBook& book, const MarketData& level, Quantity incoming, std::vector<LevelFill>& fills) {
+    for (OrderID orderID : level.orders) {
+        if (incoming == 0) break;
+        LimitOrder* order = static_cast<LimitOrder*>(book.getOrder(orderID));
+        Quantity quantity = std::min(incoming, order->getQuantity());
+        fills.push_back({order, quantity});
+        incoming -= quantity;
+    }
+}
+
+void ProRataMatching::allocate(OrderBook& book, const MarketData& level, Quantity incoming, std::vector<LevelFill>& fills) {
+    allocateProRata(book, level.orders.begin(), level.orders.end(), level.quantity, incoming, fills);
+}
+
+void TopOrderProRataMatching::allocate(OrderBook& book, const MarketData& level, Quantity incoming, std::vector<LevelFill>& fills) {
+    LimitOrder* top = static_cast<LimitOrder*>(book.getOrder(level.orders.front()));
+    Quantity topQuantity = std::min(incoming, top->getQuantity());
+    fills.push_back({top, topQuantity});
+    allocateProRata(book, std::next(level.orders.begin()), level.orders.end(),
+                    level.quantity - top->getQuantity(), incoming - topQuantity, fills);
+}
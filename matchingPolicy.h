@@ -0,0 +1,33 @@
+#pragma once
+#include <vector>
+#include "orderBook.h"
+#include "limitOrder.h"
+#include "types.h"
+
+// How much of one resting order an incoming order takes at a price level.
+struct LevelFill {
+    LimitOrder* order;
+    Quantity quantity;
+};
+
+// Allocation policies for BasicMatchingEngine. Each one splits `incoming`
+// across the orders resting at `level` and appends the fills, in the order
+// they should execute, to `fills`. They never allocate more than the level
+// holds and never emit empty fills. The engine picks one at compile time.
+
+// Strict price-time priority: the oldest order fills first.
+struct FifoMatching {
+    static void allocate(OrderBook& book, const MarketData& level, Quantity incoming, std::vector<LevelFill>& fills);
+};
+
+// Pro-rata on resting size: each order gets floor(incoming * size / level size),
+// and the lots lost to rounding go to orders in time priority.
+struct ProRataMatching {
+    static void allocate(OrderBook& book, const MarketData& level, Quantity incoming, std::vector<LevelFill>& fills);
+};
+
+// The order at the front of the level is filled first, the remainder is
+// split pro-rata across the rest, as on futures venues with top-order priority.
+struct TopOrderProRataMatching {
+    static void allocate(OrderBook& book, const MarketData& level, Quantity incoming, std::vector<LevelFill>& fills);
+};
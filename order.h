@@ -17,6 +17,14 @@ enum class OrderType {
     MARKET
 };
 
+// How long a limit order may rest. DAY orders expire at the engine's session
+// close, GTD orders at their expire time.
+enum class TimeInForce {
+    GTC,
+    DAY,
+    GTD
+};
+
 enum class OrderStatus {
     NEW,
     ACCEPTED,
@@ -36,6 +44,16 @@ class Order {
         Quantity quantity;
         TraderID traderID;
         Timestamp timestamp = std::chrono::time_point_cast<std::chrono::milliseconds>(std::chrono::system_clock::now());  
+        TimeInForce timeInForce = TimeInForce::GTC;
+        Timestamp expireTime{};
+
+        // Intrusive links through all resting orders of the same trader,
+        // maintained by OrderBook so mass cancels never scan the book.
+        Order* traderPrev = nullptr;
+        Order* traderNext = nullptr;
+        // Handle in OrderBook's expiry wheel while a DAY/GTD order rests.
+        std::uint32_t expiryTimer = ~std::uint32_t{0};
+        friend class OrderBook;
     public:
 
         virtual ~Order() {}
@@ -85,4 +103,16 @@ class Order {
         Timestamp getTimestamp() {
             return timestamp;
         }
+        TimeInForce getTimeInForce() {
+            return timeInForce;
+        }
+        void setTimeInForce(TimeInForce tif) {
+            this->timeInForce = tif;
+        }
+        Timestamp getExpireTime() {
+            return expireTime;
+        }
+        void setExpireTime(Timestamp t) {
+            this->expireTime = t;
+        }
        };
\ No newline at end of file
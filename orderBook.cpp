@@ -1,4 +1,12 @@
 #include "orderBook.h"
+#include <cstdlib>
+#include <limits>
+
+
+OrderBook::OrderBook() {
+    analytics.depthTicks = 5;
+    publishAnalytics();
+}
 
 
 void OrderBook::addOrder(std::unique_ptr<LimitOrder> order) {
@@ -25,11 +33,24 @@ void OrderBook::addOrder(std::unique_ptr<LimitOrder> order) {
             break;
     }
 
+    linkTraderOrder(order.get());
+    if (order->getTimeInForce() != TimeInForce::GTC) {
+        order->expiryTimer = expiries.schedule(order->getExpireTime().time_since_epoch().count(), orderID);
+    }
     allOrders[order->getOrderID()] = std::move(order);
+    levelChanged(side, price, quantity);
+    publishAnalytics();
 };
 
 
 void OrderBook::removeOrder(OrderID orderID) {
+    std::lock_guard<std::mutex> lock(mtx);
+    eraseOrder(orderID);
+    publishAnalytics();
+}
+
+
+void OrderBook::eraseOrder(OrderID orderID) {
     auto it = allOrders.find(orderID);
     if (it == allOrders.end()) {
         throw std::invalid_argument("Order to cancel does not exist.");
@@ -65,13 +86,18 @@ void OrderBook::removeOrder(OrderID orderID) {
         }
     }
         
+    const Side side = order->getSide();
+    unlinkTraderOrder(order);
+    if (order->expiryTimer != TimingWheel::NONE) expiries.cancel(order->expiryTimer);
     orderIterators.erase(iter_it);
     allOrders.erase(it);
+    levelChanged(side, price, -static_cast<std::int64_t>(quantity));
 };
 
 void OrderBook::cancelOrder(OrderID orderID) {
     std::lock_guard<std::mutex> lock(mtx);
-    removeOrder(orderID);
+    eraseOrder(orderID);
+    publishAnalytics();
 }
 
 Order* OrderBook::getOrder(OrderID id) {
@@ -102,8 +128,10 @@ void OrderBook::reduceOrderQuantity(OrderID orderID, Quantity quantityToReduce)
     else {
         ask_quantities.at(price) -= quantityToReduce;
     }
+    levelChanged(limitOrder->getSide(), price, -static_cast<std::int64_t>(quantityToReduce));
 
-    if (newQuantity == 0) removeOrder(orderID); 
+    if (newQuantity == 0) eraseOrder(orderID);
+    publishAnalytics();
 }
 
 std::optional<MarketData> OrderBook::getBestBid() {
@@ -125,6 +153,24 @@ std::optional<MarketData> OrderBook::getBestAsk() {
     return MarketData(price, ask_quantities.at(price), orders);
 }
 
+
+std::vector<LevelSnapshot> OrderBook::depth(Side side) {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::vector<LevelSnapshot> levels;
+    auto add = [&levels](Price price, const std::list<OrderID>& orders, const std::map<Price, Quantity>& quantities) {
+        auto quantity = quantities.find(price);
+        levels.push_back({price, quantity == quantities.end() ? 0 : quantity->second, {orders.begin(), orders.end()}});
+    };
+    if (side == Side::BUY) {
+        for (auto it = bids.rbegin(); it != bids.rend(); ++it) add(it->first, it->second, bid_quantities);
+    }
+    else {
+        for (const auto& [price, orders] : asks) add(price, orders, ask_quantities);
+    }
+    return levels;
+}
+
+
 bool OrderBook::isEmpty() {
     std::lock_guard<std::mutex> lock(mtx);
     return allOrders.empty();
@@ -135,4 +181,230 @@ bool OrderBook::isSideEmpty(Side side) {
     return side == Side::BUY ? bids.empty() : asks.empty();
 }
 
+void OrderBook::reserve(std::size_t expectedOrders) {
+    std::lock_guard<std::mutex> lock(mtx);
+    allOrders.reserve(expectedOrders);
+    orderIterators.reserve(expectedOrders);
+}
+
+void OrderBook::setAnalyticsDepth(Price ticks) {
+    std::lock_guard<std::mutex> lock(mtx);
+    analytics.depthTicks = ticks;
+    analytics.bidDepth = windowDepth(Side::BUY);
+    analytics.askDepth = windowDepth(Side::SELL);
+    publishAnalytics();
+}
+
+// Sum of the levels within depthTicks of the best price. Only needed when the
+// best price moves; otherwise levelChanged adjusts the window in place.
+std::uint64_t OrderBook::windowDepth(Side side) const {
+    std::uint64_t depth = 0;
+    const Price ticks = analytics.depthTicks;
+    if (side == Side::BUY) {
+        if (bid_quantities.empty()) return 0;
+        const Price best = bid_quantities.rbegin()->first;
+        for (auto it = bid_quantities.lower_bound(best > ticks ? best - ticks : 0); it != bid_quantities.end(); ++it) depth += it->second;
+    }
+    else {
+        if (ask_quantities.empty()) return 0;
+        const Price best = ask_quantities.begin()->first;
+        const Price limit = best + ticks < best ? std::numeric_limits<Price>::max() : best + ticks;
+        for (auto it = ask_quantities.begin(); it != ask_quantities.end() && it->first <= limit; ++it) depth += it->second;
+    }
+    return depth;
+}
+
+void OrderBook::levelChanged(Side side, Price price, std::int64_t quantityDelta) {
+    const bool buy = side == Side::BUY;
+    const auto& levels = buy ? bids : asks;
+    const auto& quantities = buy ? bid_quantities : ask_quantities;
+    Price& bestPrice = buy ? analytics.bidPrice : analytics.askPrice;
+    Quantity& bestQuantity = buy ? analytics.bidQuantity : analytics.askQuantity;
+    std::uint32_t& bestOrders = buy ? analytics.bidOrders : analytics.askOrders;
+    std::uint64_t& depth = buy ? analytics.bidDepth : analytics.askDepth;
+
+    if (levels.empty()) {
+        bestPrice = 0;
+        bestQuantity = 0;
+        bestOrders = 0;
+        depth = 0;
+    }
+    else {
+        const auto& best = buy ? *levels.rbegin() : *levels.begin();
+        if (best.first != bestPrice) {
+            bestPrice = best.first;
+            depth = windowDepth(side);
+        }
+        else if (buy ? static_cast<std::uint64_t>(price) + analytics.depthTicks >= bestPrice
+                     : static_cast<std::uint64_t>(bestPrice) + analytics.depthTicks >= price) {
+            depth += quantityDelta;
+        }
+        auto quantity = quantities.find(bestPrice);
+        bestQuantity = quantity == quantities.end() ? 0 : quantity->second;
+        bestOrders = static_cast<std::uint32_t>(best.second.size());
+    }
+}
+
+void OrderBook::publishAnalytics() {
+    sharedAnalytics.store(analytics);
+}
+
+void OrderBook::linkTraderOrder(Order* order) {
+    Order*& head = traderOrders[order->getTraderID()];
+    order->traderPrev = nullptr;
+    order->traderNext = head;
+    if (head) head->traderPrev = order;
+    head = order;
+}
+
+void OrderBook::unlinkTraderOrder(Order* order) {
+    if (order->traderNext) order->traderNext->traderPrev = order->traderPrev;
+    if (order->traderPrev) {
+        order->traderPrev->traderNext = order->traderNext;
+    }
+    else if (order->traderNext) {
+        traderOrders[order->getTraderID()] = order->traderNext;
+    }
+    else {
+        traderOrders.erase(order->getTraderID());
+    }
+    order->traderPrev = order->traderNext = nullptr;
+}
+
+void OrderBook::collectCancelled(Order* order, std::vector<CancelledOrder>& cancelled) {
+    order->setOrderStatus(OrderStatus::CANCELLED);
+    cancelled.push_back({order->getOrderID(), order->getTraderID(), order->getSide(), order->getQuantity()});
+}
+
+void OrderBook::cancelTraderOrders(TraderID traderID, std::optional<Side> side, std::vector<CancelledOrder>& cancelled) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto head = traderOrders.find(traderID);
+    if (head == traderOrders.end()) return;
+
+    Order* order = head->second;
+    while (order) {
+        Order* next = order->traderNext;
+        if (!side || order->getSide() == *side) {
+            collectCancelled(order, cancelled);
+            eraseOrder(order->getOrderID());
+        }
+        order = next;
+    }
+    publishAnalytics();
+}
+
+void OrderBook::cancelSymbolOrders(const str& symbol, std::vector<CancelledOrder>& cancelled) {
+    std::lock_guard<std::mutex> lock(mtx);
+    const std::size_t first = cancelled.size();
+    for (auto& [orderID, order] : allOrders) {
+        if (order->getSymbol() == symbol) collectCancelled(order.get(), cancelled);
+    }
+    for (std::size_t i = first; i < cancelled.size(); ++i) eraseOrder(cancelled[i].orderID);
+    publishAnalytics();
+}
+
+void OrderBook::cancelAllOrders(std::vector<CancelledOrder>& cancelled) {
+    std::lock_guard<std::mutex> lock(mtx);
+    cancelled.reserve(cancelled.size() + allOrders.size());
+    for (auto& [orderID, order] : allOrders) collectCancelled(order.get(), cancelled);
+
+    // Everything goes, so drop the containers wholesale instead of unlinking order by order
+    bids.clear();
+    bid_quantities.clear();
+    asks.clear();
+    ask_quantities.clear();
+    orderIterators.clear();
+    traderOrders.clear();
+    allOrders.clear();
+    expiries.clear();
+
+    const Price depthTicks = analytics.depthTicks;
+    analytics = BookAnalytics{};
+    analytics.depthTicks = depthTicks;
+    publishAnalytics();
+}
+
+void OrderBook::expireOrders(Timestamp now, std::vector<CancelledOrder>& expired) {
+    std::lock_guard<std::mutex> lock(mtx);
+    expiredIDs.clear();
+    expiries.advance(now.time_since_epoch().count(), expiredIDs);
+    if (expiredIDs.empty()) return;
+
+    for (OrderID orderID : expiredIDs) {
+        Order* order = allOrders.at(orderID).get();
+        // The wheel has already released the timer
+        order->expiryTimer = TimingWheel::NONE;
+        collectCancelled(order, expired);
+        eraseOrder(orderID);
+    }
+    publishAnalytics();
+}
+
+std::size_t OrderBook::scheduledExpiries() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return expiries.size();
+}
+
+std::optional<Timestamp> OrderBook::nextExpiryCheck() {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::optional<std::int64_t> due = expiries.nextDue();
+    if (!due) return std::nullopt;
+    return Timestamp(std::chrono::milliseconds(*due));
+}
+
+std::optional<AuctionResult> OrderBook::computeUncross() {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (bid_quantities.empty() || ask_quantities.empty()) return std::nullopt;
+
+    const Price low = ask_quantities.begin()->first;
+    const Price high = bid_quantities.rbegin()->first;
+    if (high < low) return std::nullopt;
 
+    // Walking prices upward, supply accumulates asks at or below the price and
+    // demand sheds bids below it, so each candidate costs O(1).
+    auto bid = bid_quantities.lower_bound(low);
+    auto ask = ask_quantities.begin();
+    std::uint64_t demand = 0;
+    std::uint64_t supply = 0;
+    for (auto it = bid; it != bid_quantities.end(); ++it) demand += it->second;
+
+    AuctionResult best{0, 0, 0};
+    Price tieHigh = 0;
+    Price crossing = 0;     // first tied price where the surplus flips side
+    while (true) {
+        const bool hasBid = bid != bid_quantities.end() && bid->first <= high;
+        const bool hasAsk = ask != ask_quantities.end() && ask->first <= high;
+        if (!hasBid && !hasAsk) break;
+
+        const Price price = !hasAsk ? bid->first : !hasBid ? ask->first : std::min(bid->first, ask->first);
+        if (hasAsk && ask->first == price) supply += (ask++)->second;
+
+        const std::uint64_t volume = std::min(demand, supply);
+        const std::int64_t imbalance = static_cast<std::int64_t>(demand) - static_cast<std::int64_t>(supply);
+        if (volume > best.volume || (volume == best.volume && std::llabs(imbalance) < std::llabs(best.imbalance))) {
+            best = {price, volume, imbalance};
+            tieHigh = price;
+            crossing = 0;
+        }
+        else if (volume == best.volume && imbalance == best.imbalance) {
+            tieHigh = price;
+        }
+        else if (volume == best.volume && imbalance == -best.imbalance && crossing == 0) {
+            crossing = price;
+        }
+
+        if (hasBid && bid->first == price) demand -= (bid++)->second;
+    }
+
+    // Among equally good prices, lean towards the side with surplus interest.
+    // Buy surplus up to tieHigh and sell surplus from crossing means neither side
+    // presses: any price strictly between them leaves no imbalance.
+    if (crossing != 0) {
+        const Price mid = tieHigh + (crossing - tieHigh) / 2;
+        best.price = tieHigh;
+        if (mid != tieHigh) best = {mid, best.volume, 0};
+    }
+    else if (best.imbalance > 0) best.price = tieHigh;
+    else if (best.imbalance == 0) best.price += (tieHigh - best.price) / 2;
+    return best;
+}
@@ -1,14 +1,19 @@
 #pragma once
+#include <cstdint>
 #include <map>
+#include <unordered_map>
 #include <list>
 #include <algorithm>
 #include <mutex>
 #include <memory>
 #include <optional>
+#include <vector>
 #include "order.h"
 #include "limitOrder.h"
 #include "marketOrder.h"
 #include "types.h"
+#include "bookAnalytics.h"
+#include "timingWheel.h"
 
 
 struct MarketData {
@@ -21,6 +26,32 @@ struct MarketData {
 };
 
 
+struct CancelledOrder {
+    OrderID orderID;
+    TraderID traderID;
+    Side side;
+    Quantity quantity;
+};
+
+
+// One price level as returned by depth(), orders in time priority.
+struct LevelSnapshot {
+    Price price;
+    Quantity quantity;
+    std::vector<OrderID> orders;
+};
+
+
+// Equilibrium of a call auction: the price that executes the most volume,
+// then leaves the smallest imbalance. `imbalance` is buy minus sell interest
+// at that price.
+struct AuctionResult {
+    Price price;
+    std::uint64_t volume;
+    std::int64_t imbalance;
+};
+
+
 class OrderBook {
     private:
         std::mutex mtx;
@@ -30,8 +61,28 @@ class OrderBook {
         std::map<Price, Quantity> ask_quantities;
         std::unordered_map<OrderID, std::unique_ptr<Order>> allOrders;
         std::unordered_map<OrderID, std::list<OrderID>::iterator> orderIterators;
+        std::unordered_map<TraderID, Order*> traderOrders;
+
+        // Deadlines of resting DAY/GTD orders, in ms since epoch
+        TimingWheel expiries;
+        std::vector<std::uint64_t> expiredIDs;
+
+        // Writer-side analytics, updated under the mutex as levels change and
+        // published to `sharedAnalytics` once per public mutation
+        BookAnalytics analytics;
+        SharedBookAnalytics sharedAnalytics;
+
+        void eraseOrder(OrderID orderID);
+        void levelChanged(Side side, Price price, std::int64_t quantityDelta);
+        std::uint64_t windowDepth(Side side) const;
+        void publishAnalytics();
+        void linkTraderOrder(Order* order);
+        void unlinkTraderOrder(Order* order);
+        void collectCancelled(Order* order, std::vector<CancelledOrder>& cancelled);
         
     public:
+        OrderBook();
+
         void addOrder(std::unique_ptr<LimitOrder> order);
         void removeOrder(OrderID orderID);
         void cancelOrder(OrderID orderID);
@@ -39,6 +90,33 @@ class OrderBook {
         void reduceOrderQuantity(OrderID orderID, Quantity quantityToReduce);
         std::optional<MarketData> getBestBid();
         std::optional<MarketData> getBestAsk();
+        // Every level on one side, best first. Copies, so it is safe to hold on to.
+        std::vector<LevelSnapshot> depth(Side side);
         bool isEmpty();
         bool isSideEmpty(Side side);
+        void reserve(std::size_t expectedOrders);
+
+        // Lock-free and O(1): a consistent copy of the latest analytics, safe
+        // to call from any thread while the engine is mutating the book.
+        BookAnalytics getAnalytics() const { return sharedAnalytics.load(); }
+        // Width of the bidDepth/askDepth window in ticks (default 5).
+        void setAnalyticsDepth(Price ticks);
+
+        // Mass cancels append what they removed to `cancelled`. Per-trader
+        // cancels cost O(orders of that trader); the others walk the book.
+        void cancelTraderOrders(TraderID traderID, std::optional<Side> side, std::vector<CancelledOrder>& cancelled);
+        void cancelSymbolOrders(const str& symbol, std::vector<CancelledOrder>& cancelled);
+        void cancelAllOrders(std::vector<CancelledOrder>& cancelled);
+
+        // Removes every DAY/GTD order whose expire time is at or before `now`
+        // and appends it to `expired`, earliest deadline first. O(1) per order
+        // however many deadlines are outstanding.
+        void expireOrders(Timestamp now, std::vector<CancelledOrder>& expired);
+        std::size_t scheduledExpiries();
+        // No expireOrders() before this time can remove anything; empty when
+        // no DAY/GTD order is resting.
+        std::optional<Timestamp> nextExpiryCheck();
+
+        // Single merge walk over the crossed price range; nullopt if the book is not crossed.
+        std::optional<AuctionResult> computeUncross();
 };
\ No newline at end of file
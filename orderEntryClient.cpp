@@ -0,0 +1,183 @@
+#include "orderEntryClient.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+OrderEntryClient::OrderEntryClient() : inbound(new char[INBOUND_BUFFER]) {}
+
+OrderEntryClient::~OrderEntryClient() {
+    close();
+}
+
+void OrderEntryClient::connect(const str& host, std::uint16_t port) {
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &result) != 0 || result == nullptr) {
+        throw std::runtime_error("Cannot resolve " + host);
+    }
+
+    fd = socket(result->ai_family, result->ai_socktype | SOCK_CLOEXEC, result->ai_protocol);
+    if (fd < 0 || ::connect(fd, result->ai_addr, result->ai_addrlen) < 0) {
+        int error = errno;
+        freeaddrinfo(result);
+        close();
+        throw std::system_error(error, std::generic_category(), "connect");
+    }
+    freeaddrinfo(result);
+
+    int enable = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    outboundSequence = 1;
+    inboundStart = inboundEnd = 0;
+}
+
+void OrderEntryClient::close() {
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+}
+
+template<typename Message>
+void OrderEntryClient::send(Message& message, GatewayMessageType type) {
+    message.header = {static_cast<std::uint16_t>(sizeof(Message)), type, 0, outboundSequence++};
+    sendRaw(&message, sizeof(Message));
+}
+
+void OrderEntryClient::sendRaw(const void* data, std::size_t size) {
+    if (fd < 0) throw std::logic_error("Order entry session is not connected");
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t sent = ::send(fd, bytes, size, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            throw std::system_error(errno, std::generic_category(), "send");
+        }
+        bytes += sent;
+        size -= static_cast<std::size_t>(sent);
+    }
+}
+
+void OrderEntryClient::login(TraderID traderID) {
+    LoginRequest request{};
+    request.traderID = traderID;
+    send(request, GatewayMessageType::LOGIN);
+}
+
+void OrderEntryClient::enterOrder(OrderToken token, const str& symbol, Side side, OrderType orderType, Price price, Quantity quantity) {
+    if (symbol.size() > sizeof(EnterOrderRequest::symbol)) throw std::invalid_argument("Symbol longer than 8 characters: " + symbol);
+    EnterOrderRequest request{};
+    request.token = token;
+    std::memcpy(request.symbol, symbol.data(), symbol.size());
+    request.price = price;
+    request.quantity = quantity;
+    request.side = static_cast<std::uint8_t>(side);
+    request.orderType = static_cast<std::uint8_t>(orderType);
+    send(request, GatewayMessageType::ENTER_ORDER);
+}
+
+void OrderEntryClient::cancelOrder(OrderToken token) {
+    CancelOrderRequest request{};
+    request.token = token;
+    send(request, GatewayMessageType::CANCEL_ORDER);
+}
+
+void OrderEntryClient::replaceOrder(OrderToken existingToken, OrderToken newToken, Price price, Quantity quantity) {
+    ReplaceOrderRequest request{};
+    request.existingToken = existingToken;
+    request.newToken = newToken;
+    request.price = price;
+    request.quantity = quantity;
+    send(request, GatewayMessageType::REPLACE_ORDER);
+}
+
+bool OrderEntryClient::receive(GatewayResponse& response, std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (fd >= 0) {
+        if (inboundEnd - inboundStart >= sizeof(MessageHeader)) {
+            MessageHeader header;
+            std::memcpy(&header, inbound.get() + inboundStart, sizeof(header));
+            if (gatewayMessageSize(header.type) != header.length) throw std::runtime_error("Malformed gateway message");
+
+            if (inboundEnd - inboundStart >= header.length) {
+                const char* data = inbound.get() + inboundStart;
+                inboundStart += header.length;
+
+                response = GatewayResponse{header.type};
+                response.sequence = header.sequence;
+                switch (header.type) {
+                    case GatewayMessageType::LOGIN_ACCEPTED: {
+                        LoginAcceptedMessage message;
+                        std::memcpy(&message, data, sizeof(message));
+                        response.traderID = message.traderID;
+                        break;
+                    }
+                    case GatewayMessageType::ACCEPTED: {
+                        OrderAcceptedMessage message;
+                        std::memcpy(&message, data, sizeof(message));
+                        response.token = message.token;
+                        response.orderID = message.orderID;
+                        break;
+                    }
+                    case GatewayMessageType::EXECUTED: {
+                        OrderExecutedMessage message;
+                        std::memcpy(&message, data, sizeof(message));
+                        response.token = message.token;
+                        response.price = message.price;
+                        response.quantity = message.quantity;
+                        response.remaining = message.remaining;
+                        break;
+                    }
+                    case GatewayMessageType::CANCELLED: {
+                        OrderCancelledMessage message;
+                        std::memcpy(&message, data, sizeof(message));
+                        response.token = message.token;
+                        response.quantity = message.quantity;
+                        response.remaining = message.remaining;
+                        break;
+                    }
+                    case GatewayMessageType::REJECTED: {
+                        OrderRejectedMessage message;
+                        std::memcpy(&message, data, sizeof(message));
+                        response.token = message.token;
+                        response.reason = message.reason;
+                        break;
+                    }
+                    default:
+                        throw std::runtime_error("Unexpected message type from gateway");
+                }
+                return true;
+            }
+        }
+
+        if (inboundStart > 0) {
+            std::memmove(inbound.get(), inbound.get() + inboundStart, inboundEnd - inboundStart);
+            inboundEnd -= inboundStart;
+            inboundStart = 0;
+        }
+
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        pollfd descriptor{fd, POLLIN, 0};
+        int ready = poll(&descriptor, 1, static_cast<int>(std::max<std::int64_t>(remaining.count(), 0)));
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready <= 0) return false;
+
+        ssize_t received = recv(fd, inbound.get() + inboundEnd, INBOUND_BUFFER - inboundEnd, 0);
+        if (received < 0 && errno == EINTR) continue;
+        if (received <= 0) {
+            close();
+            return false;
+        }
+        inboundEnd += static_cast<std::size_t>(received);
+    }
+    return false;
+}
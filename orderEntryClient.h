@@ -0,0 +1,57 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include "orderEntryProtocol.h"
+#include "order.h"
+
+// One decoded gateway message; fields not carried by `type` are left zero.
+struct GatewayResponse {
+    GatewayMessageType type;
+    std::uint32_t sequence = 0;
+    OrderToken token = 0;
+    OrderID orderID = 0;
+    TraderID traderID = 0;
+    Price price = 0;
+    Quantity quantity = 0;
+    Quantity remaining = 0;
+    RejectCode reason = RejectCode::INVALID_ORDER;
+};
+
+// Blocking order-entry session, used by the tests and the load client.
+class OrderEntryClient {
+    private:
+        static constexpr std::size_t INBOUND_BUFFER = 64 * 1024;
+
+        int fd = -1;
+        std::uint32_t outboundSequence = 1;
+        std::unique_ptr<char[]> inbound;
+        std::size_t inboundStart = 0;
+        std::size_t inboundEnd = 0;
+
+        template<typename Message>
+        void send(Message& message, GatewayMessageType type);
+
+    public:
+        OrderEntryClient();
+        ~OrderEntryClient();
+        OrderEntryClient(const OrderEntryClient&) = delete;
+        OrderEntryClient& operator=(const OrderEntryClient&) = delete;
+
+        void connect(const str& host, std::uint16_t port);
+        void close();
+        bool isConnected() const { return fd >= 0; }
+
+        void login(TraderID traderID);
+        void enterOrder(OrderToken token, const str& symbol, Side side, OrderType orderType, Price price, Quantity quantity);
+        void cancelOrder(OrderToken token);
+        void replaceOrder(OrderToken existingToken, OrderToken newToken, Price price, Quantity quantity);
+
+        // Writes bytes as-is, sequence numbers included; for exercising protocol errors.
+        void sendRaw(const void* data, std::size_t size);
+        std::uint32_t nextSequence() const { return outboundSequence; }
+
+        // Waits up to `timeout` for the next message. Returns false on timeout,
+        // or on disconnect, after which isConnected() is false.
+        bool receive(GatewayResponse& response, std::chrono::milliseconds timeout);
+};
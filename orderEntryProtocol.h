@@ -0,0 +1,151 @@
+#pragma once
+#include <cstdint>
+#include "types.h"
+
+// Fixed-layout binary order entry, in the spirit of OUCH. Every message is a
+// header followed by a body of fixed size for its type; integers are in host
+// (little-endian) order and every field is naturally aligned, so messages are
+// read and written as plain structs.
+//
+// Sequence numbers are per session and per direction and start at 1. A client
+// message out of sequence ends the session. ACCEPTED means the gateway handed
+// the order to the engine; risk rejections and fills follow as REJECTED and
+// EXECUTED. REPLACE is a cancel of the old token (acked with CANCELLED once the
+// engine pulls it) plus a new order under the new token. Self-trade prevention
+// can send a CANCELLED that leaves some `remaining`; only 0 ends the order.
+
+enum class GatewayMessageType : char {
+    // client -> gateway
+    LOGIN = 'L',
+    ENTER_ORDER = 'O',
+    CANCEL_ORDER = 'X',
+    REPLACE_ORDER = 'U',
+
+    // gateway -> client
+    LOGIN_ACCEPTED = 'a',
+    ACCEPTED = 'A',
+    EXECUTED = 'E',
+    CANCELLED = 'C',
+    REJECTED = 'J'
+};
+
+// The first values mirror RejectReason so risk rejections pass straight through.
+enum class RejectCode : std::uint8_t {
+    ORDER_SIZE,
+    POSITION_LIMIT,
+    OPEN_ORDER_LIMIT,
+    PRICE_BAND,
+    UNKNOWN_TRADER,
+    THROTTLED,
+    NOT_LOGGED_IN,
+    UNKNOWN_TOKEN,
+    DUPLICATE_TOKEN,
+    INVALID_ORDER,
+    TOO_LATE_TO_REPLACE,    // the original filled before its cancel took effect
+    REPLACE_PENDING         // the order already has a replace in flight
+};
+
+using OrderToken = std::uint64_t;
+
+struct MessageHeader {
+    std::uint16_t length;       // whole message, header included
+    GatewayMessageType type;
+    std::uint8_t reserved;
+    std::uint32_t sequence;
+};
+
+struct LoginRequest {
+    MessageHeader header;
+    TraderID traderID;
+    std::uint32_t reserved;
+};
+
+struct EnterOrderRequest {
+    MessageHeader header;
+    OrderToken token;
+    char symbol[8];             // NUL-padded
+    Price price;                // ticks; ignored for market orders
+    Quantity quantity;
+    std::uint8_t side;          // Side
+    std::uint8_t orderType;     // OrderType
+    std::uint8_t reserved[6];
+};
+
+struct CancelOrderRequest {
+    MessageHeader header;
+    OrderToken token;
+};
+
+// Cancels the order and, once the cancel is acked, enters newToken at the new
+// price for `quantity` less whatever the original had executed. If nothing
+// is left, newToken is rejected with TOO_LATE_TO_REPLACE.
+struct ReplaceOrderRequest {
+    MessageHeader header;
+    OrderToken existingToken;
+    OrderToken newToken;
+    Price price;
+    Quantity quantity;
+};
+
+struct LoginAcceptedMessage {
+    MessageHeader header;
+    TraderID traderID;
+    std::uint32_t reserved;
+};
+
+struct OrderAcceptedMessage {
+    MessageHeader header;
+    OrderToken token;
+    OrderID orderID;
+};
+
+struct OrderExecutedMessage {
+    MessageHeader header;
+    OrderToken token;
+    Price price;
+    Quantity quantity;
+    Quantity remaining;
+    std::uint32_t reserved;
+};
+
+// A non-zero `remaining` is a self-trade reduction; the order stays live.
+struct OrderCancelledMessage {
+    MessageHeader header;
+    OrderToken token;
+    Quantity quantity;
+    Quantity remaining;
+};
+
+struct OrderRejectedMessage {
+    MessageHeader header;
+    OrderToken token;
+    RejectCode reason;
+    std::uint8_t reserved[7];
+};
+
+static_assert(sizeof(MessageHeader) == 8);
+static_assert(sizeof(LoginRequest) == 16);
+static_assert(sizeof(EnterOrderRequest) == 40);
+static_assert(sizeof(CancelOrderRequest) == 16);
+static_assert(sizeof(ReplaceOrderRequest) == 32);
+static_assert(sizeof(LoginAcceptedMessage) == 16);
+static_assert(sizeof(OrderAcceptedMessage) == 24);
+static_assert(sizeof(OrderExecutedMessage) == 32);
+static_assert(sizeof(OrderCancelledMessage) == 24);
+static_assert(sizeof(OrderRejectedMessage) == 24);
+
+// Size of the message a type code announces, or 0 for an unknown type.
+constexpr std::uint16_t gatewayMessageSize(GatewayMessageType type) {
+    switch (type) {
+        case GatewayMessageType::LOGIN: return sizeof(LoginRequest);
+        case GatewayMessageType::ENTER_ORDER: return sizeof(EnterOrderRequest);
+        case GatewayMessageType::CANCEL_ORDER: return sizeof(CancelOrderRequest);
+        case GatewayMessageType::REPLACE_ORDER: return sizeof(ReplaceOrderRequest);
+        case GatewayMessageType::LOGIN_ACCEPTED: return sizeof(LoginAcceptedMessage);
+        case GatewayMessageType::ACCEPTED: return sizeof(OrderAcceptedMessage);
+        case GatewayMessageType::EXECUTED: return sizeof(OrderExecutedMessage);
+        case GatewayMessageType::CANCELLED: return sizeof(OrderCancelledMessage);
+        case GatewayMessageType::REJECTED: return sizeof(OrderRejectedMessage);
+    }
+    return 0;
+}
@@ -0,0 +1,217 @@
+#include "orderFlowGenerator.h"
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include "limitOrder.h"
+
+static_assert(std::is_trivially_copyable_v<FlowMessage>, "FlowMessage is written to disk as raw bytes");
+
+namespace {
+    constexpr std::uint32_t FLOW_FILE_MAGIC = 0x574C464F; // "OFLW"
+    constexpr std::uint32_t FLOW_FILE_VERSION = 1;
+
+    struct FlowFileHeader {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint64_t count;
+    };
+}
+
+OrderFlowGenerator::OrderFlowGenerator(const OrderFlowConfig& config)
+    : config(config),
+      rng(config.seed),
+      interArrival(config.messagesPerSecond / 1e9),
+      typeDistribution({config.addRatio, config.marketableRatio, config.cancelRatio, config.modifyRatio}),
+      quantityDistribution(config.minQuantity, config.maxQuantity),
+      traderDistribution(0, config.numTraders - 1),
+      depthDistribution(1, config.maxDepthTicks),
+      mid(config.startMid) {
+    if (config.messagesPerSecond <= 0) throw std::invalid_argument("Message rate must be positive.");
+    if (config.numTraders == 0) throw std::invalid_argument("At least one trader is required.");
+    if (config.minQuantity == 0 || config.minQuantity > config.maxQuantity) throw std::invalid_argument("Invalid quantity range.");
+    if (config.maxDepthTicks == 0) throw std::invalid_argument("Depth must be at least one tick.");
+    if (config.startMid <= config.maxDepthTicks + config.marketableDepthTicks) throw std::invalid_argument("Start mid is too close to zero.");
+}
+
+Side OrderFlowGenerator::randomSide() {
+    return (rng() & 1) ? Side::BUY : Side::SELL;
+}
+
+Price OrderFlowGenerator::passivePrice(Side side) {
+    std::uint32_t depth = depthDistribution(rng);
+    return side == Side::BUY ? mid - depth : mid + depth;
+}
+
+OrderFlowGenerator::LiveOrder OrderFlowGenerator::takeRandomLiveOrder() {
+    std::size_t index = std::uniform_int_distribution<std::size_t>(0, liveOrders.size() - 1)(rng);
+    LiveOrder order = liveOrders[index];
+    liveOrders[index] = liveOrders.back();
+    liveOrders.pop_back();
+    return order;
+}
+
+FlowMessage OrderFlowGenerator::next() {
+    clockNs += interArrival(rng);
+
+    if (unit(rng) < config.midMoveProbability) {
+        if (rng() & 1) mid += 1;
+        else if (mid > config.maxDepthTicks + config.marketableDepthTicks + 1) mid -= 1;
+    }
+
+    auto type = static_cast<FlowMessageType>(typeDistribution(rng));
+    if ((type == FlowMessageType::CANCEL || type == FlowMessageType::MODIFY) && liveOrders.empty()) {
+        type = FlowMessageType::ADD;
+    }
+
+    FlowMessage message{};
+    message.timestampNs = static_cast<std::uint64_t>(clockNs);
+    message.type = type;
+
+    switch (type) {
+        case FlowMessageType::ADD:
+        case FlowMessageType::MARKETABLE: {
+            message.orderID = nextOrderID++;
+            message.side = randomSide();
+            message.traderID = config.firstTraderID + traderDistribution(rng);
+            message.quantity = quantityDistribution(rng);
+            if (type == FlowMessageType::ADD) {
+                message.price = passivePrice(message.side);
+            }
+            else {
+                message.price = message.side == Side::BUY ? mid + config.marketableDepthTicks : mid - config.marketableDepthTicks;
+            }
+            liveOrders.push_back({message.orderID, message.traderID, message.side});
+            break;
+        }
+        case FlowMessageType::CANCEL: {
+            LiveOrder target = takeRandomLiveOrder();
+            message.targetID = target.orderID;
+            message.traderID = target.traderID;
+            message.side = target.side;
+            break;
+        }
+        case FlowMessageType::MODIFY: {
+            LiveOrder target = takeRandomLiveOrder();
+            message.targetID = target.orderID;
+            message.orderID = nextOrderID++;
+            message.traderID = target.traderID;
+            message.side = target.side;
+            message.price = passivePrice(target.side);
+            message.quantity = quantityDistribution(rng);
+            liveOrders.push_back({message.orderID, message.traderID, message.side});
+            break;
+        }
+    }
+    return message;
+}
+
+std::vector<FlowMessage> OrderFlowGenerator::generate(std::size_t count) {
+    std::vector<FlowMessage> messages;
+    messages.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) messages.push_back(next());
+    return messages;
+}
+
+
+OrderFlowWriter::OrderFlowWriter(const str& path) : out(path, std::ios::binary | std::ios::trunc) {
+    if (!out) throw std::runtime_error("Could not open order flow file for writing: " + path);
+    FlowFileHeader header{FLOW_FILE_MAGIC, FLOW_FILE_VERSION, 0};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+OrderFlowWriter::~OrderFlowWriter() {
+    close();
+}
+
+void OrderFlowWriter::write(const FlowMessage& message) {
+    out.write(reinterpret_cast<const char*>(&message), sizeof(message));
+    ++count;
+}
+
+void OrderFlowWriter::write(const std::vector<FlowMessage>& messages) {
+    out.write(reinterpret_cast<const char*>(messages.data()), messages.size() * sizeof(FlowMessage));
+    count += messages.size();
+}
+
+void OrderFlowWriter::close() {
+    if (!out.is_open()) return;
+    FlowFileHeader header{FLOW_FILE_MAGIC, FLOW_FILE_VERSION, count};
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+}
+
+
+OrderFlowReader::OrderFlowReader(const str& path) : in(path, std::ios::binary) {
+    if (!in) throw std::runtime_error("Could not open order flow file: " + path);
+    FlowFileHeader header{};
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in || header.magic != FLOW_FILE_MAGIC) throw std::runtime_error("Not an order flow file: " + path);
+    if (header.version != FLOW_FILE_VERSION) throw std::runtime_error("Unsupported order flow file version.");
+    count = header.count;
+}
+
+bool OrderFlowReader::next(FlowMessage& message) {
+    if (consumed == count) return false;
+    in.read(reinterpret_cast<char*>(&message), sizeof(message));
+    if (!in) throw std::runtime_error("Order flow file is truncated.");
+    ++consumed;
+    return true;
+}
+
+std::vector<FlowMessage> OrderFlowReader::readAll() {
+    std::vector<FlowMessage> messages(count - consumed);
+    in.read(reinterpret_cast<char*>(messages.data()), messages.size() * sizeof(FlowMessage));
+    if (!in) throw std::runtime_error("Order flow file is truncated.");
+    consumed = count;
+    return messages;
+}
+
+
+OrderFlowDriver::OrderFlowDriver(MatchingEngine& engine, str symbol)
+    : engine(engine), symbol(std::move(symbol)) {}
+
+void OrderFlowDriver::submit(const FlowMessage& message) {
+    auto order = std::make_unique<LimitOrder>(symbol, 0, OrderType::LIMIT, message.side, message.price, message.quantity, message.traderID);
+    OrderID engineID = engine.submitOrder(std::move(order));
+    if (message.orderID >= engineIDs.size()) engineIDs.resize(message.orderID * 2 + 1, 0);
+    engineIDs[message.orderID] = engineID;
+}
+
+void OrderFlowDriver::cancel(OrderID generatorID) {
+    if (generatorID < engineIDs.size() && engineIDs[generatorID] != 0) {
+        engine.cancelOrder(engineIDs[generatorID]);
+    }
+}
+
+void OrderFlowDriver::send(const FlowMessage& message) {
+    switch (message.type) {
+        case FlowMessageType::ADD:
+        case FlowMessageType::MARKETABLE:
+            submit(message);
+            break;
+        case FlowMessageType::CANCEL:
+            cancel(message.targetID);
+            break;
+        case FlowMessageType::MODIFY:
+            cancel(message.targetID);
+            submit(message);
+            break;
+    }
+}
+
+void OrderFlowDriver::runFlatOut(const std::vector<FlowMessage>& messages) {
+    for (const FlowMessage& message : messages) send(message);
+}
+
+void OrderFlowDriver::runPaced(const std::vector<FlowMessage>& messages, double speed) {
+    if (speed <= 0) throw std::invalid_argument("Replay speed must be positive.");
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+    for (const FlowMessage& message : messages) {
+        const auto due = start + std::chrono::nanoseconds(static_cast<std::int64_t>(message.timestampNs / speed));
+        while (clock::now() < due) {}
+        send(message);
+    }
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <random>
+#include <vector>
+#include "types.h"
+#include "order.h"
+#include "matchingEngine.h"
+
+enum class FlowMessageType : std::uint8_t {
+    ADD,         // passive limit order placed away from the mid
+    MARKETABLE,  // limit order priced through the mid
+    CANCEL,
+    MODIFY       // cancel/replace: targetID is pulled, orderID is re-entered at a new price
+};
+
+// Fixed-layout record so streams can be written to and read from disk as-is.
+// Order ids are assigned by the generator (1, 2, 3, ...) and are mapped onto
+// engine ids by OrderFlowDriver.
+struct FlowMessage {
+    std::uint64_t timestampNs;
+    OrderID orderID;
+    OrderID targetID;
+    Price price;
+    Quantity quantity;
+    TraderID traderID;
+    FlowMessageType type;
+    Side side;
+};
+
+struct OrderFlowConfig {
+    std::uint64_t seed = 42;
+    double messagesPerSecond = 1'000'000.0;   // mean Poisson arrival rate
+
+    // Relative weights of each message type.
+    double addRatio = 0.55;
+    double marketableRatio = 0.05;
+    double cancelRatio = 0.30;
+    double modifyRatio = 0.10;
+
+    Price startMid = 10000;
+    double midMoveProbability = 0.01;          // chance per message that the mid steps one tick
+    std::uint32_t maxDepthTicks = 20;          // passive orders land 1..maxDepthTicks away from the mid
+    std::uint32_t marketableDepthTicks = 2;    // marketable orders cross the mid by this many ticks
+
+    Quantity minQuantity = 1;
+    Quantity maxQuantity = 100;
+
+    TraderID firstTraderID = 1000;
+    std::uint32_t numTraders = 100;
+};
+
+class OrderFlowGenerator {
+    private:
+        OrderFlowConfig config;
+        std::mt19937_64 rng;
+        std::exponential_distribution<double> interArrival;
+        std::discrete_distribution<int> typeDistribution;
+        std::uniform_int_distribution<Quantity> quantityDistribution;
+        std::uniform_int_distribution<std::uint32_t> traderDistribution;
+        std::uniform_int_distribution<std::uint32_t> depthDistribution;
+        std::uniform_real_distribution<double> unit{0.0, 1.0};
+
+        double clockNs = 0.0;
+        Price mid;
+        OrderID nextOrderID = 1;
+
+        struct LiveOrder {
+            OrderID orderID;
+            TraderID traderID;
+            Side side;
+        };
+        std::vector<LiveOrder> liveOrders;
+
+        Side randomSide();
+        Price passivePrice(Side side);
+        LiveOrder takeRandomLiveOrder();
+
+    public:
+        explicit OrderFlowGenerator(const OrderFlowConfig& config);
+
+        FlowMessage next();
+        std::vector<FlowMessage> generate(std::size_t count);
+
+        Price getMid() const { return mid; }
+        std::size_t liveOrderCount() const { return liveOrders.size(); }
+};
+
+class OrderFlowWriter {
+    private:
+        std::ofstream out;
+        std::uint64_t count = 0;
+
+    public:
+        explicit OrderFlowWriter(const str& path);
+        ~OrderFlowWriter();
+
+        void write(const FlowMessage& message);
+        void write(const std::vector<FlowMessage>& messages);
+        void close();
+};
+
+class OrderFlowReader {
+    private:
+        std::ifstream in;
+        std::uint64_t count = 0;
+        std::uint64_t consumed = 0;
+
+    public:
+        explicit OrderFlowReader(const str& path);
+
+        std::uint64_t size() const { return count; }
+        bool next(FlowMessage& message);
+        std::vector<FlowMessage> readAll();
+};
+
+// Feeds a message stream into a MatchingEngine, either paced by the message
+// timestamps (scaled by `speed`) or as fast as the ingress queue accepts it.
+class OrderFlowDriver {
+    private:
+        MatchingEngine& engine;
+        str symbol;
+        std::vector<OrderID> engineIDs;    // generator id -> engine id
+
+        void submit(const FlowMessage& message);
+        void cancel(OrderID generatorID);
+
+    public:
+        OrderFlowDriver(MatchingEngine& engine, str symbol);
+
+        void send(const FlowMessage& message);
+        void runFlatOut(const std::vector<FlowMessage>& messages);
+        void runPaced(const std::vector<FlowMessage>& messages, double speed = 1.0);
+};
@@ -0,0 +1,520 @@
+#include "orderGateway.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <system_error>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "limitOrder.h"
+#include "marketOrder.h"
+
+namespace {
+    // epoll keys: sessions are stored as slot + FIRST_SESSION_KEY
+    constexpr std::uint64_t LISTEN_KEY = 0;
+    constexpr std::uint64_t WAKE_KEY = 1;
+    constexpr std::uint64_t FIRST_SESSION_KEY = 2;
+
+    [[noreturn]] void throwErrno(const char* what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+}
+
+OrderGateway::Session::Session(std::uint32_t slot, std::pmr::memory_resource* pool)
+    : slot(slot), inbound(new char[INBOUND_BUFFER]), outbound(new char[OUTBOUND_BUFFER]), tokens(pool) {}
+
+OrderGateway::OrderGateway(MatchingEngine& engine, EventDispatcher& dispatcher, const GatewayConfig& config)
+    : engine(engine), config(config), routes(&routePool) {
+    if (this->config.throttleBurst == 0) this->config.throttleBurst = this->config.messagesPerSecond;
+    sessions.reserve(config.maxSessions);
+    freeSlots.reserve(config.maxSessions);
+    flushQueue.reserve(config.maxSessions);
+
+    subscriptions.add<TradeExecutedEvent>(dispatcher, [this](const TradeExecutedEvent& e) {
+        onEngineEvent({EventKind::EXECUTED, RejectCode::INVALID_ORDER, e.aggressingOrderID, e.price, e.quantity, e.aggressingRemainingQuantity});
+        onEngineEvent({EventKind::EXECUTED, RejectCode::INVALID_ORDER, e.restingOrderID, e.price, e.quantity, e.restingRemainingQuantity});
+    });
+    subscriptions.add<OrderCancelledEvent>(dispatcher, [this](const OrderCancelledEvent& e) {
+        onEngineEvent({EventKind::CANCELLED, RejectCode::INVALID_ORDER, e.orderID, 0, e.quantity, e.remaining});
+    });
+    subscriptions.add<MassCancelEvent>(dispatcher, [this](const MassCancelEvent& e) {
+        for (const OrderCancelledEvent& cancelled : e.cancelled) {
+            onEngineEvent({EventKind::CANCELLED, RejectCode::INVALID_ORDER, cancelled.orderID, 0, cancelled.quantity, 0});
+        }
+    });
+    subscriptions.add<OrderRejectedEvent>(dispatcher, [this](const OrderRejectedEvent& e) {
+        onEngineEvent({EventKind::REJECTED, static_cast<RejectCode>(e.reason), e.orderID, 0, 0, 0});
+    });
+}
+
+OrderGateway::~OrderGateway() {
+    // Before stop(), so no engine event lands in a half-stopped gateway
+    subscriptions.clear();
+    stop();
+}
+
+void OrderGateway::start() {
+    listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) throwErrno("socket");
+    int enable = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(config.port);
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) throwErrno("bind");
+    if (listen(listenFd, 128) < 0) throwErrno("listen");
+    socklen_t length = sizeof(address);
+    getsockname(listenFd, reinterpret_cast<sockaddr*>(&address), &length);
+    boundPort = ntohs(address.sin_port);
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) throwErrno("epoll_create1");
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd < 0) throwErrno("eventfd");
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = LISTEN_KEY;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+    event.data.u64 = WAKE_KEY;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+
+    running = true;
+    loopThread = std::thread([this] { run(); });
+}
+
+void OrderGateway::stop() {
+    if (!loopThread.joinable()) return;
+    running = false;
+    wake();
+    loopThread.join();
+
+    for (std::uint32_t slot = 0; slot < sessions.size(); ++slot) {
+        if (sessions[slot]->fd >= 0) closeSession(slot);
+    }
+    close(listenFd);
+    close(wakeFd);
+    close(epollFd);
+}
+
+void OrderGateway::onEngineEvent(const GatewayEvent& event) {
+    engineEvents.push(event);
+    // One wakeup covers everything queued until the loop drains
+    if (!wakePending.exchange(true)) wake();
+}
+
+void OrderGateway::wake() {
+    std::uint64_t one = 1;
+    [[maybe_unused]] ssize_t written = write(wakeFd, &one, sizeof(one));
+}
+
+void OrderGateway::run() {
+    epoll_event events[64];
+    while (running) {
+        int ready = epoll_wait(epollFd, events, 64, -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        for (int i = 0; i < ready; ++i) {
+            const std::uint64_t key = events[i].data.u64;
+            if (key == LISTEN_KEY) {
+                acceptSessions();
+                continue;
+            }
+            if (key == WAKE_KEY) {
+                drainEngineEvents();
+                continue;
+            }
+
+            const std::uint32_t slot = static_cast<std::uint32_t>(key - FIRST_SESSION_KEY);
+            Session& session = *sessions[slot];
+            if (session.fd < 0) continue;
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                closeSession(slot);
+                continue;
+            }
+            if (events[i].events & EPOLLOUT) writeSession(session);
+            if (events[i].events & EPOLLIN) readSession(slot);
+        }
+        flushSessions();
+    }
+}
+
+void OrderGateway::acceptSessions() {
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+
+        std::uint32_t slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else if (sessions.size() < config.maxSessions) {
+            slot = static_cast<std::uint32_t>(sessions.size());
+            sessions.push_back(std::make_unique<Session>(slot, &routePool));
+        }
+        else {
+            close(fd);
+            continue;
+        }
+
+        int enable = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+        Session& session = *sessions[slot];
+        session.fd = fd;
+        session.loggedIn = false;
+        session.inboundSequence = 1;
+        session.outboundSequence = 1;
+        session.throttleTokens = config.throttleBurst;
+        session.throttleRefill = std::chrono::steady_clock::now();
+        session.inboundLength = 0;
+        session.outboundStart = 0;
+        session.outboundEnd = 0;
+        session.queuedForFlush = false;
+        session.writeBlocked = false;
+        session.overflowed = false;
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = slot + FIRST_SESSION_KEY;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+    }
+}
+
+void OrderGateway::closeSession(std::uint32_t slot) {
+    Session& session = *sessions[slot];
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, session.fd, nullptr);
+    close(session.fd);
+    if (session.loggedIn && config.cancelOnDisconnect) engine.massCancel(session.traderID);
+
+    // Bumping the generation orphans any routes still pointing at this slot
+    session.fd = -1;
+    session.generation++;
+    session.loggedIn = false;
+    session.tokens.clear();
+    freeSlots.push_back(slot);
+}
+
+void OrderGateway::readSession(std::uint32_t slot) {
+    Session& session = *sessions[slot];
+    ssize_t received = recv(session.fd, session.inbound.get() + session.inboundLength, INBOUND_BUFFER - session.inboundLength, 0);
+    if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+        closeSession(slot);
+        return;
+    }
+    if (received < 0) return;
+    session.inboundLength += static_cast<std::size_t>(received);
+
+    std::size_t offset = 0;
+    while (session.inboundLength - offset >= sizeof(MessageHeader)) {
+        MessageHeader header;
+        std::memcpy(&header, session.inbound.get() + offset, sizeof(header));
+        const std::uint16_t size = gatewayMessageSize(header.type);
+        if (size == 0 || header.length != size) {
+            closeSession(slot);
+            return;
+        }
+        if (session.inboundLength - offset < size) break;
+        if (!handleMessage(slot, session.inbound.get() + offset)) {
+            closeSession(slot);
+            return;
+        }
+        offset += size;
+    }
+
+    std::memmove(session.inbound.get(), session.inbound.get() + offset, session.inboundLength - offset);
+    session.inboundLength -= offset;
+}
+
+bool OrderGateway::handleMessage(std::uint32_t slot, const char* data) {
+    Session& session = *sessions[slot];
+    MessageHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.sequence != session.inboundSequence) return false;
+    session.inboundSequence++;
+
+    switch (header.type) {
+        case GatewayMessageType::LOGIN: {
+            if (session.loggedIn) return false;
+            LoginRequest request;
+            std::memcpy(&request, data, sizeof(request));
+            session.loggedIn = true;
+            session.traderID = request.traderID;
+            if (auto* reply = reserveOutbound<LoginAcceptedMessage>(session, GatewayMessageType::LOGIN_ACCEPTED)) {
+                reply->traderID = request.traderID;
+            }
+            return true;
+        }
+        case GatewayMessageType::ENTER_ORDER: {
+            EnterOrderRequest request;
+            std::memcpy(&request, data, sizeof(request));
+            if (!session.loggedIn) sendReject(session, request.token, RejectCode::NOT_LOGGED_IN);
+            else if (!takeThrottleToken(session)) sendReject(session, request.token, RejectCode::THROTTLED);
+            else handleEnter(slot, request);
+            return true;
+        }
+        case GatewayMessageType::CANCEL_ORDER: {
+            CancelOrderRequest request;
+            std::memcpy(&request, data, sizeof(request));
+            if (!session.loggedIn) sendReject(session, request.token, RejectCode::NOT_LOGGED_IN);
+            else if (!takeThrottleToken(session)) sendReject(session, request.token, RejectCode::THROTTLED);
+            else handleCancel(session, request);
+            return true;
+        }
+        case GatewayMessageType::REPLACE_ORDER: {
+            ReplaceOrderRequest request;
+            std::memcpy(&request, data, sizeof(request));
+            if (!session.loggedIn) sendReject(session, request.newToken, RejectCode::NOT_LOGGED_IN);
+            else if (!takeThrottleToken(session)) sendReject(session, request.newToken, RejectCode::THROTTLED);
+            else handleReplace(slot, request);
+            return true;
+        }
+        default:
+            // Gateway-to-client types are not valid from a client
+            return false;
+    }
+}
+
+bool OrderGateway::takeThrottleToken(Session& session) {
+    if (config.messagesPerSecond == 0) return true;
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - session.throttleRefill).count();
+    session.throttleRefill = now;
+    session.throttleTokens = std::min<double>(config.throttleBurst, session.throttleTokens + elapsed * config.messagesPerSecond);
+    if (session.throttleTokens < 1.0) return false;
+    session.throttleTokens -= 1.0;
+    return true;
+}
+
+void OrderGateway::handleEnter(std::uint32_t slot, const EnterOrderRequest& request) {
+    Session& session = *sessions[slot];
+    const bool isLimit = request.orderType == static_cast<std::uint8_t>(OrderType::LIMIT);
+    if (request.quantity == 0 || request.side > 1 || request.orderType > 1 || (isLimit && request.price == 0)) {
+        sendReject(session, request.token, RejectCode::INVALID_ORDER);
+        return;
+    }
+    if (session.tokens.count(request.token)) {
+        sendReject(session, request.token, RejectCode::DUPLICATE_TOKEN);
+        return;
+    }
+
+    const Side side = static_cast<Side>(request.side);
+    str symbol(request.symbol, strnlen(request.symbol, sizeof(request.symbol)));
+    std::unique_ptr<Order> order;
+    if (isLimit) order = std::make_unique<LimitOrder>(std::move(symbol), 0, OrderType::LIMIT, side, request.price, request.quantity, session.traderID);
+    else order = std::make_unique<MarketOrder>(std::move(symbol), 0, OrderType::MARKET, side, request.quantity, session.traderID);
+    submit(slot, request.token, request.symbol, std::move(order));
+}
+
+void OrderGateway::handleCancel(Session& session, const CancelOrderRequest& request) {
+    auto it = session.tokens.find(request.token);
+    if (it == session.tokens.end()) {
+        sendReject(session, request.token, RejectCode::UNKNOWN_TOKEN);
+        return;
+    }
+    if (it->second.replacing || it->second.orderID == 0) {
+        sendReject(session, request.token, RejectCode::REPLACE_PENDING);
+        return;
+    }
+    // Acked with CANCELLED when the engine removes it
+    engine.cancelOrder(it->second.orderID);
+}
+
+void OrderGateway::handleReplace(std::uint32_t slot, const ReplaceOrderRequest& request) {
+    Session& session = *sessions[slot];
+    auto it = session.tokens.find(request.existingToken);
+    if (it == session.tokens.end()) {
+        sendReject(session, request.newToken, RejectCode::UNKNOWN_TOKEN);
+        return;
+    }
+    if (session.tokens.count(request.newToken)) {
+        sendReject(session, request.newToken, RejectCode::DUPLICATE_TOKEN);
+        return;
+    }
+    if (request.quantity == 0 || request.price == 0) {
+        sendReject(session, request.newToken, RejectCode::INVALID_ORDER);
+        return;
+    }
+    if (it->second.replacing || it->second.orderID == 0) {
+        sendReject(session, request.newToken, RejectCode::REPLACE_PENDING);
+        return;
+    }
+
+    // The replacement is only entered once the cancel is acked, so it can be
+    // sized by what the original executed in the meantime
+    TokenState& original = it->second;
+    original.replacing = true;
+    original.replaceToken = request.newToken;
+    original.replacePrice = request.price;
+    original.replaceQuantity = request.quantity;
+    const OrderID orderID = original.orderID;
+
+    TokenState placeholder{0, original.side, {}};
+    std::memcpy(placeholder.symbol, original.symbol, sizeof(placeholder.symbol));
+    session.tokens.emplace(request.newToken, placeholder);
+    engine.cancelOrder(orderID);
+}
+
+void OrderGateway::finishReplace(std::uint32_t slot, const TokenState& original, bool cancelled) {
+    Session& session = *sessions[slot];
+    session.tokens.erase(original.replaceToken);
+    const Quantity leaves = original.replaceQuantity > original.executed ? original.replaceQuantity - original.executed : 0;
+    if (!cancelled || leaves == 0) {
+        sendReject(session, original.replaceToken, RejectCode::TOO_LATE_TO_REPLACE);
+        return;
+    }
+    str symbol(original.symbol, strnlen(original.symbol, sizeof(original.symbol)));
+    submit(slot, original.replaceToken, original.symbol,
+           std::make_unique<LimitOrder>(std::move(symbol), 0, OrderType::LIMIT, original.side, original.replacePrice, leaves, session.traderID));
+}
+
+void OrderGateway::submit(std::uint32_t slot, OrderToken token, const char* symbol, std::unique_ptr<Order> order) {
+    Session& session = *sessions[slot];
+    const Side side = order->getSide();
+    const OrderID orderID = engine.submitOrder(std::move(order));
+
+    // Events for this order cannot be handled before these are in place: they
+    // reach this thread through engineEvents, which is drained after we return.
+    routes.emplace(orderID, OrderRoute{slot, session.generation, token});
+    TokenState state{orderID, side, {}};
+    std::memcpy(state.symbol, symbol, sizeof(state.symbol));
+    session.tokens.emplace(token, state);
+
+    if (auto* ack = reserveOutbound<OrderAcceptedMessage>(session, GatewayMessageType::ACCEPTED)) {
+        ack->token = token;
+        ack->orderID = orderID;
+    }
+}
+
+void OrderGateway::drainEngineEvents() {
+    wakePending.store(false);
+    std::uint64_t count;
+    [[maybe_unused]] ssize_t drained = read(wakeFd, &count, sizeof(count));
+
+    GatewayEvent event;
+    while (engineEvents.tryPop(event)) {
+        auto route = routes.find(event.orderID);
+        if (route == routes.end()) continue;
+
+        const bool terminal = event.kind == EventKind::REJECTED || event.remaining == 0;
+        const OrderRoute target = route->second;
+        if (terminal) routes.erase(route);
+
+        Session& session = *sessions[target.slot];
+        if (session.fd < 0 || session.generation != target.generation) continue;
+
+        switch (event.kind) {
+            case EventKind::EXECUTED:
+                if (auto* message = reserveOutbound<OrderExecutedMessage>(session, GatewayMessageType::EXECUTED)) {
+                    message->token = target.token;
+                    message->price = event.price;
+                    message->quantity = event.quantity;
+                    message->remaining = event.remaining;
+                }
+                break;
+            case EventKind::CANCELLED:
+                if (auto* message = reserveOutbound<OrderCancelledMessage>(session, GatewayMessageType::CANCELLED)) {
+                    message->token = target.token;
+                    message->quantity = event.quantity;
+                    message->remaining = event.remaining;
+                }
+                break;
+            case EventKind::REJECTED:
+                sendReject(session, target.token, event.reason);
+                break;
+        }
+
+        auto token = session.tokens.find(target.token);
+        if (token == session.tokens.end() || token->second.orderID != event.orderID) continue;
+        if (event.kind == EventKind::EXECUTED) token->second.executed += event.quantity;
+        if (terminal) {
+            const TokenState state = token->second;
+            session.tokens.erase(token);
+            if (state.replacing) finishReplace(target.slot, state, event.kind == EventKind::CANCELLED);
+        }
+    }
+}
+
+template<typename Message>
+Message* OrderGateway::reserveOutbound(Session& session, GatewayMessageType type) {
+    if (session.outboundEnd + sizeof(Message) > OUTBOUND_BUFFER) {
+        std::memmove(session.outbound.get(), session.outbound.get() + session.outboundStart, session.outboundEnd - session.outboundStart);
+        session.outboundEnd -= session.outboundStart;
+        session.outboundStart = 0;
+    }
+    if (session.outboundEnd + sizeof(Message) > OUTBOUND_BUFFER) {
+        // The client is not reading; it is dropped at the next flush
+        session.overflowed = true;
+    }
+    if (!session.queuedForFlush) {
+        session.queuedForFlush = true;
+        flushQueue.push_back(&session);
+    }
+    if (session.overflowed) return nullptr;
+
+    // Message sizes are multiples of 8, so every message starts aligned
+    Message* message = new (session.outbound.get() + session.outboundEnd) Message{};
+    message->header = {static_cast<std::uint16_t>(sizeof(Message)), type, 0, session.outboundSequence++};
+    session.outboundEnd += sizeof(Message);
+    return message;
+}
+
+void OrderGateway::sendReject(Session& session, OrderToken token, RejectCode reason) {
+    if (auto* message = reserveOutbound<OrderRejectedMessage>(session, GatewayMessageType::REJECTED)) {
+        message->token = token;
+        message->reason = reason;
+    }
+}
+
+void OrderGateway::flushSessions() {
+    for (Session* session : flushQueue) {
+        session->queuedForFlush = false;
+        if (session->fd < 0) continue;
+        if (session->overflowed) {
+            closeSession(session->slot);
+            continue;
+        }
+        writeSession(*session);
+    }
+    flushQueue.clear();
+}
+
+void OrderGateway::writeSession(Session& session) {
+    while (session.outboundStart < session.outboundEnd) {
+        ssize_t sent = send(session.fd, session.outbound.get() + session.outboundStart,
+                            session.outboundEnd - session.outboundStart, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) return;    // the read side sees the error and closes
+            if (!session.writeBlocked) {
+                session.writeBlocked = true;
+                epoll_event event{};
+                event.events = EPOLLIN | EPOLLOUT;
+                event.data.u64 = session.slot + FIRST_SESSION_KEY;
+                epoll_ctl(epollFd, EPOLL_CTL_MOD, session.fd, &event);
+            }
+            return;
+        }
+        session.outboundStart += static_cast<std::size_t>(sent);
+    }
+
+    session.outboundStart = 0;
+    session.outboundEnd = 0;
+    if (session.writeBlocked) {
+        session.writeBlocked = false;
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = session.slot + FIRST_SESSION_KEY;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, session.fd, &event);
+    }
+}
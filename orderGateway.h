@@ -0,0 +1,144 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "orderEntryProtocol.h"
+#include "matchingEngine.h"
+#include "eventDispatcher.h"
+#include "events.h"
+#include "threadSafeQueue.h"
+
+struct GatewayConfig {
+    std::uint16_t port = 0;                     // 0 binds an ephemeral port, see getPort()
+    std::uint32_t maxSessions = 64;
+    std::uint32_t messagesPerSecond = 0;        // per-session order message throttle, 0 disables
+    std::uint32_t throttleBurst = 0;            // bucket depth, defaults to one second's worth
+    bool cancelOnDisconnect = true;
+};
+
+// Single-threaded epoll server that turns order-entry sessions into engine
+// commands and engine events back into per-session acks. Engine events are
+// handed over from the matching thread through a queue and an eventfd wakeup.
+// Socket buffers are fixed per session and the order maps draw from pooled
+// memory, so steady-state traffic does not allocate in the gateway.
+class OrderGateway {
+    private:
+        static constexpr std::size_t INBOUND_BUFFER = 64 * 1024;
+        static constexpr std::size_t OUTBOUND_BUFFER = 256 * 1024;
+
+        struct TokenState {
+            OrderID orderID;            // 0 for a replacement waiting on its original's cancel
+            Side side;
+            char symbol[8];
+            Quantity executed = 0;
+            // Set while a replace waits for this order's cancel to be acked
+            bool replacing = false;
+            OrderToken replaceToken = 0;
+            Price replacePrice = 0;
+            Quantity replaceQuantity = 0;
+        };
+
+        struct Session {
+            std::uint32_t slot;
+            int fd = -1;
+            std::uint32_t generation = 0;
+            bool loggedIn = false;
+            TraderID traderID = 0;
+            std::uint32_t inboundSequence = 1;
+            std::uint32_t outboundSequence = 1;
+            double throttleTokens = 0.0;
+            std::chrono::steady_clock::time_point throttleRefill;
+
+            std::unique_ptr<char[]> inbound;
+            std::size_t inboundLength = 0;
+            std::unique_ptr<char[]> outbound;
+            std::size_t outboundStart = 0;
+            std::size_t outboundEnd = 0;
+            bool queuedForFlush = false;
+            bool writeBlocked = false;
+            bool overflowed = false;
+
+            // Live orders by client token; side and symbol are kept for replaces.
+            std::pmr::unordered_map<OrderToken, TokenState> tokens;
+
+            Session(std::uint32_t slot, std::pmr::memory_resource* pool);
+        };
+
+        struct OrderRoute {
+            std::uint32_t slot;
+            std::uint32_t generation;
+            OrderToken token;
+        };
+
+        enum class EventKind : std::uint8_t { EXECUTED, CANCELLED, REJECTED };
+
+        // One engine event as seen by one order.
+        struct GatewayEvent {
+            EventKind kind;
+            RejectCode reason;
+            OrderID orderID;
+            Price price;
+            Quantity quantity;
+            Quantity remaining;
+        };
+
+        MatchingEngine& engine;
+        GatewayConfig config;
+        int listenFd = -1;
+        int epollFd = -1;
+        int wakeFd = -1;
+        std::uint16_t boundPort = 0;
+
+        // Declared before the sessions, whose token maps also draw from it
+        std::pmr::unsynchronized_pool_resource routePool;
+        std::pmr::unordered_map<OrderID, OrderRoute> routes;
+
+        std::vector<std::unique_ptr<Session>> sessions;
+        std::vector<std::uint32_t> freeSlots;
+        std::vector<Session*> flushQueue;
+
+        ThreadSafeQueue<GatewayEvent> engineEvents;
+        std::atomic<bool> wakePending{false};
+        std::atomic<bool> running{false};
+        std::thread loopThread;
+        Subscriptions subscriptions;
+
+        void onEngineEvent(const GatewayEvent& event);
+        void wake();
+
+        void run();
+        void acceptSessions();
+        void readSession(std::uint32_t slot);
+        void writeSession(Session& session);
+        void closeSession(std::uint32_t slot);
+        void drainEngineEvents();
+        void flushSessions();
+
+        // Returns false if the session must be dropped.
+        bool handleMessage(std::uint32_t slot, const char* data);
+        void handleEnter(std::uint32_t slot, const EnterOrderRequest& request);
+        void handleCancel(Session& session, const CancelOrderRequest& request);
+        void handleReplace(std::uint32_t slot, const ReplaceOrderRequest& request);
+        void finishReplace(std::uint32_t slot, const TokenState& original, bool cancelled);
+        bool takeThrottleToken(Session& session);
+        void submit(std::uint32_t slot, OrderToken token, const char* symbol, std::unique_ptr<Order> order);
+
+        template<typename Message>
+        Message* reserveOutbound(Session& session, GatewayMessageType type);
+        void sendReject(Session& session, OrderToken token, RejectCode reason);
+
+    public:
+        OrderGateway(MatchingEngine& engine, EventDispatcher& dispatcher, const GatewayConfig& config = GatewayConfig{});
+        ~OrderGateway();
+
+        // Binds and starts the event loop on its own thread.
+        void start();
+        void stop();
+
+        std::uint16_t getPort() const { return boundPort; }
+};
@@ -0,0 +1,201 @@
+#include "performanceAnalytics.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include "indicators.h"
+
+PerformanceAnalyzer::PerformanceAnalyzer(const PerformanceConfig& config, bool keepSeries)
+    : config(config), keepSeries(keepSeries),
+      periodRiskFree(std::pow(1.0 + config.riskFreeRate, 1.0 / config.periodsPerYear) - 1.0) {
+    if (config.periodsPerYear <= 0) throw std::invalid_argument("Periods per year must be positive.");
+    if (config.bucketMs < 0) throw std::invalid_argument("Bucket width cannot be negative.");
+    if (config.rollingWindow == 1) throw std::invalid_argument("Rolling window must be at least 2 periods.");
+}
+
+void PerformanceAnalyzer::addEquity(std::int64_t timestampMs, double value) {
+    if (summary.periods > 0 || pending) {
+        if (timestampMs < lastTimestamp) throw std::invalid_argument("Equity timestamps must be non-decreasing.");
+    }
+    lastTimestamp = timestampMs;
+
+    if (config.bucketMs == 0) {
+        addPeriod(timestampMs, value);
+        return;
+    }
+    // Floor division, so buckets line up on whole days before the epoch too
+    std::int64_t bucket = timestampMs / config.bucketMs;
+    if (timestampMs % config.bucketMs < 0) bucket--;
+    if (pending && bucket != pendingBucket) addPeriod(pendingTime, pendingValue);
+    pending = true;
+    pendingBucket = bucket;
+    pendingTime = timestampMs;
+    pendingValue = value;
+}
+
+void PerformanceAnalyzer::addPeriod(std::int64_t timestampMs, double value) {
+    double periodReturn = 0.0;
+    if (summary.periods == 0) {
+        summary.startValue = value;
+        peak = value;
+    }
+    else {
+        periodReturn = previous > 0 ? value / previous - 1.0 : 0.0;
+        // Welford over the returns, which start with the second period
+        const double n = static_cast<double>(summary.periods);
+        const double delta = periodReturn - meanReturn;
+        meanReturn += delta / n;
+        m2 += delta * (periodReturn - meanReturn);
+        const double excess = periodReturn - periodRiskFree;
+        if (excess < 0) downsideSquares += excess * excess;
+    }
+
+    if (value >= peak) {
+        peak = value;
+        belowPeak = 0;
+    }
+    else {
+        belowPeak++;
+        summary.maxDrawdownPeriods = std::max(summary.maxDrawdownPeriods, belowPeak);
+    }
+    const double drawdown = peak > 0 ? value / peak - 1.0 : 0.0;
+    summary.maxDrawdown = std::max(summary.maxDrawdown, -drawdown);
+
+    if (keepSeries) {
+        series.timestamp.push_back(timestampMs);
+        series.equity.push_back(value);
+        series.returns.push_back(periodReturn);
+        series.drawdown.push_back(drawdown);
+    }
+    previous = value;
+    summary.periods++;
+}
+
+void PerformanceAnalyzer::addFill(std::uint32_t symbol, std::int8_t side, double price, double quantity) {
+    if (symbol >= positions.size()) positions.resize(symbol + 1);
+    Position& position = positions[symbol];
+    price *= config.priceScale;
+    const double signedQuantity = side > 0 ? quantity : -quantity;
+
+    summary.fills++;
+    summary.turnover += price * quantity;
+
+    if (position.quantity == 0 || (position.quantity > 0) == (signedQuantity > 0)) {
+        const double held = std::abs(position.quantity);
+        position.averageCost = (position.averageCost * held + price * quantity) / (held + quantity);
+        position.quantity += signedQuantity;
+        return;
+    }
+
+    const double closed = std::min(quantity, std::abs(position.quantity));
+    const double pnl = closed * (price - position.averageCost) * (position.quantity > 0 ? 1.0 : -1.0);
+    summary.closedTrades++;
+    summary.realizedPnl += pnl;
+    if (pnl > 0) {
+        summary.winningTrades++;
+        summary.grossProfit += pnl;
+    }
+    else {
+        summary.grossLoss -= pnl;
+    }
+
+    position.quantity += signedQuantity;
+    // Whatever is left after a flip was opened by this fill
+    if (position.quantity == 0) position.averageCost = 0.0;
+    else if ((position.quantity > 0) == (signedQuantity > 0)) position.averageCost = price;
+}
+
+PerformanceReport PerformanceAnalyzer::finish() {
+    if (pending) {
+        addPeriod(pendingTime, pendingValue);
+        pending = false;
+    }
+
+    PerformanceReport report;
+    PerformanceSummary& s = summary;
+    const std::size_t returns = s.periods > 0 ? s.periods - 1 : 0;
+    const double annualisation = std::sqrt(config.periodsPerYear);
+
+    s.endValue = previous;
+    if (s.startValue > 0) s.totalReturn = s.endValue / s.startValue - 1.0;
+    if (returns > 0 && s.startValue > 0 && s.endValue > 0) {
+        s.annualReturn = std::pow(s.endValue / s.startValue, config.periodsPerYear / returns) - 1.0;
+    }
+    if (returns > 1) {
+        const double deviation = std::sqrt(m2 / (returns - 1));
+        s.annualVolatility = deviation * annualisation;
+        if (deviation > 0) s.sharpe = (meanReturn - periodRiskFree) / deviation * annualisation;
+    }
+    if (downsideSquares > 0) s.sortino = (meanReturn - periodRiskFree) / std::sqrt(downsideSquares / returns) * annualisation;
+    if (s.maxDrawdown > 0) s.calmar = s.annualReturn / s.maxDrawdown;
+
+    const std::size_t losing = s.closedTrades - s.winningTrades;
+    if (s.closedTrades > 0) s.winRate = static_cast<double>(s.winningTrades) / s.closedTrades;
+    if (s.winningTrades > 0) s.averageWin = s.grossProfit / s.winningTrades;
+    if (losing > 0) s.averageLoss = s.grossLoss / losing;
+    if (s.grossLoss > 0) s.profitFactor = s.grossProfit / s.grossLoss;
+    else if (s.grossProfit > 0) s.profitFactor = std::numeric_limits<double>::infinity();
+
+    if (keepSeries && config.rollingWindow > 0) {
+        // The batch indicator kernels run over the returns after the leading zero
+        const std::size_t n = series.returns.size();
+        series.rollingSharpe.assign(n, std::numeric_limits<double>::quiet_NaN());
+        series.rollingVolatility.assign(n, std::numeric_limits<double>::quiet_NaN());
+        if (n > 1) {
+            std::vector<double> mean(n - 1);
+            indicators::sma(series.returns.data() + 1, n - 1, config.rollingWindow, mean.data());
+            indicators::rollingStdDev(series.returns.data() + 1, n - 1, config.rollingWindow, series.rollingVolatility.data() + 1);
+            for (std::size_t i = 1; i < n; ++i) {
+                const double deviation = series.rollingVolatility[i];
+                series.rollingSharpe[i] = deviation > 0 ? (mean[i - 1] - periodRiskFree) / deviation * annualisation
+                                                        : std::numeric_limits<double>::quiet_NaN();
+                series.rollingVolatility[i] = deviation * annualisation;
+            }
+        }
+    }
+
+    report.summary = s;
+    report.series = std::move(series);
+    return report;
+}
+
+PerformanceReport analyzePerformance(const PerformanceInput& input, const PerformanceConfig& config, bool keepSeries) {
+    PerformanceAnalyzer analyzer(config, keepSeries);
+    for (std::size_t i = 0; i < input.points; ++i) analyzer.addEquity(input.timestamp[i], input.equity[i]);
+    for (std::size_t i = 0; i < input.fills; ++i) {
+        analyzer.addFill(input.fillSymbol ? input.fillSymbol[i] : 0, input.fillSide[i], input.fillPrice[i], input.fillQuantity[i]);
+    }
+    return analyzer.finish();
+}
+
+std::vector<PerformanceReport> analyzePerformanceBatch(const std::vector<PerformanceInput>& inputs, const PerformanceConfig& config,
+                                                       std::size_t threads, bool keepSeries) {
+    std::vector<PerformanceReport> reports(inputs.size());
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, inputs.size());
+
+    // Results vary wildly in length, so workers pull the next one as they finish
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr failure;
+    std::atomic<bool> failed{false};
+    auto work = [&] {
+        for (std::size_t i = next++; i < inputs.size() && !failed; i = next++) {
+            try {
+                reports[i] = analyzePerformance(inputs[i], config, keepSeries);
+            }
+            catch (...) {
+                if (!failed.exchange(true)) failure = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (std::size_t t = 1; t < threads; ++t) workers.emplace_back(work);
+    work();
+    for (std::thread& worker : workers) worker.join();
+    if (failure) std::rethrow_exception(failure);
+    return reports;
+}
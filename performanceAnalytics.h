@@ -0,0 +1,128 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct PerformanceConfig {
+    double periodsPerYear = 252.0;
+    double riskFreeRate = 0.0;          // annual, converted to a per-period rate
+    // Sample the equity curve at the last point of each bucket of this many ms
+    // (86'400'000 for daily); 0 treats every point as a period. Empty buckets
+    // are skipped rather than filled.
+    std::int64_t bucketMs = 0;
+    // Periods in the rolling Sharpe and volatility series; 0 skips them.
+    std::size_t rollingWindow = 0;
+    // Multiplies fill prices so trade P&L is in the equity curve's units. The
+    // default turns engine cents into dollars.
+    double priceScale = 0.01;
+};
+
+// Return statistics are over per-period simple returns; annualised figures
+// scale by periodsPerYear. P&L statistics count each fill that reduces a
+// position as one closed trade, priced against the position's average cost.
+struct PerformanceSummary {
+    std::size_t periods = 0;
+    double startValue = 0.0;
+    double endValue = 0.0;
+    double totalReturn = 0.0;
+    double annualReturn = 0.0;          // compound annual growth rate
+    double annualVolatility = 0.0;
+    double sharpe = 0.0;
+    double sortino = 0.0;
+    double maxDrawdown = 0.0;           // largest peak-to-trough loss, as a positive fraction
+    std::size_t maxDrawdownPeriods = 0; // longest run below a previous peak
+    double calmar = 0.0;
+
+    std::size_t fills = 0;
+    std::size_t closedTrades = 0;
+    std::size_t winningTrades = 0;
+    double winRate = 0.0;
+    double grossProfit = 0.0;
+    double grossLoss = 0.0;             // positive
+    double profitFactor = 0.0;
+    double averageWin = 0.0;
+    double averageLoss = 0.0;           // positive
+    double realizedPnl = 0.0;
+    double turnover = 0.0;              // traded notional
+};
+
+// Per-period series, aligned with `timestamp`. Returns start at 0, drawdown is
+// value / running peak - 1, and the rolling series are NaN until their window
+// has filled.
+struct PerformanceSeries {
+    std::vector<std::int64_t> timestamp;
+    std::vector<double> equity;
+    std::vector<double> returns;
+    std::vector<double> drawdown;
+    std::vector<double> rollingSharpe;
+    std::vector<double> rollingVolatility;
+};
+
+struct PerformanceReport {
+    PerformanceSummary summary;
+    PerformanceSeries series;
+};
+
+// Columns of one backtest result. Fills are optional; side is +1 buy, -1 sell
+// and symbol a small per-instrument index (nullptr for a single instrument).
+struct PerformanceInput {
+    const std::int64_t* timestamp = nullptr;   // ms since epoch, non-decreasing
+    const double* equity = nullptr;
+    std::size_t points = 0;
+
+    const double* fillPrice = nullptr;
+    const double* fillQuantity = nullptr;
+    const std::int8_t* fillSide = nullptr;
+    const std::uint32_t* fillSymbol = nullptr;
+    std::size_t fills = 0;
+};
+
+// Single streaming pass: equity points and fills are folded into running
+// statistics as they arrive, so nothing but the optional series is kept.
+class PerformanceAnalyzer {
+    private:
+        struct Position {
+            double quantity = 0.0;
+            double averageCost = 0.0;
+        };
+
+        PerformanceConfig config;
+        bool keepSeries;
+        double periodRiskFree;
+
+        // Bucket being filled; it becomes a period when the next one starts
+        bool pending = false;
+        std::int64_t pendingBucket = 0;
+        std::int64_t pendingTime = 0;
+        double pendingValue = 0.0;
+
+        PerformanceSummary summary;
+        double previous = 0.0;
+        double meanReturn = 0.0;
+        double m2 = 0.0;
+        double downsideSquares = 0.0;
+        double peak = 0.0;
+        std::size_t belowPeak = 0;
+        std::int64_t lastTimestamp = 0;
+
+        std::vector<Position> positions;
+        PerformanceSeries series;
+
+        void addPeriod(std::int64_t timestampMs, double value);
+
+    public:
+        explicit PerformanceAnalyzer(const PerformanceConfig& config = PerformanceConfig{}, bool keepSeries = true);
+
+        void addEquity(std::int64_t timestampMs, double value);
+        void addFill(std::uint32_t symbol, std::int8_t side, double price, double quantity);
+
+        // Closes the last bucket and computes the derived figures. Call once.
+        PerformanceReport finish();
+};
+
+PerformanceReport analyzePerformance(const PerformanceInput& input, const PerformanceConfig& config = PerformanceConfig{}, bool keepSeries = true);
+
+// Analyzes many results at once, spread over `threads` workers (0 for one per
+// core). Results come back in input order.
+std::vector<PerformanceReport> analyzePerformanceBatch(const std::vector<PerformanceInput>& inputs, const PerformanceConfig& config = PerformanceConfig{},
+                                                       std::size_t threads = 0, bool keepSeries = false);
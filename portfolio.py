@@ -1,5 +1,6 @@
 import trading_core
 from dataclasses import dataclass
+import numpy as np
 import pandas as pd
 from typing import Optional, Hashable
 
@@ -10,6 +11,9 @@ def validate_price(price: str):
             raise ValueError("Too many decimal places")
     return float(price)
 
+def to_epoch_ms(timestamp) -> int:
+    return int(pd.Timestamp(timestamp).value // 1_000_000)
+
 @dataclass
 class Position:
     symbol: str
@@ -18,7 +22,8 @@ class Position:
     market_value: float 
 
 class Portfolio:
-    def __init__(self, cash: str, trader_id: int, holdings: dict = {}, commissions: float = 0):
+    def __init__(self, cash: str, trader_id: int, holdings: dict = {}, commissions: float = 0,
+                 recorder: Optional[trading_core.FillRecorder] = None):
         self.cash: float = validate_price(cash) 
         self.holdings: dict = holdings
         self.trader_id = trader_id 
@@ -28,6 +33,9 @@ class Portfolio:
         self.current_bar_timestamp: Optional[Hashable] = None
         self.history = []
         self.trades = []
+        # When a FillRecorder is attached, fills and equity are kept in C++ columns
+        # instead of per-event Python dicts
+        self.recorder = recorder
 
     def get_position(self, symbol: str) -> Position | None:
         return self.holdings.get(symbol)
@@ -58,13 +66,14 @@ class Portfolio:
         symbol = event.symbol
         fill_direction = "BUY" if my_side == trading_core.Side.BUY else "SELL"
         
-        self.trades.append({
-            'timestamp': self.current_bar_timestamp,
-            'symbol': symbol,
-            'side': fill_direction,
-            'price': fill_price,
-            'quantity': fill_quantity
-        })
+        if self.recorder is None:
+            self.trades.append({
+                'timestamp': self.current_bar_timestamp,
+                'symbol': symbol,
+                'side': fill_direction,
+                'price': fill_price,
+                'quantity': fill_quantity
+            })
         
         print(f"Portfolio {self.trader_id} processing fill: {fill_direction} {fill_quantity} {symbol} @ {fill_price}")
 
@@ -105,11 +114,91 @@ class Portfolio:
             self.value += new_market_value - old_market_value
             
     def log_state(self, timestamp):
+        if self.recorder is not None:
+            self.recorder.record_equity(to_epoch_ms(timestamp), self.value)
+            return
         self.history.append({
             'timestamp': timestamp,
             'value': self.value
         })
 
+    def history_frame(self) -> pd.DataFrame:
+        if self.recorder is None:
+            return pd.DataFrame(self.history)
+        equity = self.recorder.take_equity()
+        return pd.DataFrame({
+            'timestamp': pd.to_datetime(equity['timestamp'], unit='ms'),
+            'value': equity['value'],
+        })
+
+    def trades_frame(self) -> pd.DataFrame:
+        if self.recorder is None:
+            return pd.DataFrame(self.trades)
+        fills = self.recorder.take_fills()
+        return pd.DataFrame({
+            'timestamp': pd.to_datetime(fills['timestamp'], unit='ms'),
+            'symbol': pd.Categorical.from_codes(fills['symbol'].astype(np.int64), categories=self.recorder.symbols),
+            'side': np.where(fills['side'] > 0, 'BUY', 'SELL'),
+            'price': fills['price'] / 100.0,
+            'quantity': fills['quantity'],
+        })
+
     def save_results(self, history_filepath="csv/backtest_history.csv", trades_filepath="csv/backtest_trades.csv"):
-        pd.DataFrame(self.history).to_csv(history_filepath, index=False)
-        pd.DataFrame(self.trades).to_csv(trades_filepath, index=False)
\ No newline at end of file
+        self.history_frame().to_csv(history_filepath, index=False)
+        self.trades_frame().to_csv(trades_filepath, index=False)
+
+
+class LedgerPortfolio:
+    """Portfolio view over a C++ Ledger: fills and marks are applied natively on the
+    dispatcher, so nothing here runs per event. Amounts come back in cents."""
+
+    def __init__(self, ledger: trading_core.Ledger, cash: str, trader_id: int,
+                 recorder: Optional[trading_core.FillRecorder] = None):
+        self.ledger = ledger
+        self.trader_id = trader_id
+        self.recorder = recorder
+        self.initial_cash = validate_price(cash)
+        self.current_bar_timestamp: Optional[Hashable] = None
+        self.history = []
+        self.trades = []    # fills are only kept when a recorder is attached
+        ledger.open_account(trader_id, round(self.initial_cash * 100))
+
+    @property
+    def cash(self) -> float:
+        return self.ledger.account(self.trader_id).cash / 100.0
+
+    @property
+    def value(self) -> float:
+        return self.ledger.account(self.trader_id).equity / 100.0
+
+    @property
+    def trade_count(self) -> int:
+        return self.ledger.account(self.trader_id).fill_count
+
+    @property
+    def holdings(self) -> dict:
+        return {
+            p.symbol: Position(symbol=p.symbol, quantity=p.quantity,
+                               cost_basis=p.cost_basis / p.quantity / 100.0,
+                               market_value=p.market_value / 100.0)
+            for p in self.ledger.positions(self.trader_id)
+        }
+
+    def get_position(self, symbol: str) -> Position | None:
+        return self.holdings.get(symbol)
+
+    def get_total_unrealized_pnl(self) -> float:
+        return self.ledger.account(self.trader_id).unrealized_pnl / 100.0
+
+    def get_realized_pnl(self) -> float:
+        return self.ledger.account(self.trader_id).realized_pnl / 100.0
+
+    def log_state(self, timestamp):
+        if self.recorder is not None:
+            self.recorder.record_equity(to_epoch_ms(timestamp), self.value)
+            return
+        self.history.append({'timestamp': timestamp, 'value': self.value})
+
+    history_frame = Portfolio.history_frame
+    trades_frame = Portfolio.trades_frame
+    save_results = Portfolio.save_results
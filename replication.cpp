@@ -0,0 +1,391 @@
+#include "replication.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "limitOrder.h"
+#include "marketOrder.h"
+
+namespace {
+    [[noreturn]] void throwErrno(const char* what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    template<typename Done>
+    bool waitUntil(Done done, std::chrono::milliseconds timeout) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!done()) {
+            if (std::chrono::steady_clock::now() >= deadline) return false;
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        return true;
+    }
+
+    void copySymbol(char (&out)[16], const str& symbol) {
+        std::memcpy(out, symbol.data(), std::min(symbol.size(), sizeof(out)));
+    }
+}
+
+ReplicationPrimary::ReplicationPrimary(const ReplicationConfig& config) : config(config) {}
+
+ReplicationPrimary::~ReplicationPrimary() {
+    stop();
+}
+
+void ReplicationPrimary::start() {
+    listenFd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) throwErrno("socket");
+    int enable = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(config.port);
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) throwErrno("bind");
+    if (listen(listenFd, 1) < 0) throwErrno("listen");
+    socklen_t length = sizeof(address);
+    getsockname(listenFd, reinterpret_cast<sockaddr*>(&address), &length);
+    boundPort = ntohs(address.sin_port);
+
+    running = true;
+    senderThread = std::thread(&ReplicationPrimary::run, this);
+}
+
+void ReplicationPrimary::stop() {
+    if (!senderThread.joinable()) return;
+    running = false;
+    senderThread.join();
+    closeBackup();
+    if (listenFd >= 0) ::close(listenFd);
+    listenFd = -1;
+}
+
+void ReplicationPrimary::enqueue(JournalRecord& record) {
+    if (overflowed.load(std::memory_order_relaxed)) return;
+    record.sequence = nextSequence++;
+    journaledSequence.store(record.sequence);
+    // Until a backup has been sent anything, the queue holds the whole journal
+    if (record.sequence > config.maxBacklog && sentSequence.load() == 0 && !connected.load()) {
+        overflowed = true;
+        return;
+    }
+    records.push(record);
+}
+
+void ReplicationPrimary::append(const Command& command) {
+    JournalRecord record{};
+    switch (command.type) {
+        case CommandType::SUBMIT: {
+            if (!command.order) return;
+            Order& order = *command.order;
+            record.type = JournalRecordType::SUBMIT;
+            record.orderID = order.getOrderID();
+            record.traderID = order.getTraderID();
+            record.side = static_cast<std::uint8_t>(order.getSide());
+            record.orderType = static_cast<std::uint8_t>(order.getOrderType());
+            record.timeInForce = static_cast<std::uint8_t>(order.getTimeInForce());
+            record.quantity = order.getQuantity();
+            if (order.getOrderType() == OrderType::LIMIT) record.price = static_cast<LimitOrder&>(order).getPrice();
+            record.time = order.getExpireTime().time_since_epoch().count();
+            copySymbol(record.symbol, order.getSymbol());
+            break;
+        }
+        case CommandType::CANCEL:
+            record.type = JournalRecordType::CANCEL;
+            record.orderID = command.orderID;
+            break;
+        case CommandType::MASS_CANCEL:
+            record.type = JournalRecordType::MASS_CANCEL;
+            record.scope = static_cast<std::uint8_t>(command.massCancel.scope);
+            record.traderID = command.massCancel.traderID;
+            record.side = static_cast<std::uint8_t>(command.massCancel.side);
+            copySymbol(record.symbol, command.massCancel.symbol);
+            break;
+        case CommandType::BEGIN_AUCTION:
+            record.type = JournalRecordType::BEGIN_AUCTION;
+            break;
+        case CommandType::UNCROSS:
+            record.type = JournalRecordType::UNCROSS;
+            break;
+        case CommandType::SET_TIME:
+            record.type = JournalRecordType::SET_TIME;
+            record.time = command.time.time_since_epoch().count();
+            break;
+        case CommandType::STOP:
+            return;
+    }
+    enqueue(record);
+}
+
+void ReplicationPrimary::appendWallClock(Timestamp now) {
+    JournalRecord record{};
+    record.type = JournalRecordType::WALL_CLOCK;
+    record.time = now.time_since_epoch().count();
+    enqueue(record);
+}
+
+void ReplicationPrimary::run() {
+    std::vector<JournalRecord> batch;
+    batch.reserve(config.maxBatch);
+    while (true) {
+        // A backup that connected as the backlog overflowed would never be sent the rest
+        if (overflowed && backupFd >= 0 && sentSequence.load() == 0) closeBackup();
+        // Until a backup connects, records wait in the queue
+        if (backupFd < 0 && !backupLost && !overflowed) {
+            if (!acceptBackup() && !running) break;
+            continue;
+        }
+
+        JournalRecord first;
+        if (!records.tryPopFor(first, std::chrono::milliseconds(1))) {
+            if (backupFd >= 0 && !readAcks(0)) closeBackup();
+            if (!running) break;
+            continue;
+        }
+        batch.clear();
+        batch.push_back(first);
+        records.tryPopMany(batch, config.maxBatch - 1);
+        if (backupFd < 0) continue;
+        if (!sendBatch(batch) || !readAcks(0)) closeBackup();
+    }
+
+    // Half-close so the backup sees the end of the journal, and give it a
+    // moment to acknowledge the tail
+    if (backupFd >= 0) {
+        shutdown(backupFd, SHUT_WR);
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (acknowledgedSequence.load() < sentSequence.load() && std::chrono::steady_clock::now() < deadline) {
+            if (!readAcks(10)) break;
+        }
+    }
+}
+
+bool ReplicationPrimary::acceptBackup() {
+    pollfd entry{listenFd, POLLIN, 0};
+    if (poll(&entry, 1, 10) <= 0) return false;
+    int fd = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd < 0) return false;
+    int enable = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    backupFd = fd;
+    connected = true;
+    return true;
+}
+
+bool ReplicationPrimary::sendBatch(const std::vector<JournalRecord>& batch) {
+    const char* bytes = reinterpret_cast<const char*>(batch.data());
+    std::size_t size = batch.size() * sizeof(JournalRecord);
+    while (size > 0) {
+        ssize_t sent = ::send(backupFd, bytes, size, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        bytes += sent;
+        size -= static_cast<std::size_t>(sent);
+    }
+    sentSequence.store(batch.back().sequence);
+    return true;
+}
+
+bool ReplicationPrimary::readAcks(int timeoutMs) {
+    pollfd entry{backupFd, POLLIN, 0};
+    if (poll(&entry, 1, timeoutMs) <= 0) return true;
+    ssize_t received = recv(backupFd, ackBuffer + ackLength, sizeof(ackBuffer) - ackLength, MSG_DONTWAIT);
+    if (received == 0) return false;
+    if (received < 0) return errno == EAGAIN || errno == EINTR;
+    ackLength += static_cast<std::size_t>(received);
+
+    // Acks are cumulative, only the latest complete one matters
+    const std::size_t complete = ackLength / sizeof(JournalAck);
+    if (complete > 0) {
+        JournalAck ack;
+        std::memcpy(&ack, ackBuffer + (complete - 1) * sizeof(JournalAck), sizeof(ack));
+        acknowledgedSequence.store(ack.sequence);
+        const std::size_t consumed = complete * sizeof(JournalAck);
+        std::memmove(ackBuffer, ackBuffer + consumed, ackLength - consumed);
+        ackLength -= consumed;
+    }
+    return true;
+}
+
+void ReplicationPrimary::closeBackup() {
+    if (backupFd < 0) return;
+    ::close(backupFd);
+    backupFd = -1;
+    backupLost = true;
+    connected = false;
+}
+
+bool ReplicationPrimary::waitForBackup(std::chrono::milliseconds timeout) const {
+    return waitUntil([this] { return connected.load(); }, timeout);
+}
+
+bool ReplicationPrimary::waitForAcknowledgement(std::uint64_t sequence, std::chrono::milliseconds timeout) const {
+    return waitUntil([this, sequence] { return acknowledgedSequence.load() >= sequence; }, timeout);
+}
+
+ReplicationBackup::ReplicationBackup(MatchingEngine& engine) : engine(engine), inbound(INBOUND_BUFFER) {}
+
+ReplicationBackup::~ReplicationBackup() {
+    disconnect();
+}
+
+void ReplicationBackup::disconnect() {
+    stopping = true;
+    if (fd >= 0) shutdown(fd, SHUT_RDWR);
+    if (receiverThread.joinable()) receiverThread.join();
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+    connected = false;
+}
+
+void ReplicationBackup::connect(const str& host, std::uint16_t port) {
+    if (fd >= 0) throw std::logic_error("Backup is already connected");
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &result) != 0 || result == nullptr) {
+        throw std::runtime_error("Cannot resolve " + host);
+    }
+
+    fd = socket(result->ai_family, result->ai_socktype | SOCK_CLOEXEC, result->ai_protocol);
+    if (fd < 0 || ::connect(fd, result->ai_addr, result->ai_addrlen) < 0) {
+        int error = errno;
+        freeaddrinfo(result);
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+        throw std::system_error(error, std::generic_category(), "connect");
+    }
+    freeaddrinfo(result);
+
+    int enable = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    submittedCommands = engine.executedCommands();
+    connected = true;
+    receiverThread = std::thread(&ReplicationBackup::run, this);
+}
+
+void ReplicationBackup::run() {
+    while (true) {
+        ssize_t received = recv(fd, inbound.data() + inboundLength, inbound.size() - inboundLength, 0);
+        if (received < 0 && errno == EINTR) continue;
+        if (received <= 0) break;
+        inboundLength += static_cast<std::size_t>(received);
+
+        std::size_t offset = 0;
+        bool good = true;
+        for (; good && offset + sizeof(JournalRecord) <= inboundLength; offset += sizeof(JournalRecord)) {
+            JournalRecord record;
+            std::memcpy(&record, inbound.data() + offset, sizeof(record));
+            good = apply(record);
+        }
+        if (!good) {
+            failed = true;
+            break;
+        }
+        std::memmove(inbound.data(), inbound.data() + offset, inboundLength - offset);
+        inboundLength -= offset;
+
+        // Acknowledge what the engine has run, not what is queued for it
+        while (!stopping && engine.executedCommands() < submittedCommands) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        if (stopping) break;
+        JournalAck ack{appliedSequence.load()};
+        ::send(fd, &ack, sizeof(ack), MSG_NOSIGNAL);
+    }
+    connected = false;
+}
+
+bool ReplicationBackup::apply(const JournalRecord& record) {
+    if (record.sequence != appliedSequence.load() + 1) return false;
+
+    const str symbol(record.symbol, strnlen(record.symbol, sizeof(record.symbol)));
+    const Side side = static_cast<Side>(record.side);
+    switch (record.type) {
+        case JournalRecordType::SUBMIT: {
+            lastOrderID = std::max(lastOrderID, record.orderID);
+            std::unique_ptr<Order> order;
+            try {
+                if (static_cast<OrderType>(record.orderType) == OrderType::LIMIT) {
+                    order = std::make_unique<LimitOrder>(symbol, record.orderID, OrderType::LIMIT, side, record.price, record.quantity, record.traderID);
+                }
+                else {
+                    order = std::make_unique<MarketOrder>(symbol, record.orderID, OrderType::MARKET, side, record.quantity, record.traderID);
+                }
+            }
+            catch (const std::invalid_argument&) {
+                // Zero quantity: the primary ignored it too
+                break;
+            }
+            order->setTimeInForce(static_cast<TimeInForce>(record.timeInForce));
+            order->setExpireTime(Timestamp(std::chrono::milliseconds(record.time)));
+            engine.submitReserved(std::move(order));
+            submittedCommands++;
+            break;
+        }
+        case JournalRecordType::CANCEL:
+            engine.cancelOrder(record.orderID);
+            submittedCommands++;
+            break;
+        case JournalRecordType::MASS_CANCEL:
+            switch (static_cast<MassCancelScope>(record.scope)) {
+                case MassCancelScope::TRADER: engine.massCancel(record.traderID); break;
+                case MassCancelScope::TRADER_SIDE: engine.massCancel(record.traderID, side); break;
+                case MassCancelScope::SYMBOL: engine.massCancelSymbol(symbol); break;
+                case MassCancelScope::ALL: engine.massCancelAll(); break;
+                default: return false;
+            }
+            submittedCommands++;
+            break;
+        case JournalRecordType::BEGIN_AUCTION:
+            engine.beginAuction();
+            submittedCommands++;
+            break;
+        case JournalRecordType::UNCROSS:
+            engine.uncross();
+            submittedCommands++;
+            break;
+        case JournalRecordType::SET_TIME:
+            // A zero time is the primary going back to the wall clock; its next
+            // WALL_CLOCK record comes before anything else runs
+            wallClock = record.time == 0;
+            if (!wallClock) {
+                engine.setTime(Timestamp(std::chrono::milliseconds(record.time)));
+                submittedCommands++;
+            }
+            break;
+        case JournalRecordType::WALL_CLOCK:
+            wallClock = true;
+            engine.setTime(Timestamp(std::chrono::milliseconds(record.time)));
+            submittedCommands++;
+            break;
+        default:
+            return false;
+    }
+    appliedSequence.store(record.sequence);
+    return true;
+}
+
+std::uint64_t ReplicationBackup::promote() {
+    disconnect();
+
+    engine.advanceOrderIDs(lastOrderID + 1);
+    if (wallClock) engine.resumeWallClock();
+    return appliedSequence.load();
+}
+
+bool ReplicationBackup::waitForSequence(std::uint64_t sequence, std::chrono::milliseconds timeout) const {
+    return waitUntil([this, sequence] { return appliedSequence.load() >= sequence; }, timeout);
+}
@@ -0,0 +1,139 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "replicationProtocol.h"
+#include "matchingEngine.h"
+#include "threadSafeQueue.h"
+
+struct ReplicationConfig {
+    std::uint16_t port = 0;             // 0 binds an ephemeral port, see getPort()
+    std::size_t maxBatch = 1024;        // records per send
+    std::uint64_t maxBacklog = 1 << 20; // records held for a backup that has not connected yet
+};
+
+// Hot-standby journal for the primary engine. Attached with
+// engine.setJournal(), it encodes each command into a JournalRecord on the
+// matching thread and queues it; a sender thread ships whatever has queued up
+// to the backup in one write, so the matching thread never waits on the
+// network. Records queue up until a backup connects, and it is sent the
+// journal from sequence 1; if `maxBacklog` records are journaled first, the
+// queue is dropped and the primary runs unprotected rather than hold the
+// whole session in memory. A single backup is served; once it disconnects
+// the primary also runs unprotected and later records are dropped.
+// Acknowledgements mean the backup's engine has run the command.
+class ReplicationPrimary : public CommandJournal {
+    private:
+        ReplicationConfig config;
+        int listenFd = -1;
+        int backupFd = -1;
+        std::uint16_t boundPort = 0;
+        bool backupLost = false;
+        char ackBuffer[64 * sizeof(JournalAck)];
+        std::size_t ackLength = 0;
+
+        // Written by the matching thread only
+        std::uint64_t nextSequence = 1;
+        ThreadSafeQueue<JournalRecord> records;
+
+        std::atomic<std::uint64_t> journaledSequence{0};
+        std::atomic<std::uint64_t> sentSequence{0};
+        std::atomic<std::uint64_t> acknowledgedSequence{0};
+        std::atomic<bool> connected{false};
+        std::atomic<bool> overflowed{false};
+        std::atomic<bool> running{false};
+        std::thread senderThread;
+
+        void enqueue(JournalRecord& record);
+        void run();
+        bool acceptBackup();
+        bool sendBatch(const std::vector<JournalRecord>& batch);
+        // False once the backup has gone away
+        bool readAcks(int timeoutMs);
+        void closeBackup();
+
+    public:
+        explicit ReplicationPrimary(const ReplicationConfig& config = ReplicationConfig{});
+        ~ReplicationPrimary();
+        ReplicationPrimary(const ReplicationPrimary&) = delete;
+        ReplicationPrimary& operator=(const ReplicationPrimary&) = delete;
+
+        // Binds and starts the sender thread.
+        void start();
+        // Sends everything journaled so far, then disconnects. Stop the engine first.
+        void stop();
+
+        void append(const Command& command) override;
+        void appendWallClock(Timestamp now) override;
+
+        bool waitForBackup(std::chrono::milliseconds timeout) const;
+        // True once the backup has acknowledged `sequence`.
+        bool waitForAcknowledgement(std::uint64_t sequence, std::chrono::milliseconds timeout) const;
+
+        std::uint16_t getPort() const { return boundPort; }
+        bool isConnected() const { return connected.load(); }
+        // The backlog outgrew maxBacklog before a backup connected; none will be served.
+        bool hasOverflowed() const { return overflowed.load(); }
+        std::uint64_t getSequence() const { return journaledSequence.load(); }
+        std::uint64_t getSentSequence() const { return sentSequence.load(); }
+        std::uint64_t getAcknowledgedSequence() const { return acknowledgedSequence.load(); }
+};
+
+// Follows a ReplicationPrimary: a receiver thread reads the journal and
+// submits each record to the backup's engine in order, which must be built
+// with the primary's EngineConfig and risk overrides, have nothing queued
+// when connecting, and be started (or drained with runPending()). A batch
+// is acknowledged once the engine has run it, and the next is not read
+// until then, so a lagging engine holds back the primary's sender through
+// TCP flow control rather than queueing here. When the primary goes away,
+// promote() takes over at the last sequence received.
+class ReplicationBackup {
+    private:
+        static constexpr std::size_t INBOUND_BUFFER = 64 * 1024;
+
+        MatchingEngine& engine;
+        int fd = -1;
+        std::vector<char> inbound;
+        std::size_t inboundLength = 0;
+
+        OrderID lastOrderID = 0;
+        bool wallClock = true;
+        // Engine commands the acknowledged records must wait for
+        std::uint64_t submittedCommands = 0;
+
+        std::atomic<std::uint64_t> appliedSequence{0};
+        std::atomic<bool> connected{false};
+        std::atomic<bool> failed{false};
+        std::atomic<bool> stopping{false};
+        std::thread receiverThread;
+
+        void run();
+        // False on a sequence gap
+        bool apply(const JournalRecord& record);
+        void disconnect();
+
+    public:
+        explicit ReplicationBackup(MatchingEngine& engine);
+        ~ReplicationBackup();
+        ReplicationBackup(const ReplicationBackup&) = delete;
+        ReplicationBackup& operator=(const ReplicationBackup&) = delete;
+
+        void connect(const str& host, std::uint16_t port);
+
+        // Stops following the primary and leaves the engine ready to trade in
+        // its place: ids continue after the primary's and the clock returns to
+        // the wall clock if that is what the primary ran on. Returns the last
+        // sequence applied; the engine's state is the primary's as of that record.
+        std::uint64_t promote();
+
+        // Waits until `sequence` has been handed to the engine.
+        bool waitForSequence(std::uint64_t sequence, std::chrono::milliseconds timeout) const;
+
+        // False once the primary has disconnected or sent a bad journal.
+        bool isConnected() const { return connected.load(); }
+        // The journal had a gap or an unknown record; the engine stopped short of it.
+        bool hasFailed() const { return failed.load(); }
+        std::uint64_t getSequence() const { return appliedSequence.load(); }
+};
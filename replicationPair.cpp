@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "replication.h"
+#include "limitOrder.h"
+
+// Usage:
+//   replication_pair [--orders N] [--seed S]
+//
+// Forks a backup process that follows an in-process primary over loopback.
+// The primary runs the same random order flow twice, once without a journal
+// and once replicating, and reports the per-command cost on the matching
+// thread for each. It then exits; the backup promotes itself and checks its
+// book against the digest the primary sent over a pipe.
+namespace {
+    std::uint64_t bookDigest(OrderBook& book) {
+        std::uint64_t hash = 1469598103934665603ull;
+        auto mix = [&hash](std::uint64_t value) { hash = (hash ^ value) * 1099511628211ull; };
+        for (Side side : {Side::BUY, Side::SELL}) {
+            for (const LevelSnapshot& level : book.depth(side)) {
+                mix(level.price);
+                mix(level.quantity);
+                for (OrderID id : level.orders) mix(id);
+            }
+        }
+        return hash;
+    }
+
+    bool readAll(int fd, void* data, std::size_t size) {
+        char* bytes = static_cast<char*>(data);
+        while (size > 0) {
+            ssize_t got = read(fd, bytes, size);
+            if (got <= 0) return false;
+            bytes += got;
+            size -= static_cast<std::size_t>(got);
+        }
+        return true;
+    }
+
+    int runBackup(int pipeFd) {
+        std::uint16_t port = 0;
+        if (!readAll(pipeFd, &port, sizeof(port))) return 1;
+
+        OrderBook book;
+        EventDispatcher dispatcher;
+        MatchingEngine engine(book, dispatcher);
+        ReplicationBackup backup(engine);
+        backup.connect("127.0.0.1", port);
+        engine.start();
+
+        std::uint64_t expected = 0;
+        if (!readAll(pipeFd, &expected, sizeof(expected))) return 1;
+        while (backup.isConnected()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        const std::uint64_t sequence = backup.promote();
+        engine.stop();
+        const bool match = bookDigest(book) == expected;
+        std::cout << "Backup promoted at sequence " << sequence << ", book " << (match ? "matches" : "DIFFERS FROM") << " the primary's"
+                  << std::endl;
+        return match && !backup.hasFailed() ? 0 : 1;
+    }
+
+    // Runs the flow synchronously and returns per-command times in ns.
+    std::vector<double> runFlow(MatchingEngine& engine, std::size_t orders, std::uint64_t seed) {
+        std::mt19937_64 rng(seed);
+        std::vector<OrderID> live;
+        std::vector<double> times;
+        times.reserve(orders);
+        for (std::size_t i = 0; i < orders; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            if (!live.empty() && rng() % 3 == 0) {
+                const std::size_t pick = rng() % live.size();
+                engine.cancelOrder(live[pick]);
+                live[pick] = live.back();
+                live.pop_back();
+            }
+            else {
+                const Side side = rng() % 2 ? Side::BUY : Side::SELL;
+                const Price price = side == Side::BUY ? 10000 - static_cast<Price>(rng() % 20) : 9995 + static_cast<Price>(rng() % 20);
+                live.push_back(engine.submitOrder(std::make_unique<LimitOrder>("SYNTH", 0, OrderType::LIMIT, side, price,
+                                                                               1 + static_cast<Quantity>(rng() % 10), 1 + rng() % 16)));
+            }
+            engine.runPending();
+            times.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::sort(times.begin(), times.end());
+        return times;
+    }
+
+    void report(const char* label, const std::vector<double>& times) {
+        auto percentile = [&](double p) { return times[std::min(times.size() - 1, static_cast<std::size_t>(p * times.size()))]; };
+        std::cout << label << " (ns): p50 " << percentile(0.50) << ", p99 " << percentile(0.99) << ", p99.9 " << percentile(0.999) << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::size_t orders = 200'000;
+    std::uint64_t seed = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        str arg = argv[i];
+        auto value = [&]() -> str {
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << std::endl;
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+        if (arg == "--orders") orders = std::max<std::size_t>(1, std::stoull(value()));
+        else if (arg == "--seed") seed = std::stoull(value());
+        else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    int pipeFds[2];
+    if (pipe(pipeFds) != 0) return 1;
+    // Fork before any threads exist
+    pid_t child = fork();
+    if (child == 0) {
+        close(pipeFds[1]);
+        return runBackup(pipeFds[0]);
+    }
+    close(pipeFds[0]);
+
+    {
+        OrderBook book;
+        EventDispatcher dispatcher;
+        MatchingEngine engine(book, dispatcher);
+        report("Per command without replication", runFlow(engine, orders, seed));
+    }
+
+    OrderBook book;
+    EventDispatcher dispatcher;
+    MatchingEngine engine(book, dispatcher);
+    ReplicationPrimary primary;
+    engine.setJournal(&primary);
+    primary.start();
+    const std::uint16_t port = primary.getPort();
+    write(pipeFds[1], &port, sizeof(port));
+    if (!primary.waitForBackup(std::chrono::seconds(5))) {
+        std::cerr << "Backup did not connect" << std::endl;
+        return 1;
+    }
+
+    report("Per command with replication   ", runFlow(engine, orders, seed));
+    const std::uint64_t sequence = primary.getSequence();
+    const bool acknowledged = primary.waitForAcknowledgement(sequence, std::chrono::seconds(5));
+    std::cout << "Primary journaled " << sequence << " records, " << (acknowledged ? "all" : "not all") << " acknowledged" << std::endl;
+
+    const std::uint64_t digest = bookDigest(book);
+    write(pipeFds[1], &digest, sizeof(digest));
+    primary.stop();
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
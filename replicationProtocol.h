@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include "types.h"
+
+// Command journal streamed from a primary engine to its backup over TCP. The
+// primary sends fixed-size records back to back, sequenced from 1 with no
+// gaps; the backup answers with a JournalAck carrying the last sequence it
+// has handed to its engine. Integers are little-endian and every record is
+// read as a plain struct.
+//
+// SUBMIT carries the whole order under the id the primary assigned, so the
+// backup's books share ids with the primary's. WALL_CLOCK is the primary's
+// wall-clock time for the records that follow; the backup applies it as an
+// engine clock so expiries and DAY deadlines come out the same on both.
+
+enum class JournalRecordType : char {
+    SUBMIT = 'O',
+    CANCEL = 'X',
+    MASS_CANCEL = 'M',
+    BEGIN_AUCTION = 'B',
+    UNCROSS = 'U',
+    SET_TIME = 'T',
+    WALL_CLOCK = 'W'
+};
+
+struct JournalRecord {
+    std::uint64_t sequence;
+    JournalRecordType type;
+    std::uint8_t side;          // Side
+    std::uint8_t orderType;     // OrderType
+    std::uint8_t timeInForce;   // TimeInForce
+    std::uint8_t scope;         // MassCancelScope
+    std::uint8_t reserved[3];
+    OrderID orderID;
+    TraderID traderID;
+    Price price;                // limit orders only
+    Quantity quantity;
+    std::uint32_t reserved2;
+    std::int64_t time;          // ms since epoch: clock records and GTD expire times
+    char symbol[16];            // NUL-padded; longer symbols are truncated
+};
+
+struct JournalAck {
+    std::uint64_t sequence;
+};
+
+static_assert(sizeof(JournalRecord) == 64);
+static_assert(sizeof(JournalAck) == 8);
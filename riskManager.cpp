@@ -0,0 +1,86 @@
+#include "riskManager.h"
+#include "limitOrder.h"
+
+RiskManager::RiskManager(const RiskLimits& defaultLimits, TraderID maxTraders)
+    : defaultLimits(defaultLimits), maxTraders(maxTraders), enabled(defaultLimits.any()) {
+    if (enabled) allocate();
+}
+
+void RiskManager::allocate() {
+    if (!traders.empty()) return;
+    TraderState fresh;
+    fresh.limits = defaultLimits;
+    traders.assign(maxTraders, fresh);
+}
+
+void RiskManager::setLimits(TraderID traderID, const RiskLimits& limits) {
+    if (traderID >= maxTraders) throw std::invalid_argument("Trader ID exceeds the configured maximum.");
+    allocate();
+    state(traderID).limits = limits;
+    enabled = enabled || limits.any();
+}
+
+std::optional<RejectReason> RiskManager::check(Order& order) {
+    if (!enabled) return std::nullopt;
+
+    const TraderID traderID = order.getTraderID();
+    if (traderID >= maxTraders) return RejectReason::UNKNOWN_TRADER;
+
+    TraderState& trader = state(traderID);
+    const RiskLimits& limits = trader.limits;
+    const Quantity quantity = order.getQuantity();
+    const bool isLimit = order.getOrderType() == OrderType::LIMIT;
+
+    if (limits.maxOrderQuantity != 0 && quantity > limits.maxOrderQuantity) {
+        return RejectReason::ORDER_SIZE;
+    }
+    if (limits.maxOpenOrders != 0 && isLimit && trader.openOrders >= limits.maxOpenOrders) {
+        return RejectReason::OPEN_ORDER_LIMIT;
+    }
+    if (limits.maxPosition != 0) {
+        // Worst case: every open order on this side fills along with this one
+        std::int64_t worst = order.getSide() == Side::BUY
+            ? trader.position + trader.openBuyQuantity + quantity
+            : trader.position - trader.openSellQuantity - quantity;
+        if (worst > limits.maxPosition || worst < -limits.maxPosition) return RejectReason::POSITION_LIMIT;
+    }
+    if (limits.priceBandTicks != 0 && isLimit && lastTradePrice != 0) {
+        Price price = static_cast<LimitOrder&>(order).getPrice();
+        Price distance = price > lastTradePrice ? price - lastTradePrice : lastTradePrice - price;
+        if (distance > limits.priceBandTicks) return RejectReason::PRICE_BAND;
+    }
+    return std::nullopt;
+}
+
+void RiskManager::onOrderRested(TraderID traderID, Side side, Quantity quantity) {
+    if (!enabled || traderID >= maxTraders) return;
+    TraderState& trader = state(traderID);
+    trader.openOrders++;
+    (side == Side::BUY ? trader.openBuyQuantity : trader.openSellQuantity) += quantity;
+}
+
+void RiskManager::onRestingReduced(TraderID traderID, Side side, Quantity quantity, bool removed) {
+    if (!enabled || traderID >= maxTraders) return;
+    TraderState& trader = state(traderID);
+    std::int64_t& open = side == Side::BUY ? trader.openBuyQuantity : trader.openSellQuantity;
+    open = open > quantity ? open - quantity : 0;
+    if (removed && trader.openOrders > 0) trader.openOrders--;
+}
+
+void RiskManager::onTrade(TraderID aggressorID, Side aggressorSide, TraderID restingID, Price price, Quantity quantity, bool restingFilled) {
+    lastTradePrice = price;
+    if (!enabled) return;
+
+    const std::int64_t signedQuantity = aggressorSide == Side::BUY ? quantity : -static_cast<std::int64_t>(quantity);
+    if (aggressorID < maxTraders) state(aggressorID).position += signedQuantity;
+    if (restingID < maxTraders) state(restingID).position -= signedQuantity;
+    onRestingReduced(restingID, getOppositeSide(aggressorSide), quantity, restingFilled);
+}
+
+std::int64_t RiskManager::getPosition(TraderID traderID) const {
+    return traderID < traders.size() ? traders[traderID].position : 0;
+}
+
+std::uint32_t RiskManager::getOpenOrders(TraderID traderID) const {
+    return traderID < traders.size() ? traders[traderID].openOrders : 0;
+}
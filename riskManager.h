@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include "types.h"
+#include "order.h"
+#include "events.h"
+#include "engineConfig.h"
+
+// Pre-trade checks and the per-trader state they need. State lives in a flat
+// array indexed by trader id so a check is a bounds test and a few compares.
+// Only the matching thread touches it.
+class RiskManager {
+    private:
+        struct TraderState {
+            RiskLimits limits;
+            std::int64_t position = 0;
+            std::int64_t openBuyQuantity = 0;
+            std::int64_t openSellQuantity = 0;
+            std::uint32_t openOrders = 0;
+        };
+
+        RiskLimits defaultLimits;
+        TraderID maxTraders;
+        bool enabled;
+        Price lastTradePrice = 0;
+        // maxTraders rows, allocated once risk is in use so the checks never grow it
+        std::vector<TraderState> traders;
+
+        void allocate();
+        TraderState& state(TraderID traderID) { return traders[traderID]; }
+
+    public:
+        RiskManager(const RiskLimits& defaultLimits, TraderID maxTraders);
+
+        void setLimits(TraderID traderID, const RiskLimits& limits);
+        bool isEnabled() const { return enabled; }
+
+        std::optional<RejectReason> check(Order& order);
+
+        void onOrderRested(TraderID traderID, Side side, Quantity quantity);
+        void onRestingReduced(TraderID traderID, Side side, Quantity quantity, bool removed);
+        void onTrade(TraderID aggressorID, Side aggressorSide, TraderID restingID, Price price, Quantity quantity, bool restingFilled);
+
+        std::int64_t getPosition(TraderID traderID) const;
+        std::uint32_t getOpenOrders(TraderID traderID) const;
+};
@@ -0,0 +1,177 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "types.h"
+#include "orderEntryProtocol.h"
+
+// Layout of the shared-memory region between ShmServer and ShmClient
+// processes. Everything here is placed in the mapping, so it may only hold
+// trivially copyable data and address-free (lock-free) atomics.
+
+constexpr std::size_t CACHE_LINE = 64;
+
+// Single-producer single-consumer ring. Each side keeps a cached copy of the
+// other side's index on its own cache line and only reloads it when the ring
+// looks full (producer) or empty (consumer).
+template<typename T, std::size_t Capacity>
+class SpscRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>);
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+    private:
+        alignas(CACHE_LINE) std::atomic<std::uint64_t> head{0};     // next slot to write
+        std::uint64_t cachedTail = 0;
+        alignas(CACHE_LINE) std::atomic<std::uint64_t> tail{0};     // next slot to read
+        std::uint64_t cachedHead = 0;
+        alignas(CACHE_LINE) T slots[Capacity];
+
+    public:
+        bool tryPush(const T& value) {
+            const std::uint64_t position = head.load(std::memory_order_relaxed);
+            if (position - cachedTail == Capacity) {
+                cachedTail = tail.load(std::memory_order_acquire);
+                if (position - cachedTail == Capacity) return false;
+            }
+            slots[position & (Capacity - 1)] = value;
+            head.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool tryPop(T& value) {
+            const std::uint64_t position = tail.load(std::memory_order_relaxed);
+            if (position == cachedHead) {
+                cachedHead = head.load(std::memory_order_acquire);
+                if (position == cachedHead) return false;
+            }
+            value = slots[position & (Capacity - 1)];
+            tail.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool empty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+
+        // Only while neither side is using the ring.
+        void reset() {
+            head.store(0, std::memory_order_relaxed);
+            tail.store(0, std::memory_order_relaxed);
+            cachedTail = 0;
+            cachedHead = 0;
+        }
+};
+
+enum class ShmCommandType : std::uint8_t { SUBMIT, CANCEL };
+
+struct ShmCommand {
+    std::uint64_t token;        // client-chosen id for the order
+    Price price;
+    Quantity quantity;
+    ShmCommandType type;
+    std::uint8_t side;          // Side
+    std::uint8_t orderType;     // OrderType
+    std::uint8_t reserved[5];
+    char symbol[8];             // NUL-padded
+};
+
+enum class ShmReportType : std::uint8_t { ACCEPTED, EXECUTED, CANCELLED, REJECTED };
+
+struct ShmReport {
+    std::uint64_t token;
+    OrderID orderID;
+    Price price;
+    Quantity quantity;
+    Quantity remaining;         // a CANCELLED leaving some is a self-trade reduction
+    ShmReportType type;
+    RejectCode reason;          // for REJECTED
+    std::uint8_t reserved[2];
+};
+
+static_assert(sizeof(ShmCommand) == 32);
+static_assert(sizeof(ShmReport) == 32);
+
+struct TopOfBook {
+    Price bidPrice = 0;         // 0 when the side is empty
+    Quantity bidQuantity = 0;
+    Price askPrice = 0;
+    Quantity askQuantity = 0;
+    Price lastPrice = 0;
+    std::uint64_t version = 0;  // bumps on every change
+};
+
+// Single-writer seqlock: the engine thread publishes, any number of client
+// processes read. Fields are relaxed atomics so concurrent reads are defined.
+class ShmTopOfBook {
+    private:
+        std::atomic<std::uint64_t> sequence{0};
+        std::atomic<Price> bidPrice{0};
+        std::atomic<Quantity> bidQuantity{0};
+        std::atomic<Price> askPrice{0};
+        std::atomic<Quantity> askQuantity{0};
+        std::atomic<Price> lastPrice{0};
+
+    public:
+        void store(const TopOfBook& top) {
+            const std::uint64_t start = sequence.load(std::memory_order_relaxed) + 1;
+            sequence.store(start, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            bidPrice.store(top.bidPrice, std::memory_order_relaxed);
+            bidQuantity.store(top.bidQuantity, std::memory_order_relaxed);
+            askPrice.store(top.askPrice, std::memory_order_relaxed);
+            askQuantity.store(top.askQuantity, std::memory_order_relaxed);
+            lastPrice.store(top.lastPrice, std::memory_order_relaxed);
+            sequence.store(start + 1, std::memory_order_release);
+        }
+
+        TopOfBook load() const {
+            TopOfBook top;
+            while (true) {
+                const std::uint64_t before = sequence.load(std::memory_order_acquire);
+                if (before & 1) continue;
+                top.bidPrice = bidPrice.load(std::memory_order_relaxed);
+                top.bidQuantity = bidQuantity.load(std::memory_order_relaxed);
+                top.askPrice = askPrice.load(std::memory_order_relaxed);
+                top.askQuantity = askQuantity.load(std::memory_order_relaxed);
+                top.lastPrice = lastPrice.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) == before) {
+                    top.version = before / 2;
+                    return top;
+                }
+            }
+        }
+};
+
+enum class ShmSlotState : std::uint32_t {
+    FREE,
+    CLAIMED,    // a client is setting the slot up
+    ACTIVE,
+    EVICTED,    // dropped by the server for not draining its reports; the client must close
+    CLOSING     // the client left; the server cancels its orders and frees the slot
+};
+
+struct ShmClientSlot {
+    static constexpr std::size_t REQUEST_CAPACITY = 1024;
+    static constexpr std::size_t REPORT_CAPACITY = 4096;
+
+    alignas(CACHE_LINE) std::atomic<ShmSlotState> state{ShmSlotState::FREE};
+    TraderID traderID = 0;
+    std::int32_t pid = 0;
+    SpscRing<ShmCommand, REQUEST_CAPACITY> requests;    // client -> server
+    SpscRing<ShmReport, REPORT_CAPACITY> reports;       // server -> client
+};
+
+struct ShmRegion {
+    static constexpr std::uint64_t MAGIC = 0x54524144454e4731;     // "TRADENG1"
+    static constexpr std::uint32_t MAX_CLIENTS = 16;
+
+    std::atomic<std::uint64_t> magic{0};    // set last, once the region is built
+    std::uint32_t version = 1;
+    std::atomic<std::uint32_t> serverRunning{0};
+    alignas(CACHE_LINE) ShmTopOfBook topOfBook;
+    ShmClientSlot clients[MAX_CLIENTS];
+};
+
+static_assert(std::atomic<ShmSlotState>::is_always_lock_free);
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
@@ -0,0 +1,89 @@
+#include "shmClient.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+ShmClient::ShmClient(const str& name, TraderID traderID) {
+    if (traderID == 0) throw std::invalid_argument("Trader id 0 is reserved");
+
+    shmFd = shm_open(name.c_str(), O_RDWR, 0);
+    if (shmFd < 0) throw std::runtime_error("No engine serving shared memory at " + name);
+    struct stat info;
+    if (fstat(shmFd, &info) < 0 || static_cast<std::size_t>(info.st_size) < sizeof(ShmRegion)) {
+        ::close(shmFd);
+        throw std::runtime_error("Shared memory at " + name + " is not an engine region");
+    }
+    void* mapping = mmap(nullptr, sizeof(ShmRegion), PROT_READ | PROT_WRITE, MAP_SHARED, shmFd, 0);
+    if (mapping == MAP_FAILED) {
+        int error = errno;
+        ::close(shmFd);
+        throw std::system_error(error, std::generic_category(), "mmap");
+    }
+    region = static_cast<ShmRegion*>(mapping);
+    if (region->magic.load(std::memory_order_acquire) != ShmRegion::MAGIC || !region->serverRunning.load(std::memory_order_acquire)) {
+        close();
+        throw std::runtime_error("No engine serving shared memory at " + name);
+    }
+
+    for (ShmClientSlot& candidate : region->clients) {
+        ShmSlotState expected = ShmSlotState::FREE;
+        if (candidate.state.compare_exchange_strong(expected, ShmSlotState::CLAIMED, std::memory_order_acq_rel)) {
+            candidate.traderID = traderID;
+            candidate.pid = static_cast<std::int32_t>(getpid());
+            candidate.state.store(ShmSlotState::ACTIVE, std::memory_order_release);
+            slot = &candidate;
+            return;
+        }
+    }
+    close();
+    throw std::runtime_error("All shared-memory client slots are in use");
+}
+
+ShmClient::~ShmClient() {
+    close();
+}
+
+void ShmClient::close() {
+    if (slot) slot->state.store(ShmSlotState::CLOSING, std::memory_order_release);
+    slot = nullptr;
+    if (region) munmap(region, sizeof(ShmRegion));
+    region = nullptr;
+    if (shmFd >= 0) ::close(shmFd);
+    shmFd = -1;
+}
+
+bool ShmClient::isConnected() const {
+    return slot && slot->state.load(std::memory_order_acquire) == ShmSlotState::ACTIVE &&
+           region->serverRunning.load(std::memory_order_acquire);
+}
+
+bool ShmClient::submit(std::uint64_t token, const str& symbol, Side side, OrderType orderType, Price price, Quantity quantity) {
+    if (!slot) throw std::logic_error("Shared-memory client is closed");
+    if (symbol.size() > sizeof(ShmCommand::symbol)) throw std::invalid_argument("Symbol longer than 8 characters: " + symbol);
+    ShmCommand command{};
+    command.token = token;
+    command.price = price;
+    command.quantity = quantity;
+    command.type = ShmCommandType::SUBMIT;
+    command.side = static_cast<std::uint8_t>(side);
+    command.orderType = static_cast<std::uint8_t>(orderType);
+    std::memcpy(command.symbol, symbol.data(), symbol.size());
+    return slot->requests.tryPush(command);
+}
+
+bool ShmClient::cancel(std::uint64_t token) {
+    if (!slot) throw std::logic_error("Shared-memory client is closed");
+    ShmCommand command{};
+    command.token = token;
+    command.type = ShmCommandType::CANCEL;
+    return slot->requests.tryPush(command);
+}
+
+bool ShmClient::poll(ShmReport& report) {
+    return slot && slot->reports.tryPop(report);
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include "shmChannel.h"
+#include "order.h"
+
+// Strategy-side end of the shared-memory channel. Each client owns one slot
+// of the region, trades as one trader, and must be used from a single thread.
+// Nothing here blocks: submit/cancel fail when the request ring is full and
+// poll returns false when no report is waiting.
+class ShmClient {
+    private:
+        int shmFd = -1;
+        ShmRegion* region = nullptr;
+        ShmClientSlot* slot = nullptr;
+
+    public:
+        // Throws std::runtime_error if no server is running under `name` or all slots are taken.
+        ShmClient(const str& name, TraderID traderID);
+        ~ShmClient();
+        ShmClient(const ShmClient&) = delete;
+        ShmClient& operator=(const ShmClient&) = delete;
+
+        // Hands the slot back; the server cancels any orders still open.
+        void close();
+        bool isConnected() const;
+
+        bool submit(std::uint64_t token, const str& symbol, Side side, OrderType orderType, Price price, Quantity quantity);
+        bool cancel(std::uint64_t token);
+        bool poll(ShmReport& report);
+
+        TopOfBook topOfBook() const { return region->topOfBook.load(); }
+};
@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "shmServer.h"
+#include "shmClient.h"
+#include "matchingEngine.h"
+#include "orderBook.h"
+#include "eventDispatcher.h"
+#include "threadTuning.h"
+
+// Usage:
+//   shm_latency [--orders N] [--engine-core C] [--server-core C] [--client-core C]
+//
+// Forks a strategy process that talks to an in-process engine over the
+// shared-memory channel and reports round-trip times from submit to the
+// ACCEPTED report (the request crosses the region twice), one order at a time.
+// Pin the three threads to separate isolated cores for meaningful numbers.
+namespace {
+    int runClient(const str& name, std::size_t orders, int core) {
+        if (core >= 0) pinCurrentThread(core);
+
+        std::unique_ptr<ShmClient> client;
+        for (int attempt = 0; !client && attempt < 1000; ++attempt) {
+            try {
+                client = std::make_unique<ShmClient>(name, 1);
+            }
+            catch (const std::runtime_error&) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+        }
+        if (!client) {
+            std::cerr << "Could not connect to " << name << std::endl;
+            return 1;
+        }
+
+        std::vector<double> roundTripsNs;
+        roundTripsNs.reserve(orders);
+        ShmReport report;
+        for (std::size_t i = 0; i < orders; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            // Alternate sides around a fixed price so the book stays small
+            Side side = (i % 2 == 0) ? Side::BUY : Side::SELL;
+            while (!client->submit(i + 1, "SYNTH", side, OrderType::LIMIT, 10000, 1)) cpuRelax();
+            do {
+                while (!client->poll(report)) cpuRelax();
+            } while (report.type != ShmReportType::ACCEPTED || report.token != i + 1);
+            roundTripsNs.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+        }
+        client->close();
+
+        std::sort(roundTripsNs.begin(), roundTripsNs.end());
+        auto percentile = [&](double p) { return roundTripsNs[std::min(roundTripsNs.size() - 1, static_cast<std::size_t>(p * roundTripsNs.size()))]; };
+        std::cout << "Round trip submit -> ACCEPTED over " << orders << " orders (ns): p50 " << percentile(0.50)
+                  << ", p99 " << percentile(0.99) << ", p99.9 " << percentile(0.999) << ", max " << roundTripsNs.back() << std::endl;
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::size_t orders = 100'000;
+    int engineCore = -1, serverCore = -1, clientCore = -1;
+
+    for (int i = 1; i < argc; ++i) {
+        str arg = argv[i];
+        auto value = [&]() -> str {
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << std::endl;
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+        if (arg == "--orders") orders = std::max<std::size_t>(1, std::stoull(value()));
+        else if (arg == "--engine-core") engineCore = std::stoi(value());
+        else if (arg == "--server-core") serverCore = std::stoi(value());
+        else if (arg == "--client-core") clientCore = std::stoi(value());
+        else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    const str name = "/trading_engine_latency_" + std::to_string(getpid());
+
+    // Fork before any threads exist; the child only ever touches the region
+    pid_t child = fork();
+    if (child == 0) return runClient(name, orders, clientCore);
+
+    EngineConfig engineConfig;
+    engineConfig.matchingCore = engineCore;
+    engineConfig.waitStrategy = WaitStrategy::BUSY_POLL;
+    ShmServerConfig serverConfig;
+    serverConfig.name = name;
+    serverConfig.pollCore = serverCore;
+
+    OrderBook book;
+    EventDispatcher dispatcher;
+    MatchingEngine engine(book, dispatcher, engineConfig);
+    ShmServer server(engine, dispatcher, book, serverConfig);
+    server.start();
+    engine.start();
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    server.stop();
+    engine.stop();
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
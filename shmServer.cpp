@@ -0,0 +1,285 @@
+#include "shmServer.h"
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <system_error>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "limitOrder.h"
+#include "marketOrder.h"
+#include "threadTuning.h"
+
+ShmServer::ShmServer(MatchingEngine& engine, EventDispatcher& dispatcher, OrderBook& book, const ShmServerConfig& config)
+    : engine(engine), book(book), config(config), engineReports(std::make_unique<SpscRing<EngineReport, 65536>>()) {
+    subscriptions.add<TradeExecutedEvent>(dispatcher, [this](const TradeExecutedEvent& e) {
+        pushEngineReport({EventKind::EXECUTED, RejectCode::INVALID_ORDER, e.aggressingOrderID, e.price, e.quantity, e.aggressingRemainingQuantity});
+        pushEngineReport({EventKind::EXECUTED, RejectCode::INVALID_ORDER, e.restingOrderID, e.price, e.quantity, e.restingRemainingQuantity});
+        publishTopOfBook(e.price);
+    });
+    subscriptions.add<OrderAcceptedEvent>(dispatcher, [this](const OrderAcceptedEvent&) {
+        publishTopOfBook(lastTop.lastPrice);
+    });
+    subscriptions.add<OrderCancelledEvent>(dispatcher, [this](const OrderCancelledEvent& e) {
+        pushEngineReport({EventKind::CANCELLED, RejectCode::INVALID_ORDER, e.orderID, 0, e.quantity, e.remaining});
+        publishTopOfBook(lastTop.lastPrice);
+    });
+    subscriptions.add<MassCancelEvent>(dispatcher, [this](const MassCancelEvent& e) {
+        for (const OrderCancelledEvent& cancelled : e.cancelled) {
+            pushEngineReport({EventKind::CANCELLED, RejectCode::INVALID_ORDER, cancelled.orderID, 0, cancelled.quantity, 0});
+        }
+        publishTopOfBook(lastTop.lastPrice);
+        massCancelsSeen.fetch_add(1, std::memory_order_release);
+    });
+    subscriptions.add<OrderRejectedEvent>(dispatcher, [this](const OrderRejectedEvent& e) {
+        pushEngineReport({EventKind::REJECTED, static_cast<RejectCode>(e.reason), e.orderID, 0, 0, 0});
+    });
+}
+
+ShmServer::~ShmServer() {
+    subscriptions.clear();
+    stop();
+}
+
+void ShmServer::start() {
+    shm_unlink(config.name.c_str());
+    shmFd = shm_open(config.name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (shmFd < 0) throw std::system_error(errno, std::generic_category(), "shm_open");
+    if (ftruncate(shmFd, sizeof(ShmRegion)) < 0) throw std::system_error(errno, std::generic_category(), "ftruncate");
+    void* mapping = mmap(nullptr, sizeof(ShmRegion), PROT_READ | PROT_WRITE, MAP_SHARED, shmFd, 0);
+    if (mapping == MAP_FAILED) throw std::system_error(errno, std::generic_category(), "mmap");
+
+    region = new (mapping) ShmRegion{};
+    region->serverRunning.store(1, std::memory_order_relaxed);
+    region->magic.store(ShmRegion::MAGIC, std::memory_order_release);
+    regionOpen.store(true);
+
+    lastLivenessCheck = std::chrono::steady_clock::now();
+    running = true;
+    pollThread = std::thread([this] { run(); });
+}
+
+void ShmServer::stop() {
+    if (!pollThread.joinable()) return;
+    running = false;
+    pollThread.join();
+
+    region->serverRunning.store(0, std::memory_order_release);
+    regionOpen.store(false);
+    while (engineInRegion.load() != 0) cpuRelax();
+    munmap(region, sizeof(ShmRegion));
+    close(shmFd);
+    shm_unlink(config.name.c_str());
+    region = nullptr;
+}
+
+void ShmServer::pushEngineReport(const EngineReport& report) {
+    // Never stall the matching thread, least of all once polling has stopped
+    if (!engineReports->tryPush(report)) dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ShmServer::publishTopOfBook(Price lastPrice) {
+    TopOfBook top;
+    if (auto bid = book.getBestBid()) {
+        top.bidPrice = bid->price;
+        top.bidQuantity = bid->quantity;
+    }
+    if (auto ask = book.getBestAsk()) {
+        top.askPrice = ask->price;
+        top.askQuantity = ask->quantity;
+    }
+    top.lastPrice = lastPrice;
+
+    if (top.bidPrice == lastTop.bidPrice && top.bidQuantity == lastTop.bidQuantity && top.askPrice == lastTop.askPrice &&
+        top.askQuantity == lastTop.askQuantity && top.lastPrice == lastTop.lastPrice) return;
+    lastTop = top;
+    engineInRegion.fetch_add(1);
+    if (regionOpen.load()) region->topOfBook.store(top);
+    engineInRegion.fetch_sub(1);
+}
+
+void ShmServer::run() {
+    if (config.pollCore >= 0) pinCurrentThread(config.pollCore);
+
+    while (running) {
+        bool idle = true;
+        for (std::uint32_t slot = 0; slot < ShmRegion::MAX_CLIENTS; ++slot) {
+            ShmClientSlot& shared = region->clients[slot];
+            const ShmSlotState state = shared.state.load(std::memory_order_acquire);
+
+            if (state == ShmSlotState::CLOSING) {
+                releaseClient(slot);
+                continue;
+            }
+            if (state != ShmSlotState::ACTIVE) continue;
+
+            ClientState& client = clients[slot];
+            if (!client.active) {
+                client.active = true;
+                client.traderID = shared.traderID;
+            }
+
+            // Bounded so one busy client cannot starve the rest
+            ShmCommand command;
+            for (int i = 0; i < 64 && shared.requests.tryPop(command); ++i) {
+                handleCommand(slot, command);
+                idle = false;
+            }
+        }
+        if (drainEngineReports()) idle = false;
+
+        if (idle) {
+            checkLiveness();
+            if (config.busyPoll) cpuRelax();
+            else std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+    cancelAttachedClients();
+}
+
+// Runs once stop() is called, on the polling thread so the cancels are
+// still routed to the clients.
+void ShmServer::cancelAttachedClients() {
+    constexpr auto TIMEOUT = std::chrono::seconds(1);
+    std::uint64_t expected = massCancelsSeen.load(std::memory_order_acquire);
+    for (std::uint32_t slot = 0; slot < ShmRegion::MAX_CLIENTS; ++slot) {
+        if (!clients[slot].active || clients[slot].traderID == 0) continue;
+        engine.massCancel(clients[slot].traderID);
+        expected++;
+    }
+    // A stopped engine only runs them once it is started again
+    const auto deadline = std::chrono::steady_clock::now() + TIMEOUT;
+    while (engine.isRunning() && massCancelsSeen.load(std::memory_order_acquire) < expected && std::chrono::steady_clock::now() < deadline) {
+        if (!drainEngineReports()) std::this_thread::yield();
+    }
+    drainEngineReports();
+}
+
+void ShmServer::handleCommand(std::uint32_t slot, const ShmCommand& command) {
+    ClientState& client = clients[slot];
+    ShmReport report{};
+    report.token = command.token;
+
+    if (command.type == ShmCommandType::CANCEL) {
+        auto it = client.tokens.find(command.token);
+        if (it == client.tokens.end()) {
+            report.type = ShmReportType::REJECTED;
+            report.reason = RejectCode::UNKNOWN_TOKEN;
+            sendReport(slot, report);
+            return;
+        }
+        // Acked with CANCELLED when the engine removes it
+        engine.cancelOrder(it->second);
+        return;
+    }
+
+    const bool isLimit = command.orderType == static_cast<std::uint8_t>(OrderType::LIMIT);
+    if (command.quantity == 0 || command.side > 1 || command.orderType > 1 || (isLimit && command.price == 0)) {
+        report.type = ShmReportType::REJECTED;
+        report.reason = RejectCode::INVALID_ORDER;
+        sendReport(slot, report);
+        return;
+    }
+    if (client.tokens.count(command.token)) {
+        report.type = ShmReportType::REJECTED;
+        report.reason = RejectCode::DUPLICATE_TOKEN;
+        sendReport(slot, report);
+        return;
+    }
+
+    const Side side = static_cast<Side>(command.side);
+    str symbol(command.symbol, strnlen(command.symbol, sizeof(command.symbol)));
+    std::unique_ptr<Order> order;
+    if (isLimit) order = std::make_unique<LimitOrder>(std::move(symbol), 0, OrderType::LIMIT, side, command.price, command.quantity, client.traderID);
+    else order = std::make_unique<MarketOrder>(std::move(symbol), 0, OrderType::MARKET, side, command.quantity, client.traderID);
+
+    // Engine events for the order are only drained on this thread, after the route exists
+    const OrderID orderID = engine.submitOrder(std::move(order));
+    routes.emplace(orderID, Route{slot, client.generation, command.token});
+    client.tokens.emplace(command.token, orderID);
+
+    report.type = ShmReportType::ACCEPTED;
+    report.orderID = orderID;
+    report.price = command.price;
+    report.quantity = command.quantity;
+    report.remaining = command.quantity;
+    sendReport(slot, report);
+}
+
+bool ShmServer::drainEngineReports() {
+    bool any = false;
+    EngineReport event;
+    while (engineReports->tryPop(event)) {
+        any = true;
+        auto route = routes.find(event.orderID);
+        if (route == routes.end()) continue;
+
+        const bool terminal = event.kind == EventKind::REJECTED || event.remaining == 0;
+        const Route target = route->second;
+        if (terminal) routes.erase(route);
+
+        ClientState& client = clients[target.slot];
+        if (!client.active || client.generation != target.generation) continue;
+        if (terminal) client.tokens.erase(target.token);
+
+        ShmReport report{};
+        report.token = target.token;
+        report.orderID = event.orderID;
+        report.price = event.price;
+        report.quantity = event.quantity;
+        report.remaining = event.remaining;
+        report.reason = event.reason;
+        switch (event.kind) {
+            case EventKind::EXECUTED: report.type = ShmReportType::EXECUTED; break;
+            case EventKind::CANCELLED: report.type = ShmReportType::CANCELLED; break;
+            case EventKind::REJECTED: report.type = ShmReportType::REJECTED; break;
+        }
+        sendReport(target.slot, report);
+    }
+    return any;
+}
+
+void ShmServer::sendReport(std::uint32_t slot, const ShmReport& report) {
+    if (region->clients[slot].reports.tryPush(report)) return;
+
+    // The client stopped draining reports. Cancel its orders and stop serving
+    // it; the slot is freed once the client closes or its process exits.
+    ClientState& client = clients[slot];
+    if (client.traderID != 0) engine.massCancel(client.traderID);
+    client.active = false;
+    client.generation++;
+    client.tokens.clear();
+    region->clients[slot].state.store(ShmSlotState::EVICTED, std::memory_order_release);
+}
+
+void ShmServer::releaseClient(std::uint32_t slot) {
+    ClientState& client = clients[slot];
+    if (client.active && client.traderID != 0) engine.massCancel(client.traderID);
+    client.active = false;
+    client.generation++;
+    client.traderID = 0;
+    client.tokens.clear();
+
+    ShmClientSlot& shared = region->clients[slot];
+    shared.requests.reset();
+    shared.reports.reset();
+    shared.traderID = 0;
+    shared.pid = 0;
+    shared.state.store(ShmSlotState::FREE, std::memory_order_release);
+}
+
+void ShmServer::checkLiveness() {
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastLivenessCheck < std::chrono::milliseconds(100)) return;
+    lastLivenessCheck = now;
+
+    for (std::uint32_t slot = 0; slot < ShmRegion::MAX_CLIENTS; ++slot) {
+        ShmClientSlot& shared = region->clients[slot];
+        const ShmSlotState state = shared.state.load(std::memory_order_acquire);
+        if ((state == ShmSlotState::ACTIVE || state == ShmSlotState::EVICTED) && shared.pid > 0 &&
+            kill(shared.pid, 0) < 0 && errno == ESRCH) {
+            releaseClient(slot);
+        }
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include "shmChannel.h"
+#include "matchingEngine.h"
+#include "orderBook.h"
+#include "eventDispatcher.h"
+#include "events.h"
+
+struct ShmServerConfig {
+    str name = "/trading_engine";    // shm_open name
+    bool busyPoll = true;            // spin on the request rings; otherwise nap briefly when idle
+    int pollCore = -1;               // core to pin the polling thread to, -1 to leave it
+};
+
+// Serves strategy processes over a shared-memory region (see shmChannel.h).
+// A polling thread takes commands off every client's request ring, submits
+// them to the engine and writes acks; execution reports come back from the
+// engine thread through an in-process ring so each client ring keeps a
+// single producer. The engine thread also publishes top of book through a
+// seqlock every client can read.
+//
+// A client that exits without closing is detected by pid and its orders are
+// cancelled. So are those of every client still attached when the server
+// stops, and the cancels are routed back to them before stop() returns:
+// stop the server before the engine. Reports the engine produces faster
+// than the polling thread routes them are dropped and counted rather than
+// stalling the engine.
+class ShmServer {
+    private:
+        enum class EventKind : std::uint8_t { EXECUTED, CANCELLED, REJECTED };
+
+        struct EngineReport {
+            EventKind kind;
+            RejectCode reason;
+            OrderID orderID;
+            Price price;
+            Quantity quantity;
+            Quantity remaining;
+        };
+
+        struct ClientState {
+            bool active = false;
+            std::uint32_t generation = 0;
+            TraderID traderID = 0;
+            std::unordered_map<std::uint64_t, OrderID> tokens;
+        };
+
+        struct Route {
+            std::uint32_t slot;
+            std::uint32_t generation;
+            std::uint64_t token;
+        };
+
+        MatchingEngine& engine;
+        OrderBook& book;
+        ShmServerConfig config;
+        int shmFd = -1;
+        ShmRegion* region = nullptr;
+
+        std::array<ClientState, ShmRegion::MAX_CLIENTS> clients;
+        std::unordered_map<OrderID, Route> routes;
+        std::unique_ptr<SpscRing<EngineReport, 65536>> engineReports;
+        TopOfBook lastTop;
+        std::chrono::steady_clock::time_point lastLivenessCheck;
+
+        std::atomic<bool> running{false};
+        std::thread pollThread;
+
+        // Lets stop() unmap the region once the engine thread is out of it
+        std::atomic<bool> regionOpen{false};
+        std::atomic<int> engineInRegion{0};
+        std::atomic<std::uint64_t> massCancelsSeen{0};
+        std::atomic<std::uint64_t> dropped{0};
+        Subscriptions subscriptions;
+
+        // Engine thread
+        void pushEngineReport(const EngineReport& report);
+        void publishTopOfBook(Price lastPrice);
+
+        // Polling thread
+        void run();
+        void handleCommand(std::uint32_t slot, const ShmCommand& command);
+        bool drainEngineReports();
+        void sendReport(std::uint32_t slot, const ShmReport& report);
+        void releaseClient(std::uint32_t slot);
+        void checkLiveness();
+        void cancelAttachedClients();
+
+    public:
+        ShmServer(MatchingEngine& engine, EventDispatcher& dispatcher, OrderBook& book, const ShmServerConfig& config = ShmServerConfig{});
+        ~ShmServer();
+        ShmServer(const ShmServer&) = delete;
+        ShmServer& operator=(const ShmServer&) = delete;
+
+        // Creates the region (replacing a stale one of the same name) and starts polling.
+        void start();
+        // Cancels attached clients' orders, waits for the acks, then unmaps.
+        void stop();
+
+        std::uint64_t droppedReports() const { return dropped.load(std::memory_order_relaxed); }
+};
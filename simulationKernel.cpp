@@ -0,0 +1,199 @@
+#include "simulationKernel.h"
+#include <algorithm>
+#include <stdexcept>
+
+SimulationKernel::SimulationKernel(MatchingEngine& engine, EventDispatcher& dispatcher, std::uint64_t seed, Timestamp origin)
+    : engine(engine), rng(seed), origin(origin) {
+    // The engine runs on this thread inside dispatch(), so these fire at the
+    // simulated time of the command that raised them
+    subscriptions.add<TradeExecutedEvent>(dispatcher, [this](const TradeExecutedEvent& e) {
+        if (e.aggressingRemainingQuantity == 0) owners.erase(e.aggressingOrderID);
+        if (e.restingRemainingQuantity == 0) owners.erase(e.restingOrderID);
+        report(e.aggressingTraderID, e);
+        if (e.restingTraderID != e.aggressingTraderID) report(e.restingTraderID, e);
+        broadcast(e);
+    });
+    subscriptions.add<OrderAcceptedEvent>(dispatcher, [this](const OrderAcceptedEvent& e) {
+        if (auto it = owners.find(e.orderID); it != owners.end()) report(it->second, e);
+        broadcast(e);
+    });
+    subscriptions.add<OrderCancelledEvent>(dispatcher, [this](const OrderCancelledEvent& e) {
+        if (auto it = owners.find(e.orderID); it != owners.end()) {
+            report(it->second, e);
+            if (e.remaining == 0) owners.erase(it);
+        }
+        broadcast(e);
+    });
+    subscriptions.add<MassCancelEvent>(dispatcher, [this](const MassCancelEvent& e) {
+        for (const OrderCancelledEvent& cancelled : e.cancelled) {
+            if (auto it = owners.find(cancelled.orderID); it != owners.end()) {
+                report(it->second, cancelled);
+                owners.erase(it);
+            }
+        }
+        broadcast(e);
+    });
+    subscriptions.add<OrderRejectedEvent>(dispatcher, [this](const OrderRejectedEvent& e) {
+        owners.erase(e.orderID);
+        report(e.traderID, e);
+    });
+    subscriptions.add<AuctionUncrossEvent>(dispatcher, [this](const AuctionUncrossEvent& e) {
+        broadcast(e);
+    });
+}
+
+void SimulationKernel::addAgent(TraderID traderID, SimulationAgent& agent, const TraderLatency& latency, bool marketData) {
+    if (!participants.emplace(traderID, Participant{&agent, latency}).second) {
+        throw std::invalid_argument("Trader " + std::to_string(traderID) + " already has an agent");
+    }
+    traderIDs.insert(std::upper_bound(traderIDs.begin(), traderIDs.end(), traderID), traderID);
+    if (marketData) {
+        auto at = std::lower_bound(subscribers.begin(), subscribers.end(), traderID,
+                                   [](const Subscriber& entry, TraderID id) { return entry.traderID < id; });
+        subscribers.insert(at, Subscriber{traderID, latency.marketData});
+    }
+}
+
+SimulationKernel::Participant* SimulationKernel::find(TraderID traderID) {
+    auto it = participants.find(traderID);
+    return it != participants.end() ? &it->second : nullptr;
+}
+
+// Jitter may not reorder what one trader sends: an arrival is never
+// earlier than that trader's previous one, and ties keep sending order.
+SimTime SimulationKernel::arrivalTime(TraderID traderID) {
+    Participant* participant = find(traderID);
+    if (!participant) return now;
+    const SimTime arrival = std::max(now + participant->latency.orderEntry.sample(rng), participant->lastArrival);
+    participant->lastArrival = arrival;
+    return arrival;
+}
+
+bool SimulationKernel::later(const Scheduled& a, const Scheduled& b) {
+    return a.time != b.time ? a.time > b.time : a.sequence > b.sequence;
+}
+
+void SimulationKernel::schedule(SimTime time, Action action) {
+    std::uint32_t slot;
+    if (freeSlots.empty()) {
+        slot = static_cast<std::uint32_t>(actions.size());
+        actions.push_back(std::move(action));
+    }
+    else {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+        actions[slot] = std::move(action);
+    }
+    queue.push_back(Scheduled{time, nextSequence++, slot});
+    std::push_heap(queue.begin(), queue.end(), later);
+}
+
+void SimulationKernel::report(TraderID traderID, const EngineEvent& event) {
+    if (Participant* participant = find(traderID)) {
+        schedule(now + participant->latency.ack.sample(rng), Delivery{traderID, false, event});
+    }
+}
+
+void SimulationKernel::broadcast(const EngineEvent& event) {
+    for (const Subscriber& subscriber : subscribers) {
+        schedule(now + subscriber.marketData.sample(rng), Delivery{subscriber.traderID, true, event});
+    }
+}
+
+OrderID SimulationKernel::submitOrder(std::unique_ptr<Order> order) {
+    const TraderID traderID = order->getTraderID();
+    const OrderID orderID = engine.reserveOrderID();
+    order->setOrderID(orderID);
+    owners[orderID] = traderID;
+    schedule(arrivalTime(traderID), OrderArrival{std::move(order)});
+    return orderID;
+}
+
+void SimulationKernel::cancelOrder(TraderID traderID, OrderID orderID) {
+    schedule(arrivalTime(traderID), CancelArrival{orderID});
+}
+
+void SimulationKernel::massCancel(TraderID traderID) {
+    schedule(arrivalTime(traderID), MassCancelArrival{traderID});
+}
+
+void SimulationKernel::setTimer(TraderID traderID, SimTime at, std::uint64_t timerID) {
+    schedule(std::max(at, now), Timer{traderID, timerID});
+}
+
+void SimulationKernel::dispatch(Action& scheduled) {
+    std::visit([this](auto& action) {
+        using T = std::decay_t<decltype(action)>;
+        // Queued ahead of the arrival, so expiries and event timestamps use simulated time
+        if constexpr (std::is_same_v<T, OrderArrival> || std::is_same_v<T, CancelArrival> || std::is_same_v<T, MassCancelArrival>) {
+            engine.setTime(timestampAt(now));
+        }
+        if constexpr (std::is_same_v<T, OrderArrival>) {
+            engine.submitReserved(std::move(action.order));
+            engine.runPending();
+        }
+        else if constexpr (std::is_same_v<T, CancelArrival>) {
+            engine.cancelOrder(action.orderID);
+            engine.runPending();
+        }
+        else if constexpr (std::is_same_v<T, MassCancelArrival>) {
+            engine.massCancel(action.traderID);
+            engine.runPending();
+        }
+        else if constexpr (std::is_same_v<T, Delivery>) {
+            if (Participant* participant = find(action.traderID)) {
+                currentRecipient = action.traderID;
+                if (action.marketData) participant->agent->onMarketData(*this, action.event);
+                else participant->agent->onExecutionReport(*this, action.event);
+            }
+        }
+        else {
+            if (Participant* participant = find(action.traderID)) {
+                currentRecipient = action.traderID;
+                participant->agent->onTimer(*this, action.timerID);
+            }
+        }
+    }, scheduled);
+}
+
+void SimulationKernel::begin() {
+    if (started) return;
+    // Agents added before the first step start at time zero, in trader order
+    started = true;
+    for (TraderID traderID : traderIDs) {
+        currentRecipient = traderID;
+        participants.at(traderID).agent->onStart(*this);
+    }
+}
+
+bool SimulationKernel::step() {
+    begin();
+    if (queue.empty()) return false;
+
+    std::pop_heap(queue.begin(), queue.end(), later);
+    const Scheduled item = queue.back();
+    queue.pop_back();
+    // Moved out first: the dispatch may schedule more and grow `actions`
+    Action action = std::move(actions[item.slot]);
+    freeSlots.push_back(item.slot);
+    now = item.time;
+    dispatch(action);
+    return true;
+}
+
+std::size_t SimulationKernel::runUntil(SimTime end) {
+    begin();
+    std::size_t processed = 0;
+    while (!queue.empty() && queue.front().time <= end) {
+        step();
+        processed++;
+    }
+    now = std::max(now, end);
+    return processed;
+}
+
+std::size_t SimulationKernel::run() {
+    std::size_t processed = 0;
+    while (step()) processed++;
+    return processed;
+}
@@ -0,0 +1,157 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+#include "matchingEngine.h"
+#include "eventDispatcher.h"
+#include "events.h"
+#include "order.h"
+
+using SimTime = std::int64_t;   // simulated nanoseconds
+
+// One leg between a trader and the engine: a fixed delay plus uniform jitter.
+struct LatencyModel {
+    SimTime base = 0;
+    SimTime jitter = 0;
+
+    SimTime sample(std::mt19937_64& rng) const {
+        if (jitter <= 0) return base;
+        return base + std::uniform_int_distribution<SimTime>(0, jitter)(rng);
+    }
+};
+
+struct TraderLatency {
+    LatencyModel orderEntry;    // trader -> engine
+    LatencyModel ack;           // engine -> trader, for its own orders
+    LatencyModel marketData;    // engine -> trader, public events
+};
+
+class SimulationKernel;
+
+// A trader inside the simulation. Callbacks run at the simulated time the
+// message reaches the trader; anything the agent sends from them is
+// delayed by its own latency before the engine sees it.
+class SimulationAgent {
+    public:
+        virtual ~SimulationAgent() = default;
+
+        virtual void onStart(SimulationKernel&) {}
+        // Events about the agent's own orders.
+        virtual void onExecutionReport(SimulationKernel&, const EngineEvent&) {}
+        // Every public event: trades, book changes and auction results.
+        virtual void onMarketData(SimulationKernel&, const EngineEvent&) {}
+        virtual void onTimer(SimulationKernel&, std::uint64_t) {}
+};
+
+// Discrete-event scheduler in simulated time. A heap of timestamped actions
+// (orders and cancels on their way to the engine, reports and market data on
+// their way back, agent timers) is drained in time order, ties broken by
+// scheduling order, and the engine is run synchronously on each arrival with
+// its clock set to the simulated time, so a run depends only on its inputs
+// and seed. The engine must not be started. A trader's orders and cancels
+// reach the engine in the order it sent them, whatever the jitter.
+//
+// Agents are not owned and must outlive the kernel.
+class SimulationKernel {
+    private:
+        struct OrderArrival {
+            std::unique_ptr<Order> order;
+        };
+        struct CancelArrival {
+            OrderID orderID;
+        };
+        struct MassCancelArrival {
+            TraderID traderID;
+        };
+        struct Delivery {
+            TraderID traderID;
+            bool marketData;
+            EngineEvent event;
+        };
+        struct Timer {
+            TraderID traderID;
+            std::uint64_t timerID;
+        };
+        using Action = std::variant<OrderArrival, CancelArrival, MassCancelArrival, Delivery, Timer>;
+
+        // Heap entries stay small; the actions they refer to sit in `actions`
+        struct Scheduled {
+            SimTime time;
+            std::uint64_t sequence;
+            std::uint32_t slot;
+        };
+
+        struct Participant {
+            SimulationAgent* agent;
+            TraderLatency latency;
+            SimTime lastArrival = 0;
+        };
+        struct Subscriber {
+            TraderID traderID;
+            LatencyModel marketData;
+        };
+
+        MatchingEngine& engine;
+        std::mt19937_64 rng;
+        std::vector<Scheduled> queue;     // min-heap on (time, sequence)
+        std::vector<Action> actions;
+        std::vector<std::uint32_t> freeSlots;
+        std::uint64_t nextSequence = 0;
+        SimTime now = 0;
+        Timestamp origin;
+        bool started = false;
+
+        std::unordered_map<TraderID, Participant> participants;
+        // Both ordered by trader id, so agents start and market data fans out in a fixed order
+        std::vector<TraderID> traderIDs;
+        std::vector<Subscriber> subscribers;
+        TraderID currentRecipient = 0;
+        std::unordered_map<OrderID, TraderID> owners;
+        Subscriptions subscriptions;
+
+        static bool later(const Scheduled& a, const Scheduled& b);
+        void begin();
+        void schedule(SimTime time, Action action);
+        Participant* find(TraderID traderID);
+        SimTime arrivalTime(TraderID traderID);
+        void report(TraderID traderID, const EngineEvent& event);
+        void broadcast(const EngineEvent& event);
+        void dispatch(Action& scheduled);
+
+    public:
+        // Simulated time zero is `origin` on the engine clock.
+        SimulationKernel(MatchingEngine& engine, EventDispatcher& dispatcher, std::uint64_t seed = 1, Timestamp origin = Timestamp{});
+        SimulationKernel(const SimulationKernel&) = delete;
+        SimulationKernel& operator=(const SimulationKernel&) = delete;
+
+        // Without `marketData` the agent only hears about its own orders, which
+        // keeps the fan-out of every public event off large agent populations.
+        // One agent object may be added under several trader ids.
+        void addAgent(TraderID traderID, SimulationAgent& agent, const TraderLatency& latency = {}, bool marketData = true);
+
+        // Sent now, reaching the engine after the trader's order-entry latency.
+        // The returned id is the one the engine will use for the order.
+        OrderID submitOrder(std::unique_ptr<Order> order);
+        void cancelOrder(TraderID traderID, OrderID orderID);
+        void massCancel(TraderID traderID);
+        void setTimer(TraderID traderID, SimTime at, std::uint64_t timerID);
+
+        // Processes the earliest pending action; false when nothing is left.
+        bool step();
+        // Processes every action due at or before `end` and leaves the clock there.
+        std::size_t runUntil(SimTime end);
+        std::size_t run();
+
+        SimTime currentTime() const { return now; }
+        // The engine clock at `time`, e.g. for GTD expiry times.
+        Timestamp timestampAt(SimTime time) const {
+            return origin + std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::nanoseconds(time));
+        }
+        // The trader whose callback is running, for agents added under several ids.
+        TraderID recipient() const { return currentRecipient; }
+        std::size_t pending() const { return queue.size(); }
+};
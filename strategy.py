@@ -1,6 +1,4 @@
 import trading_core
-from collections import deque
-import numpy as np
 
 class MovingAverageCrossoverStrategy:
     def __init__(self, engine, portfolio, symbol: str, short_window=10, long_window=30):
@@ -11,7 +9,9 @@ class MovingAverageCrossoverStrategy:
         self.short_window = short_window
         self.long_window = long_window
 
-        self.prices = deque(maxlen=long_window)
+        # Rolling means are maintained in C++ in constant time per bar
+        self.short_sma = trading_core.SimpleMovingAverage(short_window)
+        self.long_sma = trading_core.SimpleMovingAverage(long_window)
         self.short_ma = 0
         self.long_ma = 0
 
@@ -19,13 +19,10 @@ class MovingAverageCrossoverStrategy:
 
     def on_bar(self, bar):
         close_price = bar['close']
-        self.prices.append(close_price)
+        self.short_ma = self.short_sma.update(close_price)
+        self.long_ma = self.long_sma.update(close_price)
 
-        if len(self.prices) < self.long_window: return
-
-        price_array = np.array(self.prices)
-        self.short_ma = np.mean(price_array[-self.short_window:])
-        self.long_ma = np.mean(price_array)
+        if not self.long_sma.ready: return
 
         print(f"STRATEGY: Short MA: {self.short_ma:.2f}, Long MA: {self.long_ma:.2f}")
 
@@ -0,0 +1,163 @@
+#include "strategyHost.h"
+#include <cstdlib>
+#include <filesystem>
+#include <stdexcept>
+#include <dlfcn.h>
+#include "limitOrder.h"
+#include "marketOrder.h"
+
+StrategyHost::Hosted::~Hosted() {
+    // The strategy's code lives in the library, so it goes first
+    destroy(strategy);
+}
+
+OrderID StrategyHost::Hosted::submitLimit(const str& symbol, Side side, Price price, Quantity quantity) {
+    return engine.submitOrder(std::make_unique<LimitOrder>(symbol, 0, OrderType::LIMIT, side, price, quantity, trader));
+}
+
+OrderID StrategyHost::Hosted::submitMarket(const str& symbol, Side side, Quantity quantity) {
+    return engine.submitOrder(std::make_unique<MarketOrder>(symbol, 0, OrderType::MARKET, side, quantity, trader));
+}
+
+void StrategyHost::Hosted::cancel(OrderID orderID) {
+    engine.cancelOrder(orderID);
+}
+
+void StrategyHost::Hosted::cancelAll() {
+    engine.massCancel(trader);
+}
+
+std::int64_t StrategyHost::Hosted::position(const str& symbol) const {
+    auto it = positions.find(symbol);
+    return it == positions.end() ? 0 : it->second;
+}
+
+StrategyHost::StrategyHost(MatchingEngine& engine, EventDispatcher& dispatcher, OrderBook& book, std::vector<str> searchPaths)
+    : engine(engine), book(book), searchPaths(std::move(searchPaths)) {
+    subscriptions.add<TradeExecutedEvent>(dispatcher, [this](const TradeExecutedEvent& e) {
+        std::lock_guard<std::mutex> lock(callbackMutex);
+        if (stopped) return;
+        onTrade(e);
+        publishBookUpdate(e.price);
+    });
+    subscriptions.add<OrderAcceptedEvent>(dispatcher, [this](const OrderAcceptedEvent&) {
+        std::lock_guard<std::mutex> lock(callbackMutex);
+        if (!stopped) publishBookUpdate(lastTop.lastPrice);
+    });
+    subscriptions.add<OrderCancelledEvent>(dispatcher, [this](const OrderCancelledEvent&) {
+        std::lock_guard<std::mutex> lock(callbackMutex);
+        if (!stopped) publishBookUpdate(lastTop.lastPrice);
+    });
+    subscriptions.add<MassCancelEvent>(dispatcher, [this](const MassCancelEvent&) {
+        std::lock_guard<std::mutex> lock(callbackMutex);
+        if (!stopped) publishBookUpdate(lastTop.lastPrice);
+    });
+}
+
+StrategyHost::~StrategyHost() {
+    subscriptions.clear();
+    stop();
+}
+
+str StrategyHost::resolve(const str& name) const {
+    if (name.find('/') != str::npos) return name;
+
+    std::vector<str> directories = searchPaths;
+    if (const char* env = std::getenv("TRADING_STRATEGY_PATH")) {
+        str paths = env;
+        std::size_t start = 0;
+        while (start <= paths.size()) {
+            std::size_t end = paths.find(':', start);
+            if (end == str::npos) end = paths.size();
+            if (end > start) directories.push_back(paths.substr(start, end - start));
+            start = end + 1;
+        }
+    }
+
+    for (const str& directory : directories) {
+        for (const str& file : {"lib" + name + ".so", name + ".so"}) {
+            std::filesystem::path candidate = std::filesystem::path(directory) / file;
+            if (std::filesystem::is_regular_file(candidate)) return candidate.string();
+        }
+    }
+    throw std::runtime_error("Strategy library not found: " + name);
+}
+
+void StrategyHost::load(const str& name, TraderID traderID, const str& params) {
+    const str path = resolve(name);
+    void* handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) throw std::runtime_error("Cannot load strategy " + path + ": " + dlerror());
+    std::shared_ptr<void> library(handle, dlclose);
+
+    auto version = reinterpret_cast<StrategyAbiVersionFn>(dlsym(handle, "tradingStrategyAbiVersion"));
+    auto create = reinterpret_cast<StrategyCreateFn>(dlsym(handle, "tradingCreateStrategy"));
+    auto destroy = reinterpret_cast<StrategyDestroyFn>(dlsym(handle, "tradingDestroyStrategy"));
+    if (!version || !create || !destroy) throw std::runtime_error(path + " does not export a strategy");
+    if (version() != TRADING_STRATEGY_ABI_VERSION) {
+        throw std::runtime_error(path + " was built for strategy ABI " + std::to_string(version()) +
+                                 ", host is " + std::to_string(TRADING_STRATEGY_ABI_VERSION));
+    }
+
+    Strategy* strategy = create(params.c_str());
+    if (!strategy) throw std::runtime_error(path + " failed to create its strategy");
+    attach(std::move(library), strategy, destroy, traderID);
+}
+
+void StrategyHost::add(std::unique_ptr<Strategy> strategy, TraderID traderID) {
+    if (!strategy) throw std::invalid_argument("Strategy must not be null");
+    attach(nullptr, strategy.release(), [](Strategy* s) { delete s; }, traderID);
+}
+
+void StrategyHost::attach(std::shared_ptr<void> library, Strategy* strategy, StrategyDestroyFn destroy, TraderID traderID) {
+    auto hosted = std::make_unique<Hosted>(engine, book, traderID, std::move(library), strategy, destroy);
+    std::lock_guard<std::mutex> lock(callbackMutex);
+    if (stopped) throw std::logic_error("Strategy host is stopped");
+    if (traderID == 0 || byTrader.count(traderID)) {
+        throw std::invalid_argument("Trader id " + std::to_string(traderID) + " is reserved or already hosts a strategy");
+    }
+    Hosted* raw = hosted.get();
+    strategies.push_back(std::move(hosted));
+    byTrader.emplace(traderID, raw);
+    raw->strategy->onStart(*raw);
+}
+
+void StrategyHost::publishBar(const Bar& bar) {
+    std::lock_guard<std::mutex> lock(callbackMutex);
+    if (stopped) return;
+    for (auto& hosted : strategies) hosted->strategy->onBar(bar);
+}
+
+void StrategyHost::stop() {
+    std::lock_guard<std::mutex> lock(callbackMutex);
+    if (stopped) return;
+    stopped = true;
+    for (auto& hosted : strategies) hosted->strategy->onStop();
+}
+
+void StrategyHost::onTrade(const TradeExecutedEvent& e) {
+    const Tick tick{e.symbol, e.price, e.quantity, e.aggressingSide, e.timestamp};
+    for (auto& hosted : strategies) hosted->strategy->onTick(tick);
+
+    auto fill = [&](TraderID traderID, OrderID orderID, Side side, Quantity remaining) {
+        auto it = byTrader.find(traderID);
+        if (it == byTrader.end()) return;
+        Hosted& hosted = *it->second;
+        hosted.positions[e.symbol] += side == Side::BUY ? static_cast<std::int64_t>(e.quantity) : -static_cast<std::int64_t>(e.quantity);
+        hosted.strategy->onFill(Fill{orderID, e.symbol, side, e.price, e.quantity, remaining, e.timestamp});
+    };
+    fill(e.aggressingTraderID, e.aggressingOrderID, e.aggressingSide, e.aggressingRemainingQuantity);
+    fill(e.restingTraderID, e.restingOrderID, getOppositeSide(e.aggressingSide), e.restingRemainingQuantity);
+}
+
+void StrategyHost::publishBookUpdate(Price lastPrice) {
+    BookUpdate update;
+    update.analytics = book.getAnalytics();
+    if (update.analytics.version == lastTop.analytics.version && lastPrice == lastTop.lastPrice) return;
+    update.bidPrice = update.analytics.bidPrice;
+    update.bidQuantity = update.analytics.bidQuantity;
+    update.askPrice = update.analytics.askPrice;
+    update.askQuantity = update.analytics.askQuantity;
+    update.lastPrice = lastPrice;
+    lastTop = update;
+    for (auto& hosted : strategies) hosted->strategy->onBookUpdate(update);
+}
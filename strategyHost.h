@@ -0,0 +1,80 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "strategyPlugin.h"
+#include "matchingEngine.h"
+#include "orderBook.h"
+#include "eventDispatcher.h"
+#include "events.h"
+
+// Runs C++ strategies against an in-process engine. Strategies come from
+// shared libraries loaded by name (`load`) or are handed over directly
+// (`add`); each trades under its own trader id and is fed fills, trades and
+// top-of-book changes from the engine thread, and bars from `publishBar`.
+// One mutex serialises every callback, so strategies need no locking of
+// their own.
+//
+// `load("ma_crossover")` looks for libma_crossover.so, then ma_crossover.so,
+// in each search path and then in the directories listed in the
+// TRADING_STRATEGY_PATH environment variable. A name containing '/' is
+// opened as a path.
+class StrategyHost {
+    private:
+        class Hosted : public StrategyContext {
+            public:
+                MatchingEngine& engine;
+                const OrderBook& book;
+                TraderID trader;
+                std::shared_ptr<void> library;
+                Strategy* strategy;
+                StrategyDestroyFn destroy;
+                std::unordered_map<str, std::int64_t> positions;
+
+                Hosted(MatchingEngine& engine, const OrderBook& book, TraderID trader, std::shared_ptr<void> library, Strategy* strategy,
+                       StrategyDestroyFn destroy)
+                    : engine(engine), book(book), trader(trader), library(std::move(library)), strategy(strategy), destroy(destroy) {}
+                ~Hosted() override;
+
+                OrderID submitLimit(const str& symbol, Side side, Price price, Quantity quantity) override;
+                OrderID submitMarket(const str& symbol, Side side, Quantity quantity) override;
+                void cancel(OrderID orderID) override;
+                void cancelAll() override;
+                TraderID traderID() const override { return trader; }
+                std::int64_t position(const str& symbol) const override;
+                BookAnalytics bookAnalytics() const override { return book.getAnalytics(); }
+        };
+
+        MatchingEngine& engine;
+        OrderBook& book;
+        std::vector<str> searchPaths;
+        std::mutex callbackMutex;
+        std::vector<std::unique_ptr<Hosted>> strategies;
+        std::unordered_map<TraderID, Hosted*> byTrader;
+        BookUpdate lastTop;
+        bool stopped = false;
+        Subscriptions subscriptions;
+
+        void attach(std::shared_ptr<void> library, Strategy* strategy, StrategyDestroyFn destroy, TraderID traderID);
+        void onTrade(const TradeExecutedEvent& e);
+        void publishBookUpdate(Price lastPrice);
+
+    public:
+        StrategyHost(MatchingEngine& engine, EventDispatcher& dispatcher, OrderBook& book, std::vector<str> searchPaths = {});
+        ~StrategyHost();
+        StrategyHost(const StrategyHost&) = delete;
+        StrategyHost& operator=(const StrategyHost&) = delete;
+
+        // Throws std::runtime_error if the library cannot be found or opened, lacks
+        // the factory symbols or was built against another ABI version.
+        void load(const str& name, TraderID traderID, const str& params = "");
+        void add(std::unique_ptr<Strategy> strategy, TraderID traderID);
+
+        void publishBar(const Bar& bar);
+        // Calls onStop on every strategy and stops delivering events; idempotent.
+        void stop();
+
+        std::size_t size() const { return strategies.size(); }
+        str resolve(const str& name) const;
+};
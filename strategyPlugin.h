@@ -0,0 +1,122 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include "order.h"
+#include "types.h"
+#include "bookAnalytics.h"
+
+// Interface for strategies compiled into shared libraries and loaded by
+// StrategyHost (see strategyHost.h). A plugin includes only this header,
+// implements Strategy and exports it with TRADING_EXPORT_STRATEGY. Plugins
+// must be built with the same compiler and standard library as the host.
+//
+// The host never runs two callbacks of one strategy at the same time, but
+// they may arrive on different threads: bars on the thread that publishes
+// them, everything else on the engine thread.
+
+#define TRADING_STRATEGY_ABI_VERSION 2
+
+struct Bar {
+    str symbol;
+    Timestamp timestamp;
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+    double volume = 0.0;
+};
+
+// Any trade on the book, whoever traded.
+struct Tick {
+    str symbol;
+    Price price;
+    Quantity quantity;
+    Side aggressorSide;
+    Timestamp timestamp;
+};
+
+// A trade on one of the strategy's own orders.
+struct Fill {
+    OrderID orderID;
+    str symbol;
+    Side side;
+    Price price;
+    Quantity quantity;
+    Quantity remaining;
+    Timestamp timestamp;
+};
+
+// The book after it changed; empty sides are 0.
+struct BookUpdate {
+    Price bidPrice = 0;
+    Quantity bidQuantity = 0;
+    Price askPrice = 0;
+    Quantity askQuantity = 0;
+    Price lastPrice = 0;
+    BookAnalytics analytics;    // queue lengths, depth, imbalance, microprice
+};
+
+// Order entry for a loaded strategy. Calls go straight into the engine's
+// ingress queue under the strategy's trader id and return immediately.
+class StrategyContext {
+    public:
+        virtual ~StrategyContext() = default;
+
+        virtual OrderID submitLimit(const str& symbol, Side side, Price price, Quantity quantity) = 0;
+        virtual OrderID submitMarket(const str& symbol, Side side, Quantity quantity) = 0;
+        virtual void cancel(OrderID orderID) = 0;
+        virtual void cancelAll() = 0;
+
+        virtual TraderID traderID() const = 0;
+        // Net filled quantity, long positive.
+        virtual std::int64_t position(const str& symbol) const = 0;
+        // Latest book analytics; lock-free, cheap enough to call on every bar.
+        virtual BookAnalytics bookAnalytics() const = 0;
+};
+
+class Strategy {
+    public:
+        virtual ~Strategy() = default;
+
+        // The context outlives the strategy.
+        virtual void onStart(StrategyContext&) {}
+        virtual void onBar(const Bar&) {}
+        virtual void onTick(const Tick&) {}
+        virtual void onFill(const Fill&) {}
+        virtual void onBookUpdate(const BookUpdate&) {}
+        virtual void onStop() {}
+};
+
+// Parses "key=value,key=value" parameter strings handed to plugin factories.
+inline std::unordered_map<str, str> parseStrategyParams(const str& params) {
+    std::unordered_map<str, str> parsed;
+    std::size_t start = 0;
+    while (start < params.size()) {
+        std::size_t end = params.find(',', start);
+        if (end == str::npos) end = params.size();
+        str entry = params.substr(start, end - start);
+        std::size_t equals = entry.find('=');
+        if (equals == str::npos) throw std::invalid_argument("Strategy parameter without a value: " + entry);
+        parsed[entry.substr(0, equals)] = entry.substr(equals + 1);
+        start = end + 1;
+    }
+    return parsed;
+}
+
+using StrategyAbiVersionFn = int (*)();
+using StrategyCreateFn = Strategy* (*)(const char* params);
+using StrategyDestroyFn = void (*)(Strategy*);
+
+// Exports the factory symbols StrategyHost looks up. `Type` needs a
+// constructor taking the parameter string.
+#define TRADING_EXPORT_STRATEGY(Type)                                                                   \
+    extern "C" __attribute__((visibility("default"))) int tradingStrategyAbiVersion() {                 \
+        return TRADING_STRATEGY_ABI_VERSION;                                                            \
+    }                                                                                                   \
+    extern "C" __attribute__((visibility("default"))) Strategy* tradingCreateStrategy(const char* params) { \
+        return new Type(params ? str(params) : str());                                                  \
+    }                                                                                                   \
+    extern "C" __attribute__((visibility("default"))) void tradingDestroyStrategy(Strategy* strategy) { \
+        delete strategy;                                                                                \
+    }
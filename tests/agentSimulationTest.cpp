@@ -0,0 +1,150 @@
+#include "gtest/gtest.h"
+#include "agentSimulation.h"
+#include "orderBook.h"
+#include "eventDispatcher.h"
+#include <numeric>
+
+namespace {
+    AgentTask sleeper(AgentContext context, std::vector<SimTime>& wakes) {
+        for (SimTime delay : {100, 250, 0, 1000}) {
+            co_await context.sleep(delay);
+            wakes.push_back(context.now());
+        }
+    }
+
+    AgentTask resting(AgentContext context, Side side, Price price, Quantity quantity) {
+        context.placeLimit(side, price, quantity);
+        co_return;
+    }
+
+    AgentTask buyer(AgentContext context, SimTime at, Quantity quantity) {
+        co_await context.sleep(at);
+        context.placeMarket(Side::BUY, quantity);
+    }
+
+    // Sells once and waits up to a second for the fill
+    AgentTask patientSeller(AgentContext context, std::vector<SimTime>& wakes) {
+        context.placeLimit(Side::SELL, 10001, 10);
+        co_await context.sleepUntilFill(1'000'000'000);
+        wakes.push_back(context.now());
+        co_await context.sleep(5'000'000'000);
+        wakes.push_back(context.now());
+    }
+
+    AgentTask failing(AgentContext context) {
+        co_await context.sleep(10);
+        throw std::runtime_error("agent failed");
+    }
+
+    TraderLatency latency(SimTime entry, SimTime ack) {
+        return {{entry, 0}, {ack, 0}, {0, 0}};
+    }
+}
+
+class AgentSimulationTest : public ::testing::Test {
+protected:
+    OrderBook book;
+    EventDispatcher dispatcher;
+    MatchingEngine engine{book, dispatcher};
+    SimulationKernel kernel{engine, dispatcher};
+};
+
+TEST_F(AgentSimulationTest, AgentsWakeAtTheSimulatedTimesTheyAwait) {
+    AgentPopulation population(kernel, dispatcher, book);
+    std::vector<SimTime> wakes;
+    population.add(AgentKind::CUSTOM, [&wakes](AgentContext context) { return sleeper(context, wakes); });
+
+    kernel.run();
+    EXPECT_EQ(wakes, (std::vector<SimTime>{100, 350, 350, 1350}));
+    EXPECT_TRUE(population.finished(0));
+}
+
+TEST_F(AgentSimulationTest, FillsUpdateTheAgentsColumnsAfterTheAckLatency) {
+    AgentPopulationConfig config;
+    config.latency = latency(10, 40);
+    AgentPopulation population(kernel, dispatcher, book, config);
+    population.add(AgentKind::CUSTOM, [](AgentContext context) { return resting(context, Side::SELL, 10002, 30); });
+    population.add(AgentKind::CUSTOM, [](AgentContext context) { return buyer(context, 100, 20); });
+
+    kernel.runUntil(149);
+    EXPECT_EQ(population.trades(), 1u);
+    EXPECT_EQ(population.position(1), 0);      // trade at 110, ack due at 150
+    kernel.run();
+
+    EXPECT_EQ(population.position(0), -20);
+    EXPECT_EQ(population.cash(0), 20 * 10002);
+    EXPECT_EQ(population.position(1), 20);
+    EXPECT_EQ(population.cash(1), -20 * 10002);
+    EXPECT_EQ(population.fills(0), 1u);
+    EXPECT_EQ(population.markToMarket(0), 0);
+    EXPECT_EQ(population.traderID(1), config.firstTraderID + 1);
+    EXPECT_EQ(population.market().askPrice, 10002u);
+    EXPECT_EQ(population.market().askQuantity, 10u);
+}
+
+TEST_F(AgentSimulationTest, AFillCutsAWaitShortAndItsTimerIsDropped) {
+    AgentPopulation population(kernel, dispatcher, book);
+    std::vector<SimTime> wakes;
+    population.add(AgentKind::CUSTOM, [&wakes](AgentContext context) { return patientSeller(context, wakes); });
+    population.add(AgentKind::CUSTOM, [](AgentContext context) { return buyer(context, 500, 10); });
+
+    kernel.run();
+    EXPECT_EQ(wakes, (std::vector<SimTime>{500, 5'000'000'500}));
+}
+
+TEST_F(AgentSimulationTest, MarketViewLagsTheBookByTheFeedLatency) {
+    AgentPopulationConfig config;
+    config.feedLatency = 1000;
+    AgentPopulation population(kernel, dispatcher, book, config);
+    population.add(AgentKind::CUSTOM, [](AgentContext context) { return resting(context, Side::BUY, 9999, 5); });
+
+    kernel.runUntil(999);
+    EXPECT_EQ(population.market().bidPrice, 0u);
+    kernel.runUntil(1000);
+    EXPECT_EQ(population.market().bidPrice, 9999u);
+    EXPECT_EQ(population.market().mid(), 9999u);
+}
+
+TEST_F(AgentSimulationTest, AgentExceptionsEscapeTheRun) {
+    AgentPopulation population(kernel, dispatcher, book);
+    population.add(AgentKind::CUSTOM, failing);
+    EXPECT_THROW(kernel.run(), std::runtime_error);
+    EXPECT_TRUE(population.finished(0));
+}
+
+TEST_F(AgentSimulationTest, MixedPopulationTradesAndConservesPositionAndCash) {
+    auto simulate = [](std::uint64_t seed) {
+        OrderBook book;
+        EventDispatcher dispatcher;
+        MatchingEngine engine(book, dispatcher);
+        SimulationKernel kernel(engine, dispatcher, seed);
+        AgentPopulationConfig config;
+        config.latency = {{2'000, 1'000}, {2'000, 1'000}, {0, 0}};
+        config.feedLatency = 1'000;
+        config.seed = seed;
+        AgentPopulation population(kernel, dispatcher, book, config);
+        population.addMarketMakers(10);
+        population.addNoiseTraders(300);
+        population.addMomentumTraders(20);
+        kernel.runUntil(2'000'000'000);
+        population.stop();
+        kernel.run();
+
+        std::vector<std::int64_t> positions;
+        std::int64_t cash = 0;
+        for (std::size_t i = 0; i < population.size(); ++i) {
+            positions.push_back(population.position(i));
+            cash += population.cash(i);
+        }
+        EXPECT_GT(population.trades(), 1000u);
+        EXPECT_EQ(std::accumulate(positions.begin(), positions.end(), std::int64_t{0}), 0);
+        EXPECT_EQ(cash, 0);
+        EXPECT_EQ(population.kind(0), AgentKind::MARKET_MAKER);
+        EXPECT_EQ(population.kind(329), AgentKind::MOMENTUM);
+        return std::make_pair(positions, population.volume());
+    };
+
+    auto first = simulate(7);
+    EXPECT_EQ(simulate(7), first);
+    EXPECT_NE(simulate(8), first);
+}
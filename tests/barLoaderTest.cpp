@@ -0,0 +1,146 @@
+#include "gtest/gtest.h"
+#include "barLoader.h"
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <unistd.h>
+
+class BarLoaderTest : public ::testing::Test {
+protected:
+    str path = "/tmp/bar_loader_test_" + std::to_string(getpid()) + ".csv";
+
+    void TearDown() override { std::remove(path.c_str()); }
+
+    void write(const str& contents) {
+        std::ofstream file(path, std::ios::binary);
+        file << contents;
+    }
+};
+
+TEST(BarLoaderScanTest, SimdScanMatchesByteByByteScan) {
+    std::mt19937 rng(7);
+    const char alphabet[] = {',', '\n', '1', '.', 'a', '\r', '-', ' '};
+    for (std::size_t size : {0u, 1u, 15u, 16u, 31u, 32u, 33u, 100u, 4099u}) {
+        str buffer(size, ' ');
+        for (char& c : buffer) c = alphabet[rng() % sizeof(alphabet)];
+
+        std::vector<std::uint32_t> expected;
+        for (std::size_t i = 0; i < size; ++i) {
+            if (buffer[i] == ',' || buffer[i] == '\n') expected.push_back(static_cast<std::uint32_t>(i));
+        }
+        std::vector<std::uint32_t> offsets;
+        scanSeparators(buffer.data(), buffer.size(), offsets);
+        EXPECT_EQ(offsets, expected) << "size " << size;
+    }
+}
+
+TEST(BarLoaderTimestampTest, ParsesDatesTimesAndOffsets) {
+    std::int64_t ms = 0;
+    ASSERT_TRUE(parseTimestamp("2020-01-02", ms));
+    EXPECT_EQ(ms, 1'577'923'200'000);
+    ASSERT_TRUE(parseTimestamp("1970-01-01T00:00:00Z", ms));
+    EXPECT_EQ(ms, 0);
+    ASSERT_TRUE(parseTimestamp("2024-02-29 09:30:15.250", ms));
+    EXPECT_EQ(ms, 1'709'199'015'250);
+    ASSERT_TRUE(parseTimestamp("2024-02-29 09:30", ms));
+    EXPECT_EQ(ms, 1'709'199'000'000);
+    ASSERT_TRUE(parseTimestamp("2020-01-02 00:00:00-05:00", ms));
+    EXPECT_EQ(ms, 1'577'923'200'000 + 5 * 3'600'000);
+    ASSERT_TRUE(parseTimestamp("2020-01-02T05:30:00+0530", ms));
+    EXPECT_EQ(ms, 1'577'923'200'000);
+    ASSERT_TRUE(parseTimestamp("1969-12-31", ms));
+    EXPECT_EQ(ms, -86'400'000);
+
+    for (const char* bad : {"", "Date", "Ticker", "2020-1-02", "2023-02-29", "2020-13-01", "2020-01-02 24:00", "2020-01-02X", "2020-01-02 10:00:00.",
+                            "2020-01-02 10:00+5"}) {
+        EXPECT_FALSE(parseTimestamp(bad, ms)) << bad;
+    }
+}
+
+TEST_F(BarLoaderTest, ReadsYahooFinanceExport) {
+    write("Price,Close,High,Low,Open,Volume\n"
+          "Ticker,AAPL,AAPL,AAPL,AAPL,AAPL\n"
+          "Date,,,,,\n"
+          "2020-01-02,72.71,72.77,71.46,71.72,135480400\n"
+          "2020-01-03,72.01,72.99,71.97,72.19,146322800\n");
+
+    BarColumns bars = loadBarCsv(path);
+    ASSERT_EQ(bars.size(), 2u);
+    EXPECT_EQ(bars.timestamp, (std::vector<std::int64_t>{1'577'923'200'000, 1'578'009'600'000}));
+    EXPECT_EQ(bars.open, (std::vector<Price>{7172, 7219}));
+    EXPECT_EQ(bars.high, (std::vector<Price>{7277, 7299}));
+    EXPECT_EQ(bars.low, (std::vector<Price>{7146, 7197}));
+    EXPECT_EQ(bars.close, (std::vector<Price>{7271, 7201}));
+    EXPECT_EQ(bars.volume, (std::vector<std::uint64_t>{135480400, 146322800}));
+}
+
+TEST_F(BarLoaderTest, HandlesCrlfMissingValuesAndNoTrailingNewline) {
+    write("date,open,high,low,close,adj close,volume\r\n"
+          "2020-01-02 09:30:00,10.004,10.5,9.995,10.25,10.1,1.5e3\r\n"
+          "2020-01-02 09:31:00,,,,,,\r\n"
+          "\r\n"
+          "2020-01-02 09:32:00,10.25,10.25,10.25,10.25,10.2,");
+
+    BarColumns bars = loadBarCsv(path, 1000);
+    ASSERT_EQ(bars.size(), 2u);
+    EXPECT_EQ(bars.timestamp[1] - bars.timestamp[0], 120'000);
+    EXPECT_EQ(bars.open, (std::vector<Price>{10004, 10250}));
+    EXPECT_EQ(bars.low, (std::vector<Price>{9995, 10250}));
+    EXPECT_EQ(bars.volume, (std::vector<std::uint64_t>{1500, 0}));
+}
+
+TEST_F(BarLoaderTest, RoundsPricesToTicks) {
+    write("date,open,high,low,close\n"
+          "2020-01-02,71.725,71.7249,1e2,.5\n");
+
+    BarColumns cents = loadBarCsv(path);
+    EXPECT_EQ(cents.open[0], 7173u);
+    EXPECT_EQ(cents.high[0], 7172u);
+    EXPECT_EQ(cents.low[0], 10000u);
+    EXPECT_EQ(cents.close[0], 50u);
+
+    BarColumns quarters = loadBarCsv(path, 4);
+    EXPECT_EQ(quarters.open[0], 287u);
+    EXPECT_EQ(quarters.close[0], 2u);
+}
+
+TEST_F(BarLoaderTest, ReadsRowsAcrossScanChunks) {
+    // A few megabytes, so rows straddle the scanner's chunks
+    constexpr int ROWS = 50'000;
+    str contents = "timestamp,open,high,low,close\n";
+    char row[96];
+    for (int i = 0; i < ROWS; ++i) {
+        const double price = 100 + i % 7 + (i % 100) / 100.0;
+        std::snprintf(row, sizeof(row), "2021-06-01T%02d:%02d:%02dZ,%.2f,%.2f,%.2f,%.2f\n", i / 3600, i / 60 % 60, i % 60, price, price, price, price);
+        contents += row;
+    }
+    write(contents);
+
+    BarColumns bars = loadBarCsv(path);
+    ASSERT_EQ(bars.size(), static_cast<std::size_t>(ROWS));
+    for (int i = 0; i < ROWS; i += 997) {
+        EXPECT_EQ(bars.timestamp[i], 1'622'505'600'000 + i * 1000LL) << i;
+        EXPECT_EQ(bars.close[i], static_cast<Price>((100 + i % 7) * 100 + i % 100)) << i;
+        EXPECT_EQ(bars.volume[i], 0u);
+    }
+}
+
+TEST_F(BarLoaderTest, RejectsMalformedFiles) {
+    EXPECT_THROW(loadBarCsv("/nonexistent/bars.csv"), std::runtime_error);
+
+    write("date,open,high,close\n2020-01-02,1,2,3\n");
+    EXPECT_THROW(loadBarCsv(path), std::runtime_error);
+
+    write("date,open,high,low,close\n2020-01-02,1,2,x,3\n");
+    EXPECT_THROW(loadBarCsv(path), std::runtime_error);
+
+    write("date,open,high,low,close\n2020-01-02,1,2,-1,3\n");
+    EXPECT_THROW(loadBarCsv(path), std::runtime_error);
+
+    write("date,open,high,low,close\n2020-01-03,1,2,1,3\n2020-01-02,1,2,1,3\n");
+    EXPECT_THROW(loadBarCsv(path), std::runtime_error);
+
+    write("");
+    EXPECT_THROW(loadBarCsv(path), std::runtime_error);
+    EXPECT_THROW(loadBarCsv(path, 0), std::invalid_argument);
+}
@@ -0,0 +1,84 @@
+#include "gtest/gtest.h"
+#include "differentialHarness.h"
+
+namespace {
+    VenueFactory engineVenue() { return [] { return std::make_unique<EngineVenue<MatchingEngine>>(); }; }
+    VenueFactory naiveVenue() { return [] { return std::make_unique<NaiveVenue>(); }; }
+
+    // Naive venue with a planted bug: limit orders for 7 are entered as 8.
+    class SevensAsEightsVenue : public NaiveVenue {
+        public:
+            void submit(const FuzzCommand& command, OrderID orderID, std::vector<EngineEvent>& events) override {
+                if (command.op == FuzzOp::LIMIT && command.quantity == 7) {
+                    FuzzCommand widened = command;
+                    widened.quantity = 8;
+                    NaiveVenue::submit(widened, orderID, events);
+                    return;
+                }
+                NaiveVenue::submit(command, orderID, events);
+            }
+    };
+
+    FuzzCommand limit(Side side, Price price, Quantity quantity, TraderID traderID = 1) {
+        return {FuzzOp::LIMIT, side, traderID, price, quantity, 0};
+    }
+}
+
+TEST(DifferentialHarnessTest, DecodesFixedSizeRecords) {
+    const std::uint8_t data[] = {0, 3, 17, 9, 2, 1,  16, 0, 0, 0, 0, 0,  9};
+    std::vector<FuzzCommand> commands = decodeFuzzCommands(data, sizeof(data));
+    ASSERT_EQ(commands.size(), 2u);
+    EXPECT_EQ(commands[0].op, FuzzOp::LIMIT);
+    EXPECT_EQ(commands[0].side, Side::SELL);
+    EXPECT_EQ(commands[0].traderID, 2u);
+    EXPECT_EQ(commands[0].price, 1001u);
+    EXPECT_EQ(commands[0].quantity, 10u);
+    EXPECT_EQ(commands[0].target, 258u);
+    EXPECT_EQ(commands[1].op, FuzzOp::MARKET);
+}
+
+TEST(DifferentialHarnessTest, EngineMatchesNaiveVenueOnRandomStreams) {
+    for (std::uint64_t seed = 1; seed <= 300; ++seed) {
+        std::optional<Divergence> divergence = runDifferential(randomFuzzCommands(seed, 200), naiveVenue(), engineVenue());
+        ASSERT_FALSE(divergence) << "seed " << seed << ": " << divergence->description;
+    }
+}
+
+TEST(DifferentialHarnessTest, ComparesFinalBookAfterAuction) {
+    std::vector<FuzzCommand> commands = {
+        {FuzzOp::BEGIN_AUCTION},
+        limit(Side::BUY, 1005, 10, 1),
+        limit(Side::BUY, 1003, 5, 2),
+        limit(Side::SELL, 1002, 8, 3),
+        limit(Side::SELL, 1004, 9, 4),
+        {FuzzOp::UNCROSS},
+        {FuzzOp::MASS_CANCEL_TRADER_SIDE, Side::SELL, 4}
+    };
+    EXPECT_FALSE(runDifferential(commands, naiveVenue(), engineVenue()));
+
+    EngineVenue<MatchingEngine> venue;
+    std::vector<EngineEvent> events;
+    venue.submit(limit(Side::BUY, 1001, 4, 1), 1, events);
+    venue.submit(limit(Side::BUY, 1001, 6, 2), 2, events);
+    BookState state = venue.state();
+    ASSERT_EQ(state.bids.size(), 1u);
+    EXPECT_EQ(state.bids[0].quantity, 10u);
+    EXPECT_EQ(state.bids[0].orders, (std::vector<RestingOrderState>{{1, 1, 4}, {2, 2, 6}}));
+    EXPECT_TRUE(state.asks.empty());
+}
+
+TEST(DifferentialHarnessTest, FindsAndMinimizesPlantedBug) {
+    VenueFactory broken = [] { return std::make_unique<SevensAsEightsVenue>(); };
+    std::optional<std::vector<FuzzCommand>> failing;
+    for (std::uint64_t seed = 1; seed <= 50 && !failing; ++seed) {
+        std::vector<FuzzCommand> commands = randomFuzzCommands(seed, 300);
+        if (runDifferential(commands, naiveVenue(), broken)) failing = commands;
+    }
+    ASSERT_TRUE(failing);
+
+    std::vector<FuzzCommand> minimal = minimizeCommands(*failing, naiveVenue(), broken);
+    ASSERT_TRUE(runDifferential(minimal, naiveVenue(), broken));
+    // A lone resting 7 already differs: accepted as 8 instead of 7
+    EXPECT_EQ(minimal.size(), 1u) << formatCommands(minimal);
+    EXPECT_EQ(minimal[0].quantity, 7u);
+}
@@ -42,10 +42,10 @@ TEST_F(EventDispatcherTest, BasicSubscribeAndPublish) {
 TEST_F(EventDispatcherTest, MultipleSubscribersForSameEvent) {
     std::atomic<int> counter = 0;
     
-    dispatcher.subscribe<TestEventA>([&](const TestEventA& event) {
+    dispatcher.subscribe<TestEventA>([&](const TestEventA&) {
         counter++;
     });
-    dispatcher.subscribe<TestEventA>([&](const TestEventA& event) {
+    dispatcher.subscribe<TestEventA>([&](const TestEventA&) {
         counter++;
     });
 
@@ -58,10 +58,10 @@ TEST_F(EventDispatcherTest, CorrectSubscriberForCorrectEventType) {
     bool eventAReceived = false;
     bool eventBReceived = false;
 
-    dispatcher.subscribe<TestEventA>([&](const TestEventA& event) {
+    dispatcher.subscribe<TestEventA>([&](const TestEventA&) {
         eventAReceived = true;
     });
-    dispatcher.subscribe<TestEventB>([&](const TestEventB& event) {
+    dispatcher.subscribe<TestEventB>([&](const TestEventB&) {
         eventBReceived = true;
     });
 
@@ -80,10 +80,10 @@ TEST_F(EventDispatcherTest, PublishWithNoSubscribers) {
 TEST_F(EventDispatcherTest, SubscriberThrowsException) {
     std::atomic<bool> secondSubscriberWasCalled = false;
 
-    dispatcher.subscribe<TestEventA>([](const TestEventA& event) {
+    dispatcher.subscribe<TestEventA>([](const TestEventA&) {
         throw std::runtime_error("Test exception");
     });
-    dispatcher.subscribe<TestEventA>([&](const TestEventA& event) {
+    dispatcher.subscribe<TestEventA>([&](const TestEventA&) {
         secondSubscriberWasCalled = true;
     });
 
@@ -108,7 +108,7 @@ TEST_F(EventDispatcherTest, MultithreadedStressTest) {
     // Subscriber thread: Rapidly subscribes new listeners.
     std::thread subscriber([&]() {
         for (int i = 0; i < num_events; ++i) {
-            dispatcher.subscribe<TestEventA>([&](const TestEventA& event) {
+            dispatcher.subscribe<TestEventA>([&](const TestEventA&) {
                 eventCount++;
             });
         }
@@ -125,3 +125,65 @@ TEST_F(EventDispatcherTest, MultithreadedStressTest) {
     EXPECT_GT(eventCount, 0);
     std::cout << "Multithreaded test completed with " << eventCount << " events handled." << std::endl;
 }
+
+TEST_F(EventDispatcherTest, UnsubscribedCallbackIsNotCalled) {
+    int first = 0, second = 0;
+    SubscriptionID id = dispatcher.subscribe<TestEventA>([&](const TestEventA&) { first++; });
+    dispatcher.subscribe<TestEventA>([&](const TestEventA&) { second++; });
+
+    dispatcher.publish(TestEventA{1});
+    dispatcher.unsubscribe(id);
+    dispatcher.unsubscribe(id);
+    dispatcher.publish(TestEventA{2});
+
+    EXPECT_EQ(first, 1);
+    EXPECT_EQ(second, 2);
+}
+
+TEST_F(EventDispatcherTest, CallbackCanUnsubscribeItself) {
+    int calls = 0;
+    SubscriptionID id = 0;
+    id = dispatcher.subscribe<TestEventA>([&](const TestEventA&) {
+        calls++;
+        dispatcher.unsubscribe(id);
+    });
+
+    dispatcher.publish(TestEventA{1});
+    dispatcher.publish(TestEventA{2});
+    EXPECT_EQ(calls, 1);
+}
+
+TEST_F(EventDispatcherTest, UnsubscribeWaitsForARunningCallback) {
+    std::atomic<bool> entered = false, release = false, finished = false;
+    SubscriptionID id = dispatcher.subscribe<TestEventA>([&](const TestEventA&) {
+        entered = true;
+        while (!release) std::this_thread::yield();
+        finished = true;
+    });
+
+    std::thread publisher([&] { dispatcher.publish(TestEventA{1}); });
+    while (!entered) std::this_thread::yield();
+    std::thread releaser([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        release = true;
+    });
+    dispatcher.unsubscribe(id);
+    EXPECT_TRUE(finished);
+
+    publisher.join();
+    releaser.join();
+}
+
+TEST_F(EventDispatcherTest, SubscriptionsReleaseOnDestruction) {
+    int calls = 0;
+    {
+        Subscriptions subscriptions;
+        subscriptions.add<TestEventA>(dispatcher, [&](const TestEventA&) { calls++; });
+        subscriptions.add<TestEventB>(dispatcher, [&](const TestEventB&) { calls++; });
+        dispatcher.publish(TestEventA{1});
+        dispatcher.publish(TestEventB{"b"});
+    }
+    dispatcher.publish(TestEventA{2});
+    dispatcher.publish(TestEventB{"b"});
+    EXPECT_EQ(calls, 2);
+}
@@ -0,0 +1,84 @@
+#include "gtest/gtest.h"
+#include "fillRecorder.h"
+#include "eventDispatcher.h"
+#include "events.h"
+
+class FillRecorderTest : public ::testing::Test {
+protected:
+    EventDispatcher dispatcher;
+
+    TradeExecutedEvent trade(const std::string& symbol, Price price, Quantity quantity, TraderID aggressor, Side side, TraderID resting) {
+        TradeExecutedEvent event{symbol, price, quantity, 100 + aggressor, aggressor, side, 0, 200 + resting, resting, 0};
+        return event;
+    }
+};
+
+TEST_F(FillRecorderTest, Unfiltered_RecordsEveryTradeFromAggressorSide) {
+    FillRecorder recorder(std::nullopt, 4);
+    recorder.subscribe(dispatcher);
+
+    dispatcher.publish(trade("AAPL", 15000, 10, 1, Side::BUY, 2));
+    dispatcher.publish(trade("MSFT", 30000, 5, 3, Side::SELL, 4));
+
+    auto fills = recorder.takeFills();
+    ASSERT_EQ(fills->size(), 2u);
+    EXPECT_EQ(fills->price[0], 15000u);
+    EXPECT_EQ(fills->side[0], 1);
+    EXPECT_EQ(fills->side[1], -1);
+    EXPECT_EQ(fills->traderID[1], 3u);
+    EXPECT_EQ(fills->symbol[0], 0u);
+    EXPECT_EQ(fills->symbol[1], 1u);
+    EXPECT_EQ(recorder.getSymbols(), (std::vector<std::string>{"AAPL", "MSFT"}));
+}
+
+TEST_F(FillRecorderTest, TraderFilter_RecordsOnlyOwnFillsFromOwnSide) {
+    FillRecorder recorder(1, 4);
+    recorder.subscribe(dispatcher);
+
+    dispatcher.publish(trade("AAPL", 15000, 10, 1, Side::BUY, 2));   // we aggress and buy
+    dispatcher.publish(trade("AAPL", 15100, 4, 2, Side::BUY, 1));    // we rest and sell
+    dispatcher.publish(trade("AAPL", 15200, 7, 3, Side::SELL, 4));   // not ours
+
+    auto fills = recorder.takeFills();
+    ASSERT_EQ(fills->size(), 2u);
+    EXPECT_EQ(fills->side[0], 1);
+    EXPECT_EQ(fills->orderID[0], 101u);
+    EXPECT_EQ(fills->side[1], -1);
+    EXPECT_EQ(fills->orderID[1], 201u);
+    EXPECT_EQ(fills->quantity[1], 4u);
+}
+
+TEST_F(FillRecorderTest, Clock_OverridesEventTimestamp) {
+    FillRecorder recorder;
+    recorder.subscribe(dispatcher);
+
+    recorder.setClock(1'600'000'000'000);
+    dispatcher.publish(trade("AAPL", 15000, 10, 1, Side::BUY, 2));
+
+    auto fills = recorder.takeFills();
+    ASSERT_EQ(fills->size(), 1u);
+    EXPECT_EQ(fills->timestamp[0], 1'600'000'000'000);
+}
+
+TEST_F(FillRecorderTest, Take_HandsOverBatchAndStartsFresh) {
+    FillRecorder recorder(std::nullopt, 8);
+    recorder.subscribe(dispatcher);
+
+    dispatcher.publish(trade("AAPL", 15000, 10, 1, Side::BUY, 2));
+    recorder.recordEquity(1, 100.0);
+    recorder.recordEquity(2, 101.5);
+
+    auto first = recorder.takeFills();
+    EXPECT_EQ(first->size(), 1u);
+    EXPECT_EQ(recorder.fillCount(), 0u);
+
+    dispatcher.publish(trade("AAPL", 15000, 10, 1, Side::BUY, 2));
+    auto second = recorder.takeFills();
+    EXPECT_EQ(second->size(), 1u);
+    EXPECT_GE(second->timestamp.capacity(), 1u);
+
+    auto equity = recorder.takeEquity();
+    ASSERT_EQ(equity->size(), 2u);
+    EXPECT_DOUBLE_EQ(equity->value[1], 101.5);
+    EXPECT_EQ(recorder.takeEquity()->size(), 0u);
+}
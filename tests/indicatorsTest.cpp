@@ -0,0 +1,142 @@
+#include "gtest/gtest.h"
+#include "indicators.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+class IndicatorsTest : public ::testing::Test {
+protected:
+    std::vector<double> prices;
+    std::vector<double> volumes;
+
+    void SetUp() override {
+        std::mt19937 rng(7);
+        std::normal_distribution<double> step(0.0, 0.5);
+        std::uniform_int_distribution<int> size(1, 500);
+        double price = 150.0;
+        for (int i = 0; i < 10000; i++) {
+            price += step(rng);
+            prices.push_back(price);
+            volumes.push_back(size(rng));
+        }
+    }
+
+    double naiveMean(std::size_t end, std::size_t period) {
+        double sum = 0.0;
+        for (std::size_t i = end + 1 - period; i <= end; i++) sum += prices[i];
+        return sum / period;
+    }
+
+    double naiveStdDev(std::size_t end, std::size_t period) {
+        double mean = naiveMean(end, period), sum = 0.0;
+        for (std::size_t i = end + 1 - period; i <= end; i++) sum += (prices[i] - mean) * (prices[i] - mean);
+        return std::sqrt(sum / (period - 1));
+    }
+};
+
+TEST_F(IndicatorsTest, SMA_IncrementalMatchesBatchAndNaive) {
+    const std::size_t period = 20;
+    SimpleMovingAverage sma(period);
+    std::vector<double> batch(prices.size());
+    indicators::sma(prices.data(), prices.size(), period, batch.data());
+
+    for (std::size_t i = 0; i < prices.size(); i++) {
+        double value = sma.update(prices[i]);
+        if (i + 1 < period) {
+            EXPECT_FALSE(sma.ready());
+            EXPECT_TRUE(std::isnan(batch[i]));
+            continue;
+        }
+        ASSERT_TRUE(sma.ready());
+        double expected = naiveMean(i, period);
+        ASSERT_NEAR(value, expected, 1e-9) << i;
+        ASSERT_NEAR(batch[i], expected, 1e-9) << i;
+    }
+}
+
+TEST_F(IndicatorsTest, EMA_IncrementalMatchesBatch) {
+    const std::size_t period = 12;
+    ExponentialMovingAverage ema(period);
+    std::vector<double> batch(prices.size());
+    indicators::ema(prices.data(), prices.size(), period, batch.data());
+
+    EXPECT_DOUBLE_EQ(ema.update(prices[0]), prices[0]);
+    for (std::size_t i = 1; i < prices.size(); i++) {
+        double value = ema.update(prices[i]);
+        if (i + 1 >= period) {
+            ASSERT_DOUBLE_EQ(batch[i], value);
+        }
+    }
+    EXPECT_TRUE(std::isnan(batch[period - 2]));
+}
+
+TEST_F(IndicatorsTest, StdDev_IncrementalMatchesBatchAndNaive) {
+    const std::size_t period = 30;
+    RollingStdDev stddev(period);
+    std::vector<double> batch(prices.size());
+    indicators::rollingStdDev(prices.data(), prices.size(), period, batch.data());
+
+    for (std::size_t i = 0; i < prices.size(); i++) {
+        double value = stddev.update(prices[i]);
+        if (i + 1 < period) continue;
+        double expected = naiveStdDev(i, period);
+        ASSERT_NEAR(value, expected, 1e-7) << i;
+        ASSERT_NEAR(batch[i], expected, 1e-7) << i;
+    }
+}
+
+TEST_F(IndicatorsTest, MinMax_IncrementalMatchesBatchAndNaive) {
+    for (std::size_t period : {1u, 3u, 16u, 17u}) {
+        RollingMin rollingMin(period);
+        RollingMax rollingMax(period);
+        std::vector<double> mins(prices.size()), maxs(prices.size());
+        indicators::rollingMin(prices.data(), prices.size(), period, mins.data());
+        indicators::rollingMax(prices.data(), prices.size(), period, maxs.data());
+
+        for (std::size_t i = 0; i < prices.size(); i++) {
+            double low = rollingMin.update(prices[i]);
+            double high = rollingMax.update(prices[i]);
+            std::size_t start = i + 1 >= period ? i + 1 - period : 0;
+            auto [lowest, highest] = std::minmax_element(prices.begin() + start, prices.begin() + i + 1);
+            ASSERT_EQ(low, *lowest) << period << " " << i;
+            ASSERT_EQ(high, *highest) << period << " " << i;
+            if (i + 1 >= period) {
+                ASSERT_EQ(mins[i], *lowest) << period << " " << i;
+                ASSERT_EQ(maxs[i], *highest) << period << " " << i;
+            }
+        }
+    }
+}
+
+TEST_F(IndicatorsTest, VWAP_IncrementalMatchesBatch) {
+    const std::size_t period = 50;
+    RollingVWAP vwap(period);
+    std::vector<double> batch(prices.size());
+    indicators::vwap(prices.data(), volumes.data(), prices.size(), period, batch.data());
+
+    for (std::size_t i = 0; i < prices.size(); i++) {
+        double value = vwap.update(prices[i], volumes[i]);
+        if (i + 1 < period) continue;
+        double notional = 0.0, volume = 0.0;
+        for (std::size_t j = i + 1 - period; j <= i; j++) {
+            notional += prices[j] * volumes[j];
+            volume += volumes[j];
+        }
+        ASSERT_NEAR(value, notional / volume, 1e-8) << i;
+        ASSERT_NEAR(batch[i], notional / volume, 1e-8) << i;
+    }
+}
+
+TEST_F(IndicatorsTest, ShortInput_IsAllNaN) {
+    std::vector<double> out(5);
+    indicators::sma(prices.data(), 5, 10, out.data());
+    indicators::rollingMax(prices.data(), 5, 10, out.data());
+    EXPECT_TRUE(std::all_of(out.begin(), out.end(), [](double v) { return std::isnan(v); }));
+}
+
+TEST_F(IndicatorsTest, ZeroPeriod_Throws) {
+    EXPECT_THROW(SimpleMovingAverage(0), std::invalid_argument);
+    EXPECT_THROW(RollingMin(0), std::invalid_argument);
+    std::vector<double> out(5);
+    EXPECT_THROW(indicators::sma(prices.data(), 5, 0, out.data()), std::invalid_argument);
+}
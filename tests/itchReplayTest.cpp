@@ -0,0 +1,195 @@
+#include "gtest/gtest.h"
+#include "itchReplay.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+class ItchReplayTest : public ::testing::Test {
+protected:
+    str path = "/tmp/itch_replay_test_" + std::to_string(getpid()) + ".itch";
+
+    void TearDown() override { std::remove(path.c_str()); }
+
+    static Quantity restingQuantity(OrderBook& book, Side side) {
+        Quantity total = 0;
+        for (const LevelSnapshot& level : book.depth(side)) total += level.quantity;
+        return total;
+    }
+
+    static std::size_t restingOrders(OrderBook& book) {
+        std::size_t total = 0;
+        for (Side side : {Side::BUY, Side::SELL}) {
+            for (const LevelSnapshot& level : book.depth(side)) total += level.orders.size();
+        }
+        return total;
+    }
+};
+
+TEST_F(ItchReplayTest, AppliesEveryOrderMessage) {
+    {
+        ItchWriter writer(path);
+        writer.systemEvent(1, 'O');
+        writer.stockDirectory(7, 2, "AAPL");
+        writer.addOrder(7, 10, 100, Side::BUY, 500, "AAPL", 18950);
+        writer.addOrder(7, 11, 101, Side::SELL, 300, "AAPL", 18960, true);
+        writer.addOrder(7, 12, 102, Side::BUY, 200, "AAPL", 18940);
+        writer.orderExecuted(7, 20, 100, 100, 1);
+        writer.orderCancel(7, 21, 101, 50);
+        writer.orderDelete(7, 22, 102);
+        writer.orderReplace(7, 23, 100, 200, 700, 18955);
+        writer.trade(7, 24, Side::BUY, 100, "AAPL", 18958, 2);
+        writer.close();
+    }
+
+    ItchReplay replay(path);
+    EXPECT_EQ(replay.step(), 10u);
+    EXPECT_TRUE(replay.done());
+    EXPECT_EQ(replay.currentTime(), 24u);
+    EXPECT_EQ(replay.getSymbol(7), "AAPL");
+    EXPECT_EQ(replay.stats().applied, 7u);
+    EXPECT_EQ(replay.stats().unknownOrders, 0u);
+
+    OrderBook* book = replay.getBook("AAPL");
+    ASSERT_NE(book, nullptr);
+    EXPECT_EQ(book, replay.getBook(7));
+    EXPECT_EQ(book->getOrder(100), nullptr);
+    EXPECT_EQ(book->getOrder(102), nullptr);
+    EXPECT_EQ(book->getOrder(200)->getQuantity(), 700u);
+    EXPECT_EQ(book->getOrder(200)->getSide(), Side::BUY);
+    EXPECT_EQ(book->getOrder(101)->getQuantity(), 250u);
+    EXPECT_EQ(book->getBestBid()->price, 18955u);
+    EXPECT_EQ(book->getBestAsk()->price, 18960u);
+}
+
+TEST_F(ItchReplayTest, PublishesPrintableExecutions) {
+    {
+        ItchWriter writer(path);
+        writer.stockDirectory(3, 1, "MSFT");
+        writer.addOrder(3, 2, 1, Side::SELL, 400, "MSFT", 41000);
+        writer.orderExecuted(3, 5'000'000, 1, 100, 1);
+        writer.orderExecutedWithPrice(3, 6'000'000, 1, 100, 2, 41001);
+        writer.orderExecutedWithPrice(3, 7'000'000, 1, 100, 3, 41002, false);
+        writer.close();
+    }
+
+    EventDispatcher dispatcher;
+    std::vector<TradeExecutedEvent> trades;
+    dispatcher.subscribe<TradeExecutedEvent>([&](const TradeExecutedEvent& e) { trades.push_back(e); });
+
+    ItchReplay replay(path);
+    replay.publishTrades(dispatcher, 1'700'000'000'000);
+    replay.step();
+
+    ASSERT_EQ(trades.size(), 2u);
+    EXPECT_EQ(trades[0].symbol, "MSFT");
+    EXPECT_EQ(trades[0].price, 41000u);
+    EXPECT_EQ(trades[0].quantity, 100u);
+    EXPECT_EQ(trades[0].aggressingSide, Side::BUY);
+    EXPECT_EQ(trades[0].restingOrderID, 1u);
+    EXPECT_EQ(trades[0].restingRemainingQuantity, 300u);
+    EXPECT_EQ(trades[0].timestamp.time_since_epoch().count(), 1'700'000'000'005);
+    EXPECT_EQ(trades[1].price, 41001u);
+    // The non-printable execution still comes off the book
+    EXPECT_EQ(replay.getBook(3)->getOrder(1)->getQuantity(), 100u);
+}
+
+TEST_F(ItchReplayTest, FiltersBySymbolAndLocate) {
+    {
+        ItchWriter writer(path);
+        writer.stockDirectory(1, 1, "AAA");
+        writer.stockDirectory(2, 1, "BBB");
+        writer.stockDirectory(3, 1, "CCC");
+        for (std::uint16_t locate = 1; locate <= 3; ++locate) {
+            writer.addOrder(locate, 2, locate, Side::BUY, 100, "X", 1000);
+            writer.orderExecuted(locate, 3, locate, 50, locate);
+        }
+        writer.close();
+    }
+
+    ItchReplay replay(path);
+    replay.addSymbol("BBB");
+    replay.addLocate(3);
+    replay.step();
+
+    EXPECT_EQ(replay.getBook(1), nullptr);
+    EXPECT_EQ(replay.getBook("AAA"), nullptr);
+    EXPECT_EQ(replay.getBook(2)->getOrder(2)->getQuantity(), 50u);
+    EXPECT_EQ(replay.getBook(3)->getOrder(3)->getQuantity(), 50u);
+    EXPECT_EQ(replay.bookCount(), 2u);
+    EXPECT_EQ(replay.stats().filtered, 2u);
+    EXPECT_EQ(replay.stats().applied, 4u);
+}
+
+TEST_F(ItchReplayTest, UnknownOrdersDoNotCreateBooks) {
+    {
+        ItchWriter writer(path);
+        writer.stockDirectory(1, 1, "AAA");
+        writer.addOrder(1, 2, 1, Side::BUY, 100, "AAA", 1000);
+        writer.orderExecuted(2, 3, 7, 50, 1);
+        writer.orderCancel(3, 4, 8, 50);
+        writer.orderDelete(4, 5, 9);
+        writer.orderReplace(5, 6, 10, 11, 100, 1000);
+        writer.orderDelete(1, 7, 12);
+        writer.close();
+    }
+
+    ItchReplay replay(path);
+    replay.step();
+
+    EXPECT_EQ(replay.stats().unknownOrders, 5u);
+    EXPECT_EQ(replay.stats().applied, 1u);
+    EXPECT_EQ(replay.bookCount(), 1u);
+    for (std::uint16_t locate = 2; locate <= 5; ++locate) EXPECT_EQ(replay.getBook(locate), nullptr);
+}
+
+TEST_F(ItchReplayTest, RunUntilStopsAtTheTimestamp) {
+    {
+        ItchWriter writer(path);
+        writer.stockDirectory(1, 100, "AAA");
+        writer.addOrder(1, 200, 1, Side::BUY, 100, "AAA", 1000);
+        writer.addOrder(1, 300, 2, Side::BUY, 100, "AAA", 1000);
+        writer.close();
+    }
+
+    ItchReplay replay(path);
+    EXPECT_EQ(replay.runUntil(250), 2u);
+    EXPECT_EQ(replay.currentTime(), 200u);
+    EXPECT_EQ(restingQuantity(*replay.getBook(1), Side::BUY), 100u);
+    EXPECT_EQ(replay.runUntil(1000), 1u);
+    EXPECT_TRUE(replay.done());
+}
+
+TEST_F(ItchReplayTest, SyntheticSessionStaysConsistent) {
+    const std::size_t resting = synthesizeItch(path, 50'000, 8, 42);
+
+    ItchReplay replay(path);
+    EXPECT_EQ(replay.step(), 50'000u);
+    EXPECT_EQ(replay.stats().unknownOrders, 0u);
+    EXPECT_EQ(replay.bookCount(), 8u);
+
+    std::size_t total = 0;
+    for (std::uint16_t locate = 1; locate <= 8; ++locate) {
+        EXPECT_EQ(replay.getSymbol(locate), "STK000" + std::to_string(locate));
+        total += restingOrders(*replay.getBook(locate));
+    }
+    EXPECT_EQ(total, resting);
+}
+
+TEST_F(ItchReplayTest, RejectsTruncatedAndCompressedFiles) {
+    {
+        ItchWriter writer(path);
+        writer.stockDirectory(1, 1, "AAA");
+        writer.close();
+    }
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 4);
+    ItchReplay truncated(path);
+    EXPECT_THROW(truncated.step(), std::runtime_error);
+
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "\x1f\x8b\x08";
+    }
+    EXPECT_THROW(ItchReplay{path}, std::runtime_error);
+    EXPECT_THROW(ItchReplay{"/nonexistent/capture.itch"}, std::runtime_error);
+}
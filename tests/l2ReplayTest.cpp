@@ -0,0 +1,140 @@
+#include "gtest/gtest.h"
+#include "l2Replay.h"
+#include "eventDispatcher.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+class L2ReplayTest : public ::testing::Test {
+protected:
+    EventDispatcher dispatcher;
+    std::vector<TradeExecutedEvent> trades;
+
+    void SetUp() override {
+        dispatcher.subscribe<TradeExecutedEvent>([this](const TradeExecutedEvent& e) { trades.push_back(e); });
+    }
+
+    static L2Event book(std::int64_t t, Side side, Price price, Quantity quantity) { return {t, L2EventType::BOOK, side, price, quantity}; }
+    static L2Event print(std::int64_t t, Side aggressor, Price price, Quantity quantity) { return {t, L2EventType::TRADE, aggressor, price, quantity}; }
+};
+
+TEST(L2BookTest, KeepsLevelsSortedWithBestLast) {
+    L2Book book;
+    book.set(Side::BUY, 100, 5);
+    book.set(Side::BUY, 102, 7);
+    book.set(Side::BUY, 101, 6);
+    book.set(Side::SELL, 105, 3);
+    book.set(Side::SELL, 104, 4);
+
+    EXPECT_EQ(book.best(Side::BUY)->price, 102u);
+    EXPECT_EQ(book.best(Side::SELL)->price, 104u);
+    EXPECT_EQ(book.set(Side::BUY, 102, 0), 7u);
+    EXPECT_EQ(book.best(Side::BUY)->price, 101u);
+    EXPECT_EQ(book.quantityAt(Side::SELL, 105), 3u);
+    EXPECT_EQ(book.quantityAt(Side::SELL, 106), 0u);
+}
+
+TEST_F(L2ReplayTest, TradesConsumeQueueAheadBeforeFillingOrder) {
+    L2Replay replay(dispatcher, "ES", 7, {book(1, Side::BUY, 10000, 300), book(1, Side::SELL, 10001, 200),
+                                         print(2, Side::SELL, 10000, 250), book(2, Side::BUY, 10000, 50),
+                                         print(3, Side::SELL, 10000, 80)});
+    replay.runUntil(1);
+    OrderID id = replay.submitLimit(Side::BUY, 10000, 100);
+    EXPECT_EQ(replay.getOrder(id)->queueAhead, 300u);
+
+    // 250 trade ahead of us; the book update confirming it is not read as cancels
+    replay.runUntil(2);
+    EXPECT_EQ(replay.getOrder(id)->queueAhead, 50u);
+    EXPECT_TRUE(trades.empty());
+
+    replay.run();
+    ASSERT_EQ(trades.size(), 1u);
+    EXPECT_EQ(trades[0].quantity, 30u);
+    EXPECT_EQ(trades[0].restingOrderID, id);
+    EXPECT_EQ(trades[0].restingTraderID, 7u);
+    EXPECT_EQ(trades[0].restingRemainingQuantity, 70u);
+    EXPECT_EQ(trades[0].aggressingSide, Side::SELL);
+    EXPECT_EQ(replay.getOrder(id)->queueAhead, 0u);
+}
+
+TEST_F(L2ReplayTest, CancelsShrinkQueueProportionallyAndJoinersQueueBehind) {
+    L2Replay replay(dispatcher, "ES", 7, {book(1, Side::SELL, 10005, 400), book(2, Side::SELL, 10005, 1000),
+                                         book(3, Side::SELL, 10005, 500)});
+    replay.runUntil(1);
+    OrderID id = replay.submitLimit(Side::SELL, 10005, 10);
+
+    replay.runUntil(2);
+    EXPECT_EQ(replay.getOrder(id)->queueAhead, 400u);
+    // Half the level cancelled, so half the queue ahead of us is assumed gone
+    replay.runUntil(3);
+    EXPECT_EQ(replay.getOrder(id)->queueAhead, 200u);
+}
+
+TEST_F(L2ReplayTest, MarketableOrdersTakeDisplayedLiquidityAndTradeThroughsFill) {
+    L2Replay replay(dispatcher, "ES", 7, {book(1, Side::SELL, 10001, 50), book(1, Side::SELL, 10002, 50),
+                                         book(1, Side::BUY, 9998, 500), print(2, Side::SELL, 9997, 10)});
+    replay.runUntil(1);
+    OrderID taker = replay.submitLimit(Side::BUY, 10002, 80);
+    ASSERT_EQ(trades.size(), 2u);
+    EXPECT_EQ(trades[0].price, 10001u);
+    EXPECT_EQ(trades[1].price, 10002u);
+    EXPECT_EQ(trades[1].quantity, 30u);
+    EXPECT_EQ(trades[1].aggressingOrderID, taker);
+    EXPECT_FALSE(replay.getOrder(taker));
+    EXPECT_EQ(replay.getBook().quantityAt(Side::SELL, 10002), 20u);
+
+    // Behind 500 at 9998, but a print at 9997 means every bid at 9998 traded
+    OrderID resting = replay.submitLimit(Side::BUY, 9998, 40);
+    replay.run();
+    ASSERT_EQ(trades.size(), 3u);
+    EXPECT_EQ(trades[2].restingOrderID, resting);
+    EXPECT_EQ(trades[2].price, 9998u);
+    EXPECT_EQ(trades[2].quantity, 40u);
+    EXPECT_TRUE(replay.getOrders().empty());
+}
+
+TEST_F(L2ReplayTest, SubscribersMaySubmitAndCancelFromFillCallbacks) {
+    L2Replay replay(dispatcher, "ES", 7, {book(1, Side::BUY, 9998, 100), print(2, Side::SELL, 9997, 10)});
+    replay.runUntil(1);
+    OrderID first = replay.submitLimit(Side::BUY, 9998, 10);
+    OrderID second = replay.submitLimit(Side::BUY, 9998, 10);
+
+    // Requote on every fill, and pull the other order when the first fills
+    std::vector<OrderID> requotes;
+    dispatcher.subscribe<TradeExecutedEvent>([&](const TradeExecutedEvent& e) {
+        if (e.restingOrderID == first) replay.cancel(second);
+        for (int i = 0; i < 8; i++) requotes.push_back(replay.submitLimit(Side::BUY, 9990, 1));
+    });
+    replay.run();
+
+    ASSERT_EQ(trades.size(), 2u);
+    EXPECT_EQ(trades[0].restingOrderID, first);
+    EXPECT_EQ(trades[1].restingOrderID, second);
+    EXPECT_EQ(requotes.size(), 16u);
+    EXPECT_EQ(replay.getOrders().size(), 16u);
+}
+
+TEST_F(L2ReplayTest, LoadsCsvEvents) {
+    const str path = "/tmp/l2_replay_test_" + std::to_string(getpid()) + ".csv";
+    {
+        std::ofstream file(path);
+        file << "timestamp,type,side,price,quantity\n"
+             << "1000,B,B,150.25,300\r\n"
+             << "2000,T,S,150.2,100\n";
+    }
+    std::vector<L2Event> events = loadL2Csv(path);
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].price, 15025u);
+    EXPECT_EQ(events[0].type, L2EventType::BOOK);
+    EXPECT_EQ(events[1].price, 15020u);
+    EXPECT_EQ(events[1].side, Side::SELL);
+    EXPECT_EQ(events[1].type, L2EventType::TRADE);
+
+    {
+        std::ofstream file(path, std::ios::app);
+        file << "3000,X,B,1.00,1\n";
+    }
+    EXPECT_THROW(loadL2Csv(path), std::runtime_error);
+    std::remove(path.c_str());
+}
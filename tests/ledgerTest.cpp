@@ -0,0 +1,103 @@
+#include "gtest/gtest.h"
+#include "ledger.h"
+#include "eventDispatcher.h"
+#include "events.h"
+
+class LedgerTest : public ::testing::Test {
+protected:
+    EventDispatcher dispatcher;
+    Ledger ledger;
+
+    void SetUp() override {
+        ledger.openAccount(1, 1000000);    // $10,000.00
+        ledger.openAccount(2, 1000000);
+        ledger.subscribe(dispatcher);
+    }
+
+    void trade(const std::string& symbol, Price price, Quantity quantity, TraderID aggressor, Side side, TraderID resting) {
+        dispatcher.publish(TradeExecutedEvent{symbol, price, quantity, 100, aggressor, side, 0, 200, resting, 0});
+    }
+
+    void mark(const std::string& symbol, Price price) {
+        MarketDataEvent event;
+        event.symbol = symbol;
+        event.last_price = price;
+        dispatcher.publish(event);
+    }
+};
+
+TEST_F(LedgerTest, Fill_UpdatesBothSides) {
+    trade("AAPL", 15000, 10, 1, Side::BUY, 2);
+
+    auto buyer = ledger.getAccount(1);
+    auto seller = ledger.getAccount(2);
+    ASSERT_TRUE(buyer && seller);
+    EXPECT_EQ(buyer->cash, 1000000 - 150000);
+    EXPECT_EQ(buyer->marketValue, 150000);
+    EXPECT_EQ(buyer->equity, 1000000);
+    EXPECT_EQ(seller->cash, 1000000 + 150000);
+    EXPECT_EQ(seller->marketValue, -150000);
+    EXPECT_EQ(ledger.getPosition(2, "AAPL")->quantity, -10);
+    EXPECT_EQ(buyer->fillCount, 1u);
+}
+
+TEST_F(LedgerTest, UnknownTrader_IsIgnored) {
+    trade("AAPL", 15000, 10, 7, Side::BUY, 1);
+
+    EXPECT_FALSE(ledger.getAccount(7).has_value());
+    EXPECT_EQ(ledger.getPosition(1, "AAPL")->quantity, -10);
+}
+
+TEST_F(LedgerTest, MarketData_RevaluesHoldersIncrementally) {
+    trade("AAPL", 15000, 10, 1, Side::BUY, 2);
+    mark("AAPL", 15500);
+
+    auto buyer = ledger.getAccount(1);
+    EXPECT_EQ(buyer->marketValue, 155000);
+    EXPECT_EQ(buyer->unrealizedPnl, 5000);
+    EXPECT_EQ(buyer->equity, 1005000);
+    EXPECT_EQ(ledger.getAccount(2)->unrealizedPnl, -5000);
+    EXPECT_EQ(*ledger.getMark("AAPL"), 15500u);
+
+    mark("MSFT", 30000);
+    EXPECT_EQ(ledger.getAccount(1)->marketValue, 155000);
+}
+
+TEST_F(LedgerTest, PartialClose_RealizesAgainstAverageCost) {
+    trade("AAPL", 10000, 10, 1, Side::BUY, 2);
+    trade("AAPL", 11000, 10, 1, Side::BUY, 2);    // average cost 105.00
+    trade("AAPL", 12000, 5, 1, Side::SELL, 2);
+
+    auto position = ledger.getPosition(1, "AAPL");
+    EXPECT_EQ(position->quantity, 15);
+    EXPECT_EQ(position->costBasis, 157500);
+    EXPECT_EQ(position->realizedPnl, 7500);
+    EXPECT_EQ(position->unrealizedPnl, 15 * 12000 - 157500);
+    EXPECT_EQ(ledger.getAccount(1)->realizedPnl, 7500);
+    EXPECT_EQ(ledger.getAccount(2)->realizedPnl, -7500);
+}
+
+TEST_F(LedgerTest, FlipThroughZero_ClosesThenOpensAtFillPrice) {
+    trade("AAPL", 10000, 10, 1, Side::BUY, 2);
+    trade("AAPL", 9000, 15, 2, Side::BUY, 1);     // trader 1 sells 15 as the resting side
+
+    auto position = ledger.getPosition(1, "AAPL");
+    EXPECT_EQ(position->quantity, -5);
+    EXPECT_EQ(position->costBasis, -45000);
+    EXPECT_EQ(position->realizedPnl, -10000);
+
+    trade("AAPL", 8000, 5, 1, Side::BUY, 2);      // cover the short
+    position = ledger.getPosition(1, "AAPL");
+    EXPECT_EQ(position->quantity, 0);
+    EXPECT_EQ(position->costBasis, 0);
+    EXPECT_EQ(position->realizedPnl, -10000 + 5000);
+    EXPECT_TRUE(ledger.getPositions(1).empty());
+
+    auto account = ledger.getAccount(1);
+    EXPECT_EQ(account->cash, 1000000 - 5000);
+    EXPECT_EQ(account->equity, account->cash);
+}
+
+TEST_F(LedgerTest, OpenAccount_DuplicateThrows) {
+    EXPECT_THROW(ledger.openAccount(1, 0), std::invalid_argument);
+}
@@ -0,0 +1,132 @@
+#include "gtest/gtest.h"
+#include "marketDataFeed.h"
+#include "feedClient.h"
+#include "matchingEngine.h"
+#include "orderBook.h"
+#include "eventDispatcher.h"
+#include "limitOrder.h"
+#include "marketOrder.h"
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+namespace {
+    std::vector<char> addPacket(std::uint64_t sequence, OrderID orderID, Side side, Price price, Quantity quantity) {
+        FeedPacketWriter writer(256);
+        writer.begin(sequence);
+        auto* add = writer.append<AddOrderMessage>(FeedMessageType::ADD_ORDER, static_cast<std::uint8_t>(side));
+        add->orderID = orderID;
+        add->price = price;
+        add->quantity = quantity;
+        std::memcpy(add->symbol, "ES", 2);
+        return {writer.data(), writer.data() + writer.size()};
+    }
+
+    std::vector<char> deletePacket(std::uint64_t sequence, OrderID orderID) {
+        FeedPacketWriter writer(256);
+        writer.begin(sequence);
+        writer.append<OrderDeleteMessage>(FeedMessageType::ORDER_DELETE)->orderID = orderID;
+        return {writer.data(), writer.data() + writer.size()};
+    }
+}
+
+TEST(FeedBookBuilderTest, AppliesIncrementalMessages) {
+    FeedBookBuilder builder;
+    FeedPacketWriter writer(1400);
+    writer.begin(1);
+    auto* add = writer.append<AddOrderMessage>(FeedMessageType::ADD_ORDER, static_cast<std::uint8_t>(Side::SELL));
+    *add = {add->header, 10100, 7, 50, 0, "ES"};
+    add = writer.append<AddOrderMessage>(FeedMessageType::ADD_ORDER, static_cast<std::uint8_t>(Side::BUY));
+    *add = {add->header, 9900, 8, 30, 0, "ES"};
+    auto* executed = writer.append<OrderExecutedMessage>(FeedMessageType::ORDER_EXECUTED);
+    executed->orderID = 7;
+    executed->quantity = 20;
+    auto* cancel = writer.append<OrderCancelMessage>(FeedMessageType::ORDER_CANCEL);
+    cancel->orderID = 8;
+    cancel->quantity = 10;
+    builder.onIncrementalPacket(writer.data(), writer.size());
+
+    EXPECT_TRUE(builder.isSynchronized());
+    EXPECT_EQ(builder.getSequence(), 4u);
+    EXPECT_EQ(builder.getBook().getBestAsk()->quantity, 30u);
+    EXPECT_EQ(builder.getBook().getBestBid()->price, 9900u);
+    EXPECT_EQ(builder.getBook().getBestBid()->quantity, 20u);
+
+    // Replayed packets are ignored
+    builder.onIncrementalPacket(writer.data(), writer.size());
+    EXPECT_EQ(builder.getBook().getBestAsk()->quantity, 30u);
+}
+
+TEST(FeedBookBuilderTest, RecoversFromGapViaSnapshot) {
+    FeedBookBuilder builder;
+    auto first = addPacket(1, 1, Side::BUY, 9900, 10);
+    builder.onIncrementalPacket(first.data(), first.size());
+
+    // Sequence 2 (an add of order 2) is lost
+    auto third = deletePacket(3, 1);
+    builder.onIncrementalPacket(third.data(), third.size());
+    EXPECT_FALSE(builder.isSynchronized());
+    EXPECT_EQ(builder.getGapCount(), 1u);
+    auto fourth = addPacket(4, 3, Side::SELL, 10100, 5);
+    builder.onIncrementalPacket(fourth.data(), fourth.size());
+
+    // Snapshot as of sequence 2: orders 1 and 2
+    FeedPacketWriter snapshot(1400);
+    snapshot.begin(2);
+    auto* start = snapshot.append<SnapshotStartMessage>(FeedMessageType::SNAPSHOT_START);
+    start->orderCount = 2;
+    start->sequence = 2;
+    auto* add = snapshot.append<AddOrderMessage>(FeedMessageType::ADD_ORDER, static_cast<std::uint8_t>(Side::BUY));
+    *add = {add->header, 9900, 1, 10, 0, "ES"};
+    add = snapshot.append<AddOrderMessage>(FeedMessageType::ADD_ORDER, static_cast<std::uint8_t>(Side::BUY));
+    *add = {add->header, 9800, 2, 15, 0, "ES"};
+    auto* end = snapshot.append<SnapshotEndMessage>(FeedMessageType::SNAPSHOT_END);
+    end->orderCount = 2;
+    end->sequence = 2;
+    builder.onSnapshotPacket(snapshot.data(), snapshot.size());
+
+    ASSERT_TRUE(builder.isSynchronized());
+    EXPECT_EQ(builder.getSequence(), 4u);
+    EXPECT_EQ(builder.getBook().orderCount(), 2u);
+    EXPECT_EQ(builder.getBook().getBestBid()->price, 9800u);
+    EXPECT_EQ(builder.getBook().getBestAsk()->price, 10100u);
+}
+
+TEST(MarketDataFeedTest, ClientRebuildsEngineBookOverLoopback) {
+    FeedConfig config;
+    config.snapshotInterval = std::chrono::milliseconds(0);
+    FeedClient client(config);
+    config.port = client.getPort();
+    config.snapshotPort = client.getSnapshotPort();
+
+    OrderBook book;
+    EventDispatcher dispatcher;
+    MatchingEngine engine(book, dispatcher);
+    MarketDataFeed feed(dispatcher, config);
+    feed.start();
+    engine.start();
+
+    engine.submitOrder(std::make_unique<LimitOrder>("ES", 0, OrderType::LIMIT, Side::SELL, "101.00", 50, 1));
+    engine.submitOrder(std::make_unique<LimitOrder>("ES", 0, OrderType::LIMIT, Side::SELL, "102.00", 40, 1));
+    OrderID bid = engine.submitOrder(std::make_unique<LimitOrder>("ES", 0, OrderType::LIMIT, Side::BUY, "99.00", 30, 2));
+    engine.submitOrder(std::make_unique<MarketOrder>("ES", 0, OrderType::MARKET, Side::BUY, 60, 3));
+    engine.cancelOrder(bid);
+    engine.submitOrder(std::make_unique<LimitOrder>("ES", 0, OrderType::LIMIT, Side::BUY, "98.00", 25, 2));
+    engine.stop();
+    feed.stop();
+
+    // add, add, add, exec 50 (delete by fill), exec 10, delete, add
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (client.getBuilder().getSequence() < feed.getSequence() && std::chrono::steady_clock::now() < deadline) {
+        client.poll(std::chrono::milliseconds(50));
+    }
+
+    EXPECT_EQ(feed.getSequence(), 7u);
+    ASSERT_EQ(client.getBuilder().getSequence(), 7u);
+    const FeedBook& replica = client.getBook();
+    EXPECT_EQ(replica.orderCount(), 2u);
+    EXPECT_EQ(replica.getBestAsk()->price, book.getBestAsk()->price);
+    EXPECT_EQ(replica.getBestAsk()->quantity, 30u);
+    EXPECT_EQ(replica.getBestBid()->price, book.getBestBid()->price);
+    EXPECT_EQ(replica.getBestBid()->quantity, 25u);
+}
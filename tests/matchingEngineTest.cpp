@@ -5,6 +5,7 @@
 #include "eventDispatcher.h"
 #include "limitOrder.h"
 #include "marketOrder.h"
+#include "threadTuning.h"
 #include "types.h"
 #include <memory>
 #include <vector>
@@ -12,6 +13,8 @@
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
+#include <sched.h>
+#include <system_error>
 
 class MockListener {
 private:
@@ -145,9 +148,6 @@ TEST_F(MatchingEngineTest, LimitOrder_PartialFill_ThenRests) {
 
     // Aggressing buy order for 15 shares at $100
     auto buyOrder = std::make_unique<LimitOrder>("AAPL", 0, OrderType::LIMIT, Side::BUY, "100.00", 15, 1);
-    // Get a raw pointer to check the order's state after submission.
-    // The engine takes ownership, so we can't use the unique_ptr after moving it.
-    Order* buyOrderPtr = buyOrder.get();
     submitOrderWithUnblock(std::move(buyOrder));
     
     listener.waitForEvents();
@@ -277,3 +277,414 @@ TEST_F(MatchingEngineTest, ConcurrentSubmissions_AreHandledSafely) {
     ASSERT_TRUE(bestAsk.has_value());
     EXPECT_EQ(bestAsk->quantity, 900); // 1000 - (10 * 10 * 1)
 }
+
+
+// --- Engine configuration ---
+
+TEST(MatchingEngineConfigTest, BusyPoll_MatchesOrders) {
+    OrderBook book;
+    EventDispatcher dispatcher;
+    EngineConfig config;
+    config.waitStrategy = WaitStrategy::BUSY_POLL;
+    config.expectedOrders = 1024;
+    MatchingEngine engine(book, dispatcher, config);
+
+    std::atomic<int> trades{0};
+    dispatcher.subscribe<TradeExecutedEvent>([&](const TradeExecutedEvent&) { trades++; });
+
+    engine.start();
+    engine.submitOrder(std::make_unique<LimitOrder>("AAPL", 0, OrderType::LIMIT, Side::SELL, "100.00", 10, 1));
+    engine.submitOrder(std::make_unique<LimitOrder>("AAPL", 0, OrderType::LIMIT, Side::BUY, "100.00", 4, 2));
+    engine.stop();
+
+    EXPECT_EQ(trades.load(), 1);
+    auto bestAsk = book.getBestAsk();
+    ASSERT_TRUE(bestAsk.has_value());
+    EXPECT_EQ(bestAsk->quantity, 6);
+}
+
+TEST(MatchingEngineConfigTest, PinnedEngine_RunsSubscribersOnThatCore) {
+    OrderBook book;
+    EventDispatcher dispatcher;
+    EngineConfig config;
+    config.matchingCore = 0;
+    MatchingEngine engine(book, dispatcher, config);
+
+    std::atomic<int> observedCore{-1};
+    dispatcher.subscribe<OrderCancelledEvent>([&](const OrderCancelledEvent&) { observedCore = sched_getcpu(); });
+
+    engine.start();
+    // A market order into an empty book is cancelled, which gives us a callback on the matching thread
+    engine.submitOrder(std::make_unique<MarketOrder>("AAPL", 0, OrderType::MARKET, Side::BUY, 10, 1));
+    engine.stop();
+
+    EXPECT_EQ(observedCore.load(), 0);
+}
+
+TEST(MatchingEngineConfigTest, BoundAndPrefaultedEngine_MatchesOrders) {
+    OrderBook book;
+    EventDispatcher dispatcher;
+    EngineConfig config;
+    config.matchingCore = 0;
+    config.bindMemory = true;
+    config.prefaultBytes = 8 << 20;
+    config.expectedOrders = 1024;
+    MatchingEngine engine(book, dispatcher, config);
+
+    std::atomic<int> trades{0};
+    dispatcher.subscribe<TradeExecutedEvent>([&](const TradeExecutedEvent&) { trades++; });
+
+    engine.start();
+    engine.submitOrder(std::make_unique<LimitOrder>("AAPL", 0, OrderType::LIMIT, Side::SELL, "100.00", 10, 1));
+    engine.submitOrder(std::make_unique<LimitOrder>("AAPL", 0, OrderType::LIMIT, Side::BUY, "100.00", 10, 2));
+    engine.stop();
+
+    EXPECT_EQ(trades.load(), 1);
+    EXPECT_EQ(numaNodeOfCore(0), 0);
+}
+
+TEST(MatchingEngineConfigTest, BindMemoryWithoutCore_ThrowsFromStart) {
+    OrderBook book;
+    EventDispatcher dispatcher;
+    EngineConfig config;
+    config.bindMemory = true;
+    MatchingEngine engine(book, dispatcher, config);
+
+    EXPECT_THROW(engine.start(), std::invalid_argument);
+}
+
+TEST(MatchingEngineConfigTest, UnavailableCore_ThrowsFromStart) {
+    OrderBook book;
+    EventDispatcher dispatcher;
+    EngineConfig config;
+    config.matchingCore = CPU_SETSIZE - 1;
+    MatchingEngine engine(book, dispatcher, config);
+
+    EXPECT_THROW(engine.start(), std::system_error);
+    EXPECT_NO_THROW(engine.stop());
+}
+
+
+// --- Self-trade prevention and risk checks ---
+
+class SelfTradeTest : public ::testing::Test {
+protected:
+    OrderBook book;
+    EventDispatcher dispatcher;
+    std::vector<TradeExecutedEvent> trades;
+    std::vector<OrderCancelledEvent> cancellations;
+    std::vector<OrderRejectedEvent> rejections;
+
+    void SetUp() override {
+        dispatcher.subscribe<TradeExecutedEvent>([this](const TradeExecutedEvent& e) { trades.push_back(e); });
+        dispatcher.subscribe<OrderCancelledEvent>([this](const OrderCancelledEvent& e) { cancellations.push_back(e); });
+        dispatcher.subscribe<OrderRejectedEvent>([this](const OrderRejectedEvent& e) { rejections.push_back(e); });
+    }
+
+    EngineConfig withMode(SelfTradePrevention mode) {
+        EngineConfig config;
+        config.selfTradePrevention = mode;
+        return config;
+    }
+
+    // Trader 7 rests 10 then 5 at $100, trader 8 rests 5 behind them, and trader 7 buys 12
+    OrderID runScenario(MatchingEngine& engine) {
+        engine.start();
+        engine.submitOrder(std::make_unique<LimitOrder>("AAPL", 0, OrderType::LIMIT, Side::SELL, "100.00", 10, 7));
+        engine.submitOrder(std::make_unique<LimitOrder>("AAPL", 0, OrderType::LIMIT, Side::SELL, "100.00", 5, 8));
+        OrderID buyID = engine.submitOrder(std::make_unique<LimitOrder>("AAPL", 0, OrderType::LIMIT, Side::BUY, "100.00", 12, 7));
+        engine.stop();
+        return buyID;
+    }
+};
+
+TEST_F(SelfTradeTest, None_AllowsSelfTrade) {
+    MatchingEngine engine(book, dispatcher, withMode(SelfTradePrevention::NONE));
+    runScenario(engine);
+
+    ASSERT_EQ(trades.size(), 2u);
+    EXPECT_EQ(trades[0].restingTraderID, 7u);
+    EXPECT_EQ(trades[0].aggressingTraderID, 7u);
+}
+
+TEST_F(SelfTradeTest, CancelResting_SkipsOwnOrders) {
+    MatchingEngine engine(book, dispatcher, withMode(SelfTradePrevention::CANCEL_RESTING));
+    OrderID buyID = runScenario(engine);
+
+    ASSERT_EQ(cancellations.size(), 1u);
+    EXPECT_EQ(cancellations[0].orderID, 1u);
+    EXPECT_EQ(cancellations[0].quantity, 10u);
+
+    ASSERT_EQ(trades.size(), 1u);
+    EXPECT_EQ(trades[0].restingTraderID, 8u);
+    EXPECT_EQ(trades[0].quantity, 5u);
+
+    // The remaining 7 of the buy rest on the book
+    auto bestBid = book.getBestBid();
+    ASSERT_TRUE(bestBid.has_value());
+    EXPECT_EQ(bestBid->quantity, 7u);
+    EXPECT_NE(book.getOrder(buyID), nullptr);
+    EXPECT_FALSE(book.getBestAsk().has_value());
+}
+
+TEST_F(SelfTradeTest, CancelAggressor_LeavesBookUntouched) {
+    MatchingEngine engine(book, dispatcher, withMode(SelfTradePrevention::CANCEL_AGGRESSOR));
+    OrderID buyID = runScenario(engine);
+
+    EXPECT_TRUE(trades.empty());
+    ASSERT_EQ(cancellations.size(), 1u);
+    EXPECT_EQ(cancellations[0].orderID, buyID);
+    EXPECT_EQ(cancellations[0].quantity, 12u);
+
+    EXPECT_FALSE(book.getBestBid().has_value());
+    auto bestAsk = book.getBestAsk();
+    ASSERT_TRUE(bestAsk.has_value());
+    EXPECT_EQ(bestAsk->quantity, 15u);
+}
+
+TEST_F(SelfTradeTest, DecrementBoth_ReducesWithoutTrading) {
+    MatchingEngine engine(book, dispatcher, withMode(SelfTradePrevention::DECREMENT_BOTH));
+    OrderID buyID = runScenario(engine);
+
+    // 10 of the buy's 12 cancel against trader 7's own ask; the other 2 trade with trader 8
+    ASSERT_EQ(cancellations.size(), 2u);
+    EXPECT_EQ(cancellations[0].orderID, 1u);
+    EXPECT_EQ(cancellations[0].remaining, 0u);
+    EXPECT_EQ(cancellations[1].orderID, buyID);
+    EXPECT_EQ(cancellations[1].quantity, 10u);
+    EXPECT_EQ(cancellations[1].remaining, 2u);
+
+    ASSERT_EQ(trades.size(), 1u);
+    EXPECT_EQ(trades[0].restingTraderID, 8u);
+    EXPECT_EQ(trades[0].quantity, 2u);
+    EXPECT_EQ(trades[0].restingRemainingQuantity, 3u);
+
+    EXPECT_FALSE(book.getBestBid().has_value());
+    auto bestAsk = book.getBestAsk();
+    ASSERT_TRUE(bestAsk.has_value());
+    EXPECT_EQ(bestAsk->quantity, 3u);
+}
+
+TEST_F(SelfTradeTest, RiskCheck_RejectsBeforeMatching) {
+    EngineConfig config;
+    config.defaultRiskLimits.maxOrderQuantity = 10;
+    config.defaultRiskLimits.maxOpenOrders = 1;
+    MatchingEngine engine(book, dispatcher, config);
+
+    engine.start();
+    engine.submitOrder(std::make_unique<LimitOrder>("AAPL", 0, OrderType::LIMIT, Side::SELL, "100.00", 10, 1));
+    OrderID tooMany = engine.submitOrder(std::make_unique<LimitOrder>("AAPL", 0, OrderType::LIMIT, Side::SELL, "101.00", 10, 1));
+    OrderID tooBig = engine.submitOrder(std::make_unique<LimitOrder>("AAPL", 0, OrderType::LIMIT, Side::BUY, "100.00", 11, 2));
+    engine.submitOrder(std::make_unique<LimitOrder>("AAPL", 0, OrderType::LIMIT, Side::BUY, "100.00", 10, 2));
+    engine.stop();
+
+    ASSERT_EQ(rejections.size(), 2u);
+    EXPECT_EQ(rejections[0].orderID, tooMany);
+    EXPECT_EQ(rejections[0].reason, RejectReason::OPEN_ORDER_LIMIT);
+    EXPECT_EQ(rejections[1].orderID, tooBig);
+    EXPECT_EQ(rejections[1].reason, RejectReason::ORDER_SIZE);
+
+    ASSERT_EQ(trades.size(), 1u);
+    EXPECT_EQ(engine.getRiskManager().getPosition(1), -10);
+    EXPECT_EQ(engine.getRiskManager().getPosition(2), 10);
+    EXPECT_EQ(engine.getRiskManager().getOpenOrders(1), 0u);
+}
+
+TEST_F(SelfTradeTest, MassCancel_PublishesOneBatchedEvent) {
+    EngineConfig config;
+    config.defaultRiskLimits.maxOpenOrders = 10;
+    MatchingEngine engine(book, dispatcher, config);
+    std::vector<MassCancelEvent> massCancels;
+    dispatcher.subscribe<MassCancelEvent>([&](const MassCancelEvent& e) { massCancels.push_back(e); });
+
+    engine.start();
+    for (int i = 0; i < 3; ++i) {
+        engine.submitOrder(std::make_unique<LimitOrder>("AAPL", 0, OrderType::LIMIT, Side::BUY, "99.00", 10, 1));
+        engine.submitOrder(std::make_unique<LimitOrder>("AAPL", 0, OrderType::LIMIT, Side::SELL, "101.00", 10, 1));
+    }
+    engine.submitOrder(std::make_unique<LimitOrder>("AAPL", 0, OrderType::LIMIT, Side::BUY, "98.00", 10, 2));
+    engine.massCancel(1, Side::SELL);
+    engine.massCancel(1);
+    engine.stop();
+
+    ASSERT_EQ(massCancels.size(), 2u);
+    EXPECT_EQ(massCancels[0].cancelled.size(), 3u);
+    EXPECT_EQ(massCancels[1].cancelled.size(), 3u);
+    EXPECT_TRUE(cancellations.empty());
+    EXPECT_EQ(engine.getRiskManager().getOpenOrders(1), 0u);
+
+    auto bestBid = book.getBestBid();
+    ASSERT_TRUE(bestBid.has_value());
+    EXPECT_EQ(bestBid->price, 9800);
+    EXPECT_FALSE(book.getBestAsk().has_value());
+}
+
+TEST_F(SelfTradeTest, Auction_AccumulatesThenUncrossesInOneBurst) {
+    MatchingEngine engine(book, dispatcher);
+    std::vector<AuctionUncrossEvent> uncrosses;
+    std::size_t tradesBeforeUncross = 0;
+    dispatcher.subscribe<AuctionUncrossEvent>([&](const AuctionUncrossEvent& e) {
+        tradesBeforeUncross = trades.size();
+        uncrosses.push_back(e);
+    });
+
+    engine.start();
+    engine.beginAuction();
+    engine.submitOrder(std::make_unique<LimitOrder>("AAPL", 0, OrderType::LIMIT, Side::BUY, "102.00", 10, 1));
+    engine.submitOrder(std::make_unique<LimitOrder>("AAPL", 0, OrderType::LIMIT, Side::BUY, "101.00", 20, 1));
+    engine.submitOrder(std::make_unique<LimitOrder>("AAPL", 0, OrderType::LIMIT, Side::BUY, "100.00", 30, 1));
+    engine.submitOrder(std::make_unique<LimitOrder>("AAPL", 0, OrderType::LIMIT, Side::SELL, "99.00", 15, 2));
+    engine.submitOrder(std::make_unique<LimitOrder>("AAPL", 0, OrderType::LIMIT, Side::SELL, "100.00", 15, 2));
+    engine.submitOrder(std::make_unique<LimitOrder>("AAPL", 0, OrderType::LIMIT, Side::SELL, "101.00", 25, 2));
+    engine.uncross();
+    // Continuous matching resumes after the uncross
+    engine.submitOrder(std::make_unique<LimitOrder>("AAPL", 0, OrderType::LIMIT, Side::SELL, "100.00", 5, 3));
+    engine.stop();
+
+    ASSERT_EQ(uncrosses.size(), 1u);
+    EXPECT_EQ(uncrosses[0].price, 10100);
+    EXPECT_EQ(uncrosses[0].volume, 30u);
+    EXPECT_EQ(tradesBeforeUncross, 3u);
+
+    ASSERT_EQ(trades.size(), 4u);
+    Quantity auctionVolume = 0;
+    for (std::size_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(trades[i].price, 10100);
+        EXPECT_EQ(trades[i].aggressingSide, Side::BUY);
+        auctionVolume += trades[i].quantity;
+    }
+    EXPECT_EQ(auctionVolume, 30u);
+    EXPECT_EQ(trades[3].price, 10000);
+    EXPECT_EQ(trades[3].quantity, 5u);
+
+    auto bestBid = book.getBestBid();
+    auto bestAsk = book.getBestAsk();
+    ASSERT_TRUE(bestBid && bestAsk);
+    EXPECT_EQ(bestBid->price, 10000);
+    EXPECT_EQ(bestBid->quantity, 25u);
+    EXPECT_EQ(bestAsk->price, 10100);
+    EXPECT_EQ(bestAsk->quantity, 25u);
+}
+
+TEST_F(SelfTradeTest, Auction_UncrossWithoutCross_PublishesEmptyResult) {
+    MatchingEngine engine(book, dispatcher);
+    std::vector<AuctionUncrossEvent> uncrosses;
+    dispatcher.subscribe<AuctionUncrossEvent>([&](const AuctionUncrossEvent& e) { uncrosses.push_back(e); });
+
+    engine.start();
+    engine.beginAuction();
+    engine.submitOrder(std::make_unique<LimitOrder>("AAPL", 0, OrderType::LIMIT, Side::BUY, "99.00", 10, 1));
+    engine.uncross();
+    engine.stop();
+
+    ASSERT_EQ(uncrosses.size(), 1u);
+    EXPECT_EQ(uncrosses[0].volume, 0u);
+    EXPECT_TRUE(trades.empty());
+}
+
+
+class TimeInForceTest : public SelfTradeTest {
+protected:
+    // 2024-01-02 14:30 UTC
+    static constexpr Timestamp OPEN{std::chrono::milliseconds(1'704'205'800'000)};
+
+    static std::unique_ptr<LimitOrder> order(Side side, const str& price, Quantity quantity, TraderID trader,
+                                             TimeInForce tif = TimeInForce::GTC, Timestamp expireTime = {}) {
+        auto o = std::make_unique<LimitOrder>("AAPL", 0, OrderType::LIMIT, side, price, quantity, trader);
+        o->setTimeInForce(tif);
+        o->setExpireTime(expireTime);
+        return o;
+    }
+};
+
+TEST_F(TimeInForceTest, GoodTillDate_ExpiresWithACancelOnceTheClockPassesIt) {
+    MatchingEngine engine(book, dispatcher);
+    engine.setTime(OPEN);
+    OrderID gtd = engine.submitOrder(order(Side::SELL, "100.00", 10, 1, TimeInForce::GTD, OPEN + std::chrono::minutes(5)));
+    OrderID gtc = engine.submitOrder(order(Side::SELL, "101.00", 10, 1));
+    engine.submitOrder(order(Side::BUY, "100.00", 4, 2));
+    engine.runPending();
+    EXPECT_EQ(book.scheduledExpiries(), 1u);
+
+    engine.setTime(OPEN + std::chrono::minutes(5) - std::chrono::milliseconds(1));
+    engine.runPending();
+    EXPECT_TRUE(cancellations.empty());
+
+    engine.setTime(OPEN + std::chrono::minutes(5));
+    engine.runPending();
+    ASSERT_EQ(cancellations.size(), 1u);
+    EXPECT_EQ(cancellations[0].orderID, gtd);
+    EXPECT_EQ(cancellations[0].quantity, 6u);
+    EXPECT_EQ(book.getOrder(gtd), nullptr);
+    EXPECT_NE(book.getOrder(gtc), nullptr);
+    EXPECT_EQ(book.scheduledExpiries(), 0u);
+}
+
+TEST_F(TimeInForceTest, Day_ExpiresAtTheNextSessionClose) {
+    EngineConfig config;
+    config.sessionClose = std::chrono::hours(21);
+    MatchingEngine engine(book, dispatcher, config);
+    engine.setTime(OPEN);
+    OrderID today = engine.submitOrder(order(Side::BUY, "99.00", 10, 1, TimeInForce::DAY));
+    engine.setTime(OPEN + std::chrono::hours(7));   // after the close, so it lives until tomorrow's
+    OrderID tomorrow = engine.submitOrder(order(Side::BUY, "98.00", 10, 1, TimeInForce::DAY));
+    engine.runPending();
+
+    ASSERT_EQ(cancellations.size(), 1u);
+    EXPECT_EQ(cancellations[0].orderID, today);
+    EXPECT_EQ(book.getOrder(today), nullptr);
+
+    engine.setTime(OPEN + std::chrono::hours(24 + 6) + std::chrono::minutes(30));
+    engine.runPending();
+    ASSERT_EQ(cancellations.size(), 2u);
+    EXPECT_EQ(cancellations[1].orderID, tomorrow);
+    EXPECT_TRUE(book.isEmpty());
+}
+
+TEST_F(TimeInForceTest, AlreadyExpired_TradesButNeverRests) {
+    MatchingEngine engine(book, dispatcher);
+    engine.setTime(OPEN);
+    engine.submitOrder(order(Side::SELL, "100.00", 5, 1));
+    OrderID late = engine.submitOrder(order(Side::BUY, "100.00", 8, 2, TimeInForce::GTD, OPEN - std::chrono::seconds(1)));
+    engine.runPending();
+
+    ASSERT_EQ(trades.size(), 1u);
+    EXPECT_EQ(trades[0].quantity, 5u);
+    ASSERT_EQ(cancellations.size(), 1u);
+    EXPECT_EQ(cancellations[0].orderID, late);
+    EXPECT_EQ(cancellations[0].quantity, 3u);
+    EXPECT_TRUE(book.isEmpty());
+}
+
+TEST_F(TimeInForceTest, FilledAndCancelledOrders_LeaveTheWheel) {
+    MatchingEngine engine(book, dispatcher);
+    engine.setTime(OPEN);
+    const Timestamp deadline = OPEN + std::chrono::hours(1);
+    engine.submitOrder(order(Side::SELL, "100.00", 5, 1, TimeInForce::GTD, deadline));
+    OrderID cancelled = engine.submitOrder(order(Side::SELL, "101.00", 5, 1, TimeInForce::GTD, deadline));
+    engine.submitOrder(order(Side::SELL, "102.00", 5, 3, TimeInForce::GTD, deadline));
+    engine.submitOrder(order(Side::BUY, "100.00", 5, 2));
+    engine.cancelOrder(cancelled);
+    engine.massCancel(3);
+    engine.runPending();
+
+    EXPECT_EQ(book.scheduledExpiries(), 0u);
+    engine.setTime(deadline);
+    engine.runPending();
+    EXPECT_EQ(cancellations.size(), 1u);
+}
+
+TEST_F(TimeInForceTest, WallClock_ExpiresOnTheMatchingThreadWhileIdle) {
+    MatchingEngine engine(book, dispatcher);
+    std::atomic<int> expired{0};
+    dispatcher.subscribe<OrderCancelledEvent>([&](const OrderCancelledEvent&) { expired++; });
+
+    engine.start();
+    const Timestamp now = std::chrono::time_point_cast<std::chrono::milliseconds>(std::chrono::system_clock::now());
+    engine.submitOrder(order(Side::BUY, "99.00", 10, 1, TimeInForce::GTD, now + std::chrono::milliseconds(20)));
+    for (int i = 0; i < 500 && expired == 0; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    engine.stop();
+
+    EXPECT_EQ(expired, 1);
+    EXPECT_TRUE(book.isEmpty());
+}
@@ -0,0 +1,69 @@
+#include "gtest/gtest.h"
+#include "matchingPolicy.h"
+#include "matchingEngine.h"
+#include "orderBook.h"
+#include "marketOrder.h"
+
+class MatchingPolicyTest : public ::testing::Test {
+protected:
+    OrderBook book;
+    std::vector<LevelFill> fills;
+
+    // Three sells at $100 of 10, 20 and 30, oldest first
+    void SetUp() override {
+        book.addOrder(std::make_unique<LimitOrder>("ES", 1, OrderType::LIMIT, Side::SELL, "100.00", 10, 1));
+        book.addOrder(std::make_unique<LimitOrder>("ES", 2, OrderType::LIMIT, Side::SELL, "100.00", 20, 2));
+        book.addOrder(std::make_unique<LimitOrder>("ES", 3, OrderType::LIMIT, Side::SELL, "100.00", 30, 3));
+    }
+
+    template<typename Policy>
+    std::vector<std::pair<OrderID, Quantity>> allocate(Quantity incoming) {
+        fills.clear();
+        Policy::allocate(book, *book.getBestAsk(), incoming, fills);
+        std::vector<std::pair<OrderID, Quantity>> result;
+        for (const LevelFill& fill : fills) result.emplace_back(fill.order->getOrderID(), fill.quantity);
+        return result;
+    }
+
+    using Allocation = std::vector<std::pair<OrderID, Quantity>>;
+};
+
+TEST_F(MatchingPolicyTest, Fifo_FillsOldestFirst) {
+    EXPECT_EQ(allocate<FifoMatching>(25), (Allocation{{1, 10}, {2, 15}}));
+    EXPECT_EQ(allocate<FifoMatching>(100), (Allocation{{1, 10}, {2, 20}, {3, 30}}));
+}
+
+TEST_F(MatchingPolicyTest, ProRata_SplitsBySizeAndRoundsToTimePriority) {
+    // 25 * {10, 20, 30} / 60 floors to {4, 8, 12}; the spare lot goes to the oldest order
+    EXPECT_EQ(allocate<ProRataMatching>(25), (Allocation{{1, 5}, {2, 8}, {3, 12}}));
+    EXPECT_EQ(allocate<ProRataMatching>(1), (Allocation{{1, 1}}));
+    EXPECT_EQ(allocate<ProRataMatching>(100), (Allocation{{1, 10}, {2, 20}, {3, 30}}));
+}
+
+TEST_F(MatchingPolicyTest, TopOrderProRata_FillsTopThenSplitsRest) {
+    // The top order takes 10, then 15 * {20, 30} / 50
+    EXPECT_EQ(allocate<TopOrderProRataMatching>(25), (Allocation{{1, 10}, {2, 6}, {3, 9}}));
+    EXPECT_EQ(allocate<TopOrderProRataMatching>(4), (Allocation{{1, 4}}));
+}
+
+TEST(MatchingPolicyEngineTest, ProRataEngine_TradesAcrossTheLevel) {
+    OrderBook book;
+    EventDispatcher dispatcher;
+    std::vector<TradeExecutedEvent> trades;
+    dispatcher.subscribe<TradeExecutedEvent>([&](const TradeExecutedEvent& e) { trades.push_back(e); });
+
+    ProRataMatchingEngine engine(book, dispatcher);
+    engine.start();
+    engine.submitOrder(std::make_unique<LimitOrder>("ES", 0, OrderType::LIMIT, Side::SELL, "100.00", 10, 1));
+    engine.submitOrder(std::make_unique<LimitOrder>("ES", 0, OrderType::LIMIT, Side::SELL, "100.00", 20, 2));
+    engine.submitOrder(std::make_unique<LimitOrder>("ES", 0, OrderType::LIMIT, Side::SELL, "100.00", 30, 3));
+    engine.submitOrder(std::make_unique<MarketOrder>("ES", 0, OrderType::MARKET, Side::BUY, 25, 4));
+    engine.stop();
+
+    ASSERT_EQ(trades.size(), 3u);
+    EXPECT_EQ(trades[0].quantity, 5u);
+    EXPECT_EQ(trades[1].quantity, 8u);
+    EXPECT_EQ(trades[2].quantity, 12u);
+    EXPECT_EQ(trades[2].aggressingRemainingQuantity, 0u);
+    EXPECT_EQ(book.getBestAsk()->quantity, 35u);
+}
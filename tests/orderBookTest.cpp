@@ -5,6 +5,9 @@
 #include "types.h"
 #include <memory> // Required for std::unique_ptr
 #include <optional> // Required for std::optional
+#include <atomic>
+#include <random>
+#include <thread>
 
 // Test fixture for the OrderBook class
 class OrderBookTest : public ::testing::Test {
@@ -146,4 +149,230 @@ TEST_F(OrderBookTest, ReduceOrderQuantity_FullFill) {
     auto bestBid = ob->getBestBid();
     ASSERT_TRUE(bestBid.has_value());
     EXPECT_EQ(bestBid->quantity, 5);
-}
\ No newline at end of file
+}
+// Mass cancel by trader only touches that trader's orders
+TEST_F(OrderBookTest, CancelTraderOrders_RemovesOnlyThatTrader) {
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 1, OrderType::LIMIT, Side::BUY, "100.00", 10, 1));
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 2, OrderType::LIMIT, Side::BUY, "100.00", 5, 2));
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 3, OrderType::LIMIT, Side::SELL, "101.00", 7, 1));
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 4, OrderType::LIMIT, Side::SELL, "102.00", 3, 2));
+
+    std::vector<CancelledOrder> cancelled;
+    ob->cancelTraderOrders(1, std::nullopt, cancelled);
+
+    ASSERT_EQ(cancelled.size(), 2u);
+    EXPECT_EQ(ob->getOrder(1), nullptr);
+    EXPECT_EQ(ob->getOrder(3), nullptr);
+    EXPECT_NE(ob->getOrder(2), nullptr);
+    EXPECT_NE(ob->getOrder(4), nullptr);
+
+    auto bestBid = ob->getBestBid();
+    ASSERT_TRUE(bestBid.has_value());
+    EXPECT_EQ(bestBid->quantity, 5);
+    auto bestAsk = ob->getBestAsk();
+    ASSERT_TRUE(bestAsk.has_value());
+    EXPECT_EQ(bestAsk->price, 10200);
+
+    // A second pass finds nothing left for trader 1
+    cancelled.clear();
+    ob->cancelTraderOrders(1, std::nullopt, cancelled);
+    EXPECT_TRUE(cancelled.empty());
+}
+
+TEST_F(OrderBookTest, CancelTraderOrders_BySide) {
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 1, OrderType::LIMIT, Side::BUY, "100.00", 10, 1));
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 2, OrderType::LIMIT, Side::BUY, "99.00", 10, 1));
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 3, OrderType::LIMIT, Side::SELL, "101.00", 7, 1));
+
+    std::vector<CancelledOrder> cancelled;
+    ob->cancelTraderOrders(1, Side::BUY, cancelled);
+
+    ASSERT_EQ(cancelled.size(), 2u);
+    EXPECT_FALSE(ob->getBestBid().has_value());
+    EXPECT_NE(ob->getOrder(3), nullptr);
+
+    // Orders removed individually are unlinked too
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 4, OrderType::LIMIT, Side::SELL, "102.00", 1, 1));
+    ob->removeOrder(3);
+    cancelled.clear();
+    ob->cancelTraderOrders(1, std::nullopt, cancelled);
+    ASSERT_EQ(cancelled.size(), 1u);
+    EXPECT_EQ(cancelled[0].orderID, 4u);
+    EXPECT_TRUE(ob->isEmpty());
+}
+
+TEST_F(OrderBookTest, CancelSymbolAndAll_ClearMatchingOrders) {
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 1, OrderType::LIMIT, Side::BUY, "100.00", 10, 1));
+    ob->addOrder(std::make_unique<LimitOrder>("MSFT", 2, OrderType::LIMIT, Side::BUY, "100.00", 5, 2));
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 3, OrderType::LIMIT, Side::SELL, "101.00", 7, 3));
+
+    std::vector<CancelledOrder> cancelled;
+    ob->cancelSymbolOrders("AAPL", cancelled);
+    EXPECT_EQ(cancelled.size(), 2u);
+    EXPECT_NE(ob->getOrder(2), nullptr);
+
+    cancelled.clear();
+    ob->cancelAllOrders(cancelled);
+    EXPECT_EQ(cancelled.size(), 1u);
+    EXPECT_TRUE(ob->isEmpty());
+    EXPECT_FALSE(ob->getBestBid().has_value());
+
+    // The book is fully usable after a wholesale clear
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 5, OrderType::LIMIT, Side::BUY, "100.00", 1, 2));
+    cancelled.clear();
+    ob->cancelTraderOrders(2, std::nullopt, cancelled);
+    EXPECT_EQ(cancelled.size(), 1u);
+}
+
+TEST_F(OrderBookTest, ComputeUncross_NotCrossed_ReturnsNullopt) {
+    EXPECT_FALSE(ob->computeUncross().has_value());
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 1, OrderType::LIMIT, Side::BUY, "99.00", 10, 1));
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 2, OrderType::LIMIT, Side::SELL, "100.00", 10, 2));
+    EXPECT_FALSE(ob->computeUncross().has_value());
+}
+
+TEST_F(OrderBookTest, ComputeUncross_MaximizesVolumeThenMinimizesImbalance) {
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 1, OrderType::LIMIT, Side::BUY, "102.00", 10, 1));
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 2, OrderType::LIMIT, Side::BUY, "101.00", 20, 1));
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 3, OrderType::LIMIT, Side::BUY, "100.00", 30, 1));
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 4, OrderType::LIMIT, Side::SELL, "99.00", 15, 2));
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 5, OrderType::LIMIT, Side::SELL, "100.00", 15, 2));
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 6, OrderType::LIMIT, Side::SELL, "101.00", 25, 2));
+
+    // 100.00 and 101.00 both execute 30; 101.00 leaves the smaller imbalance
+    auto result = ob->computeUncross();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->price, 10100);
+    EXPECT_EQ(result->volume, 30u);
+    EXPECT_EQ(result->imbalance, -25);
+}
+
+TEST_F(OrderBookTest, ComputeUncross_BalancedTie_TakesMidpoint) {
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 1, OrderType::LIMIT, Side::BUY, "101.00", 10, 1));
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 2, OrderType::LIMIT, Side::SELL, "99.00", 10, 2));
+
+    auto result = ob->computeUncross();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->price, 10000);
+    EXPECT_EQ(result->volume, 10u);
+    EXPECT_EQ(result->imbalance, 0);
+}
+
+TEST_F(OrderBookTest, ComputeUncross_MixedSignTie_SettlesBetweenTheSurpluses) {
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 1, OrderType::LIMIT, Side::BUY, "101.00", 10, 1));
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 2, OrderType::LIMIT, Side::BUY, "99.00", 5, 1));
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 3, OrderType::LIMIT, Side::SELL, "99.00", 10, 2));
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 4, OrderType::LIMIT, Side::SELL, "101.00", 5, 2));
+
+    // 99.00 leaves 5 to buy and 101.00 leaves 5 to sell; in between both sides fill exactly
+    auto result = ob->computeUncross();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->price, 10000);
+    EXPECT_EQ(result->volume, 10u);
+    EXPECT_EQ(result->imbalance, 0);
+}
+
+TEST_F(OrderBookTest, Analytics_TrackTopQueueAndDepthWindow) {
+    ob->setAnalyticsDepth(2);
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 1, OrderType::LIMIT, Side::BUY, 10000, 10, 1));
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 2, OrderType::LIMIT, Side::BUY, 10000, 20, 2));
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 3, OrderType::LIMIT, Side::BUY, 9998, 5, 1));
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 4, OrderType::LIMIT, Side::BUY, 9997, 7, 1));   // outside the window
+    ob->addOrder(std::make_unique<LimitOrder>("AAPL", 5, OrderType::LIMIT, Side::SELL, 10001, 10, 2));
+
+    BookAnalytics a = ob->getAnalytics();
+    EXPECT_EQ(a.bidPrice, 10000u);
+    EXPECT_EQ(a.bidQuantity, 30u);
+    EXPECT_EQ(a.bidOrders, 2u);
+    EXPECT_EQ(a.bidDepth, 35u);
+    EXPECT_EQ(a.askDepth, 10u);
+    EXPECT_DOUBLE_EQ(a.imbalance(), 0.5);
+    EXPECT_DOUBLE_EQ(a.microprice(), (10000.0 * 10 + 10001.0 * 30) / 40);
+
+    // A partial fill at the top shrinks the queue quantity; the best moving pulls the window down
+    ob->reduceOrderQuantity(1, 10);
+    a = ob->getAnalytics();
+    EXPECT_EQ(a.bidQuantity, 20u);
+    EXPECT_EQ(a.bidOrders, 1u);
+    EXPECT_EQ(a.bidDepth, 25u);
+
+    ob->cancelOrder(2);
+    a = ob->getAnalytics();
+    EXPECT_EQ(a.bidPrice, 9998u);
+    EXPECT_EQ(a.bidDepth, 12u);
+
+    std::vector<CancelledOrder> cancelled;
+    ob->cancelAllOrders(cancelled);
+    a = ob->getAnalytics();
+    EXPECT_EQ(a.bidPrice, 0u);
+    EXPECT_EQ(a.askDepth, 0u);
+    EXPECT_EQ(a.depthTicks, 2u);
+    EXPECT_DOUBLE_EQ(a.microprice(), 0.0);
+}
+
+TEST_F(OrderBookTest, Analytics_ReadersSeeConsistentSnapshotsWhileBookChanges) {
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    std::thread reader([&] {
+        while (!done.load()) {
+            BookAnalytics a = ob->getAnalytics();
+            // Written together, so a torn read would break these
+            if ((a.bidQuantity == 0) != (a.bidOrders == 0) || a.bidDepth < a.bidQuantity || a.bidQuantity != a.bidOrders * 3u) torn++;
+        }
+    });
+
+    for (OrderID id = 1; id <= 20000; ++id) {
+        ob->addOrder(std::make_unique<LimitOrder>("AAPL", id, OrderType::LIMIT, Side::BUY, 10000 + id % 7, 3, 1));
+        if (id % 3 == 0) ob->cancelOrder(id - 1);
+    }
+    done = true;
+    reader.join();
+    EXPECT_EQ(torn.load(), 0);
+}
+
+TEST_F(OrderBookTest, Analytics_MatchDepthRecomputedFromScratch) {
+    ob->setAnalyticsDepth(3);
+    std::mt19937 rng(11);
+    std::vector<OrderID> live;
+    for (OrderID id = 1; id <= 5000; ++id) {
+        switch (rng() % 3) {
+            case 0:
+                if (!live.empty()) {
+                    std::size_t i = rng() % live.size();
+                    ob->cancelOrder(live[i]);
+                    live.erase(live.begin() + i);
+                    break;
+                }
+                [[fallthrough]];
+            case 1: {
+                const Side side = rng() % 2 ? Side::BUY : Side::SELL;
+                const Price price = side == Side::BUY ? 9990 + rng() % 10 : 10000 + rng() % 10;
+                ob->addOrder(std::make_unique<LimitOrder>("AAPL", id, OrderType::LIMIT, side, price, 1 + rng() % 20, 1));
+                live.push_back(id);
+                break;
+            }
+            default:
+                if (!live.empty()) {
+                    std::size_t i = rng() % live.size();
+                    Quantity quantity = ob->getOrder(live[i])->getQuantity();
+                    Quantity fill = 1 + rng() % quantity;
+                    ob->reduceOrderQuantity(live[i], fill);
+                    if (fill == quantity) live.erase(live.begin() + i);
+                }
+        }
+
+        BookAnalytics a = ob->getAnalytics();
+        for (Side side : {Side::BUY, Side::SELL}) {
+            std::vector<LevelSnapshot> levels = ob->depth(side);
+            std::uint64_t depth = 0;
+            for (const LevelSnapshot& level : levels) {
+                if (level.price + 3 >= levels.front().price && level.price <= levels.front().price + 3) depth += level.quantity;
+            }
+            const bool buy = side == Side::BUY;
+            ASSERT_EQ(buy ? a.bidDepth : a.askDepth, depth) << "after order " << id;
+            ASSERT_EQ(buy ? a.bidPrice : a.askPrice, levels.empty() ? 0 : levels.front().price);
+            ASSERT_EQ(buy ? a.bidQuantity : a.askQuantity, levels.empty() ? 0 : levels.front().quantity);
+            ASSERT_EQ(buy ? a.bidOrders : a.askOrders, levels.empty() ? 0 : levels.front().orders.size());
+        }
+    }
+}
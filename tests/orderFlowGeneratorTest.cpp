@@ -0,0 +1,142 @@
+#include "gtest/gtest.h"
+#include "orderFlowGenerator.h"
+#include "matchingEngine.h"
+#include "orderBook.h"
+#include "eventDispatcher.h"
+#include "events.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <map>
+
+class OrderFlowGeneratorTest : public ::testing::Test {
+protected:
+    OrderFlowConfig config;
+    std::string tempPath;
+
+    void SetUp() override {
+        config.seed = 7;
+        config.numTraders = 10;
+        tempPath = (std::filesystem::temp_directory_path() / "order_flow_test.bin").string();
+    }
+
+    void TearDown() override {
+        std::remove(tempPath.c_str());
+    }
+};
+
+// The same seed must always produce the same stream
+TEST_F(OrderFlowGeneratorTest, SameSeed_ProducesIdenticalStream) {
+    OrderFlowGenerator a(config);
+    OrderFlowGenerator b(config);
+
+    for (int i = 0; i < 1000; ++i) {
+        FlowMessage ma = a.next();
+        FlowMessage mb = b.next();
+        ASSERT_EQ(ma.timestampNs, mb.timestampNs);
+        ASSERT_EQ(ma.type, mb.type);
+        ASSERT_EQ(ma.orderID, mb.orderID);
+        ASSERT_EQ(ma.targetID, mb.targetID);
+        ASSERT_EQ(ma.price, mb.price);
+        ASSERT_EQ(ma.quantity, mb.quantity);
+    }
+}
+
+// Message mix and arrival rate should track the configuration
+TEST_F(OrderFlowGeneratorTest, MessageMixAndRate_MatchConfiguration) {
+    config.messagesPerSecond = 100'000;
+    OrderFlowGenerator generator(config);
+    auto messages = generator.generate(100'000);
+
+    std::map<FlowMessageType, int> counts;
+    for (const auto& m : messages) counts[m.type]++;
+
+    const double total = messages.size();
+    EXPECT_NEAR(counts[FlowMessageType::ADD] / total, 0.55, 0.02);
+    EXPECT_NEAR(counts[FlowMessageType::MARKETABLE] / total, 0.05, 0.01);
+    EXPECT_NEAR(counts[FlowMessageType::CANCEL] / total, 0.30, 0.02);
+    EXPECT_NEAR(counts[FlowMessageType::MODIFY] / total, 0.10, 0.01);
+
+    // 100k messages at 100k msg/s should span roughly one second
+    EXPECT_NEAR(messages.back().timestampNs / 1e9, 1.0, 0.02);
+}
+
+// Passive orders rest on their own side of the mid and cancels only target known orders
+TEST_F(OrderFlowGeneratorTest, Messages_AreWellFormed) {
+    config.midMoveProbability = 0.0;
+    OrderFlowGenerator generator(config);
+
+    OrderID highestID = 0;
+    for (int i = 0; i < 10'000; ++i) {
+        FlowMessage m = generator.next();
+        EXPECT_GE(m.traderID, config.firstTraderID);
+        EXPECT_LT(m.traderID, config.firstTraderID + config.numTraders);
+
+        if (m.type == FlowMessageType::ADD) {
+            if (m.side == Side::BUY) EXPECT_LT(m.price, config.startMid);
+            else EXPECT_GT(m.price, config.startMid);
+        }
+        if (m.type == FlowMessageType::CANCEL || m.type == FlowMessageType::MODIFY) {
+            EXPECT_GT(m.targetID, 0u);
+            EXPECT_LE(m.targetID, highestID);
+        }
+        if (m.type != FlowMessageType::CANCEL) {
+            EXPECT_EQ(m.orderID, highestID + 1);
+            highestID = m.orderID;
+            EXPECT_GE(m.quantity, config.minQuantity);
+            EXPECT_LE(m.quantity, config.maxQuantity);
+        }
+    }
+}
+
+// A recorded stream reads back byte-for-byte
+TEST_F(OrderFlowGeneratorTest, RecordAndReplay_RoundTrips) {
+    OrderFlowGenerator generator(config);
+    auto messages = generator.generate(5000);
+
+    {
+        OrderFlowWriter writer(tempPath);
+        writer.write(messages);
+    }
+
+    OrderFlowReader reader(tempPath);
+    ASSERT_EQ(reader.size(), messages.size());
+    auto replayed = reader.readAll();
+    ASSERT_EQ(replayed.size(), messages.size());
+    for (size_t i = 0; i < messages.size(); ++i) {
+        ASSERT_EQ(std::memcmp(&replayed[i], &messages[i], sizeof(FlowMessage)), 0) << "Mismatch at message " << i;
+    }
+}
+
+TEST_F(OrderFlowGeneratorTest, Reader_RejectsForeignFile) {
+    {
+        std::ofstream out(tempPath, std::ios::binary);
+        out << "definitely not an order flow file";
+    }
+    EXPECT_THROW(OrderFlowReader reader(tempPath), std::runtime_error);
+}
+
+// Driving the engine flat-out should trade and leave a two-sided, uncrossed book
+TEST_F(OrderFlowGeneratorTest, Driver_FeedsMatchingEngine) {
+    OrderBook book;
+    EventDispatcher dispatcher;
+    MatchingEngine engine(book, dispatcher);
+    std::atomic<int> trades{0};
+    dispatcher.subscribe<TradeExecutedEvent>([&](const TradeExecutedEvent&) { trades++; });
+
+    OrderFlowGenerator generator(config);
+    auto messages = generator.generate(20'000);
+
+    OrderFlowDriver driver(engine, "SYNTH");
+    engine.start();
+    driver.runFlatOut(messages);
+    engine.stop(); // drains everything queued before returning
+
+    EXPECT_GT(trades.load(), 0);
+    auto bestBid = book.getBestBid();
+    auto bestAsk = book.getBestAsk();
+    ASSERT_TRUE(bestBid.has_value());
+    ASSERT_TRUE(bestAsk.has_value());
+    EXPECT_LT(bestBid->price, bestAsk->price);
+}
@@ -0,0 +1,217 @@
+#include "gtest/gtest.h"
+#include "orderGateway.h"
+#include "orderEntryClient.h"
+#include "matchingEngine.h"
+#include "orderBook.h"
+#include "eventDispatcher.h"
+#include <chrono>
+#include <memory>
+
+class OrderGatewayTest : public ::testing::Test {
+protected:
+    OrderBook book;
+    EventDispatcher dispatcher;
+    std::unique_ptr<MatchingEngine> engine;
+    std::unique_ptr<OrderGateway> gateway;
+
+    static constexpr std::chrono::milliseconds TIMEOUT{2000};
+
+    void startGateway(const GatewayConfig& config = GatewayConfig{}, const EngineConfig& engineConfig = EngineConfig{}) {
+        engine = std::make_unique<MatchingEngine>(book, dispatcher, engineConfig);
+        gateway = std::make_unique<OrderGateway>(*engine, dispatcher, config);
+        engine->start();
+        gateway->start();
+    }
+
+    void TearDown() override {
+        if (engine) engine->stop();
+        if (gateway) gateway->stop();
+    }
+
+    void connect(OrderEntryClient& client, TraderID traderID) {
+        client.connect("127.0.0.1", gateway->getPort());
+        client.login(traderID);
+        GatewayResponse response;
+        ASSERT_TRUE(client.receive(response, TIMEOUT));
+        ASSERT_EQ(response.type, GatewayMessageType::LOGIN_ACCEPTED);
+        EXPECT_EQ(response.traderID, traderID);
+    }
+
+    GatewayResponse expect(OrderEntryClient& client, GatewayMessageType type) {
+        GatewayResponse response{};
+        EXPECT_TRUE(client.receive(response, TIMEOUT));
+        EXPECT_EQ(response.type, type);
+        return response;
+    }
+};
+
+TEST_F(OrderGatewayTest, EnterExecuteAndCancel_AreAckedPerSession) {
+    startGateway();
+    OrderEntryClient seller, buyer;
+    connect(seller, 1);
+    connect(buyer, 2);
+
+    seller.enterOrder(11, "ES", Side::SELL, OrderType::LIMIT, 10000, 10);
+    GatewayResponse accepted = expect(seller, GatewayMessageType::ACCEPTED);
+    EXPECT_EQ(accepted.token, 11u);
+    EXPECT_EQ(accepted.sequence, 2u);
+
+    buyer.enterOrder(21, "ES", Side::BUY, OrderType::MARKET, 0, 4);
+    EXPECT_EQ(expect(buyer, GatewayMessageType::ACCEPTED).token, 21u);
+    GatewayResponse aggressor = expect(buyer, GatewayMessageType::EXECUTED);
+    EXPECT_EQ(aggressor.token, 21u);
+    EXPECT_EQ(aggressor.price, 10000u);
+    EXPECT_EQ(aggressor.quantity, 4u);
+    EXPECT_EQ(aggressor.remaining, 0u);
+
+    GatewayResponse resting = expect(seller, GatewayMessageType::EXECUTED);
+    EXPECT_EQ(resting.token, 11u);
+    EXPECT_EQ(resting.remaining, 6u);
+    EXPECT_EQ(resting.sequence, 3u);
+
+    seller.cancelOrder(11);
+    GatewayResponse cancelled = expect(seller, GatewayMessageType::CANCELLED);
+    EXPECT_EQ(cancelled.token, 11u);
+    EXPECT_EQ(cancelled.quantity, 6u);
+}
+
+TEST_F(OrderGatewayTest, Replace_CancelsOldTokenAndEntersNewOne) {
+    startGateway();
+    OrderEntryClient client;
+    connect(client, 1);
+
+    client.enterOrder(1, "ES", Side::BUY, OrderType::LIMIT, 9900, 5);
+    expect(client, GatewayMessageType::ACCEPTED);
+    client.replaceOrder(1, 2, 9950, 7);
+    EXPECT_EQ(expect(client, GatewayMessageType::CANCELLED).token, 1u);
+    EXPECT_EQ(expect(client, GatewayMessageType::ACCEPTED).token, 2u);
+
+    client.cancelOrder(1);
+    GatewayResponse rejected = expect(client, GatewayMessageType::REJECTED);
+    EXPECT_EQ(rejected.reason, RejectCode::UNKNOWN_TOKEN);
+    client.enterOrder(2, "ES", Side::BUY, OrderType::LIMIT, 9900, 5);
+    EXPECT_EQ(expect(client, GatewayMessageType::REJECTED).reason, RejectCode::DUPLICATE_TOKEN);
+}
+
+TEST_F(OrderGatewayTest, Replace_IsReducedByWhatTheOriginalExecuted) {
+    startGateway();
+    OrderEntryClient seller, buyer;
+    connect(seller, 1);
+    connect(buyer, 2);
+
+    seller.enterOrder(1, "ES", Side::SELL, OrderType::LIMIT, 10000, 10);
+    expect(seller, GatewayMessageType::ACCEPTED);
+    buyer.enterOrder(1, "ES", Side::BUY, OrderType::MARKET, 0, 4);
+    expect(buyer, GatewayMessageType::ACCEPTED);
+    expect(buyer, GatewayMessageType::EXECUTED);
+    expect(seller, GatewayMessageType::EXECUTED);
+
+    // Ten in total, four of which already traded: six rest at the new price
+    seller.replaceOrder(1, 2, 10010, 10);
+    EXPECT_EQ(expect(seller, GatewayMessageType::CANCELLED).quantity, 6u);
+    EXPECT_EQ(expect(seller, GatewayMessageType::ACCEPTED).token, 2u);
+
+    buyer.enterOrder(2, "ES", Side::BUY, OrderType::MARKET, 0, 10);
+    expect(buyer, GatewayMessageType::ACCEPTED);
+    GatewayResponse fill = expect(seller, GatewayMessageType::EXECUTED);
+    EXPECT_EQ(fill.token, 2u);
+    EXPECT_EQ(fill.price, 10010u);
+    EXPECT_EQ(fill.quantity, 6u);
+    EXPECT_EQ(fill.remaining, 0u);
+}
+
+TEST_F(OrderGatewayTest, Replace_NotAboveWhatExecutedIsTooLate) {
+    startGateway();
+    OrderEntryClient seller, buyer;
+    connect(seller, 1);
+    connect(buyer, 2);
+
+    seller.enterOrder(1, "ES", Side::SELL, OrderType::LIMIT, 10000, 10);
+    expect(seller, GatewayMessageType::ACCEPTED);
+    buyer.enterOrder(1, "ES", Side::BUY, OrderType::MARKET, 0, 4);
+    expect(seller, GatewayMessageType::EXECUTED);
+
+    seller.replaceOrder(1, 2, 10000, 4);
+    expect(seller, GatewayMessageType::CANCELLED);
+    GatewayResponse rejected = expect(seller, GatewayMessageType::REJECTED);
+    EXPECT_EQ(rejected.token, 2u);
+    EXPECT_EQ(rejected.reason, RejectCode::TOO_LATE_TO_REPLACE);
+    EXPECT_FALSE(book.getBestAsk().has_value());
+}
+
+TEST_F(OrderGatewayTest, DecrementBoth_ReducedAggressorStaysLive) {
+    EngineConfig engineConfig;
+    engineConfig.selfTradePrevention = SelfTradePrevention::DECREMENT_BOTH;
+    startGateway(GatewayConfig{}, engineConfig);
+    OrderEntryClient trader, other;
+    connect(trader, 1);
+    connect(other, 2);
+
+    trader.enterOrder(1, "ES", Side::SELL, OrderType::LIMIT, 10000, 4);
+    expect(trader, GatewayMessageType::ACCEPTED);
+    other.enterOrder(1, "ES", Side::SELL, OrderType::LIMIT, 10000, 5);
+    expect(other, GatewayMessageType::ACCEPTED);
+
+    // Four of the buy decrement against the trader's own ask, the rest trades with the other seller
+    trader.enterOrder(2, "ES", Side::BUY, OrderType::LIMIT, 10000, 10);
+    expect(trader, GatewayMessageType::ACCEPTED);
+    GatewayResponse resting = expect(trader, GatewayMessageType::CANCELLED);
+    EXPECT_EQ(resting.token, 1u);
+    EXPECT_EQ(resting.quantity, 4u);
+    EXPECT_EQ(resting.remaining, 0u);
+    GatewayResponse reduced = expect(trader, GatewayMessageType::CANCELLED);
+    EXPECT_EQ(reduced.token, 2u);
+    EXPECT_EQ(reduced.quantity, 4u);
+    EXPECT_EQ(reduced.remaining, 6u);
+    GatewayResponse fill = expect(trader, GatewayMessageType::EXECUTED);
+    EXPECT_EQ(fill.token, 2u);
+    EXPECT_EQ(fill.quantity, 5u);
+    EXPECT_EQ(fill.remaining, 1u);
+    expect(other, GatewayMessageType::EXECUTED);
+
+    // Still live, so the token can be cancelled
+    trader.cancelOrder(2);
+    GatewayResponse cancelled = expect(trader, GatewayMessageType::CANCELLED);
+    EXPECT_EQ(cancelled.quantity, 1u);
+    EXPECT_EQ(cancelled.remaining, 0u);
+}
+
+TEST_F(OrderGatewayTest, ProtocolErrors_RejectOrDisconnect) {
+    startGateway();
+    OrderEntryClient client;
+    client.connect("127.0.0.1", gateway->getPort());
+
+    client.enterOrder(1, "ES", Side::BUY, OrderType::LIMIT, 9900, 5);
+    EXPECT_EQ(expect(client, GatewayMessageType::REJECTED).reason, RejectCode::NOT_LOGGED_IN);
+
+    client.login(1);
+    expect(client, GatewayMessageType::LOGIN_ACCEPTED);
+    client.enterOrder(2, "ES", Side::BUY, OrderType::LIMIT, 9900, 0);
+    EXPECT_EQ(expect(client, GatewayMessageType::REJECTED).reason, RejectCode::INVALID_ORDER);
+
+    // Skipping a sequence number ends the session
+    CancelOrderRequest gap{};
+    gap.header = {sizeof(CancelOrderRequest), GatewayMessageType::CANCEL_ORDER, 0, client.nextSequence() + 1};
+    gap.token = 2;
+    client.sendRaw(&gap, sizeof(gap));
+    GatewayResponse response;
+    EXPECT_FALSE(client.receive(response, TIMEOUT));
+    EXPECT_FALSE(client.isConnected());
+}
+
+TEST_F(OrderGatewayTest, Throttle_RejectsBeyondBurst) {
+    GatewayConfig config;
+    config.messagesPerSecond = 1;
+    config.throttleBurst = 2;
+    startGateway(config);
+
+    OrderEntryClient client;
+    connect(client, 1);
+    for (OrderToken token = 1; token <= 3; ++token) client.enterOrder(token, "ES", Side::BUY, OrderType::LIMIT, 9900, 1);
+
+    expect(client, GatewayMessageType::ACCEPTED);
+    expect(client, GatewayMessageType::ACCEPTED);
+    GatewayResponse throttled = expect(client, GatewayMessageType::REJECTED);
+    EXPECT_EQ(throttled.token, 3u);
+    EXPECT_EQ(throttled.reason, RejectCode::THROTTLED);
+}
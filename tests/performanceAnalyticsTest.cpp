@@ -0,0 +1,135 @@
+#include "gtest/gtest.h"
+#include "performanceAnalytics.h"
+#include <cmath>
+#include <random>
+
+namespace {
+    PerformanceInput curve(const std::vector<std::int64_t>& timestamps, const std::vector<double>& values) {
+        PerformanceInput input;
+        input.timestamp = timestamps.data();
+        input.equity = values.data();
+        input.points = values.size();
+        return input;
+    }
+}
+
+TEST(PerformanceAnalyticsTest, ComputesReturnAndRiskFigures) {
+    std::vector<std::int64_t> timestamps{0, 1, 2, 3};
+    std::vector<double> values{100, 110, 99, 120};
+    PerformanceReport report = analyzePerformance(curve(timestamps, values));
+    const PerformanceSummary& s = report.summary;
+
+    const double r[] = {0.1, -0.1, 120.0 / 99 - 1};
+    const double mean = (r[0] + r[1] + r[2]) / 3;
+    const double deviation = std::sqrt(((r[0] - mean) * (r[0] - mean) + (r[1] - mean) * (r[1] - mean) + (r[2] - mean) * (r[2] - mean)) / 2);
+    EXPECT_EQ(s.periods, 4u);
+    EXPECT_DOUBLE_EQ(s.totalReturn, 0.2);
+    EXPECT_NEAR(s.annualReturn, std::pow(1.2, 252.0 / 3) - 1, 1e-6 * s.annualReturn);
+    EXPECT_NEAR(s.annualVolatility, deviation * std::sqrt(252.0), 1e-12);
+    EXPECT_NEAR(s.sharpe, mean / deviation * std::sqrt(252.0), 1e-9);
+    EXPECT_NEAR(s.sortino, mean / std::sqrt(0.01 / 3) * std::sqrt(252.0), 1e-9);
+    EXPECT_NEAR(s.maxDrawdown, 0.1, 1e-12);
+    EXPECT_EQ(s.maxDrawdownPeriods, 1u);
+
+    ASSERT_EQ(report.series.drawdown.size(), 4u);
+    EXPECT_DOUBLE_EQ(report.series.returns[0], 0.0);
+    EXPECT_NEAR(report.series.drawdown[2], -0.1, 1e-12);
+    EXPECT_DOUBLE_EQ(report.series.drawdown[3], 0.0);
+}
+
+TEST(PerformanceAnalyticsTest, BucketsKeepTheLastPointOfEachDay) {
+    const std::int64_t day = 86'400'000;
+    std::vector<std::int64_t> timestamps{day + 10, day + 20, 2 * day + 5, 2 * day + 6, 5 * day};
+    std::vector<double> values{50, 100, 70, 110, 99};
+    PerformanceConfig config;
+    config.bucketMs = day;
+    PerformanceReport report = analyzePerformance(curve(timestamps, values), config);
+
+    EXPECT_EQ(report.series.equity, (std::vector<double>{100, 110, 99}));
+    EXPECT_EQ(report.series.timestamp, (std::vector<std::int64_t>{day + 20, 2 * day + 6, 5 * day}));
+    EXPECT_NEAR(report.summary.totalReturn, -0.01, 1e-12);
+
+    std::swap(timestamps[0], timestamps[1]);
+    std::swap(timestamps[0], timestamps[3]);
+    EXPECT_THROW(analyzePerformance(curve(timestamps, values), config), std::invalid_argument);
+}
+
+TEST(PerformanceAnalyticsTest, ScoresClosingFillsAgainstAverageCost) {
+    PerformanceConfig config;
+    config.priceScale = 1.0;
+    PerformanceAnalyzer analyzer(config);
+    analyzer.addFill(0, 1, 100, 10);
+    analyzer.addFill(1, -1, 50, 3);      // another symbol, opened short
+    analyzer.addFill(0, -1, 110, 4);     // +40
+    analyzer.addFill(0, -1, 90, 10);     // closes 6 for -60, flips to 4 short at 90
+    analyzer.addFill(0, 1, 80, 4);       // +40
+    analyzer.addFill(1, 1, 55, 3);       // -15
+    const PerformanceSummary s = analyzer.finish().summary;
+
+    EXPECT_EQ(s.fills, 6u);
+    EXPECT_EQ(s.closedTrades, 4u);
+    EXPECT_EQ(s.winningTrades, 2u);
+    EXPECT_DOUBLE_EQ(s.grossProfit, 80);
+    EXPECT_DOUBLE_EQ(s.grossLoss, 75);
+    EXPECT_DOUBLE_EQ(s.realizedPnl, 5);
+    EXPECT_DOUBLE_EQ(s.profitFactor, 80.0 / 75);
+    EXPECT_DOUBLE_EQ(s.averageWin, 40);
+    EXPECT_DOUBLE_EQ(s.averageLoss, 37.5);
+    EXPECT_DOUBLE_EQ(s.turnover, 1000 + 150 + 440 + 900 + 320 + 165);
+}
+
+TEST(PerformanceAnalyticsTest, RollingSeriesMatchAWindowedRecomputation) {
+    std::mt19937 rng(9);
+    std::normal_distribution<double> noise(0.0005, 0.01);
+    std::vector<std::int64_t> timestamps;
+    std::vector<double> values{1000};
+    for (int i = 0; i < 300; ++i) values.push_back(values.back() * (1 + noise(rng)));
+    for (std::size_t i = 0; i < values.size(); ++i) timestamps.push_back(static_cast<std::int64_t>(i));
+
+    PerformanceConfig config;
+    config.rollingWindow = 20;
+    PerformanceReport report = analyzePerformance(curve(timestamps, values), config);
+    const PerformanceSeries& series = report.series;
+
+    for (std::size_t i = 0; i < 20; ++i) EXPECT_TRUE(std::isnan(series.rollingSharpe[i])) << i;
+    for (std::size_t i = 20; i < values.size(); ++i) {
+        double mean = 0, m2 = 0;
+        for (std::size_t j = i - 19; j <= i; ++j) mean += series.returns[j] / 20;
+        for (std::size_t j = i - 19; j <= i; ++j) m2 += (series.returns[j] - mean) * (series.returns[j] - mean);
+        const double deviation = std::sqrt(m2 / 19);
+        ASSERT_NEAR(series.rollingVolatility[i], deviation * std::sqrt(252.0), 1e-9) << i;
+        ASSERT_NEAR(series.rollingSharpe[i], mean / deviation * std::sqrt(252.0), 1e-6) << i;
+    }
+}
+
+TEST(PerformanceAnalyticsTest, BatchMatchesOneAtATimeOnEveryThreadCount) {
+    std::mt19937 rng(4);
+    std::vector<std::vector<std::int64_t>> timestamps(37);
+    std::vector<std::vector<double>> values(37);
+    std::vector<PerformanceInput> inputs;
+    for (std::size_t k = 0; k < timestamps.size(); ++k) {
+        double value = 100;
+        for (std::size_t i = 0; i < 50 + rng() % 2000; ++i) {
+            value *= 1 + std::normal_distribution<double>(0, 0.02)(rng);
+            timestamps[k].push_back(static_cast<std::int64_t>(i) * 60'000);
+            values[k].push_back(value);
+        }
+        inputs.push_back(curve(timestamps[k], values[k]));
+    }
+
+    for (std::size_t threads : {1u, 3u, 0u}) {
+        std::vector<PerformanceReport> reports = analyzePerformanceBatch(inputs, PerformanceConfig{}, threads);
+        ASSERT_EQ(reports.size(), inputs.size());
+        for (std::size_t k = 0; k < inputs.size(); ++k) {
+            const PerformanceSummary expected = analyzePerformance(inputs[k]).summary;
+            EXPECT_EQ(reports[k].summary.sharpe, expected.sharpe);
+            EXPECT_EQ(reports[k].summary.maxDrawdown, expected.maxDrawdown);
+            EXPECT_TRUE(reports[k].series.equity.empty());
+        }
+    }
+
+    std::vector<std::int64_t> backwards{2, 1};
+    std::vector<double> flat{1, 1};
+    inputs.push_back(curve(backwards, flat));
+    EXPECT_THROW(analyzePerformanceBatch(inputs, PerformanceConfig{}, 4), std::invalid_argument);
+}
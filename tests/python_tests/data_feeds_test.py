@@ -0,0 +1,59 @@
+import sys
+from datetime import datetime
+from pathlib import Path
+import pytest
+
+project_root = Path(__file__).resolve().parents[2]
+sys.path.insert(0, str(project_root))
+
+from data_feeds import MergedDataHandler, SymbolFeed
+
+# --- Helper Function ---
+def write_feed(directory: Path, symbol: str, rows, header="Date,Open,High,Low,Close,Volume"):
+    path = directory / f"{symbol}.csv"
+    lines = [header] + [f"{day},{close},{close},{close},{close},100" for day, close in rows]
+    path.write_text("\n".join(lines) + "\n")
+    return path
+
+# --- Tests ---
+
+def test_symbol_feed_reads_in_chunks_and_skips_non_bar_rows(tmp_path):
+    """yfinance writes two extra header rows; they are skipped, and chunking does not lose rows."""
+    path = tmp_path / "AAPL.csv"
+    path.write_text(
+        "Price,Close,High,Low,Open,Volume\n"
+        "Ticker,AAPL,AAPL,AAPL,AAPL,AAPL\n"
+        "Date,,,,,\n"
+        + "".join(f"2020-01-{day:02d},{day}.5,{day + 1},{day - 1},{day},1000\n" for day in range(1, 8))
+    )
+
+    bars = list(SymbolFeed("AAPL", path, chunk_size=2))
+
+    assert len(bars) == 7
+    assert bars[0] == (datetime(2020, 1, 1), {"close": 1.5, "high": 2.0, "low": 0.0, "open": 1.0, "volume": 1000.0})
+    assert [timestamp.day for timestamp, _ in bars] == list(range(1, 8))
+
+def test_merge_yields_bars_in_global_timestamp_order(tmp_path):
+    write_feed(tmp_path, "AAPL", [("2020-01-01", 1), ("2020-01-03", 3), ("2020-01-05", 5)])
+    write_feed(tmp_path, "MSFT", [("2020-01-02", 2), ("2020-01-03", 30)])
+    write_feed(tmp_path, "EMPTY", [])
+
+    handler = MergedDataHandler.from_directory(tmp_path, chunk_size=1)
+    merged = [(timestamp.day, symbol, bar["close"]) for timestamp, symbol, bar in handler.stream_bars()]
+
+    assert merged == [(1, "AAPL", 1.0), (2, "MSFT", 2.0), (3, "AAPL", 3.0), (3, "MSFT", 30.0), (5, "AAPL", 5.0)]
+
+def test_slices_group_bars_sharing_a_timestamp(tmp_path):
+    write_feed(tmp_path, "AAPL", [("2020-01-01", 1), ("2020-01-02", 2)])
+    write_feed(tmp_path, "MSFT", [("2020-01-02", 20)])
+
+    slices = list(MergedDataHandler.from_directory(tmp_path).stream_slices())
+
+    assert [(timestamp.day, sorted(bars)) for timestamp, bars in slices] == [(1, ["AAPL"]), (2, ["AAPL", "MSFT"])]
+    assert slices[1][1]["MSFT"]["close"] == 20.0
+
+def test_out_of_order_feed_is_rejected(tmp_path):
+    path = write_feed(tmp_path, "AAPL", [("2020-01-02", 2), ("2020-01-01", 1)])
+
+    with pytest.raises(ValueError):
+        list(SymbolFeed("AAPL", path))
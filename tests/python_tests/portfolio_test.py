@@ -1,6 +1,7 @@
 import sys
 from pathlib import Path
 import pytest
+import pandas as pd
 
 # --- Add this block to fix the import path ---
 # Get the absolute path of the current test file
@@ -179,3 +180,32 @@ def test_rapid_buy_sell_sequence(fresh_portfolio):
     assert "SPY" not in fresh_portfolio.holdings
     # Final cash = 99400 + (75 * 15) = 99400 + 1125 = 100525.0
     assert fresh_portfolio.cash == 100525.0
+
+# --- Columnar Recording Tests ---
+
+def test_recorder_collects_fills_and_equity_columns():
+    """Tests that an attached FillRecorder replaces the per-fill dicts and feeds save_results."""
+    dispatcher = trading_core.EventDispatcher()
+    recorder = trading_core.FillRecorder(trader_id=1)
+    recorder.attach(dispatcher)
+    portfolio = Portfolio(cash="100000.00", trader_id=1, holdings={}, recorder=recorder)
+    dispatcher.subscribe_trade_executed(portfolio.on_fill)
+
+    recorder.set_clock(1_577_923_200_000)  # 2020-01-02
+    dispatcher.publish_trade_executed(create_mock_trade_event("AAPL", 15000, 10, 1, trading_core.Side.BUY))
+    dispatcher.publish_trade_executed(create_mock_trade_event("AAPL", 15500, 4, 2, trading_core.Side.BUY, resting_id=1))
+    portfolio.log_state("2020-01-02")
+
+    assert portfolio.trades == []
+    assert portfolio.holdings["AAPL"].quantity == 6
+
+    trades = portfolio.trades_frame()
+    assert list(trades['side']) == ['BUY', 'SELL']
+    assert list(trades['price']) == [150.0, 155.0]
+    assert list(trades['quantity']) == [10, 4]
+    assert list(trades['symbol']) == ['AAPL', 'AAPL']
+    assert trades['timestamp'].iloc[0] == pd.Timestamp("2020-01-02")
+
+    history = portfolio.history_frame()
+    assert len(history) == 1
+    assert history['value'].iloc[0] == portfolio.value
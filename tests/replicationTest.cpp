@@ -0,0 +1,229 @@
+#include "gtest/gtest.h"
+#include "replication.h"
+#include "limitOrder.h"
+#include "marketOrder.h"
+#include <arpa/inet.h>
+#include <chrono>
+#include <memory>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <thread>
+#include <tuple>
+#include <unistd.h>
+
+class ReplicationTest : public ::testing::Test {
+protected:
+    static constexpr std::chrono::milliseconds TIMEOUT{2000};
+    using Fill = std::tuple<Price, Quantity, OrderID, OrderID>;
+
+    OrderBook primaryBook, backupBook;
+    EventDispatcher primaryDispatcher, backupDispatcher;
+    MatchingEngine primaryEngine{primaryBook, primaryDispatcher};
+    MatchingEngine backupEngine{backupBook, backupDispatcher};
+    ReplicationPrimary primary;
+    ReplicationBackup backup{backupEngine};
+    std::vector<Fill> primaryFills, backupFills;
+
+    void SetUp() override {
+        primaryDispatcher.subscribe<TradeExecutedEvent>([this](const TradeExecutedEvent& e) {
+            primaryFills.emplace_back(e.price, e.quantity, e.aggressingOrderID, e.restingOrderID);
+        });
+        backupDispatcher.subscribe<TradeExecutedEvent>([this](const TradeExecutedEvent& e) {
+            backupFills.emplace_back(e.price, e.quantity, e.aggressingOrderID, e.restingOrderID);
+        });
+        primaryEngine.setJournal(&primary);
+        primary.start();
+        backup.connect("127.0.0.1", primary.getPort());
+        ASSERT_TRUE(primary.waitForBackup(TIMEOUT));
+        primaryEngine.start();
+        backupEngine.start();
+    }
+
+    void TearDown() override {
+        primaryEngine.stop();
+        primary.stop();
+        backupEngine.stop();
+    }
+
+    // Stops the primary side and lets the backup engine catch up.
+    void settle() {
+        primaryEngine.stop();
+        const std::uint64_t last = primary.getSequence();
+        primary.stop();
+        ASSERT_TRUE(backup.waitForSequence(last, TIMEOUT));
+        backupEngine.stop();
+    }
+
+    static std::vector<std::tuple<Price, Quantity, std::vector<OrderID>>> levels(OrderBook& book, Side side) {
+        std::vector<std::tuple<Price, Quantity, std::vector<OrderID>>> result;
+        for (const LevelSnapshot& level : book.depth(side)) result.emplace_back(level.price, level.quantity, level.orders);
+        return result;
+    }
+
+    static std::unique_ptr<LimitOrder> limit(Side side, Price price, Quantity quantity, TraderID traderID, const str& symbol = "ES") {
+        return std::make_unique<LimitOrder>(symbol, 0, OrderType::LIMIT, side, price, quantity, traderID);
+    }
+};
+
+TEST_F(ReplicationTest, BackupBookMatchesThePrimary) {
+    std::vector<OrderID> ids;
+    for (int i = 0; i < 50; ++i) {
+        ids.push_back(primaryEngine.submitOrder(limit(Side::SELL, 10010 + i % 7, 5 + i % 3, 1 + i % 4, i % 5 ? "ES" : "NQ")));
+        ids.push_back(primaryEngine.submitOrder(limit(Side::BUY, 10000 - i % 5, 4 + i % 6, 5 + i % 3)));
+    }
+    primaryEngine.submitOrder(std::make_unique<MarketOrder>("ES", 0, OrderType::MARKET, Side::BUY, 40, 9));
+    primaryEngine.submitOrder(limit(Side::SELL, 9998, 30, 9));
+    for (std::size_t i = 0; i < ids.size(); i += 9) primaryEngine.cancelOrder(ids[i]);
+    primaryEngine.massCancel(2);
+    primaryEngine.massCancel(5, Side::BUY);
+    primaryEngine.massCancelSymbol("NQ");
+
+    primaryEngine.beginAuction();
+    primaryEngine.submitOrder(limit(Side::BUY, 10012, 20, 3));
+    primaryEngine.submitOrder(limit(Side::SELL, 9999, 15, 4));
+    primaryEngine.uncross();
+    settle();
+
+    EXPECT_FALSE(backup.hasFailed());
+    EXPECT_FALSE(primaryFills.empty());
+    EXPECT_EQ(backupFills, primaryFills);
+    EXPECT_EQ(levels(backupBook, Side::BUY), levels(primaryBook, Side::BUY));
+    EXPECT_EQ(levels(backupBook, Side::SELL), levels(primaryBook, Side::SELL));
+    EXPECT_EQ(primary.getAcknowledgedSequence(), primary.getSequence());
+}
+
+TEST_F(ReplicationTest, ExpiriesFollowThePrimaryClock) {
+    const Timestamp now = std::chrono::time_point_cast<std::chrono::milliseconds>(std::chrono::system_clock::now());
+    auto expiring = [&](Side side, Price price, std::chrono::milliseconds after) {
+        auto order = limit(side, price, 10, 1);
+        order->setTimeInForce(TimeInForce::GTD);
+        order->setExpireTime(now + after);
+        return order;
+    };
+    // Wall clock first, then a backtest-style clock
+    primaryEngine.submitOrder(expiring(Side::BUY, 100, std::chrono::milliseconds(30)));
+    primaryEngine.submitOrder(expiring(Side::BUY, 101, std::chrono::hours(1)));
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    primaryEngine.submitOrder(limit(Side::SELL, 200, 10, 2));
+
+    primaryEngine.setTime(now + std::chrono::minutes(30));
+    primaryEngine.submitOrder(expiring(Side::SELL, 201, std::chrono::minutes(45)));
+    primaryEngine.setTime(now + std::chrono::minutes(50));
+    settle();
+
+    ASSERT_EQ(primaryBook.depth(Side::BUY).size(), 1u);
+    EXPECT_EQ(primaryBook.depth(Side::BUY)[0].price, 101u);
+    EXPECT_EQ(primaryBook.depth(Side::SELL).size(), 1u);
+    EXPECT_EQ(levels(backupBook, Side::BUY), levels(primaryBook, Side::BUY));
+    EXPECT_EQ(levels(backupBook, Side::SELL), levels(primaryBook, Side::SELL));
+}
+
+TEST_F(ReplicationTest, PromotedBackupTakesOverAtTheLastSequence) {
+    primaryEngine.submitOrder(limit(Side::SELL, 10010, 5, 1));
+    const OrderID last = primaryEngine.submitOrder(limit(Side::BUY, 10000, 5, 2));
+    primaryEngine.stop();
+    const std::uint64_t sequence = primary.getSequence();
+    primary.stop();
+    ASSERT_TRUE(backup.waitForSequence(sequence, TIMEOUT));
+
+    // The primary went away; the backup's engine is still running
+    EXPECT_EQ(backup.promote(), sequence);
+    EXPECT_FALSE(backup.isConnected());
+    EXPECT_GT(backupEngine.submitOrder(limit(Side::SELL, 10000, 5, 3)), last);
+    backupEngine.stop();
+    EXPECT_EQ(backupBook.depth(Side::BUY).size(), 0u);
+    ASSERT_EQ(backupFills.size(), 1u);
+    EXPECT_EQ(std::get<3>(backupFills[0]), last);
+}
+
+TEST(ReplicationBackupTest, StopsAtASequenceGap) {
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+    ASSERT_EQ(listen(listener, 1), 0);
+    socklen_t length = sizeof(address);
+    getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length);
+
+    OrderBook book;
+    EventDispatcher dispatcher;
+    MatchingEngine engine(book, dispatcher);
+    ReplicationBackup backup(engine);
+    backup.connect("127.0.0.1", ntohs(address.sin_port));
+    int fd = accept(listener, nullptr, nullptr);
+    ASSERT_GE(fd, 0);
+
+    JournalRecord records[2]{};
+    records[0].sequence = 1;
+    records[0].type = JournalRecordType::BEGIN_AUCTION;
+    records[1].sequence = 3;
+    records[1].type = JournalRecordType::UNCROSS;
+    ASSERT_EQ(send(fd, records, sizeof(records), 0), static_cast<ssize_t>(sizeof(records)));
+
+    for (int i = 0; i < 2000 && backup.isConnected(); ++i) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    EXPECT_FALSE(backup.isConnected());
+    EXPECT_TRUE(backup.hasFailed());
+    EXPECT_EQ(backup.getSequence(), 1u);
+    EXPECT_EQ(engine.runPending(), 1u);
+    close(fd);
+    close(listener);
+}
+
+TEST(ReplicationPrimaryTest, AcknowledgesOnlyWhatTheBackupEngineHasRun) {
+    OrderBook primaryBook, backupBook;
+    EventDispatcher primaryDispatcher, backupDispatcher;
+    MatchingEngine primaryEngine(primaryBook, primaryDispatcher);
+    MatchingEngine backupEngine(backupBook, backupDispatcher);
+    ReplicationPrimary primary;
+    primaryEngine.setJournal(&primary);
+    primary.start();
+    ReplicationBackup backup(backupEngine);
+    backup.connect("127.0.0.1", primary.getPort());
+    ASSERT_TRUE(primary.waitForBackup(std::chrono::milliseconds(2000)));
+
+    primaryEngine.setTime(Timestamp(std::chrono::hours(1)));
+    primaryEngine.submitOrder(std::make_unique<LimitOrder>("ES", 0, OrderType::LIMIT, Side::BUY, 100, 5, 1));
+    primaryEngine.runPending();
+    const std::uint64_t sequence = primary.getSequence();
+
+    // Handed to the backup's engine, which has not run it yet
+    ASSERT_TRUE(backup.waitForSequence(1, std::chrono::milliseconds(2000)));
+    EXPECT_FALSE(primary.waitForAcknowledgement(1, std::chrono::milliseconds(50)));
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (primary.getAcknowledgedSequence() < sequence && std::chrono::steady_clock::now() < deadline) {
+        backupEngine.runPending();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(primary.getAcknowledgedSequence(), sequence);
+    EXPECT_EQ(backupBook.getBestBid()->quantity, 5u);
+    primary.stop();
+}
+
+TEST(ReplicationPrimaryTest, GivesUpOnReplicationOnceTheBacklogOverflows) {
+    OrderBook book;
+    EventDispatcher dispatcher;
+    MatchingEngine engine(book, dispatcher);
+    ReplicationConfig config;
+    config.maxBacklog = 8;
+    ReplicationPrimary primary(config);
+    engine.setJournal(&primary);
+    primary.start();
+
+    engine.setTime(Timestamp(std::chrono::hours(1)));
+    for (int i = 0; i < 20; ++i) engine.submitOrder(std::make_unique<LimitOrder>("ES", 0, OrderType::LIMIT, Side::BUY, 100, 1, 1));
+    engine.runPending();
+    EXPECT_TRUE(primary.hasOverflowed());
+    EXPECT_EQ(primary.getSequence(), 9u);
+
+    // A backup arriving now could not be brought up to date, so it is never served
+    OrderBook backupBook;
+    EventDispatcher backupDispatcher;
+    MatchingEngine backupEngine(backupBook, backupDispatcher);
+    ReplicationBackup backup(backupEngine);
+    backup.connect("127.0.0.1", primary.getPort());
+    EXPECT_FALSE(primary.waitForBackup(std::chrono::milliseconds(50)));
+    EXPECT_EQ(book.depth(Side::BUY)[0].quantity, 20u);
+    primary.stop();
+}
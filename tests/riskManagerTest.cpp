@@ -0,0 +1,90 @@
+#include "gtest/gtest.h"
+#include "riskManager.h"
+#include "limitOrder.h"
+#include "marketOrder.h"
+#include <memory>
+
+class RiskManagerTest : public ::testing::Test {
+protected:
+    RiskLimits limits;
+
+    std::unique_ptr<LimitOrder> limit(Side side, Price price, Quantity quantity, TraderID trader = 1) {
+        return std::make_unique<LimitOrder>("AAPL", 1, OrderType::LIMIT, side, price, quantity, trader);
+    }
+};
+
+TEST_F(RiskManagerTest, NoLimits_AcceptsEverything) {
+    RiskManager risk(limits, 16);
+    EXPECT_FALSE(risk.isEnabled());
+    // Even traders beyond the bound pass while no checks are active
+    EXPECT_FALSE(risk.check(*limit(Side::BUY, 10000, 1'000'000, 1'000)).has_value());
+}
+
+TEST_F(RiskManagerTest, MaxOrderQuantity_RejectsLargeOrders) {
+    limits.maxOrderQuantity = 100;
+    RiskManager risk(limits, 16);
+
+    EXPECT_FALSE(risk.check(*limit(Side::BUY, 10000, 100)).has_value());
+    EXPECT_EQ(risk.check(*limit(Side::BUY, 10000, 101)), RejectReason::ORDER_SIZE);
+}
+
+TEST_F(RiskManagerTest, MaxOpenOrders_CountsRestingOrders) {
+    limits.maxOpenOrders = 2;
+    RiskManager risk(limits, 16);
+
+    risk.onOrderRested(1, Side::BUY, 10);
+    risk.onOrderRested(1, Side::BUY, 10);
+    EXPECT_EQ(risk.check(*limit(Side::BUY, 10000, 10)), RejectReason::OPEN_ORDER_LIMIT);
+
+    // Market orders never rest, so they are not subject to the open order limit
+    MarketOrder market("AAPL", 2, OrderType::MARKET, Side::SELL, 10, 1);
+    EXPECT_FALSE(risk.check(market).has_value());
+
+    risk.onRestingReduced(1, Side::BUY, 10, true);
+    EXPECT_FALSE(risk.check(*limit(Side::BUY, 10000, 10)).has_value());
+    EXPECT_EQ(risk.getOpenOrders(1), 1u);
+}
+
+TEST_F(RiskManagerTest, MaxPosition_IncludesOpenOrdersAndFills) {
+    limits.maxPosition = 100;
+    RiskManager risk(limits, 16);
+
+    risk.onOrderRested(1, Side::BUY, 60);
+    EXPECT_EQ(risk.check(*limit(Side::BUY, 10000, 50)), RejectReason::POSITION_LIMIT);
+    EXPECT_FALSE(risk.check(*limit(Side::BUY, 10000, 40)).has_value());
+
+    // The resting buy fills against trader 2's sell
+    risk.onTrade(2, Side::SELL, 1, 10000, 60, true);
+    EXPECT_EQ(risk.getPosition(1), 60);
+    EXPECT_EQ(risk.getPosition(2), -60);
+
+    // Selling reduces exposure, so a sell of 160 is the most trader 1 can send
+    EXPECT_FALSE(risk.check(*limit(Side::SELL, 10000, 160)).has_value());
+    EXPECT_EQ(risk.check(*limit(Side::SELL, 10000, 161)), RejectReason::POSITION_LIMIT);
+}
+
+TEST_F(RiskManagerTest, PriceBand_AppliesOnlyAfterFirstTrade) {
+    limits.priceBandTicks = 100;
+    RiskManager risk(limits, 16);
+
+    EXPECT_FALSE(risk.check(*limit(Side::BUY, 50000, 1)).has_value());
+
+    risk.onTrade(2, Side::BUY, 3, 10000, 1, true);
+    EXPECT_FALSE(risk.check(*limit(Side::BUY, 10100, 1)).has_value());
+    EXPECT_EQ(risk.check(*limit(Side::BUY, 10101, 1)), RejectReason::PRICE_BAND);
+    EXPECT_EQ(risk.check(*limit(Side::SELL, 9899, 1)), RejectReason::PRICE_BAND);
+}
+
+TEST_F(RiskManagerTest, PerTraderOverride_TakesPrecedence) {
+    limits.maxOrderQuantity = 10;
+    RiskManager risk(limits, 16);
+
+    RiskLimits generous;
+    generous.maxOrderQuantity = 1000;
+    risk.setLimits(5, generous);
+
+    EXPECT_EQ(risk.check(*limit(Side::BUY, 10000, 500, 4)), RejectReason::ORDER_SIZE);
+    EXPECT_FALSE(risk.check(*limit(Side::BUY, 10000, 500, 5)).has_value());
+    EXPECT_EQ(risk.check(*limit(Side::BUY, 10000, 1, 16)), RejectReason::UNKNOWN_TRADER);
+    EXPECT_THROW(risk.setLimits(16, generous), std::invalid_argument);
+}
@@ -0,0 +1,138 @@
+#include "gtest/gtest.h"
+#include "shmServer.h"
+#include "shmClient.h"
+#include "matchingEngine.h"
+#include "orderBook.h"
+#include "eventDispatcher.h"
+#include <chrono>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+TEST(SpscRingTest, FillsToCapacityAndPopsInOrder) {
+    auto ring = std::make_unique<SpscRing<int, 4>>();
+    for (int i = 0; i < 4; ++i) EXPECT_TRUE(ring->tryPush(i));
+    EXPECT_FALSE(ring->tryPush(4));
+
+    int value;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring->tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(ring->tryPop(value));
+    EXPECT_TRUE(ring->tryPush(5));
+    EXPECT_TRUE(ring->tryPop(value));
+    EXPECT_EQ(value, 5);
+}
+
+class ShmChannelTest : public ::testing::Test {
+protected:
+    OrderBook book;
+    EventDispatcher dispatcher;
+    MatchingEngine engine{book, dispatcher};
+    ShmServerConfig config;
+    std::unique_ptr<ShmServer> server;
+
+    void SetUp() override {
+        config.name = "/trading_engine_test_" + std::to_string(getpid());
+        config.busyPoll = false;
+        server = std::make_unique<ShmServer>(engine, dispatcher, book, config);
+        server->start();
+        engine.start();
+    }
+
+    void TearDown() override {
+        server->stop();
+        engine.stop();
+    }
+
+    static ShmReport expect(ShmClient& client, ShmReportType type) {
+        ShmReport report{};
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (!client.poll(report)) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                ADD_FAILURE() << "No report";
+                return report;
+            }
+            std::this_thread::yield();
+        }
+        EXPECT_EQ(report.type, type);
+        return report;
+    }
+
+    template<typename Predicate>
+    static bool waitFor(Predicate predicate) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (!predicate()) {
+            if (std::chrono::steady_clock::now() > deadline) return false;
+            std::this_thread::yield();
+        }
+        return true;
+    }
+};
+
+TEST_F(ShmChannelTest, SubmitExecuteAndCancel_ReportToEachClient) {
+    ShmClient seller(config.name, 1);
+    ShmClient buyer(config.name, 2);
+    ASSERT_TRUE(seller.isConnected());
+
+    ASSERT_TRUE(seller.submit(10, "ES", Side::SELL, OrderType::LIMIT, 10000, 10));
+    ShmReport accepted = expect(seller, ShmReportType::ACCEPTED);
+    EXPECT_EQ(accepted.token, 10u);
+    EXPECT_NE(accepted.orderID, 0u);
+    EXPECT_TRUE(waitFor([&] { return seller.topOfBook().askQuantity == 10; }));
+
+    ASSERT_TRUE(buyer.submit(20, "ES", Side::BUY, OrderType::MARKET, 0, 4));
+    expect(buyer, ShmReportType::ACCEPTED);
+    ShmReport aggressor = expect(buyer, ShmReportType::EXECUTED);
+    EXPECT_EQ(aggressor.token, 20u);
+    EXPECT_EQ(aggressor.quantity, 4u);
+    EXPECT_EQ(aggressor.remaining, 0u);
+
+    ShmReport resting = expect(seller, ShmReportType::EXECUTED);
+    EXPECT_EQ(resting.token, 10u);
+    EXPECT_EQ(resting.price, 10000u);
+    EXPECT_EQ(resting.remaining, 6u);
+    EXPECT_TRUE(waitFor([&] { return buyer.topOfBook().askQuantity == 6 && buyer.topOfBook().lastPrice == 10000; }));
+
+    ASSERT_TRUE(seller.cancel(10));
+    EXPECT_EQ(expect(seller, ShmReportType::CANCELLED).quantity, 6u);
+    ASSERT_TRUE(seller.cancel(10));
+    EXPECT_EQ(expect(seller, ShmReportType::REJECTED).reason, RejectCode::UNKNOWN_TOKEN);
+}
+
+TEST_F(ShmChannelTest, StoppingServer_CancelsAttachedClientsAndReportsIt) {
+    ShmClient client(config.name, 1);
+    ASSERT_TRUE(client.submit(1, "ES", Side::BUY, OrderType::LIMIT, 9900, 5));
+    expect(client, ShmReportType::ACCEPTED);
+
+    server->stop();
+    EXPECT_EQ(expect(client, ShmReportType::CANCELLED).token, 1u);
+    EXPECT_TRUE(book.isEmpty());
+    EXPECT_EQ(server->droppedReports(), 0u);
+}
+
+TEST_F(ShmChannelTest, ClosingClient_CancelsItsOrdersAndFreesSlot) {
+    {
+        ShmClient client(config.name, 1);
+        ASSERT_TRUE(client.submit(1, "ES", Side::BUY, OrderType::LIMIT, 9900, 5));
+        expect(client, ShmReportType::ACCEPTED);
+        EXPECT_TRUE(waitFor([&] { return client.topOfBook().bidQuantity == 5; }));
+    }
+
+    ShmClient observer(config.name, 2);
+    EXPECT_TRUE(waitFor([&] { return observer.topOfBook().bidPrice == 0; }));
+
+    // Every slot can be claimed again once released
+    std::vector<std::unique_ptr<ShmClient>> clients;
+    EXPECT_TRUE(waitFor([&] {
+        try {
+            while (clients.size() < ShmRegion::MAX_CLIENTS - 1) clients.push_back(std::make_unique<ShmClient>(config.name, 100 + clients.size()));
+            return true;
+        }
+        catch (const std::runtime_error&) {
+            return false;
+        }
+    }));
+    EXPECT_THROW(ShmClient(config.name, 999), std::runtime_error);
+}
@@ -0,0 +1,203 @@
+#include "gtest/gtest.h"
+#include "simulationKernel.h"
+#include "limitOrder.h"
+#include "marketOrder.h"
+#include "orderBook.h"
+#include "eventDispatcher.h"
+
+namespace {
+    struct Delivered {
+        SimTime time;
+        bool marketData;
+        std::size_t eventIndex;
+    };
+
+    struct RecordingAgent : SimulationAgent {
+        std::vector<Delivered> received;
+        std::vector<EngineEvent> events;
+
+        void onExecutionReport(SimulationKernel& kernel, const EngineEvent& event) override {
+            received.push_back({kernel.currentTime(), false, event.index()});
+            events.push_back(event);
+        }
+        void onMarketData(SimulationKernel& kernel, const EngineEvent& event) override {
+            received.push_back({kernel.currentTime(), true, event.index()});
+            events.push_back(event);
+        }
+    };
+
+    // Lifts the offer as soon as it sees one
+    struct SnipingAgent : RecordingAgent {
+        TraderID traderID;
+        explicit SnipingAgent(TraderID id) : traderID(id) {}
+
+        void onMarketData(SimulationKernel& kernel, const EngineEvent& event) override {
+            RecordingAgent::onMarketData(kernel, event);
+            if (auto* accepted = std::get_if<OrderAcceptedEvent>(&event); accepted && accepted->side == Side::SELL) {
+                kernel.submitOrder(std::make_unique<MarketOrder>("ES", 0, OrderType::MARKET, Side::BUY, accepted->quantity, traderID));
+            }
+        }
+    };
+
+    TraderLatency latency(SimTime entry, SimTime ack, SimTime marketData) {
+        return {{entry, 0}, {ack, 0}, {marketData, 0}};
+    }
+}
+
+class SimulationKernelTest : public ::testing::Test {
+protected:
+    OrderBook book;
+    EventDispatcher dispatcher;
+    MatchingEngine engine{book, dispatcher};
+};
+
+TEST_F(SimulationKernelTest, OrdersAndReportsArriveAfterTheirLatencies) {
+    SimulationKernel kernel(engine, dispatcher);
+    RecordingAgent seller, observer;
+    kernel.addAgent(1, seller, latency(100, 50, 30));
+    kernel.addAgent(2, observer, latency(0, 0, 500));
+
+    OrderID id = kernel.submitOrder(std::make_unique<LimitOrder>("ES", 0, OrderType::LIMIT, Side::SELL, 10000, 5, 1));
+    kernel.run();
+
+    ASSERT_EQ(seller.received.size(), 2u);
+    EXPECT_EQ(seller.received[0].time, 100 + 30);      // public copy first: market data is faster than acks here
+    EXPECT_TRUE(seller.received[0].marketData);
+    EXPECT_EQ(seller.received[1].time, 100 + 50);
+    EXPECT_FALSE(seller.received[1].marketData);
+    EXPECT_EQ(std::get<OrderAcceptedEvent>(seller.events[1]).orderID, id);
+
+    ASSERT_EQ(observer.received.size(), 1u);
+    EXPECT_EQ(observer.received[0].time, 100 + 500);
+    EXPECT_EQ(kernel.currentTime(), 600);
+    EXPECT_EQ(book.getBestAsk()->quantity, 5u);
+}
+
+TEST_F(SimulationKernelTest, LowerLatencyTraderWinsTheRace) {
+    SimulationKernel kernel(engine, dispatcher);
+    RecordingAgent seller;
+    SnipingAgent fast(2), slow(3);
+    kernel.addAgent(1, seller, latency(10, 10, 10));
+    kernel.addAgent(2, fast, latency(20, 20, 20));
+    kernel.addAgent(3, slow, latency(5, 20, 40));
+
+    kernel.submitOrder(std::make_unique<LimitOrder>("ES", 0, OrderType::LIMIT, Side::SELL, 10000, 5, 1));
+    kernel.run();
+
+    auto filled = [](const RecordingAgent& agent) {
+        Quantity quantity = 0;
+        for (std::size_t i = 0; i < agent.events.size(); ++i) {
+            if (agent.received[i].marketData) continue;
+            if (auto* trade = std::get_if<TradeExecutedEvent>(&agent.events[i])) quantity += trade->quantity;
+        }
+        return quantity;
+    };
+    // Fast sees the offer at 30 and reaches the engine at 50; slow sees it at 50 and arrives at 55
+    EXPECT_EQ(filled(fast), 5u);
+    EXPECT_EQ(filled(slow), 0u);
+    EXPECT_FALSE(book.getBestAsk());
+}
+
+TEST_F(SimulationKernelTest, JitteredRunsAreReproducibleFromTheSeed) {
+    auto simulate = [](std::uint64_t seed) {
+        OrderBook book;
+        EventDispatcher dispatcher;
+        MatchingEngine engine(book, dispatcher);
+        SimulationKernel kernel(engine, dispatcher, seed);
+        RecordingAgent a, b;
+        TraderLatency jittery{{100, 1000}, {100, 1000}, {100, 1000}};
+        kernel.addAgent(1, a, jittery);
+        kernel.addAgent(2, b, jittery);
+        for (int i = 0; i < 20; ++i) {
+            kernel.submitOrder(std::make_unique<LimitOrder>("ES", 0, OrderType::LIMIT, Side::SELL, 10000 + i, 1, 1));
+            kernel.submitOrder(std::make_unique<MarketOrder>("ES", 0, OrderType::MARKET, Side::BUY, 1, 2));
+        }
+        kernel.run();
+        std::vector<SimTime> times;
+        for (const Delivered& d : b.received) times.push_back(d.time);
+        return times;
+    };
+
+    EXPECT_EQ(simulate(7), simulate(7));
+    EXPECT_NE(simulate(7), simulate(8));
+}
+
+TEST_F(SimulationKernelTest, RunUntilStopsAtTheHorizon) {
+    SimulationKernel kernel(engine, dispatcher);
+    RecordingAgent agent;
+    kernel.addAgent(1, agent, latency(1000, 0, 0));
+    kernel.setTimer(1, 5000, 42);
+    kernel.submitOrder(std::make_unique<LimitOrder>("ES", 0, OrderType::LIMIT, Side::BUY, 9900, 1, 1));
+
+    kernel.runUntil(999);
+    EXPECT_EQ(kernel.currentTime(), 999);
+    EXPECT_FALSE(book.getBestBid());
+    kernel.runUntil(1000);
+    EXPECT_EQ(book.getBestBid()->price, 9900u);
+    EXPECT_EQ(kernel.pending(), 1u);
+}
+
+TEST_F(SimulationKernelTest, AgentsWithoutMarketDataOnlyHearAboutTheirOwnOrders) {
+    struct SharedAgent : RecordingAgent {
+        std::vector<TraderID> recipients;
+        void onExecutionReport(SimulationKernel& kernel, const EngineEvent& event) override {
+            RecordingAgent::onExecutionReport(kernel, event);
+            recipients.push_back(kernel.recipient());
+        }
+    };
+    SimulationKernel kernel(engine, dispatcher);
+    SharedAgent shared;
+    RecordingAgent observer;
+    kernel.addAgent(1, shared, latency(0, 10, 0), false);
+    kernel.addAgent(2, shared, latency(0, 20, 0), false);
+    kernel.addAgent(3, observer, latency(0, 0, 5));
+
+    kernel.submitOrder(std::make_unique<LimitOrder>("ES", 0, OrderType::LIMIT, Side::SELL, 10000, 5, 1));
+    kernel.run();
+    kernel.submitOrder(std::make_unique<MarketOrder>("ES", 0, OrderType::MARKET, Side::BUY, 5, 2));
+    kernel.run();
+
+    // Accepted to 1, then the trade to 1 and to 2; nothing as market data
+    EXPECT_EQ(shared.recipients, (std::vector<TraderID>{1, 1, 2}));
+    for (const Delivered& d : shared.received) EXPECT_FALSE(d.marketData);
+    EXPECT_EQ(observer.received.size(), 2u);
+}
+
+TEST_F(SimulationKernelTest, JitterNeverDeliversACancelBeforeItsOrder) {
+    SimulationKernel kernel(engine, dispatcher, 3);
+    RecordingAgent agent;
+    kernel.addAgent(1, agent, {{0, 1'000'000}, {0, 0}, {0, 0}}, false);
+
+    for (int i = 0; i < 50; ++i) {
+        OrderID id = kernel.submitOrder(std::make_unique<LimitOrder>("ES", 0, OrderType::LIMIT, Side::BUY, 9900, 1, 1));
+        kernel.cancelOrder(1, id);
+    }
+    kernel.run();
+
+    std::size_t cancelled = 0;
+    for (const EngineEvent& event : agent.events) cancelled += std::holds_alternative<OrderCancelledEvent>(event);
+    EXPECT_EQ(cancelled, 50u);
+    EXPECT_FALSE(book.getBestBid());
+}
+
+TEST_F(SimulationKernelTest, EngineRunsOnSimulatedTime) {
+    const Timestamp origin = Timestamp(std::chrono::hours(24 * 365));
+    SimulationKernel kernel(engine, dispatcher, 1, origin);
+    RecordingAgent seller, buyer;
+    kernel.addAgent(1, seller, latency(0, 0, 0), false);
+    kernel.addAgent(2, buyer, latency(3'000'000, 0, 0), false);
+
+    auto expiring = std::make_unique<LimitOrder>("ES", 0, OrderType::LIMIT, Side::SELL, 10001, 1, 1);
+    expiring->setTimeInForce(TimeInForce::GTD);
+    expiring->setExpireTime(kernel.timestampAt(2'000'000));
+    kernel.submitOrder(std::move(expiring));
+    kernel.submitOrder(std::make_unique<LimitOrder>("ES", 0, OrderType::LIMIT, Side::SELL, 10002, 1, 1));
+    kernel.submitOrder(std::make_unique<MarketOrder>("ES", 0, OrderType::MARKET, Side::BUY, 1, 2));
+    kernel.run();
+
+    // The GTD order expired at 2 ms, before the buyer arrived at 3 ms
+    ASSERT_EQ(buyer.events.size(), 1u);
+    const auto& trade = std::get<TradeExecutedEvent>(buyer.events[0]);
+    EXPECT_EQ(trade.price, 10002u);
+    EXPECT_EQ(trade.timestamp, origin + std::chrono::milliseconds(3));
+}
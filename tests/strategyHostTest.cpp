@@ -0,0 +1,98 @@
+#include "gtest/gtest.h"
+#include "strategyHost.h"
+#include "matchingEngine.h"
+#include "limitOrder.h"
+#include "orderBook.h"
+#include "eventDispatcher.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+    // Buys on every bar and records what it is told
+    struct RecordingStrategy : Strategy {
+        StrategyContext* context = nullptr;
+        std::atomic<int> fills{0};
+        std::atomic<int> ticks{0};
+        std::atomic<Price> lastAsk{0};
+        std::atomic<std::int64_t> position{0};
+        std::atomic<bool> stopped{false};
+
+        void onStart(StrategyContext& ctx) override { context = &ctx; }
+        void onBar(const Bar& bar) override { context->submitLimit(bar.symbol, Side::BUY, static_cast<Price>(bar.close), 5); }
+        void onTick(const Tick&) override { ticks++; }
+        void onFill(const Fill& fill) override {
+            EXPECT_EQ(fill.side, Side::BUY);
+            position = context->position(fill.symbol);
+            fills++;
+        }
+        void onBookUpdate(const BookUpdate& top) override { lastAsk = top.askPrice; }
+        void onStop() override { stopped = true; }
+    };
+
+    template<typename Predicate>
+    bool waitFor(Predicate predicate) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (!predicate()) {
+            if (std::chrono::steady_clock::now() > deadline) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+}
+
+class StrategyHostTest : public ::testing::Test {
+protected:
+    OrderBook book;
+    EventDispatcher dispatcher;
+    MatchingEngine engine{book, dispatcher};
+    StrategyHost host{engine, dispatcher, book, {STRATEGY_PLUGIN_DIR}};
+    std::atomic<Quantity> strategyBuys{0};
+
+    void SetUp() override { engine.start(); }
+    void TearDown() override { engine.stop(); }
+};
+
+TEST_F(StrategyHostTest, HostedStrategy_TradesThroughEngineAndSeesItsFills) {
+    auto owned = std::make_unique<RecordingStrategy>();
+    RecordingStrategy& strategy = *owned;
+    host.add(std::move(owned), 7);
+
+    engine.submitOrder(std::make_unique<LimitOrder>("AAPL", 0, OrderType::LIMIT, Side::SELL, 10000, 8, 99));
+    EXPECT_TRUE(waitFor([&] { return strategy.lastAsk == 10000; }));
+
+    host.publishBar(Bar{"AAPL", {}, 0, 0, 0, 10000, 0});
+    EXPECT_TRUE(waitFor([&] { return strategy.fills == 1; }));
+    EXPECT_EQ(strategy.ticks, 1);
+    EXPECT_EQ(strategy.position, 5);
+
+    host.stop();
+    EXPECT_TRUE(strategy.stopped);
+    host.publishBar(Bar{"AAPL", {}, 0, 0, 0, 10000, 0});
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(strategy.fills, 1);
+}
+
+TEST_F(StrategyHostTest, LoadsPluginByName_AndRoutesBarsToIt) {
+    dispatcher.subscribe<TradeExecutedEvent>([&](const TradeExecutedEvent& e) {
+        if (e.aggressingTraderID == 3 && e.aggressingSide == Side::BUY) strategyBuys += e.quantity;
+    });
+    host.load("ma_crossover", 3, "symbol=ES,short=1,long=2,quantity=4");
+    EXPECT_EQ(host.size(), 1u);
+
+    engine.submitOrder(std::make_unique<LimitOrder>("ES", 0, OrderType::LIMIT, Side::SELL, 10100, 10, 99));
+    // The one-bar average crosses above the two-bar average on the rise
+    host.publishBar(Bar{"ES", {}, 0, 0, 0, 100.0, 0});
+    host.publishBar(Bar{"ES", {}, 0, 0, 0, 101.0, 0});
+    EXPECT_TRUE(waitFor([&] { return strategyBuys == 4; }));
+}
+
+TEST_F(StrategyHostTest, RejectsMissingLibrariesAndDuplicateTraders) {
+    EXPECT_THROW(host.load("no_such_strategy", 1), std::runtime_error);
+    EXPECT_THROW(host.load("/nonexistent/libstrategy.so", 1), std::runtime_error);
+
+    host.add(std::make_unique<RecordingStrategy>(), 1);
+    EXPECT_THROW(host.add(std::make_unique<RecordingStrategy>(), 1), std::invalid_argument);
+    EXPECT_THROW(host.load("ma_crossover", 1), std::invalid_argument);
+    EXPECT_EQ(host.size(), 1u);
+}
@@ -0,0 +1,124 @@
+#include "gtest/gtest.h"
+#include "timingWheel.h"
+#include <algorithm>
+#include <map>
+#include <random>
+
+TEST(TimingWheelTest, FiresInDeadlineOrderAcrossLevels) {
+    TimingWheel wheel(1'700'000'000'000);
+    wheel.schedule(1'700'000'000'000 + 86'400'000, 4);     // a day out
+    wheel.schedule(1'700'000'000'000 + 5, 1);
+    wheel.schedule(1'700'000'000'000 + 70, 2);
+    wheel.schedule(1'700'000'000'000 + 5'000, 3);
+    EXPECT_EQ(wheel.size(), 4u);
+
+    std::vector<std::uint64_t> expired;
+    wheel.advance(1'700'000'000'000 + 4, expired);
+    EXPECT_TRUE(expired.empty());
+    wheel.advance(1'700'000'000'000 + 5'000, expired);
+    EXPECT_EQ(expired, (std::vector<std::uint64_t>{1, 2, 3}));
+    wheel.advance(1'700'000'000'000 + 86'400'000, expired);
+    EXPECT_EQ(expired, (std::vector<std::uint64_t>{1, 2, 3, 4}));
+    EXPECT_EQ(wheel.size(), 0u);
+}
+
+TEST(TimingWheelTest, CancelledTimersNeverFire) {
+    TimingWheel wheel;
+    TimingWheel::Handle a = wheel.schedule(100, 1);
+    TimingWheel::Handle b = wheel.schedule(100, 2);
+    wheel.schedule(100, 3);
+    wheel.cancel(b);
+    wheel.cancel(a);
+    EXPECT_EQ(wheel.size(), 1u);
+
+    // Freed handles are reused
+    wheel.schedule(200, 4);
+    std::vector<std::uint64_t> expired;
+    wheel.advance(1000, expired);
+    EXPECT_EQ(expired, (std::vector<std::uint64_t>{3, 4}));
+}
+
+TEST(TimingWheelTest, PastDeadlinesFireOnTheNextAdvance) {
+    TimingWheel wheel(500);
+    wheel.schedule(10, 1);
+    wheel.schedule(500, 2);
+
+    std::vector<std::uint64_t> expired;
+    wheel.advance(400, expired);
+    EXPECT_TRUE(expired.empty());
+    EXPECT_EQ(wheel.now(), 500);
+    wheel.advance(501, expired);
+    EXPECT_EQ(expired.size(), 2u);
+}
+
+TEST(TimingWheelTest, NextDueNeverPassesTheEarliestDeadline) {
+    TimingWheel wheel(1'700'000'000'000);
+    EXPECT_FALSE(wheel.nextDue());
+    wheel.schedule(1'700'000'000'000 + 5'000, 1);
+    wheel.schedule(1'700'000'000'000 + 86'400'000, 2);
+
+    // A coarse level may have to cascade before the deadline itself is known
+    std::vector<std::uint64_t> expired;
+    std::optional<std::int64_t> due = wheel.nextDue();
+    while (due && expired.empty()) {
+        EXPECT_LE(*due, 1'700'000'000'000 + 5'000);
+        wheel.advance(*due, expired);
+        due = wheel.nextDue();
+    }
+    EXPECT_EQ(wheel.now(), 1'700'000'000'000 + 5'000);
+    EXPECT_EQ(expired, (std::vector<std::uint64_t>{1}));
+    EXPECT_LE(*wheel.nextDue(), 1'700'000'000'000 + 86'400'000);
+}
+
+TEST(TimingWheelTest, MatchesAnOrderedMapUnderRandomLoad) {
+    std::mt19937_64 rng(11);
+    TimingWheel wheel(1'000'000);
+    std::multimap<std::int64_t, std::uint64_t> reference;
+    std::map<std::uint64_t, std::pair<TimingWheel::Handle, std::int64_t>> live;
+    std::int64_t now = 1'000'000;
+    std::uint64_t nextID = 0;
+
+    for (int step = 0; step < 20000; ++step) {
+        const unsigned action = rng() % 10;
+        if (action < 6) {
+            // Mostly near deadlines, some hours or years out
+            const std::int64_t horizon = rng() % 8 == 0 ? std::int64_t{1} << (rng() % 40) : 1 + rng() % 5000;
+            const std::int64_t deadline = now + 1 + static_cast<std::int64_t>(rng() % horizon);
+            live[nextID] = {wheel.schedule(deadline, nextID), deadline};
+            reference.emplace(deadline, nextID++);
+        }
+        else if (action < 8 && !live.empty()) {
+            auto it = live.lower_bound(rng() % nextID);
+            if (it == live.end()) it = live.begin();
+            wheel.cancel(it->second.first);
+            auto [first, last] = reference.equal_range(it->second.second);
+            for (; first != last; ++first) {
+                if (first->second == it->first) {
+                    reference.erase(first);
+                    break;
+                }
+            }
+            live.erase(it);
+        }
+        else {
+            now += rng() % 4 == 0 ? static_cast<std::int64_t>(rng() % (std::int64_t{1} << 30)) : static_cast<std::int64_t>(rng() % 3000);
+            std::vector<std::uint64_t> expired;
+            wheel.advance(now, expired);
+
+            std::vector<std::int64_t> deadlines;
+            for (std::uint64_t id : expired) {
+                deadlines.push_back(live.at(id).second);
+                live.erase(id);
+            }
+            ASSERT_TRUE(std::is_sorted(deadlines.begin(), deadlines.end()));
+
+            std::size_t due = 0;
+            while (!reference.empty() && reference.begin()->first <= now) {
+                reference.erase(reference.begin());
+                due++;
+            }
+            ASSERT_EQ(expired.size(), due) << "step " << step;
+        }
+        ASSERT_EQ(wheel.size(), reference.size());
+    }
+}
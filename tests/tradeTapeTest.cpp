@@ -0,0 +1,157 @@
+#include "gtest/gtest.h"
+#include "tradeTape.h"
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <sstream>
+#include <unistd.h>
+
+class TradeTapeTest : public ::testing::Test {
+protected:
+    str path = "/tmp/trade_tape_test_" + std::to_string(getpid()) + ".tape";
+
+    void TearDown() override { std::remove(path.c_str()); }
+
+    static TradeExecutedEvent trade(const str& symbol, Price price, Quantity quantity, OrderID aggressor, TraderID aggressorTrader,
+                                    OrderID resting, TraderID restingTrader, Side side = Side::BUY) {
+        return TradeExecutedEvent{symbol, price, quantity, aggressor, aggressorTrader, side, 0, resting, restingTrader, 5};
+    }
+};
+
+TEST_F(TradeTapeTest, RoundTripsEveryFieldAcrossBlocks) {
+    {
+        TradeTapeWriter writer(path, 4);
+        for (int i = 0; i < 10; ++i) {
+            writer.setClock(1'700'000'000'000 + i * 250);
+            TradeExecutedEvent e = trade(i % 3 ? "ES" : "NQ", 10000 - i * 3, 1 + i, 100 + i, 7, 50 - i, 8, i % 2 ? Side::SELL : Side::BUY);
+            e.aggressingRemainingQuantity = i;
+            writer.onTrade(e);
+        }
+        EXPECT_EQ(writer.tradeCount(), 10u);
+    }
+
+    TradeTapeReader reader(path);
+    EXPECT_EQ(reader.tradeCount(), 10u);
+    EXPECT_EQ(reader.blockIndex().size(), 3u);
+    EXPECT_EQ(reader.symbols(), (std::vector<str>{"NQ", "ES"}));
+
+    std::vector<TapeTrade> trades = reader.sequenceRange(0, 100);
+    ASSERT_EQ(trades.size(), 10u);
+    for (int i = 0; i < 10; ++i) {
+        const TapeTrade& t = trades[i];
+        EXPECT_EQ(t.sequence, static_cast<std::uint64_t>(i));
+        EXPECT_EQ(t.timestamp, 1'700'000'000'000 + i * 250);
+        EXPECT_EQ(reader.symbols()[t.symbol], i % 3 ? "ES" : "NQ");
+        EXPECT_EQ(t.price, static_cast<Price>(10000 - i * 3));
+        EXPECT_EQ(t.quantity, static_cast<Quantity>(1 + i));
+        EXPECT_EQ(t.aggressingOrderID, static_cast<OrderID>(100 + i));
+        EXPECT_EQ(t.aggressingTraderID, 7u);
+        EXPECT_EQ(t.aggressingSide, i % 2 ? Side::SELL : Side::BUY);
+        EXPECT_EQ(t.aggressingRemainingQuantity, static_cast<Quantity>(i));
+        EXPECT_EQ(t.restingOrderID, static_cast<OrderID>(50 - i));
+        EXPECT_EQ(t.restingTraderID, 8u);
+        EXPECT_EQ(t.restingRemainingQuantity, 5u);
+    }
+
+    trades = reader.sequenceRange(5, 7);
+    ASSERT_EQ(trades.size(), 2u);
+    EXPECT_EQ(trades[0].sequence, 5u);
+    EXPECT_EQ(reader.blocksDecoded(), 1u);
+}
+
+TEST_F(TradeTapeTest, RoundTripsFullWidthValues) {
+    std::mt19937_64 rng(5);
+    std::vector<TradeExecutedEvent> written;
+    {
+        TradeTapeWriter writer(path, 97);
+        for (int i = 0; i < 1000; ++i) {
+            // Random ids make the deltas span all 64 bits; prices and quantities vary in width block to block
+            TradeExecutedEvent e = trade("ES", static_cast<Price>(rng() >> (rng() % 64)), static_cast<Quantity>(rng()), rng(),
+                                         static_cast<TraderID>(rng()), rng(), static_cast<TraderID>(rng()));
+            writer.setClock(static_cast<std::int64_t>(rng() >> 1));
+            writer.onTrade(e);
+            written.push_back(e);
+        }
+    }
+    TradeTapeReader reader(path);
+    std::vector<TapeTrade> trades = reader.sequenceRange(0, 1000);
+    ASSERT_EQ(trades.size(), 1000u);
+    for (std::size_t i = 0; i < trades.size(); ++i) {
+        ASSERT_EQ(trades[i].price, written[i].price) << i;
+        ASSERT_EQ(trades[i].quantity, written[i].quantity) << i;
+        ASSERT_EQ(trades[i].aggressingOrderID, written[i].aggressingOrderID) << i;
+        ASSERT_EQ(trades[i].restingTraderID, written[i].restingTraderID) << i;
+    }
+}
+
+TEST_F(TradeTapeTest, QueriesDecodeOnlyBlocksThatCanMatch) {
+    {
+        TradeTapeWriter writer(path, 1000);
+        for (int i = 0; i < 10000; ++i) {
+            writer.setClock(1'000'000 + i * 10);
+            writer.onTrade(trade(i < 5000 ? "ES" : "NQ", 10000 + i % 5, 1, i * 2, 1 + i % 4, i * 2 + 1, i == 4321 ? 99 : 2));
+        }
+    }
+    TradeTapeReader reader(path);
+
+    TapeQuery window;
+    window.from = 1'000'000 + 2500 * 10;
+    window.to = 1'000'000 + 2600 * 10;
+    std::vector<TapeTrade> trades = reader.query(window);
+    ASSERT_EQ(trades.size(), 100u);
+    EXPECT_EQ(trades.front().sequence, 2500u);
+    EXPECT_EQ(reader.blocksDecoded(), 1u);
+
+    TapeQuery trader;
+    trader.traderID = 99;
+    trades = reader.query(trader);
+    ASSERT_EQ(trades.size(), 1u);
+    EXPECT_EQ(trades[0].restingOrderID, 4321u * 2 + 1);
+    EXPECT_EQ(reader.blocksDecoded(), 1u);
+
+    TapeQuery symbol;
+    symbol.symbol = "NQ";
+    symbol.from = 1'000'000 + 4000 * 10;
+    EXPECT_EQ(reader.query(symbol).size(), 5000u);
+    EXPECT_EQ(reader.blocksDecoded(), 5u);
+
+    symbol.symbol = "CL";
+    EXPECT_TRUE(reader.query(symbol).empty());
+    EXPECT_EQ(reader.blocksDecoded(), 0u);
+}
+
+TEST_F(TradeTapeTest, IsAnOrderOfMagnitudeSmallerThanCsv) {
+    std::mt19937 rng(3);
+    std::ostringstream csv;
+    {
+        TradeTapeWriter writer(path);
+        Price price = 450000;
+        OrderID nextOrder = 1;
+        std::int64_t time = 1'700'000'000'000;
+        for (int i = 0; i < 100000; ++i) {
+            time += rng() % 50;
+            price += static_cast<Price>(rng() % 3) - 1;
+            const Quantity quantity = 1 + rng() % 10;
+            const OrderID resting = nextOrder - rng() % 20;
+            TradeExecutedEvent e = trade("ES", price, quantity, nextOrder++, 1 + rng() % 50, resting, 1 + rng() % 50);
+            writer.setClock(time);
+            writer.onTrade(e);
+            csv << time << ",ES," << price / 100.0 << ',' << quantity << ',' << e.aggressingOrderID << ',' << e.aggressingTraderID
+                << ",BUY," << e.aggressingRemainingQuantity << ',' << e.restingOrderID << ',' << e.restingTraderID << ','
+                << e.restingRemainingQuantity << '\n';
+        }
+    }
+    const std::size_t tapeBytes = std::filesystem::file_size(path);
+    EXPECT_LT(tapeBytes * 10, csv.str().size()) << tapeBytes << " vs " << csv.str().size();
+}
+
+TEST_F(TradeTapeTest, RejectsUnclosedOrForeignFiles) {
+    TradeTapeWriter writer(path);
+    writer.onTrade(trade("ES", 10000, 1, 1, 1, 2, 2));
+    writer.flush();
+    EXPECT_THROW(TradeTapeReader{path}, std::runtime_error);
+    writer.close();
+    EXPECT_EQ(TradeTapeReader(path).tradeCount(), 1u);
+
+    EXPECT_THROW(TradeTapeReader{"/nonexistent/tape"}, std::runtime_error);
+}
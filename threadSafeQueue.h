@@ -1,7 +1,9 @@
 #pragma once
+#include <chrono>
 #include <queue>
 #include <mutex>
 #include <condition_variable>
+#include <vector>
 
 template<typename T>
 class ThreadSafeQueue {
@@ -26,4 +28,34 @@ public:
         queue.pop();
         return value;
     }
+
+    // Non-blocking pop for busy-polling consumers
+    bool tryPop(T& value) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (queue.empty()) return false;
+        value = std::move(queue.front());
+        queue.pop();
+        return true;
+    }
+
+    // Moves up to `max` items into `out` under one lock; returns how many
+    std::size_t tryPopMany(std::vector<T>& out, std::size_t max) {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::size_t count = 0;
+        for (; count < max && !queue.empty(); ++count) {
+            out.push_back(std::move(queue.front()));
+            queue.pop();
+        }
+        return count;
+    }
+
+    // Blocks for at most `timeout`; false if nothing arrived
+    template<typename Rep, typename Period>
+    bool tryPopFor(T& value, std::chrono::duration<Rep, Period> timeout) {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (!cv.wait_for(lock, timeout, [this]{ return !queue.empty(); })) return false;
+        value = std::move(queue.front());
+        queue.pop();
+        return true;
+    }
 };
\ No newline at end of file
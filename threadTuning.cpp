@@ -0,0 +1,90 @@
+#include "threadTuning.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <new>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <linux/mempolicy.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+    constexpr std::size_t PREFAULT_CHUNK = 1 << 20;
+    constexpr std::size_t PREFAULT_STACK = 256 * 1024;
+
+    [[gnu::noinline]] void prefaultStack() {
+        char stack[PREFAULT_STACK];
+        std::memset(stack, 0, sizeof(stack));
+        // Keep the stores from being optimized away
+        asm volatile("" : : "r"(stack) : "memory");
+    }
+}
+
+void pinCurrentThread(int core) {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(core, &cpuset);
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+    if (rc != 0) throw std::system_error(rc, std::generic_category(), "Could not pin thread to core " + std::to_string(core));
+}
+
+void setCurrentThreadRealtime(int priority) {
+    sched_param param{};
+    param.sched_priority = priority;
+    int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (rc != 0) throw std::system_error(rc, std::generic_category(), "Could not set SCHED_FIFO priority");
+}
+
+int numaNodeOfCore(int core) {
+    std::error_code error;
+    const std::filesystem::path cpu = "/sys/devices/system/cpu/cpu" + std::to_string(core);
+    for (const auto& entry : std::filesystem::directory_iterator(cpu, error)) {
+        const std::string name = entry.path().filename().string();
+        if (name.rfind("node", 0) == 0 && name.size() > 4) return std::atoi(name.c_str() + 4);
+    }
+    return 0;
+}
+
+void bindCurrentThreadMemory(int node) {
+    if (node < 0 || node >= static_cast<int>(sizeof(unsigned long) * 8)) {
+        throw std::system_error(EINVAL, std::generic_category(), "Could not bind memory to NUMA node " + std::to_string(node));
+    }
+    const unsigned long mask = 1UL << node;
+    if (syscall(SYS_set_mempolicy, MPOL_BIND, &mask, sizeof(mask) * 8) != 0) {
+        throw std::system_error(errno, std::generic_category(), "Could not bind memory to NUMA node " + std::to_string(node));
+    }
+}
+
+void prefaultMemory(std::size_t heapBytes) {
+    // Large blocks would otherwise be mmapped and unmapped again on free
+    mallopt(M_MMAP_MAX, 0);
+    mallopt(M_TRIM_THRESHOLD, -1);
+
+    // Allocated in chunks so a thread arena's heaps can hold them
+    std::vector<void*> chunks;
+    chunks.reserve(heapBytes / PREFAULT_CHUNK + 1);
+    for (std::size_t done = 0; done < heapBytes; done += PREFAULT_CHUNK) {
+        void* chunk = std::malloc(PREFAULT_CHUNK);
+        if (chunk == nullptr) {
+            for (void* allocated : chunks) std::free(allocated);
+            throw std::bad_alloc();
+        }
+        std::memset(chunk, 0, PREFAULT_CHUNK);
+        chunks.push_back(chunk);
+    }
+    for (void* chunk : chunks) std::free(chunk);
+    prefaultStack();
+}
+
+void lockProcessMemory() {
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        throw std::system_error(errno, std::generic_category(), "Could not lock process memory");
+    }
+}
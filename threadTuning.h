@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// Helpers for running latency-sensitive threads on isolated cores. All of them
+// act on the calling thread so they can be applied from inside the thread
+// before it touches any of its working memory.
+
+// Pins the calling thread to a single core. Throws std::system_error on failure.
+void pinCurrentThread(int core);
+
+// Switches the calling thread to SCHED_FIFO at the given priority. Usually
+// requires CAP_SYS_NICE. Throws std::system_error on failure.
+void setCurrentThreadRealtime(int priority);
+
+// NUMA node the core belongs to, from sysfs; 0 where the kernel reports no nodes.
+int numaNodeOfCore(int core);
+
+// Restricts the calling thread's future page allocations to one NUMA node
+// (set_mempolicy MPOL_BIND). Throws std::system_error on failure.
+void bindCurrentThreadMemory(int node);
+
+// Faults in `heapBytes` of the calling thread's malloc arena and a slab of its
+// stack, then hands the heap back to malloc with trimming and mmap turned off
+// so later allocations reuse the resident pages. The malloc settings are
+// process-wide. Throws std::bad_alloc if the heap cannot grow that far.
+void prefaultMemory(std::size_t heapBytes);
+
+// Locks current and future pages of the process into RAM so the hot path never
+// takes a major page fault. Throws std::system_error on failure.
+void lockProcessMemory();
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
@@ -0,0 +1,120 @@
+#include "timingWheel.h"
+#include <bit>
+
+TimingWheel::TimingWheel(std::int64_t start) : current(start) {
+    buckets.fill(NONE);
+}
+
+TimingWheel::Handle TimingWheel::schedule(std::int64_t deadline, std::uint64_t id) {
+    Handle handle;
+    if (freeList != NONE) {
+        handle = freeList;
+        freeList = timers[handle].next;
+    }
+    else {
+        handle = static_cast<Handle>(timers.size());
+        timers.emplace_back();
+    }
+    timers[handle].deadline = deadline > current ? deadline : current + 1;
+    timers[handle].id = id;
+    insert(handle);
+    count++;
+    return handle;
+}
+
+void TimingWheel::insert(Handle handle) {
+    Timer& timer = timers[handle];
+    const std::uint64_t differing = static_cast<std::uint64_t>(timer.deadline) ^ static_cast<std::uint64_t>(current);
+    const int level = (std::bit_width(differing) - 1) / SLOT_BITS;
+    const int slot = static_cast<int>((static_cast<std::uint64_t>(timer.deadline) >> (level * SLOT_BITS)) & (SLOTS - 1));
+
+    timer.bucket = static_cast<std::uint16_t>(level * SLOTS + slot);
+    timer.prev = NONE;
+    timer.next = buckets[timer.bucket];
+    if (timer.next != NONE) timers[timer.next].prev = handle;
+    buckets[timer.bucket] = handle;
+    occupied[level] |= std::uint64_t{1} << slot;
+}
+
+void TimingWheel::cancel(Handle handle) {
+    Timer& timer = timers[handle];
+    if (timer.next != NONE) timers[timer.next].prev = timer.prev;
+    if (timer.prev != NONE) {
+        timers[timer.prev].next = timer.next;
+    }
+    else {
+        buckets[timer.bucket] = timer.next;
+        if (timer.next == NONE) occupied[timer.bucket / SLOTS] &= ~(std::uint64_t{1} << (timer.bucket % SLOTS));
+    }
+    release(handle);
+}
+
+void TimingWheel::release(Handle handle) {
+    timers[handle].next = freeList;
+    freeList = handle;
+    count--;
+}
+
+bool TimingWheel::nextSlot(int& level, int& slot, std::int64_t& reached) const {
+    // Every slot at or behind the current digit is empty, so the next thing
+    // to happen is the first occupied slot ahead of it on the lowest level
+    // that has one.
+    for (level = 0; level < LEVELS; ++level) {
+        const int digit = static_cast<int>((static_cast<std::uint64_t>(current) >> (level * SLOT_BITS)) & (SLOTS - 1));
+        const std::uint64_t ahead = digit == SLOTS - 1 ? 0 : occupied[level] & (~std::uint64_t{0} << (digit + 1));
+        if (ahead) {
+            slot = std::countr_zero(ahead);
+            break;
+        }
+    }
+    if (level == LEVELS) return false;
+
+    // The clock reaches that slot when its digit turns over and every lower digit is zero
+    const int shift = level * SLOT_BITS;
+    const int above = shift + SLOT_BITS;
+    const std::uint64_t high = above >= 64 ? 0 : (static_cast<std::uint64_t>(current) >> above) << above;
+    reached = static_cast<std::int64_t>(high | (static_cast<std::uint64_t>(slot) << shift));
+    return true;
+}
+
+std::optional<std::int64_t> TimingWheel::nextDue() const {
+    int level, slot;
+    std::int64_t reached;
+    if (!nextSlot(level, slot, reached)) return std::nullopt;
+    return reached;
+}
+
+void TimingWheel::advance(std::int64_t now, std::vector<std::uint64_t>& expired) {
+    if (now <= current) return;
+
+    int level, slot;
+    std::int64_t reached;
+    while (nextSlot(level, slot, reached) && reached <= now) {
+        current = reached;
+
+        const std::size_t bucket = static_cast<std::size_t>(level * SLOTS + slot);
+        Handle handle = buckets[bucket];
+        buckets[bucket] = NONE;
+        occupied[level] &= ~(std::uint64_t{1} << slot);
+        while (handle != NONE) {
+            const Handle next = timers[handle].next;
+            if (timers[handle].deadline <= current) {
+                expired.push_back(timers[handle].id);
+                release(handle);
+            }
+            else {
+                insert(handle);
+            }
+            handle = next;
+        }
+    }
+    current = now;
+}
+
+void TimingWheel::clear() {
+    timers.clear();
+    freeList = NONE;
+    buckets.fill(NONE);
+    occupied.fill(0);
+    count = 0;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Hierarchical timing wheel over integer ticks. Times are split into 6-bit
+// digits and every digit gets a level of 64 slots: a timer sits on the level
+// of the highest digit where its deadline differs from the current time, in
+// the slot for that digit. Scheduling and cancelling are O(1), and a timer
+// cascades down at most once per level before it fires. Per-level occupancy
+// bitmaps let advance() jump straight to the next occupied slot, so moving
+// the clock a whole day costs no more than moving it a tick.
+class TimingWheel {
+    public:
+        using Handle = std::uint32_t;
+        static constexpr Handle NONE = ~Handle{0};
+
+    private:
+        static constexpr int SLOT_BITS = 6;
+        static constexpr int SLOTS = 1 << SLOT_BITS;
+        static constexpr int LEVELS = (64 + SLOT_BITS - 1) / SLOT_BITS;
+
+        struct Timer {
+            std::int64_t deadline;
+            std::uint64_t id;
+            Handle prev;
+            Handle next;
+            std::uint16_t bucket;   // level * SLOTS + slot
+        };
+
+        std::vector<Timer> timers;      // slab; free entries are chained through `next`
+        Handle freeList = NONE;
+        std::array<Handle, LEVELS * SLOTS> buckets;
+        std::array<std::uint64_t, LEVELS> occupied{};
+        std::int64_t current;
+        std::size_t count = 0;
+
+        void insert(Handle handle);
+        void release(Handle handle);
+        bool nextSlot(int& level, int& slot, std::int64_t& reached) const;
+
+    public:
+        explicit TimingWheel(std::int64_t start = 0);
+
+        // Deadlines at or before now() fire on the next advance. The handle is
+        // valid until the timer fires or is cancelled.
+        Handle schedule(std::int64_t deadline, std::uint64_t id);
+        void cancel(Handle handle);
+
+        // Moves the clock to `now` and appends the ids of every timer whose
+        // deadline has passed, in deadline order. Never moves backwards.
+        void advance(std::int64_t now, std::vector<std::uint64_t>& expired);
+
+        // The earliest time advance() has anything to do: the next deadline,
+        // or earlier when a coarser level has to cascade first. Empty when no
+        // timer is scheduled.
+        std::optional<std::int64_t> nextDue() const;
+
+        // Drops every timer; outstanding handles become invalid.
+        void clear();
+
+        std::int64_t now() const { return current; }
+        std::size_t size() const { return count; }
+};
@@ -0,0 +1,435 @@
+#include "tradeTape.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    constexpr char MAGIC[8] = {'T', 'R', 'D', 'T', 'A', 'P', 'E', '1'};
+
+    enum Column : std::size_t {
+        TIME, SYMBOL, PRICE, QUANTITY,
+        AGGRESSING_SIDE, AGGRESSING_ORDER, AGGRESSING_TRADER, AGGRESSING_REMAINING,
+        RESTING_ORDER, RESTING_TRADER, RESTING_REMAINING,
+        COLUMN_COUNT
+    };
+    // Columns that move slowly from row to row are stored as deltas
+    constexpr bool DELTA[COLUMN_COUNT] = {true, false, true, false, false, true, false, false, true, false, false};
+
+    std::uint64_t columnValue(const TapeTrade& t, std::size_t column) {
+        switch (column) {
+            case TIME: return static_cast<std::uint64_t>(t.timestamp);
+            case SYMBOL: return t.symbol;
+            case PRICE: return t.price;
+            case QUANTITY: return t.quantity;
+            case AGGRESSING_SIDE: return t.aggressingSide == Side::BUY ? 0 : 1;
+            case AGGRESSING_ORDER: return t.aggressingOrderID;
+            case AGGRESSING_TRADER: return t.aggressingTraderID;
+            case AGGRESSING_REMAINING: return t.aggressingRemainingQuantity;
+            case RESTING_ORDER: return t.restingOrderID;
+            case RESTING_TRADER: return t.restingTraderID;
+            default: return t.restingRemainingQuantity;
+        }
+    }
+
+    std::uint64_t zigzag(std::int64_t v) { return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63); }
+    std::int64_t unzigzag(std::uint64_t v) { return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1); }
+
+    void putVarint(str& out, std::uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    // Frame of reference plus bit packing: the column minimum as a varint, the
+    // bit width of the largest offset from it, then every offset at that width.
+    // Constant columns cost two bytes per block.
+    void packColumn(str& out, const std::vector<std::uint64_t>& values) {
+        const std::uint64_t base = *std::min_element(values.begin(), values.end());
+        std::uint64_t spread = 0;
+        for (std::uint64_t value : values) spread |= value - base;
+        const unsigned width = spread == 0 ? 0 : 64 - __builtin_clzll(spread);
+        putVarint(out, base);
+        out.push_back(static_cast<char>(width));
+        if (width == 0) return;
+
+        std::uint64_t word = 0;
+        unsigned bits = 0;
+        auto emit = [&out](std::uint64_t bytes, unsigned count) {
+            for (unsigned i = 0; i < count; ++i) out.push_back(static_cast<char>(bytes >> (8 * i)));
+        };
+        for (std::uint64_t value : values) {
+            value -= base;
+            word |= value << bits;
+            if (bits + width >= 64) {
+                emit(word, 8);
+                const unsigned used = 64 - bits;
+                word = used < 64 ? value >> used : 0;
+                bits = bits + width - 64;
+            }
+            else {
+                bits += width;
+            }
+        }
+        emit(word, (bits + 7) / 8);
+    }
+
+    template<typename T>
+    void put(str& out, T value) {
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        out.append(bytes, sizeof(T));
+    }
+
+    struct Cursor {
+        const std::uint8_t* p;
+        const std::uint8_t* end;
+
+        std::uint64_t varint() {
+            std::uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (p == end) throw std::runtime_error("Corrupt trade tape: truncated varint");
+                const std::uint8_t byte = *p++;
+                value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+                if (!(byte & 0x80)) return value;
+            }
+            throw std::runtime_error("Corrupt trade tape: varint too long");
+        }
+
+        void unpackColumn(std::vector<std::uint64_t>& values, std::size_t count) {
+            const std::uint64_t base = varint();
+            if (p == end) throw std::runtime_error("Corrupt trade tape: truncated column");
+            const unsigned width = *p++;
+            if (width > 64) throw std::runtime_error("Corrupt trade tape: bad bit width");
+            values.assign(count, base);
+            if (width == 0) return;
+            if (static_cast<std::size_t>(end - p) * 8 < count * width) throw std::runtime_error("Corrupt trade tape: truncated column");
+
+            const std::uint64_t mask = width == 64 ? ~0ull : (1ull << width) - 1;
+            std::uint64_t word = 0;
+            unsigned bits = 0;
+            for (std::size_t i = 0; i < count; ++i) {
+                if (bits >= width) {
+                    values[i] += word & mask;
+                    word = width < 64 ? word >> width : 0;
+                    bits -= width;
+                    continue;
+                }
+                std::uint64_t fresh = 0;
+                const unsigned available = static_cast<unsigned>(std::min<std::ptrdiff_t>(8, end - p));
+                for (unsigned b = 0; b < available; ++b) fresh |= static_cast<std::uint64_t>(p[b]) << (8 * b);
+                p += available;
+                const unsigned needed = width - bits;
+                values[i] += (word | (bits < 64 ? fresh << bits : 0)) & mask;
+                word = needed < 64 ? fresh >> needed : 0;
+                bits = available * 8 - needed;
+            }
+        }
+
+        template<typename T>
+        T fixed() {
+            if (static_cast<std::size_t>(end - p) < sizeof(T)) throw std::runtime_error("Corrupt trade tape: truncated field");
+            T value;
+            std::memcpy(&value, p, sizeof(T));
+            p += sizeof(T);
+            return value;
+        }
+    };
+}
+
+TradeTapeWriter::TradeTapeWriter(const str& path, std::size_t blockTrades)
+    : file(path, std::ios::binary | std::ios::trunc), blockTrades(std::max<std::size_t>(1, blockTrades)) {
+    if (!file) throw std::runtime_error("Cannot open trade tape " + path);
+    pending.reserve(this->blockTrades);
+    write(str(MAGIC, sizeof(MAGIC)));
+}
+
+TradeTapeWriter::~TradeTapeWriter() {
+    subscriptions.clear();
+    close();
+}
+
+void TradeTapeWriter::subscribe(EventDispatcher& dispatcher) {
+    subscriptions.add<TradeExecutedEvent>(dispatcher, [this](const TradeExecutedEvent& event) { onTrade(event); });
+}
+
+std::uint32_t TradeTapeWriter::internSymbol(const str& symbol) {
+    auto it = symbolIndex.find(symbol);
+    if (it != symbolIndex.end()) return it->second;
+    std::uint32_t index = static_cast<std::uint32_t>(symbols.size());
+    symbols.push_back(symbol);
+    symbolIndex.emplace(symbol, index);
+    return index;
+}
+
+void TradeTapeWriter::onTrade(const TradeExecutedEvent& event) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (closed) return;
+
+    TapeTrade trade;
+    trade.sequence = nextSequence++;
+    trade.timestamp = clock != 0 ? clock : event.timestamp.time_since_epoch().count();
+    trade.symbol = internSymbol(event.symbol);
+    trade.price = event.price;
+    trade.quantity = event.quantity;
+    trade.aggressingOrderID = event.aggressingOrderID;
+    trade.aggressingTraderID = event.aggressingTraderID;
+    trade.aggressingSide = event.aggressingSide;
+    trade.aggressingRemainingQuantity = event.aggressingRemainingQuantity;
+    trade.restingOrderID = event.restingOrderID;
+    trade.restingTraderID = event.restingTraderID;
+    trade.restingRemainingQuantity = event.restingRemainingQuantity;
+    pending.push_back(trade);
+
+    if (pending.size() >= blockTrades) writeBlock();
+}
+
+void TradeTapeWriter::setClock(std::int64_t timestampMs) {
+    std::lock_guard<std::mutex> lock(mtx);
+    clock = timestampMs;
+}
+
+void TradeTapeWriter::write(const str& bytes) {
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    if (!file) throw std::runtime_error("Failed writing trade tape");
+    offset += bytes.size();
+}
+
+void TradeTapeWriter::writeBlock() {
+    if (pending.empty()) return;
+
+    TapeBlockIndex entry;
+    entry.offset = offset;
+    entry.count = static_cast<std::uint32_t>(pending.size());
+    entry.firstSequence = pending.front().sequence;
+    entry.minTime = entry.maxTime = pending.front().timestamp;
+    for (const TapeTrade& trade : pending) {
+        entry.minTime = std::min(entry.minTime, trade.timestamp);
+        entry.maxTime = std::max(entry.maxTime, trade.timestamp);
+        entry.symbolMask |= 1ull << (trade.symbol % 64);
+        entry.traderMask |= (1ull << (trade.aggressingTraderID % 64)) | (1ull << (trade.restingTraderID % 64));
+    }
+
+    str columns[COLUMN_COUNT];
+    std::vector<std::uint64_t> values(pending.size());
+    for (std::size_t c = 0; c < COLUMN_COUNT; ++c) {
+        // Deltas start from the first row, written up front, so it does not widen the packing
+        std::uint64_t previous = columnValue(pending.front(), c);
+        if (DELTA[c]) putVarint(columns[c], previous);
+        for (std::size_t i = 0; i < pending.size(); ++i) {
+            const std::uint64_t value = columnValue(pending[i], c);
+            values[i] = DELTA[c] ? zigzag(static_cast<std::int64_t>(value - previous)) : value;
+            previous = value;
+        }
+        packColumn(columns[c], values);
+    }
+
+    str block;
+    for (const str& column : columns) put<std::uint32_t>(block, static_cast<std::uint32_t>(column.size()));
+    for (const str& column : columns) block += column;
+    entry.bytes = static_cast<std::uint32_t>(block.size());
+    write(block);
+
+    blocks.push_back(entry);
+    pending.clear();
+}
+
+void TradeTapeWriter::flush() {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (closed) return;
+    writeBlock();
+    file.flush();
+}
+
+void TradeTapeWriter::close() {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (closed) return;
+    closed = true;
+    writeBlock();
+
+    const std::uint64_t footerOffset = offset;
+    str footer;
+    put<std::uint32_t>(footer, static_cast<std::uint32_t>(symbols.size()));
+    for (const str& symbol : symbols) {
+        put<std::uint16_t>(footer, static_cast<std::uint16_t>(symbol.size()));
+        footer += symbol;
+    }
+    put<std::uint32_t>(footer, static_cast<std::uint32_t>(blocks.size()));
+    for (const TapeBlockIndex& block : blocks) {
+        put(footer, block.offset);
+        put(footer, block.bytes);
+        put(footer, block.count);
+        put(footer, block.firstSequence);
+        put(footer, block.minTime);
+        put(footer, block.maxTime);
+        put(footer, block.symbolMask);
+        put(footer, block.traderMask);
+    }
+    put(footer, footerOffset);
+    footer.append(MAGIC, sizeof(MAGIC));
+    write(footer);
+    file.close();
+}
+
+std::uint64_t TradeTapeWriter::tradeCount() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return nextSequence;
+}
+
+TradeTapeReader::TradeTapeReader(const str& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open trade tape " + path);
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot stat trade tape " + path);
+    }
+    size = static_cast<std::size_t>(info.st_size);
+    if (size < 2 * sizeof(MAGIC) + sizeof(std::uint64_t)) {
+        ::close(fd);
+        throw std::runtime_error("Not a trade tape: " + path);
+    }
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) throw std::runtime_error("Cannot map trade tape " + path);
+    data = static_cast<const std::uint8_t*>(mapped);
+
+    try {
+        if (std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0 || std::memcmp(data + size - sizeof(MAGIC), MAGIC, sizeof(MAGIC)) != 0) {
+            throw std::runtime_error("Not a trade tape, or its writer was not closed: " + path);
+        }
+        Cursor trailer{data + size - sizeof(MAGIC) - sizeof(std::uint64_t), data + size};
+        const std::uint64_t footerOffset = trailer.fixed<std::uint64_t>();
+        if (footerOffset < sizeof(MAGIC) || footerOffset > size - sizeof(MAGIC) - sizeof(std::uint64_t)) {
+            throw std::runtime_error("Corrupt trade tape: bad footer offset");
+        }
+
+        Cursor footer{data + footerOffset, data + size - sizeof(MAGIC) - sizeof(std::uint64_t)};
+        const std::uint32_t symbolCount = footer.fixed<std::uint32_t>();
+        for (std::uint32_t i = 0; i < symbolCount; ++i) {
+            const std::uint16_t length = footer.fixed<std::uint16_t>();
+            if (static_cast<std::size_t>(footer.end - footer.p) < length) throw std::runtime_error("Corrupt trade tape: truncated symbol");
+            symbolNames.emplace_back(reinterpret_cast<const char*>(footer.p), length);
+            footer.p += length;
+        }
+        const std::uint32_t blockCount = footer.fixed<std::uint32_t>();
+        blocks.reserve(blockCount);
+        for (std::uint32_t i = 0; i < blockCount; ++i) {
+            TapeBlockIndex block;
+            block.offset = footer.fixed<std::uint64_t>();
+            block.bytes = footer.fixed<std::uint32_t>();
+            block.count = footer.fixed<std::uint32_t>();
+            block.firstSequence = footer.fixed<std::uint64_t>();
+            block.minTime = footer.fixed<std::int64_t>();
+            block.maxTime = footer.fixed<std::int64_t>();
+            block.symbolMask = footer.fixed<std::uint64_t>();
+            block.traderMask = footer.fixed<std::uint64_t>();
+            if (block.offset < sizeof(MAGIC) || block.offset + block.bytes > footerOffset) throw std::runtime_error("Corrupt trade tape: bad block extent");
+            trades += block.count;
+            blocks.push_back(block);
+        }
+    }
+    catch (...) {
+        munmap(const_cast<std::uint8_t*>(data), size);
+        throw;
+    }
+}
+
+TradeTapeReader::~TradeTapeReader() {
+    if (data) munmap(const_cast<std::uint8_t*>(data), size);
+}
+
+void TradeTapeReader::decodeBlock(const TapeBlockIndex& block, const TapeQuery& query, std::optional<std::uint32_t> symbol,
+                                  std::uint64_t firstSequence, std::uint64_t lastSequence, std::vector<TapeTrade>& out) {
+    decoded++;
+    Cursor header{data + block.offset, data + block.offset + block.bytes};
+    const std::uint8_t* starts[COLUMN_COUNT];
+    const std::uint8_t* next = data + block.offset + COLUMN_COUNT * sizeof(std::uint32_t);
+    for (std::size_t c = 0; c < COLUMN_COUNT; ++c) {
+        starts[c] = next;
+        next += header.fixed<std::uint32_t>();
+    }
+    if (next != header.end) throw std::runtime_error("Corrupt trade tape: column sizes do not add up");
+
+    std::vector<std::uint64_t> values[COLUMN_COUNT];
+    auto column = [&](std::size_t c) -> const std::vector<std::uint64_t>& {
+        if (values[c].empty()) {
+            Cursor cursor{starts[c], c + 1 < COLUMN_COUNT ? starts[c + 1] : header.end};
+            std::uint64_t previous = DELTA[c] ? cursor.varint() : 0;
+            cursor.unpackColumn(values[c], block.count);
+            if (DELTA[c]) {
+                for (std::uint64_t& value : values[c]) value = previous += static_cast<std::uint64_t>(unzigzag(value));
+            }
+        }
+        return values[c];
+    };
+
+    // Filter on the columns the query needs; the rest are decoded only if something matched
+    std::vector<std::uint32_t> rows;
+    const std::vector<std::uint64_t>& times = column(TIME);
+    for (std::uint32_t i = 0; i < block.count; ++i) {
+        const std::uint64_t sequence = block.firstSequence + i;
+        const std::int64_t time = static_cast<std::int64_t>(times[i]);
+        if (sequence < firstSequence || sequence >= lastSequence || time < query.from || time >= query.to) continue;
+        if (symbol && column(SYMBOL)[i] != *symbol) continue;
+        if (query.traderID && column(AGGRESSING_TRADER)[i] != *query.traderID && column(RESTING_TRADER)[i] != *query.traderID) continue;
+        rows.push_back(i);
+    }
+    if (rows.empty()) return;
+
+    for (std::size_t c = 0; c < COLUMN_COUNT; ++c) column(c);
+    for (std::uint32_t i : rows) {
+        TapeTrade trade;
+        trade.sequence = block.firstSequence + i;
+        trade.timestamp = static_cast<std::int64_t>(values[TIME][i]);
+        trade.symbol = static_cast<std::uint32_t>(values[SYMBOL][i]);
+        trade.price = static_cast<Price>(values[PRICE][i]);
+        trade.quantity = static_cast<Quantity>(values[QUANTITY][i]);
+        trade.aggressingSide = values[AGGRESSING_SIDE][i] == 0 ? Side::BUY : Side::SELL;
+        trade.aggressingOrderID = values[AGGRESSING_ORDER][i];
+        trade.aggressingTraderID = static_cast<TraderID>(values[AGGRESSING_TRADER][i]);
+        trade.aggressingRemainingQuantity = static_cast<Quantity>(values[AGGRESSING_REMAINING][i]);
+        trade.restingOrderID = values[RESTING_ORDER][i];
+        trade.restingTraderID = static_cast<TraderID>(values[RESTING_TRADER][i]);
+        trade.restingRemainingQuantity = static_cast<Quantity>(values[RESTING_REMAINING][i]);
+        out.push_back(trade);
+    }
+}
+
+std::vector<TapeTrade> TradeTapeReader::query(const TapeQuery& query) {
+    decoded = 0;
+    std::vector<TapeTrade> out;
+    std::optional<std::uint32_t> symbol;
+    if (query.symbol) {
+        auto it = std::find(symbolNames.begin(), symbolNames.end(), *query.symbol);
+        if (it == symbolNames.end()) return out;
+        symbol = static_cast<std::uint32_t>(it - symbolNames.begin());
+    }
+
+    for (const TapeBlockIndex& block : blocks) {
+        if (block.maxTime < query.from || block.minTime >= query.to) continue;
+        if (symbol && !(block.symbolMask & (1ull << (*symbol % 64)))) continue;
+        if (query.traderID && !(block.traderMask & (1ull << (*query.traderID % 64)))) continue;
+        decodeBlock(block, query, symbol, 0, std::numeric_limits<std::uint64_t>::max(), out);
+    }
+    return out;
+}
+
+std::vector<TapeTrade> TradeTapeReader::sequenceRange(std::uint64_t first, std::uint64_t last) {
+    decoded = 0;
+    std::vector<TapeTrade> out;
+    // Blocks hold consecutive sequence numbers, so start from the one containing `first`
+    auto it = std::upper_bound(blocks.begin(), blocks.end(), first,
+                               [](std::uint64_t sequence, const TapeBlockIndex& block) { return sequence < block.firstSequence; });
+    if (it != blocks.begin()) --it;
+    for (; it != blocks.end() && it->firstSequence < last; ++it) {
+        if (it->firstSequence + it->count <= first) continue;
+        decodeBlock(*it, TapeQuery{}, std::nullopt, first, last, out);
+    }
+    return out;
+}
@@ -0,0 +1,136 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include "types.h"
+#include "order.h"
+#include "events.h"
+#include "eventDispatcher.h"
+
+// One execution as stored on the tape. Sequence numbers are assigned by the
+// writer in arrival order, starting at 0.
+struct TapeTrade {
+    std::uint64_t sequence = 0;
+    std::int64_t timestamp = 0;     // ms since epoch
+    std::uint32_t symbol = 0;       // index into TradeTapeReader::symbols()
+    Price price = 0;
+    Quantity quantity = 0;
+
+    OrderID aggressingOrderID = 0;
+    TraderID aggressingTraderID = 0;
+    Side aggressingSide = Side::BUY;
+    Quantity aggressingRemainingQuantity = 0;
+
+    OrderID restingOrderID = 0;
+    TraderID restingTraderID = 0;
+    Quantity restingRemainingQuantity = 0;
+};
+
+// Footer entry for one block: where it is and enough about its contents to
+// skip it without decoding. Symbols and traders are summarised as 64-bit
+// masks (bit id % 64), so a set bit means "maybe", a clear bit "no".
+struct TapeBlockIndex {
+    std::uint64_t offset = 0;
+    std::uint32_t bytes = 0;
+    std::uint32_t count = 0;
+    std::uint64_t firstSequence = 0;
+    std::int64_t minTime = 0;
+    std::int64_t maxTime = 0;
+    std::uint64_t symbolMask = 0;
+    std::uint64_t traderMask = 0;
+};
+
+// Appends every trade to a columnar tape file. Trades are buffered into
+// blocks and each column of a block is encoded on its own: timestamps, prices
+// and order ids as zigzag deltas from the previous row, then every column as
+// a varint minimum plus fixed-width bit-packed offsets. The footer with the
+// symbol table and block index is written by close(), so a tape can only be
+// read once its writer has closed it.
+//
+// File layout, little-endian:
+//   "TRDTAPE1"  blocks...  footer  u64 footerOffset  "TRDTAPE1"
+class TradeTapeWriter {
+    private:
+        std::mutex mtx;
+        std::ofstream file;
+        std::size_t blockTrades;
+        std::uint64_t offset = 0;
+        std::uint64_t nextSequence = 0;
+        std::int64_t clock = 0;
+        bool closed = false;
+
+        std::vector<TapeTrade> pending;
+        std::vector<TapeBlockIndex> blocks;
+        std::vector<str> symbols;
+        std::unordered_map<str, std::uint32_t> symbolIndex;
+        Subscriptions subscriptions;
+
+        std::uint32_t internSymbol(const str& symbol);
+        void writeBlock();
+        void write(const str& bytes);
+
+    public:
+        explicit TradeTapeWriter(const str& path, std::size_t blockTrades = 4096);
+        ~TradeTapeWriter();
+        TradeTapeWriter(const TradeTapeWriter&) = delete;
+        TradeTapeWriter& operator=(const TradeTapeWriter&) = delete;
+
+        void subscribe(EventDispatcher& dispatcher);
+        void onTrade(const TradeExecutedEvent& event);
+
+        // Stamp subsequent trades with this time instead of the event's wall
+        // clock, e.g. the timestamp of the bar being replayed.
+        void setClock(std::int64_t timestampMs);
+
+        // Seals the partial block and flushes the file.
+        void flush();
+        // Writes the footer. Further trades are ignored.
+        void close();
+
+        std::uint64_t tradeCount();
+};
+
+// [from, to) in ms; unset filters match everything. A trader matches on
+// either side of the trade.
+struct TapeQuery {
+    std::int64_t from = std::numeric_limits<std::int64_t>::min();
+    std::int64_t to = std::numeric_limits<std::int64_t>::max();
+    std::optional<TraderID> traderID;
+    std::optional<str> symbol;
+};
+
+// Memory-maps a closed tape. Queries consult the block index first and only
+// decode blocks that can contain a match; within a block, the filter columns
+// are decoded before the rest.
+class TradeTapeReader {
+    private:
+        const std::uint8_t* data = nullptr;
+        std::size_t size = 0;
+        std::vector<TapeBlockIndex> blocks;
+        std::vector<str> symbolNames;
+        std::uint64_t trades = 0;
+        std::size_t decoded = 0;
+
+        void decodeBlock(const TapeBlockIndex& block, const TapeQuery& query, std::optional<std::uint32_t> symbol,
+                         std::uint64_t firstSequence, std::uint64_t lastSequence, std::vector<TapeTrade>& out);
+
+    public:
+        explicit TradeTapeReader(const str& path);
+        ~TradeTapeReader();
+        TradeTapeReader(const TradeTapeReader&) = delete;
+        TradeTapeReader& operator=(const TradeTapeReader&) = delete;
+
+        std::vector<TapeTrade> query(const TapeQuery& query);
+        // Trades with sequence numbers in [first, last).
+        std::vector<TapeTrade> sequenceRange(std::uint64_t first, std::uint64_t last);
+
+        const std::vector<str>& symbols() const { return symbolNames; }
+        const std::vector<TapeBlockIndex>& blockIndex() const { return blocks; }
+        std::uint64_t tradeCount() const { return trades; }
+        // Blocks the last query had to decode.
+        std::size_t blocksDecoded() const { return decoded; }
+};
@@ -1,6 +1,8 @@
 import collections.abc
 import datetime
 import typing
+import numpy
+import numpy.typing
 from typing import ClassVar
 
 BUY: Side
@@ -8,16 +10,173 @@ LIMIT: OrderType
 MARKET: OrderType
 SELL: Side
 
+class AccountSnapshot:
+    def __init__(self, *args, **kwargs) -> None: ...
+    @property
+    def cash(self) -> int: ...
+    @property
+    def equity(self) -> int: ...
+    @property
+    def fill_count(self) -> int: ...
+    @property
+    def market_value(self) -> int: ...
+    @property
+    def realized_pnl(self) -> int: ...
+    @property
+    def trader_id(self) -> int: ...
+    @property
+    def unrealized_pnl(self) -> int: ...
+
+class AuctionUncrossEvent:
+    imbalance: int
+    price: int
+    volume: int
+    def __init__(self) -> None: ...
+
+class Bar:
+    close: float
+    high: float
+    low: float
+    open: float
+    symbol: str
+    timestamp: datetime.datetime
+    volume: float
+    def __init__(self, symbol: str, timestamp: datetime.datetime, open: typing.SupportsFloat, high: typing.SupportsFloat, low: typing.SupportsFloat, close: typing.SupportsFloat, volume: typing.SupportsFloat = ...) -> None: ...
+
+class BookAnalytics:
+    def depth_imbalance(self) -> float: ...
+    def imbalance(self) -> float: ...
+    def microprice(self) -> float: ...
+    @property
+    def ask_depth(self) -> int: ...
+    @property
+    def ask_orders(self) -> int: ...
+    @property
+    def ask_price(self) -> int: ...
+    @property
+    def ask_quantity(self) -> int: ...
+    @property
+    def bid_depth(self) -> int: ...
+    @property
+    def bid_orders(self) -> int: ...
+    @property
+    def bid_price(self) -> int: ...
+    @property
+    def bid_quantity(self) -> int: ...
+    @property
+    def depth_ticks(self) -> int: ...
+    @property
+    def version(self) -> int: ...
+
+class EngineConfig:
+    bind_memory: bool
+    default_risk_limits: RiskLimits
+    expected_orders: int
+    lock_memory: bool
+    matching_core: int
+    max_traders: int
+    prefault_bytes: int
+    realtime_priority: int
+    self_trade_prevention: SelfTradePrevention
+    session_close: datetime.timedelta
+    wait_strategy: WaitStrategy
+    def __init__(self) -> None: ...
+
 class EventDispatcher:
     def __init__(self) -> None: ...
+    def publish_auction_uncross(self, arg0: AuctionUncrossEvent) -> None: ...
     def publish_market_data(self, arg0: MarketDataEvent) -> None: ...
+    def publish_mass_cancel(self, arg0: MassCancelEvent) -> None: ...
     def publish_order_accepted(self, arg0: OrderAcceptedEvent) -> None: ...
     def publish_order_cancelled(self, arg0: OrderCancelledEvent) -> None: ...
+    def publish_order_rejected(self, arg0: OrderRejectedEvent) -> None: ...
     def publish_trade_executed(self, arg0: TradeExecutedEvent) -> None: ...
-    def subscribe_market_data(self, arg0: collections.abc.Callable[[MarketDataEvent], None]) -> None: ...
-    def subscribe_order_accepted(self, arg0: collections.abc.Callable[[OrderAcceptedEvent], None]) -> None: ...
-    def subscribe_order_cancelled(self, arg0: collections.abc.Callable[[OrderCancelledEvent], None]) -> None: ...
-    def subscribe_trade_executed(self, arg0: collections.abc.Callable[[TradeExecutedEvent], None]) -> None: ...
+    def subscribe_auction_uncross(self, arg0: collections.abc.Callable[[AuctionUncrossEvent], None]) -> int: ...
+    def subscribe_market_data(self, arg0: collections.abc.Callable[[MarketDataEvent], None]) -> int: ...
+    def subscribe_mass_cancel(self, arg0: collections.abc.Callable[[MassCancelEvent], None]) -> int: ...
+    def subscribe_order_accepted(self, arg0: collections.abc.Callable[[OrderAcceptedEvent], None]) -> int: ...
+    def subscribe_order_cancelled(self, arg0: collections.abc.Callable[[OrderCancelledEvent], None]) -> int: ...
+    def subscribe_order_rejected(self, arg0: collections.abc.Callable[[OrderRejectedEvent], None]) -> int: ...
+    def subscribe_trade_executed(self, arg0: collections.abc.Callable[[TradeExecutedEvent], None]) -> int: ...
+    def unsubscribe(self, arg0: int) -> None: ...
+
+class ExponentialMovingAverage:
+    def __init__(self, period: typing.SupportsInt) -> None: ...
+    def update(self, value: typing.SupportsFloat) -> float: ...
+    @property
+    def ready(self) -> bool: ...
+    @property
+    def value(self) -> float: ...
+
+class FillRecorder:
+    def __init__(self, trader_id: typing.SupportsInt | None = None, capacity: typing.SupportsInt = 65536) -> None: ...
+    def attach(self, dispatcher: EventDispatcher) -> None: ...
+    def fill_count(self) -> int: ...
+    def record_equity(self, timestamp_ms: typing.SupportsInt, value: typing.SupportsFloat) -> None: ...
+    def set_clock(self, timestamp_ms: typing.SupportsInt) -> None: ...
+    def take_equity(self) -> dict: ...
+    def take_fills(self) -> dict: ...
+    @property
+    def symbols(self) -> list[str]: ...
+
+class ItchReplay:
+    def __init__(self, path: str) -> None: ...
+    def add_locate(self, locate: typing.SupportsInt) -> None: ...
+    def add_symbol(self, symbol: str) -> None: ...
+    def book_count(self) -> int: ...
+    def current_time(self) -> int: ...
+    def done(self) -> bool: ...
+    @typing.overload
+    def get_book(self, locate: typing.SupportsInt) -> OrderBook | None: ...
+    @typing.overload
+    def get_book(self, symbol: str) -> OrderBook | None: ...
+    def get_symbol(self, locate: typing.SupportsInt) -> str: ...
+    def publish_trades(self, dispatcher: EventDispatcher, session_date_ms: typing.SupportsInt) -> None: ...
+    def run_until(self, nanos_since_midnight: typing.SupportsInt) -> int: ...
+    def stats(self) -> ItchStats: ...
+    def step(self, max_messages: typing.SupportsInt = ...) -> int: ...
+
+class ItchStats:
+    @property
+    def applied(self) -> int: ...
+    @property
+    def filtered(self) -> int: ...
+    @property
+    def messages(self) -> int: ...
+    @property
+    def unknown_orders(self) -> int: ...
+
+class Ledger:
+    def __init__(self) -> None: ...
+    def account(self, trader_id: typing.SupportsInt) -> AccountSnapshot | None: ...
+    def attach(self, dispatcher: EventDispatcher) -> None: ...
+    def mark(self, symbol: str) -> int | None: ...
+    def open_account(self, trader_id: typing.SupportsInt, cash: typing.SupportsInt) -> None: ...
+    def position(self, trader_id: typing.SupportsInt, symbol: str) -> PositionSnapshot | None: ...
+    def positions(self, trader_id: typing.SupportsInt) -> list[PositionSnapshot]: ...
+
+class L2Level:
+    @property
+    def price(self) -> int: ...
+    @property
+    def quantity(self) -> int: ...
+
+class L2Replay:
+    def __init__(self, dispatcher: EventDispatcher, symbol: str, trader_id: typing.SupportsInt, path: str) -> None: ...
+    def __len__(self) -> int: ...
+    def best_ask(self) -> L2Level | None: ...
+    def best_bid(self) -> L2Level | None: ...
+    def cancel(self, order_id: typing.SupportsInt) -> bool: ...
+    def get_order(self, order_id: typing.SupportsInt) -> SimOrder | None: ...
+    def run(self) -> int: ...
+    def run_until(self, timestamp: typing.SupportsInt) -> int: ...
+    def step(self) -> bool: ...
+    def submit_limit(self, side: Side, price: typing.SupportsInt, quantity: typing.SupportsInt) -> int: ...
+    def submit_market(self, side: Side, quantity: typing.SupportsInt) -> int: ...
+    @property
+    def current_time(self) -> int: ...
+    @property
+    def done(self) -> bool: ...
 
 class LimitOrder(Order):
     def __init__(self, arg0: str, arg1: typing.SupportsInt, arg2: OrderType, arg3: Side, arg4: str, arg5: typing.SupportsInt, arg6: typing.SupportsInt) -> None: ...
@@ -34,28 +193,59 @@ class MarketOrder(Order):
     def __init__(self, arg0: str, arg1: typing.SupportsInt, arg2: OrderType, arg3: Side, arg4: typing.SupportsInt, arg5: typing.SupportsInt) -> None: ...
     def get_quantity(self) -> int: ...
 
+class MassCancelEvent:
+    cancelled: list[OrderCancelledEvent]
+    def __init__(self) -> None: ...
+
 class MatchingEngine:
+    @typing.overload
     def __init__(self, arg0: OrderBook, arg1: EventDispatcher) -> None: ...
+    @typing.overload
+    def __init__(self, order_book: OrderBook, dispatcher: EventDispatcher, config: EngineConfig) -> None: ...
+    def begin_auction(self) -> None: ...
     def cancel_order(self, order_id: typing.SupportsInt) -> None: ...
+    @typing.overload
+    def mass_cancel(self, trader_id: typing.SupportsInt) -> None: ...
+    @typing.overload
+    def mass_cancel(self, trader_id: typing.SupportsInt, side: Side) -> None: ...
+    def mass_cancel_all(self) -> None: ...
+    def mass_cancel_symbol(self, symbol: str) -> None: ...
+    def run_pending(self) -> int: ...
+    def set_risk_limits(self, trader_id: typing.SupportsInt, limits: RiskLimits) -> None: ...
+    def set_time(self, now: datetime.datetime) -> None: ...
     def start(self) -> None: ...
     def stop(self) -> None: ...
     def submit_order(self, order: Order) -> int: ...
+    def uncross(self) -> None: ...
 
 class Order:
+    expire_time: datetime.datetime
+    time_in_force: TimeInForce
     def __init__(self, *args, **kwargs) -> None: ...
 
 class OrderAcceptedEvent:
     order_id: int
     price: int
     quantity: int
+    symbol: str
+    side: Side
     def __init__(self) -> None: ...
 
 class OrderBook:
     def __init__(self) -> None: ...
+    def get_analytics(self) -> BookAnalytics: ...
+    def set_analytics_depth(self, ticks: typing.SupportsInt) -> None: ...
 
 class OrderCancelledEvent:
     order_id: int
     quantity: int
+    remaining: int
+    def __init__(self) -> None: ...
+
+class OrderRejectedEvent:
+    order_id: int
+    reason: RejectReason
+    trader_id: int
     def __init__(self) -> None: ...
 
 class OrderType:
@@ -74,6 +264,255 @@ class OrderType:
     @property
     def value(self) -> int: ...
 
+class PerformanceConfig:
+    bucket_ms: int
+    periods_per_year: float
+    price_scale: float
+    risk_free_rate: float
+    rolling_window: int
+    def __init__(self) -> None: ...
+
+class PerformanceSummary:
+    def __init__(self, *args, **kwargs) -> None: ...
+    @property
+    def annual_return(self) -> float: ...
+    @property
+    def annual_volatility(self) -> float: ...
+    @property
+    def average_loss(self) -> float: ...
+    @property
+    def average_win(self) -> float: ...
+    @property
+    def calmar(self) -> float: ...
+    @property
+    def closed_trades(self) -> int: ...
+    @property
+    def end_value(self) -> float: ...
+    @property
+    def fills(self) -> int: ...
+    @property
+    def gross_loss(self) -> float: ...
+    @property
+    def gross_profit(self) -> float: ...
+    @property
+    def max_drawdown(self) -> float: ...
+    @property
+    def max_drawdown_periods(self) -> int: ...
+    @property
+    def periods(self) -> int: ...
+    @property
+    def profit_factor(self) -> float: ...
+    @property
+    def realized_pnl(self) -> float: ...
+    @property
+    def sharpe(self) -> float: ...
+    @property
+    def sortino(self) -> float: ...
+    @property
+    def start_value(self) -> float: ...
+    @property
+    def total_return(self) -> float: ...
+    @property
+    def turnover(self) -> float: ...
+    @property
+    def win_rate(self) -> float: ...
+    @property
+    def winning_trades(self) -> int: ...
+
+class PositionSnapshot:
+    def __init__(self, *args, **kwargs) -> None: ...
+    @property
+    def cost_basis(self) -> int: ...
+    @property
+    def market_value(self) -> int: ...
+    @property
+    def quantity(self) -> int: ...
+    @property
+    def realized_pnl(self) -> int: ...
+    @property
+    def symbol(self) -> str: ...
+    @property
+    def unrealized_pnl(self) -> int: ...
+
+class ProRataMatchingEngine:
+    @typing.overload
+    def __init__(self, arg0: OrderBook, arg1: EventDispatcher) -> None: ...
+    @typing.overload
+    def __init__(self, order_book: OrderBook, dispatcher: EventDispatcher, config: EngineConfig) -> None: ...
+    def begin_auction(self) -> None: ...
+    def cancel_order(self, order_id: typing.SupportsInt) -> None: ...
+    @typing.overload
+    def mass_cancel(self, trader_id: typing.SupportsInt) -> None: ...
+    @typing.overload
+    def mass_cancel(self, trader_id: typing.SupportsInt, side: Side) -> None: ...
+    def mass_cancel_all(self) -> None: ...
+    def mass_cancel_symbol(self, symbol: str) -> None: ...
+    def run_pending(self) -> int: ...
+    def set_risk_limits(self, trader_id: typing.SupportsInt, limits: RiskLimits) -> None: ...
+    def set_time(self, now: datetime.datetime) -> None: ...
+    def start(self) -> None: ...
+    def stop(self) -> None: ...
+    def submit_order(self, order: Order) -> int: ...
+    def uncross(self) -> None: ...
+
+class RejectCode:
+    __members__: ClassVar[dict] = ...  # read-only
+    ORDER_SIZE: ClassVar[RejectCode] = ...
+    POSITION_LIMIT: ClassVar[RejectCode] = ...
+    OPEN_ORDER_LIMIT: ClassVar[RejectCode] = ...
+    PRICE_BAND: ClassVar[RejectCode] = ...
+    UNKNOWN_TRADER: ClassVar[RejectCode] = ...
+    THROTTLED: ClassVar[RejectCode] = ...
+    NOT_LOGGED_IN: ClassVar[RejectCode] = ...
+    UNKNOWN_TOKEN: ClassVar[RejectCode] = ...
+    DUPLICATE_TOKEN: ClassVar[RejectCode] = ...
+    INVALID_ORDER: ClassVar[RejectCode] = ...
+    TOO_LATE_TO_REPLACE: ClassVar[RejectCode] = ...
+    REPLACE_PENDING: ClassVar[RejectCode] = ...
+    __entries: ClassVar[dict] = ...
+    def __init__(self, value: typing.SupportsInt) -> None: ...
+    def __eq__(self, other: object) -> bool: ...
+    def __hash__(self) -> int: ...
+    def __index__(self) -> int: ...
+    def __int__(self) -> int: ...
+    def __ne__(self, other: object) -> bool: ...
+    @property
+    def name(self) -> str: ...
+    @property
+    def value(self) -> int: ...
+
+class RejectReason:
+    __members__: ClassVar[dict] = ...  # read-only
+    ORDER_SIZE: ClassVar[RejectReason] = ...
+    POSITION_LIMIT: ClassVar[RejectReason] = ...
+    OPEN_ORDER_LIMIT: ClassVar[RejectReason] = ...
+    PRICE_BAND: ClassVar[RejectReason] = ...
+    UNKNOWN_TRADER: ClassVar[RejectReason] = ...
+    __entries: ClassVar[dict] = ...
+    def __init__(self, value: typing.SupportsInt) -> None: ...
+    def __eq__(self, other: object) -> bool: ...
+    def __hash__(self) -> int: ...
+    def __index__(self) -> int: ...
+    def __int__(self) -> int: ...
+    def __ne__(self, other: object) -> bool: ...
+    @property
+    def name(self) -> str: ...
+    @property
+    def value(self) -> int: ...
+
+class RiskLimits:
+    max_open_orders: int
+    max_order_quantity: int
+    max_position: int
+    price_band_ticks: int
+    def __init__(self) -> None: ...
+
+class RollingMax:
+    def __init__(self, period: typing.SupportsInt) -> None: ...
+    def update(self, value: typing.SupportsFloat) -> float: ...
+    @property
+    def ready(self) -> bool: ...
+    @property
+    def value(self) -> float: ...
+
+class RollingMin:
+    def __init__(self, period: typing.SupportsInt) -> None: ...
+    def update(self, value: typing.SupportsFloat) -> float: ...
+    @property
+    def ready(self) -> bool: ...
+    @property
+    def value(self) -> float: ...
+
+class RollingStdDev:
+    def __init__(self, period: typing.SupportsInt) -> None: ...
+    def update(self, value: typing.SupportsFloat) -> float: ...
+    @property
+    def mean(self) -> float: ...
+    @property
+    def ready(self) -> bool: ...
+    @property
+    def value(self) -> float: ...
+
+class RollingVWAP:
+    def __init__(self, period: typing.SupportsInt) -> None: ...
+    def update(self, price: typing.SupportsFloat, quantity: typing.SupportsFloat) -> float: ...
+    @property
+    def ready(self) -> bool: ...
+    @property
+    def value(self) -> float: ...
+
+class SelfTradePrevention:
+    __members__: ClassVar[dict] = ...  # read-only
+    NONE: ClassVar[SelfTradePrevention] = ...
+    CANCEL_RESTING: ClassVar[SelfTradePrevention] = ...
+    CANCEL_AGGRESSOR: ClassVar[SelfTradePrevention] = ...
+    DECREMENT_BOTH: ClassVar[SelfTradePrevention] = ...
+    __entries: ClassVar[dict] = ...
+    def __init__(self, value: typing.SupportsInt) -> None: ...
+    def __eq__(self, other: object) -> bool: ...
+    def __hash__(self) -> int: ...
+    def __index__(self) -> int: ...
+    def __int__(self) -> int: ...
+    def __ne__(self, other: object) -> bool: ...
+    @property
+    def name(self) -> str: ...
+    @property
+    def value(self) -> int: ...
+
+class ShmClient:
+    def __init__(self, name: str, trader_id: typing.SupportsInt) -> None: ...
+    def cancel(self, token: typing.SupportsInt) -> bool: ...
+    def close(self) -> None: ...
+    def is_connected(self) -> bool: ...
+    def poll(self) -> ShmReport | None: ...
+    def submit(self, token: typing.SupportsInt, symbol: str, side: Side, order_type: OrderType, price: typing.SupportsInt, quantity: typing.SupportsInt) -> bool: ...
+    def top_of_book(self) -> TopOfBook: ...
+
+class ShmReport:
+    @property
+    def order_id(self) -> int: ...
+    @property
+    def price(self) -> int: ...
+    @property
+    def quantity(self) -> int: ...
+    @property
+    def reason(self) -> RejectCode: ...
+    @property
+    def remaining(self) -> int: ...
+    @property
+    def token(self) -> int: ...
+    @property
+    def type(self) -> ShmReportType: ...
+
+class ShmReportType:
+    __members__: ClassVar[dict] = ...  # read-only
+    ACCEPTED: ClassVar[ShmReportType] = ...
+    EXECUTED: ClassVar[ShmReportType] = ...
+    CANCELLED: ClassVar[ShmReportType] = ...
+    REJECTED: ClassVar[ShmReportType] = ...
+    __entries: ClassVar[dict] = ...
+    def __init__(self, value: typing.SupportsInt) -> None: ...
+    def __eq__(self, other: object) -> bool: ...
+    def __hash__(self) -> int: ...
+    def __index__(self) -> int: ...
+    def __int__(self) -> int: ...
+    def __ne__(self, other: object) -> bool: ...
+    @property
+    def name(self) -> str: ...
+    @property
+    def value(self) -> int: ...
+
+class ShmServer:
+    def __init__(self, engine: MatchingEngine, dispatcher: EventDispatcher, book: OrderBook, config: ShmServerConfig = ...) -> None: ...
+    def start(self) -> None: ...
+    def stop(self) -> None: ...
+
+class ShmServerConfig:
+    busy_poll: bool
+    name: str
+    poll_core: int
+    def __init__(self) -> None: ...
+
 class Side:
     __members__: ClassVar[dict] = ...  # read-only
     BUY: ClassVar[Side] = ...
@@ -90,6 +529,88 @@ class Side:
     @property
     def value(self) -> int: ...
 
+class SimOrder:
+    @property
+    def order_id(self) -> int: ...
+    @property
+    def price(self) -> int: ...
+    @property
+    def quantity(self) -> int: ...
+    @property
+    def queue_ahead(self) -> int: ...
+    @property
+    def remaining(self) -> int: ...
+    @property
+    def side(self) -> Side: ...
+
+class SimpleMovingAverage:
+    def __init__(self, period: typing.SupportsInt) -> None: ...
+    def update(self, value: typing.SupportsFloat) -> float: ...
+    @property
+    def ready(self) -> bool: ...
+    @property
+    def value(self) -> float: ...
+
+class StrategyHost:
+    def __init__(self, engine: MatchingEngine, dispatcher: EventDispatcher, book: OrderBook, search_paths: collections.abc.Sequence[str] = ...) -> None: ...
+    def __len__(self) -> int: ...
+    def load(self, name: str, trader_id: typing.SupportsInt, params: str = ...) -> None: ...
+    def publish_bar(self, bar: Bar) -> None: ...
+    def resolve(self, name: str) -> str: ...
+    def stop(self) -> None: ...
+
+class TimeInForce:
+    __members__: ClassVar[dict] = ...  # read-only
+    GTC: ClassVar[TimeInForce] = ...
+    DAY: ClassVar[TimeInForce] = ...
+    GTD: ClassVar[TimeInForce] = ...
+    __entries: ClassVar[dict] = ...
+    def __init__(self, value: typing.SupportsInt) -> None: ...
+    def __eq__(self, other: object) -> bool: ...
+    def __hash__(self) -> int: ...
+    def __index__(self) -> int: ...
+    def __int__(self) -> int: ...
+    def __ne__(self, other: object) -> bool: ...
+    @property
+    def name(self) -> str: ...
+    @property
+    def value(self) -> int: ...
+
+class TopOrderMatchingEngine:
+    @typing.overload
+    def __init__(self, arg0: OrderBook, arg1: EventDispatcher) -> None: ...
+    @typing.overload
+    def __init__(self, order_book: OrderBook, dispatcher: EventDispatcher, config: EngineConfig) -> None: ...
+    def begin_auction(self) -> None: ...
+    def cancel_order(self, order_id: typing.SupportsInt) -> None: ...
+    @typing.overload
+    def mass_cancel(self, trader_id: typing.SupportsInt) -> None: ...
+    @typing.overload
+    def mass_cancel(self, trader_id: typing.SupportsInt, side: Side) -> None: ...
+    def mass_cancel_all(self) -> None: ...
+    def mass_cancel_symbol(self, symbol: str) -> None: ...
+    def run_pending(self) -> int: ...
+    def set_risk_limits(self, trader_id: typing.SupportsInt, limits: RiskLimits) -> None: ...
+    def set_time(self, now: datetime.datetime) -> None: ...
+    def start(self) -> None: ...
+    def stop(self) -> None: ...
+    def submit_order(self, order: Order) -> int: ...
+    def uncross(self) -> None: ...
+
+class TopOfBook:
+    @property
+    def ask_price(self) -> int: ...
+    @property
+    def ask_quantity(self) -> int: ...
+    @property
+    def bid_price(self) -> int: ...
+    @property
+    def bid_quantity(self) -> int: ...
+    @property
+    def last_price(self) -> int: ...
+    @property
+    def version(self) -> int: ...
+
 class TradeExecutedEvent:
     aggressing_order_id: int
     aggressing_remaining_quantity: int
@@ -103,3 +624,46 @@ class TradeExecutedEvent:
     symbol: str
     timestamp: datetime.datetime
     def __init__(self) -> None: ...
+
+class TradeTapeReader:
+    def __init__(self, path: str) -> None: ...
+    def blocks_decoded(self) -> int: ...
+    def query(self, from_ms: typing.SupportsInt | None = None, to_ms: typing.SupportsInt | None = None, trader_id: typing.SupportsInt | None = None, symbol: str | None = None) -> dict: ...
+    def sequence_range(self, first: typing.SupportsInt, last: typing.SupportsInt) -> dict: ...
+    def trade_count(self) -> int: ...
+    @property
+    def symbols(self) -> list[str]: ...
+
+class TradeTapeWriter:
+    def __init__(self, path: str, block_trades: typing.SupportsInt = 4096) -> None: ...
+    def attach(self, dispatcher: EventDispatcher) -> None: ...
+    def close(self) -> None: ...
+    def flush(self) -> None: ...
+    def set_clock(self, timestamp_ms: typing.SupportsInt) -> None: ...
+    def trade_count(self) -> int: ...
+
+class WaitStrategy:
+    __members__: ClassVar[dict] = ...  # read-only
+    BLOCKING: ClassVar[WaitStrategy] = ...
+    BUSY_POLL: ClassVar[WaitStrategy] = ...
+    __entries: ClassVar[dict] = ...
+    def __init__(self, value: typing.SupportsInt) -> None: ...
+    def __eq__(self, other: object) -> bool: ...
+    def __hash__(self) -> int: ...
+    def __index__(self) -> int: ...
+    def __int__(self) -> int: ...
+    def __ne__(self, other: object) -> bool: ...
+    @property
+    def name(self) -> str: ...
+    @property
+    def value(self) -> int: ...
+
+def analyze_performance(timestamp: typing.Annotated[numpy.typing.ArrayLike, numpy.int64], equity: typing.Annotated[numpy.typing.ArrayLike, numpy.float64], fills: dict | None = None, config: PerformanceConfig = ...) -> tuple[PerformanceSummary, dict]: ...
+def analyze_performance_batch(results: list, config: PerformanceConfig = ..., threads: typing.SupportsInt = 0) -> list[PerformanceSummary]: ...
+def ema(values: typing.Annotated[numpy.typing.ArrayLike, numpy.float64], period: typing.SupportsInt) -> numpy.typing.NDArray[numpy.float64]: ...
+def load_bars_csv(path: str, ticks_per_unit: typing.SupportsFloat = 100.0) -> dict: ...
+def rolling_max(values: typing.Annotated[numpy.typing.ArrayLike, numpy.float64], period: typing.SupportsInt) -> numpy.typing.NDArray[numpy.float64]: ...
+def rolling_min(values: typing.Annotated[numpy.typing.ArrayLike, numpy.float64], period: typing.SupportsInt) -> numpy.typing.NDArray[numpy.float64]: ...
+def rolling_std(values: typing.Annotated[numpy.typing.ArrayLike, numpy.float64], period: typing.SupportsInt) -> numpy.typing.NDArray[numpy.float64]: ...
+def sma(values: typing.Annotated[numpy.typing.ArrayLike, numpy.float64], period: typing.SupportsInt) -> numpy.typing.NDArray[numpy.float64]: ...
+def vwap(prices: typing.Annotated[numpy.typing.ArrayLike, numpy.float64], volumes: typing.Annotated[numpy.typing.ArrayLike, numpy.float64], period: typing.SupportsInt) -> numpy.typing.NDArray[numpy.float64]: ...
@@ -1,5 +1,6 @@
 #pragma once
 #include <cstdint>
+#include <chrono>
 
 using Price = std::uint32_t;
 using Quantity = std::uint32_t;